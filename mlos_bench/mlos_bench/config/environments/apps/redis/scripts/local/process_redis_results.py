@@ -8,35 +8,28 @@ Script for post-processing redis-benchmark results.
 """
 
 import argparse
-
-import pandas as pd
+import csv
 
 
 def _main(input_file: str, output_file: str) -> None:
     """
     Re-shape Redis benchmark CSV results from wide to long.
+    Stream the rows through, without loading the entire file into memory.
     """
-    df_wide = pd.read_csv(input_file)
-
-    # Format the results from wide to long
-    # The target is columns of metric and value to act as key-value pairs.
-    df_long = (
-        df_wide
-        .melt(id_vars=["test"])
-        .assign(metric=lambda df: df["test"] + "_" + df["variable"])
-        .drop(columns=["test", "variable"])
-        .loc[:, ["metric", "value"]]
-    )
-
-    # Add a default `score` metric to the end of the dataframe.
-    df_long = pd.concat([
-        df_long,
-        pd.DataFrame({"metric": ["score"], "value": [df_long.value[df_long.index.max()]]})
-    ])
+    with open(input_file, "rt", encoding="utf-8", newline="") as fh_input, \
+            open(output_file, "wt", encoding="utf-8", newline="") as fh_output:
+        writer = csv.writer(fh_output)
+        # The target is columns of metric and value to act as key-value pairs.
+        writer.writerow(["metric", "value"])
+        value = None
+        for row in csv.DictReader(fh_input):
+            test = row.pop("test")
+            for (variable, value) in row.items():
+                writer.writerow([f"{test}_{variable}", value])
+        # Add a default `score` metric to the end of the output.
+        writer.writerow(["score", value])
 
-    df_long.to_csv(output_file, index=False)
     print(f"Converted: {input_file} -> {output_file}")
-    # print(df_long)
 
 
 if __name__ == "__main__":
@@ -9,6 +9,7 @@ A simple class for describing where to find different config schemas and validat
 import logging
 from enum import Enum
 from os import path, walk, environ
+from threading import RLock
 from typing import Dict, Iterator, Mapping
 
 import json         # schema files are pure json - no comments
@@ -73,6 +74,11 @@ class SchemaStore(Mapping):
 
 SCHEMA_STORE = SchemaStore()
 
+# Precompiled validators, keyed by the schema path (see `ConfigSchema.validator`).
+# The validators share the (stateful) ref resolvers, so use them under the lock only.
+_VALIDATORS: Dict[str, jsonschema.protocols.Validator] = {}
+_VALIDATORS_LOCK = RLock()
+
 
 class ConfigSchema(Enum):
     """
@@ -95,6 +101,26 @@ class ConfigSchema(Enum):
         assert schema
         return schema
 
+    @property
+    def validator(self) -> jsonschema.protocols.Validator:
+        """
+        Gets the validator for this schema type.
+        The schema is checked and the validator is created once per process.
+
+        Raises
+        ------
+        jsonschema.exceptions.SchemaError
+        """
+        with _VALIDATORS_LOCK:
+            validator = _VALIDATORS.get(self.value)
+            if validator is None:
+                validator_class = jsonschema.validators.validator_for(self.schema)
+                validator_class.check_schema(self.schema)
+                resolver = jsonschema.RefResolver.from_schema(self.schema, store=SCHEMA_STORE)
+                validator = validator_class(self.schema, resolver=resolver)
+                _VALIDATORS[self.value] = validator
+            return validator
+
     def validate(self, config: dict) -> None:
         """
         Validates the given config against this schema.
@@ -112,5 +138,9 @@ class ConfigSchema(Enum):
         if _SKIP_VALIDATION:
             _LOG.warning("%s is set - skip schema validation", _VALIDATION_ENV_FLAG)
         else:
-            resolver: jsonschema.RefResolver = jsonschema.RefResolver.from_schema(self.schema, store=SCHEMA_STORE)
-            jsonschema.validate(instance=config, schema=self.schema, resolver=resolver)
+            # Same as `jsonschema.validate()`, but without re-checking the schema
+            # and re-creating the validator on every call.
+            with _VALIDATORS_LOCK:
+                error = jsonschema.exceptions.best_match(self.validator.iter_errors(config))
+            if error is not None:
+                raise error
@@ -9,7 +9,8 @@ A hierarchy of benchmark environments.
 import abc
 import json
 import logging
-from typing import Dict, Optional, Tuple, TYPE_CHECKING
+from datetime import datetime
+from typing import Dict, Iterable, List, Optional, Tuple, TYPE_CHECKING
 
 from mlos_bench.environments.status import Status
 from mlos_bench.services.base_service import Service
@@ -29,6 +30,9 @@ class Environment(metaclass=abc.ABCMeta):
     An abstract base of all benchmark environments.
     """
 
+    _SKIP_UNCHANGED_SETUP = False
+    """Default value of the `skip_unchanged_setup` config parameter."""
+
     @classmethod
     def new(cls,
             *,
@@ -123,6 +127,17 @@ class Environment(metaclass=abc.ABCMeta):
 
         self._params = self._combine_tunables(self._tunable_params)
 
+        # If True, skip the setup steps whose tunables have not changed since the last successful setup.
+        # Environments that do not declare their own tunables may depend on the tunables
+        # of their siblings, so we never skip their setup.
+        self._skip_unchanged_setup = bool(tunable_groups) and \
+            bool(config.get("skip_unchanged_setup", self._SKIP_UNCHANGED_SETUP))
+        # Values of the tunables of this environment from the last `.setup()` call.
+        self._setup_tunables: Optional[TunableGroups] = None
+        # Same values, but only the covariant groups that have changed since the
+        # previous successful setup are marked as updated. None means everything has changed.
+        self._setup_delta: Optional[TunableGroups] = None
+
         if _LOG.isEnabledFor(logging.DEBUG):
             _LOG.debug("Config for: %s\n%s",
                        name, json.dumps(self.config, indent=2))
@@ -226,14 +241,90 @@ class Environment(metaclass=abc.ABCMeta):
         _LOG.info("Setup %s :: %s", self, tunables)
         assert isinstance(tunables, TunableGroups)
 
+        prev_params = self._params
         self._params = self._combine_tunables(tunables)
         merge_parameters(dest=self._params, source=global_config)
 
+        # At this point, `self._is_ready` is True only if the previous `.setup()`
+        # call has succeeded and there was no `.teardown()` since.
+        self._setup_delta = self._get_setup_delta(tunables)
+        self._setup_tunables = self._setup_delta.copy() if self._setup_delta is not None else \
+            tunables.subgroup(self._tunable_params.get_covariant_group_names()).copy()
+        tunable_names = set(self._tunable_params.get_param_values())
+        if ({key: val for (key, val) in prev_params.items() if key not in tunable_names} !=
+                {key: val for (key, val) in self._params.items() if key not in tunable_names}):
+            # Non-tunable parameters have changed: redo all setup steps.
+            self._setup_delta = None
+
+        # Derived classes set it back to True when (and only when) their setup succeeds.
+        self._is_ready = False
+
         if _LOG.isEnabledFor(logging.DEBUG):
             _LOG.debug("Combined parameters:\n%s", json.dumps(self._params, indent=2))
 
         return True
 
+    def _get_setup_delta(self, tunables: TunableGroups) -> Optional[TunableGroups]:
+        """
+        Get the tunables of this environment set to the given values, with only
+        the covariant groups that differ from the last successful setup marked
+        as updated. Return None if the environment has not been set up yet.
+        """
+        if not self._is_ready or self._setup_tunables is None:
+            return None
+        return self._setup_tunables.copy().reset().assign(
+            tunables.get_param_values(self._tunable_params.get_covariant_group_names()))
+
+    def get_setup_cost(self, tunables: TunableGroups) -> int:
+        """
+        Estimate the cost of reconfiguring this environment with the given tunables,
+        i.e., the total cost of the covariant groups that would have to change
+        since the last successful setup.
+
+        Parameters
+        ----------
+        tunables : TunableGroups
+            A collection of tunable parameters along with their values.
+
+        Returns
+        -------
+        cost : int
+            The sum of `CovariantTunableGroup.get_current_cost()` values
+            for the tunable groups of this environment.
+        """
+        delta = self._get_setup_delta(tunables)
+        if delta is None:
+            return self._tunable_params.get_total_cost()
+        return delta.get_current_cost()
+
+    def _is_setup_updated(self, group_names: Optional[Iterable[str]] = None) -> bool:
+        """
+        Check if (some of) the setup steps have to be performed at the current `.setup()` call.
+        That is, if the tunables in the given covariant groups have changed since
+        the last successful setup, or the environment is not configured to skip unchanged setup.
+        The setup is always redone if the previous one has failed, the environment has been
+        torn down since, its non-tunable parameters have changed, or the environment
+        does not declare its own `tunable_params`.
+
+        Parameters
+        ----------
+        group_names : Optional[Iterable[str]]
+            Names of the covariant groups the setup step depends on.
+            Default is all tunable groups of this environment.
+
+        Returns
+        -------
+        is_updated : bool
+            True if the setup step has to be (re)done, False if it can be skipped.
+        """
+        if not self._skip_unchanged_setup or self._setup_delta is None:
+            return True
+        own_groups = set(self._setup_delta.get_covariant_group_names())
+        if group_names is None:
+            group_names = own_groups
+        group_names = [name for name in group_names if name in own_groups]
+        return bool(group_names) and self._setup_delta.is_updated(group_names)
+
     def teardown(self) -> None:
         """
         Tear down the benchmark environment. This method must be idempotent,
@@ -242,6 +333,8 @@ class Environment(metaclass=abc.ABCMeta):
         """
         _LOG.info("Teardown %s", self)
         self._is_ready = False
+        self._setup_tunables = None
+        self._setup_delta = None
 
     def run(self) -> Tuple[Status, Optional[dict]]:
         """
@@ -257,9 +350,41 @@ class Environment(metaclass=abc.ABCMeta):
             with the results or None if the status is not COMPLETED.
             If run script is a benchmark, then the score is usually expected to
             be in the `score` field.
+            Environments that run the benchmark asynchronously return PENDING
+            right after submitting it; the caller then polls `.status()` until it
+            returns one of the final statuses along with the results.
         """
         return self.status()
 
+    def cancel(self) -> bool:
+        """
+        Stop the benchmark that has been submitted asynchronously by `.run()`,
+        e.g., when the early stopping rule decides that the trial is not worth
+        completing. The environment has to be set up again after cancellation.
+
+        Returns
+        -------
+        is_success : bool
+            True if the benchmark has been stopped, False if the environment
+            does not support cancellation (the default).
+        """
+        _LOG.warning("Environment does not support cancellation: %s", self)
+        return False
+
+    def telemetry(self) -> Iterable[Tuple[datetime, Dict[str, float]]]:
+        """
+        Get the time series the environment has collected during the last `.run()`
+        (e.g., per-second benchmark results), in addition to the final results.
+        The series can be long, so the callers should iterate over it only once.
+        Base implementation returns an empty list.
+
+        Returns
+        -------
+        telemetry : Iterable[Tuple[datetime, Dict[str, float]]]
+            Pairs of (timestamp, metrics) values.
+        """
+        return []
+
     def status(self) -> Tuple[Status, Optional[dict]]:
         """
         Check the status of the benchmark environment.
@@ -269,6 +394,9 @@ class Environment(metaclass=abc.ABCMeta):
         (benchmark_status, telemetry) : (Status, dict)
             A pair of (benchmark status, telemetry) values.
             `telemetry` is a free-form dict or None if the environment is not running.
+            If the benchmark has been submitted asynchronously by `.run()`, the status
+            is RUNNING while it is in progress; once it completes, the final status
+            is returned along with the benchmark results instead of the telemetry.
         """
         if self._is_ready:
             return (Status.READY, None)
@@ -6,12 +6,16 @@
 Composite benchmark environment.
 """
 
+import contextvars
 import logging
-from typing import List, Optional, Tuple
+from datetime import datetime
+from concurrent.futures import FIRST_COMPLETED, Future, ThreadPoolExecutor, wait
+from typing import Callable, Dict, Iterable, List, Optional, Set, Tuple
 
 from mlos_bench.services.base_service import Service
 from mlos_bench.environments.status import Status
 from mlos_bench.environments.base_environment import Environment
+from mlos_bench.timing import timed_phase
 from mlos_bench.tunables.tunable_groups import TunableGroups
 
 _LOG = logging.getLogger(__name__)
@@ -39,6 +43,9 @@ class CompositeEnv(Environment):
         config : dict
             Free-format dictionary that contains the environment
             configuration. Must have a "children" section.
+            Optional "dependencies" section maps the child names to the lists
+            of children they depend on. If present, the independent children
+            are set up and torn down concurrently; otherwise, one by one.
         global_config : dict
             Free-format dictionary of global parameters (e.g., security credentials)
             to be mixed in into the "const_args" section of the local config.
@@ -51,6 +58,9 @@ class CompositeEnv(Environment):
         super().__init__(name=name, config=config, global_config=global_config, tunables=tunables, service=service)
 
         self._children: List[Environment] = []
+        # Children that have not completed the current run yet.
+        # The first one might be running asynchronously.
+        self._run_queue: List[Environment] = []
 
         # To support trees of composite environments (e.g. for multiple VM experiments),
         # each CompositeEnv gets a copy of the original global config and adjusts it with
@@ -71,6 +81,11 @@ class CompositeEnv(Environment):
         if not self._children:
             raise ValueError("At least one child environment must be present")
 
+        # Setup dependencies between the children (by name), if any.
+        self._dependencies: Optional[Dict[str, Set[str]]] = None
+        if "dependencies" in config:
+            self._dependencies = self._init_dependencies(config["dependencies"])
+
     @property
     def children(self) -> List[Environment]:
         """
@@ -105,9 +120,109 @@ class CompositeEnv(Environment):
         self._children.append(env)
         self._tunable_params.merge(env.tunable_params)
 
+    def _init_dependencies(self, dependencies: Dict[str, List[str]]) -> Dict[str, Set[str]]:
+        """
+        Validate the dependencies between the children and return them
+        as a mapping from each child name to the set of children it depends on.
+        """
+        names = [env.name for env in self._children]
+        if len(set(names)) != len(names):
+            raise ValueError(f"Child environments must have unique names: {names}")
+        deps: Dict[str, Set[str]] = {name: set() for name in names}
+        for (name, parents) in dependencies.items():
+            unknown = {name, *parents} - deps.keys()
+            if unknown:
+                raise ValueError(f"Unknown child environment(s) in dependencies: {unknown}")
+            deps[name].update(parents)
+        # Make sure there are no cycles (Kahn's algorithm).
+        remaining = {name: set(parents) for (name, parents) in deps.items()}
+        while remaining:
+            ready = [name for (name, parents) in remaining.items() if not parents]
+            if not ready:
+                raise ValueError(f"Circular dependencies: {sorted(remaining)}")
+            for name in ready:
+                del remaining[name]
+            for parents in remaining.values():
+                parents.difference_update(ready)
+        return deps
+
+    def _run_concurrently(self, func: Callable[[Environment], bool],
+                          dependencies: Dict[str, Set[str]],
+                          stop_on_failure: bool,
+                          completed: Optional[List[Environment]] = None) -> bool:
+        """
+        Call `func` for each child in a separate thread as soon as `func`
+        has completed successfully for all children it depends on.
+
+        Parameters
+        ----------
+        func : Callable[[Environment], bool]
+            The operation to perform on the child, e.g., `.setup()`.
+        dependencies : Dict[str, Set[str]]
+            Names of the children that must complete before each child can start.
+        stop_on_failure : bool
+            If True, do not start any more children after the first failure
+            and cancel the ones that have been submitted but not started yet.
+            The children that are already running are allowed to complete.
+        completed : Optional[List[Environment]]
+            If provided, append to it the children for which `func` has
+            succeeded, in the order of completion.
+
+        Returns
+        -------
+        is_success : bool
+            True if `func` succeeded for all children, False otherwise.
+        """
+        envs = {env.name: env for env in self._children}
+        remaining = {name: set(parents) for (name, parents) in dependencies.items()}
+        running: Dict[Future, str] = {}
+        is_success = True
+        error: Optional[Exception] = None
+        with ThreadPoolExecutor(max_workers=len(envs),
+                                thread_name_prefix=f"{self.name}-child") as executor:
+            while remaining or running:
+                if is_success or not stop_on_failure:
+                    for name in [name for (name, parents) in remaining.items() if not parents]:
+                        del remaining[name]
+                        _LOG.debug("Start child env.: %s", name)
+                        # Carry over the active trial timer (if any) to the worker thread.
+                        running[executor.submit(contextvars.copy_context().run, func, envs[name])] = name
+                if not running:
+                    break   # The dependencies of the remaining children have failed.
+                (done, _) = wait(running, return_when=FIRST_COMPLETED)
+                for future in done:
+                    name = running.pop(future)
+                    if future.cancelled():
+                        _LOG.debug("Child env. canceled: %s", name)
+                        continue
+                    try:
+                        is_ok = future.result()
+                    except Exception as ex:     # pylint: disable=broad-except
+                        _LOG.error("Child env. %s failed: %s", name, ex)
+                        error = error or ex
+                        is_ok = False
+                    if is_ok:
+                        if completed is not None:
+                            completed.append(envs[name])
+                        for parents in remaining.values():
+                            parents.discard(name)
+                    else:
+                        is_success = False
+                if not is_success and stop_on_failure:
+                    for future in running:
+                        future.cancel()
+        if error is not None:
+            raise error
+        return is_success and not remaining
+
     def setup(self, tunables: TunableGroups, global_config: Optional[dict] = None) -> bool:
         """
         Set up the children environments.
+        If the dependencies between the children are specified in the config,
+        the independent children are set up concurrently, and a failure
+        prevents the setup of the children that have not started yet.
+        If the setup of one child fails, the children that have been set up
+        successfully are torn down before returning.
 
         Parameters
         ----------
@@ -125,20 +240,79 @@ class CompositeEnv(Environment):
         """
         self._is_ready = (
             super().setup(tunables, global_config) and
-            all(env.setup(tunables, global_config) for env in self._children)
+            self._setup_children(tunables, global_config)
         )
         return self._is_ready
 
+    def _setup_children(self, tunables: TunableGroups, global_config: Optional[dict]) -> bool:
+        """
+        Set up all children (one by one or concurrently, depending on the config).
+        On failure, tear down the children that have completed their setup.
+        """
+        completed: List[Environment] = []
+        try:
+            if self._dependencies is None:
+                is_success = True
+                for env in self._children:
+                    if not self._setup_child(env, tunables, global_config):
+                        is_success = False
+                        break
+                    completed.append(env)
+            else:
+                is_success = self._run_concurrently(
+                    lambda env: self._setup_child(env, tunables, global_config),
+                    self._dependencies, stop_on_failure=True, completed=completed)
+        except Exception:
+            self._teardown_completed(completed)
+            raise
+        if not is_success:
+            self._teardown_completed(completed)
+        return is_success
+
+    def _teardown_completed(self, completed: List[Environment]) -> None:
+        """
+        Tear down the children that have been set up, in the reverse order.
+        """
+        for env in reversed(completed):
+            _LOG.info("Tear down child env. after a failed setup of %s: %s", self, env)
+            env.teardown()
+
+    @staticmethod
+    def _setup_child(env: Environment, tunables: TunableGroups, global_config: Optional[dict]) -> bool:
+        """
+        Set up the child environment and time it as the `env.setup.{name}` phase.
+        """
+        with timed_phase(f"env.setup.{env.name}"):
+            return env.setup(tunables, global_config)
+
     def teardown(self) -> None:
         """
         Tear down the children environments. This method is idempotent,
         i.e., calling it several times is equivalent to a single call.
-        The environments are being torn down in the reverse order.
+        The environments are being torn down in the reverse order
+        (or in the reverse order of the dependencies, if specified).
         """
-        for env in reversed(self._children):
-            env.teardown()
+        self._run_queue = []
+        if self._dependencies is None:
+            for env in reversed(self._children):
+                env.teardown()
+        else:
+            # Tear down each child after all children that depend on it.
+            dependents: Dict[str, Set[str]] = {name: set() for name in self._dependencies}
+            for (name, parents) in self._dependencies.items():
+                for parent in parents:
+                    dependents[parent].add(name)
+            self._run_concurrently(self._teardown_child, dependents, stop_on_failure=False)
         super().teardown()
 
+    @staticmethod
+    def _teardown_child(env: Environment) -> bool:
+        """
+        Tear down the child environment. Always succeeds.
+        """
+        env.teardown()
+        return True
+
     def run(self) -> Tuple[Status, Optional[dict]]:
         """
         Submit a new experiment to the environment.
@@ -152,16 +326,103 @@ class CompositeEnv(Environment):
             with the results or None if the status is not COMPLETED.
             If run script is a benchmark, then the score is usually expected to
             be in the `score` field.
+            PENDING if one of the children runs asynchronously;
+            in that case, use `.status()` to poll for the results.
         """
         _LOG.info("Run: %s", self._children)
+        self._run_queue = []
         (status, _) = result = super().run()
         if not status.is_ready:
             return result
-        for env in self._children:
+        self._run_queue = list(self._children)
+        result = self._run_children()
+        _LOG.info("Run completed: %s :: %s", self, result)
+        return result
+
+    def telemetry(self) -> Iterable[Tuple[datetime, Dict[str, float]]]:
+        """
+        Get the time series the children environments have collected during the last `.run()`.
+
+        Returns
+        -------
+        telemetry : List[Tuple[datetime, Dict[str, float]]]
+            Pairs of (timestamp, metrics) values of all children, ordered by timestamp.
+        """
+        return sorted((sample for env in self._children for sample in env.telemetry()),
+                      key=lambda sample: sample[0])
+
+    def status(self) -> Tuple[Status, Optional[dict]]:
+        """
+        Check the status of the composite environment. If one of the children
+        is running asynchronously, poll its status, and once it completes,
+        continue running the remaining children.
+
+        Returns
+        -------
+        (status, output) : (Status, dict)
+            A pair of (Status, output) values. While the children are still
+            running, the status is RUNNING and `output` is the telemetry of the
+            current child. Once all children complete, return the final status
+            and the output of the *last* child (or of the last failed one).
+        """
+        if not self._run_queue:
+            return super().status()
+        env = self._run_queue[0]
+        (status, output) = result = env.status()
+        if not status.is_completed:
+            return (Status.RUNNING, output)
+        _LOG.info("Child env. async run results: %s :: %s", env, result)
+        self._run_queue.pop(0)
+        if status.is_good and self._run_queue:
+            (status, _) = result = self._run_children()
+            if status.is_pending:
+                return (Status.RUNNING, None)
+        self._run_queue = []
+        return result
+
+    def cancel(self) -> bool:
+        """
+        Cancel the child environment that is currently running asynchronously
+        and skip the remaining children.
+
+        Returns
+        -------
+        is_success : bool
+            True if the running child has been stopped, False otherwise.
+        """
+        if not self._run_queue:
+            return super().cancel()
+        env = self._run_queue[0]
+        _LOG.info("Cancel child env.: %s", env)
+        is_success = env.cancel()
+        if is_success:
+            self._run_queue = []
+            self._is_ready = False
+        return is_success
+
+    def _run_children(self) -> Tuple[Status, Optional[dict]]:
+        """
+        Run the children in `_run_queue` one by one until one of them fails
+        or starts running asynchronously (i.e., returns PENDING from `.run()`).
+
+        Returns
+        -------
+        (status, output) : (Status, dict)
+            PENDING if one of the children is running asynchronously;
+            otherwise, the result of the last child that has been run.
+        """
+        result: Tuple[Status, Optional[dict]] = (Status.READY, None)
+        while self._run_queue:
+            env = self._run_queue[0]
             _LOG.debug("Child env. run: %s", env)
-            (status, _) = result = env.run()
+            with timed_phase(f"env.run.{env.name}"):
+                (status, _) = result = env.run()
             _LOG.debug("Child env. run results: %s :: %s", env, result)
+            if status.is_pending:
+                # The child has submitted the run and will be polled in `.status()`.
+                return (Status.PENDING, None)
+            self._run_queue.pop(0)
             if not status.is_good:
+                self._run_queue = []
                 break
-        _LOG.info("Run completed: %s :: %s", self, result)
         return result
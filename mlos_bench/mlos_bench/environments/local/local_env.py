@@ -8,15 +8,19 @@ Scheduler-side benchmark environment to run scripts locally.
 
 import json
 import logging
+import os
 
-from typing import Iterable, Optional, Tuple
-
-import pandas
+from contextlib import ExitStack
+from datetime import datetime
+from typing import Dict, Iterable, List, Optional, Tuple
 
 from mlos_bench.environments.status import Status
 from mlos_bench.environments.script_env import ScriptEnv
+from mlos_bench.environments.local.results_reader import ResultsAggregator, get_results_reader, read_results
 from mlos_bench.services.base_service import Service
+from mlos_bench.services.local.local_exec import LocalProcess
 from mlos_bench.services.types.local_exec_type import SupportsLocalExec
+from mlos_bench.timing import timed_phase
 from mlos_bench.tunables.tunable_groups import TunableGroups
 from mlos_bench.util import path_join
 
@@ -47,7 +51,7 @@ class LocalEnv(ScriptEnv):
             configuration. Each config must have at least the "tunable_params"
             and the "const_args" sections.
             `LocalEnv` must also have at least some of the following parameters:
-            {setup, run, teardown, dump_params_file, read_results_file}
+            {setup, run, teardown, dump_params_file, read_results_file, async_run}
         global_config : dict
             Free-format dictionary of global parameters (e.g., security credentials)
             to be mixed in into the "const_args" section of the local config.
@@ -68,6 +72,17 @@ class LocalEnv(ScriptEnv):
 
         self._dump_params_file: Optional[str] = self.config.get("dump_params_file")
         self._read_results_file: Optional[str] = self.config.get("read_results_file")
+        self._read_results_format: Optional[str] = self.config.get("read_results_format")
+        # If specified, the results file has one row per sample, and we compute the aggregates while reading it.
+        self._read_results_aggregate: Optional[Dict[str, List[str]]] = self.config.get("read_results_aggregate")
+        # If specified, save each sample of the results file as telemetry.
+        self._read_results_timestamp: Optional[str] = self.config.get("read_results_timestamp")
+        self._aggregator: Optional[ResultsAggregator] = None
+        # If True, `.run()` only starts the run script in the background and returns PENDING;
+        # the caller is expected to poll `.status()`, which reports the results read so far.
+        self._async_run = bool(self.config.get("async_run", False))
+        # The background process, its work directory, and the context that keeps that directory.
+        self._async_proc: Optional[Tuple[LocalProcess, str, ExitStack]] = None
 
     def setup(self, tunables: TunableGroups, global_config: Optional[dict] = None) -> bool:
         """
@@ -124,11 +139,25 @@ class LocalEnv(ScriptEnv):
             with the results or None if the status is not COMPLETED.
             If run script is a benchmark, then the score is usually expected to
             be in the `score` field.
+            If `async_run` is set, return PENDING right after starting the script;
+            use `.status()` to poll for the results.
         """
+        self._aggregator = None
+        self._stop_async_run()
         (status, _) = result = super().run()
         if not status.is_ready:
             return result
 
+        if self._async_run and self._script_run:
+            # Keep the temp directory until the script completes.
+            context = ExitStack()
+            temp_dir = context.enter_context(self._local_exec_service.temp_dir_context(self._temp_dir))
+            _LOG.info("Start the script locally in background: %s at %s", self, temp_dir)
+            proc = self._local_exec_service.local_exec_start(
+                self._script_run, env=self._get_env_params(), cwd=temp_dir)
+            self._async_proc = (proc, temp_dir, context)
+            return (Status.PENDING, None)
+
         with self._local_exec_service.temp_dir_context(self._temp_dir) as temp_dir:
 
             if self._script_run:
@@ -136,28 +165,139 @@ class LocalEnv(ScriptEnv):
                 if return_code != 0:
                     return (Status.FAILED, None)
 
-            if not self._read_results_file:
-                _LOG.debug("Not reading the data at: %s", self)
-                return (Status.SUCCEEDED, {})
+            return self._read_results(temp_dir)
+
+    def status(self) -> Tuple[Status, Optional[dict]]:
+        """
+        Check the status of the environment. If the run script has been started
+        in background (see `async_run` config parameter), check if it has completed,
+        without waiting.
+
+        Returns
+        -------
+        (status, output) : (Status, dict)
+            A pair of (Status, output) values. While the run script is in progress,
+            the status is RUNNING, and `output` has the results read from the
+            (incomplete) results file so far, if any. Once the script completes,
+            return the final status and the results of the run.
+        """
+        if self._async_proc is None:
+            return super().status()
+        (proc, temp_dir, _) = self._async_proc
+        return_code = proc.poll()
+        if return_code is None:
+            return (Status.RUNNING, self._read_partial_results(temp_dir))
+        try:
+            if return_code != 0:
+                (_, stderr) = proc.output
+                _LOG.warning("ERROR: Local script returns code %d stderr:\n%s", return_code, stderr)
+                return (Status.FAILED, None)
+            return self._read_results(temp_dir)
+        finally:
+            self._stop_async_run()
+
+    def cancel(self) -> bool:
+        """
+        Stop the run script that has been started in background by killing its process.
+        The environment has to be set up again after that.
 
-            data: pandas.DataFrame = pandas.read_csv(
-                self._config_loader_service.resolve_path(
-                    self._read_results_file, extra_paths=[temp_dir]))
+        Returns
+        -------
+        is_success : bool
+            True if the script has been stopped, False if nothing is running in background.
+        """
+        if self._async_proc is None:
+            return super().cancel()
+        _LOG.info("Cancel local run: %s", self)
+        self._stop_async_run()
+        self._is_ready = False
+        return True
+
+    def _read_results(self, temp_dir: str) -> Tuple[Status, Optional[dict]]:
+        """
+        Read the results of the completed run script from the results file (if any).
+        """
+        if not self._read_results_file:
+            _LOG.debug("Not reading the data at: %s", self)
+            return (Status.SUCCEEDED, {})
 
-            _LOG.debug("Read data:\n%s", data)
-            if len(data) != 1:
-                _LOG.warning(
-                    "Local run has %d rows: assume long format of (metric, value)", len(data))
-                data = pandas.DataFrame([data.value.to_list()], columns=data.metric.to_list())
+        fname = self._config_loader_service.resolve_path(
+            self._read_results_file, extra_paths=[temp_dir])
+        with timed_phase("env.read_results"):
+            (data_dict, aggregator) = self._parse_results(fname)
+        if self._read_results_timestamp is not None:
+            self._aggregator = aggregator
 
-            data_dict = data.iloc[-1].to_dict()
-            _LOG.info("Local run complete: %s ::\n%s", self, data_dict)
-            return (Status.SUCCEEDED, data_dict)
+        _LOG.info("Local run complete: %s ::\n%s", self, data_dict)
+        return (Status.SUCCEEDED, data_dict)
+
+    def _read_partial_results(self, temp_dir: str) -> Optional[dict]:
+        """
+        Read the results that the run script has written so far, e.g., the aggregates
+        of the samples up to now. Return None if there are none yet, or
+        if the file cannot be parsed at the moment (e.g., it is being written).
+        """
+        if not self._read_results_file:
+            return None
+        fname = self._config_loader_service.resolve_path(
+            self._read_results_file, extra_paths=[temp_dir])
+        if not os.path.exists(fname):
+            return None
+        try:
+            (data_dict, _) = self._parse_results(fname)
+        except (OSError, ValueError) as ex:  # Includes the pandas parser errors.
+            _LOG.debug("Cannot read the partial results yet: %s :: %s", fname, ex)
+            return None
+        _LOG.debug("Local run partial results: %s :: %s", self, data_dict)
+        return data_dict or None
+
+    def _parse_results(self, fname: str) -> Tuple[dict, Optional[ResultsAggregator]]:
+        """
+        Parse the results file, computing the aggregates while reading it, if necessary.
+
+        Returns
+        -------
+        (results, aggregator) : (dict, Optional[ResultsAggregator])
+            The results, and the aggregator that has computed them (if any).
+        """
+        reader = get_results_reader(fname, self._read_results_format)
+        _LOG.debug("Read data with %s from: %s", reader, fname)
+        if self._read_results_aggregate is None and self._read_results_timestamp is None:
+            return (read_results(reader, fname), None)
+        aggregator = ResultsAggregator(self._read_results_aggregate or {},
+                                       self._read_results_timestamp)
+        for chunk in reader.read_chunks(fname):
+            aggregator.update(chunk)
+        return (aggregator.results(), aggregator)
+
+    def _stop_async_run(self) -> None:
+        """
+        Kill the run script running in background (if any) and release its temp directory.
+        """
+        if self._async_proc is None:
+            return
+        (proc, _, context) = self._async_proc
+        self._async_proc = None
+        proc.kill()
+        context.close()
+
+    def telemetry(self) -> Iterable[Tuple[datetime, Dict[str, float]]]:
+        """
+        Get the per-sample time series from the results file of the last `.run()`.
+        Only available if the `read_results_timestamp` config parameter is set.
+
+        Returns
+        -------
+        telemetry : Iterable[Tuple[datetime, Dict[str, float]]]
+            Pairs of (timestamp, metrics) values, produced one chunk at a time.
+        """
+        return [] if self._aggregator is None else self._aggregator.iter_telemetry()
 
     def teardown(self) -> None:
         """
         Clean up the local environment.
         """
+        self._stop_async_run()
         if self._script_teardown:
             _LOG.info("Local teardown: %s", self)
             return_code = self._local_exec(self._script_teardown)
@@ -0,0 +1,299 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Pluggable readers for the benchmark results files produced by the local scripts.
+The readers parse the files in chunks, so the aggregates (and the telemetry)
+are computed while streaming, without loading the entire file into memory.
+"""
+
+import logging
+import re
+
+from abc import ABCMeta, abstractmethod
+from datetime import datetime
+from typing import Any, Dict, Iterator, List, Optional, Tuple, Type
+
+import numpy as np
+import numpy.typing as npt
+import pandas
+
+_LOG = logging.getLogger(__name__)
+
+_PERCENTILE_RE = re.compile(r"^p([0-9]{1,2}(\.[0-9]+)?)$")
+
+
+class ResultsReader(metaclass=ABCMeta):
+    """
+    Base class for the readers that parse the results file in chunks.
+    """
+
+    DEFAULT_CHUNK_SIZE = 65536
+    """Number of rows to process at once."""
+
+    def __init__(self, chunk_size: int = DEFAULT_CHUNK_SIZE):
+        """
+        Create a new results reader.
+
+        Parameters
+        ----------
+        chunk_size : int
+            Number of rows to process at once.
+        """
+        self._chunk_size = chunk_size
+
+    def __repr__(self) -> str:
+        return f"{self.__class__.__name__}(chunk_size={self._chunk_size})"
+
+    @abstractmethod
+    def read_chunks(self, path: str) -> Iterator[pandas.DataFrame]:
+        """
+        Read the file in chunks of (at most) `chunk_size` rows.
+
+        Parameters
+        ----------
+        path : str
+            Path to the results file.
+
+        Returns
+        -------
+        chunks : Iterator[pandas.DataFrame]
+            The consecutive chunks of the data. All chunks have the same columns.
+        """
+
+
+class CsvResultsReader(ResultsReader):
+    """
+    Read the results from a CSV file.
+    """
+
+    def read_chunks(self, path: str) -> Iterator[pandas.DataFrame]:
+        with pandas.read_csv(path, chunksize=self._chunk_size) as reader:
+            yield from reader
+
+
+class ParquetResultsReader(ResultsReader):
+    """
+    Read the results from a Parquet file, one batch of rows at a time.
+    Requires `pyarrow`.
+    """
+
+    def read_chunks(self, path: str) -> Iterator[pandas.DataFrame]:
+        import pyarrow.parquet  # pylint: disable=import-outside-toplevel
+        for batch in pyarrow.parquet.ParquetFile(path).iter_batches(batch_size=self._chunk_size):
+            yield batch.to_pandas()
+
+
+class ArrowResultsReader(ResultsReader):
+    """
+    Read the results from an Arrow IPC (Feather v2) file.
+    The file is memory-mapped, so the numeric columns are not copied.
+    Requires `pyarrow`.
+    """
+
+    def read_chunks(self, path: str) -> Iterator[pandas.DataFrame]:
+        import pyarrow  # pylint: disable=import-outside-toplevel
+        import pyarrow.ipc  # pylint: disable=import-outside-toplevel
+        with pyarrow.memory_map(path, "r") as source:
+            reader = pyarrow.ipc.open_file(source)
+            for i in range(reader.num_record_batches):
+                batch = reader.get_batch(i)
+                for offset in range(0, batch.num_rows, self._chunk_size):
+                    yield batch.slice(offset, self._chunk_size).to_pandas()
+
+
+_READERS: Dict[str, Type[ResultsReader]] = {
+    "csv": CsvResultsReader,
+    "parquet": ParquetResultsReader,
+    "arrow": ArrowResultsReader,
+}
+
+_EXTENSIONS: Dict[str, str] = {
+    ".parquet": "parquet",
+    ".arrow": "arrow",
+    ".feather": "arrow",
+}
+
+
+def get_results_reader(path: str, results_format: Optional[str] = None) -> ResultsReader:
+    """
+    Get the reader for the given results file.
+
+    Parameters
+    ----------
+    path : str
+        Path to the results file.
+    results_format : Optional[str]
+        One of "csv", "parquet", or "arrow".
+        If not specified, guess it from the file extension (default is "csv").
+
+    Returns
+    -------
+    reader : ResultsReader
+        A new reader instance.
+    """
+    if results_format is None:
+        ext = path[path.rfind("."):].lower() if "." in path else ""
+        results_format = _EXTENSIONS.get(ext, "csv")
+    reader_class = _READERS.get(results_format)
+    if reader_class is None:
+        raise ValueError(f"Unknown results format: {results_format}")
+    return reader_class()
+
+
+def read_results(reader: ResultsReader, path: str) -> Dict[str, Any]:
+    """
+    Read the benchmark results in one of the two formats:
+    a single row with metrics in the columns (wide), or (metric, value) pairs
+    one per row (long). In the wide format with multiple rows, only the last
+    row is returned.
+
+    Parameters
+    ----------
+    reader : ResultsReader
+        The reader to parse the file with.
+    path : str
+        Path to the results file.
+
+    Returns
+    -------
+    results : Dict[str, Any]
+        Benchmark results as a dict of metric to its value.
+    """
+    n_rows = 0
+    last_row: Dict[str, Any] = {}
+    long_data: Dict[str, Any] = {}
+    for chunk in reader.read_chunks(path):
+        if len(chunk) == 0:
+            continue
+        n_rows += len(chunk)
+        last_row = chunk.iloc[-1].to_dict()
+        if "metric" in chunk.columns and "value" in chunk.columns:
+            long_data.update(zip(chunk["metric"].tolist(), chunk["value"].tolist()))
+    if n_rows > 1 and long_data:
+        _LOG.debug("Results have %d rows: assume long format of (metric, value)", n_rows)
+        return long_data
+    return last_row
+
+
+class ResultsAggregator:
+    """
+    Compute the aggregates of the per-sample (e.g., per-request or per-second)
+    benchmark results while streaming the file, and optionally keep the samples
+    as telemetry time series.
+
+    Supported aggregates are "min", "max", "mean", "sum", "count", "last",
+    and percentiles "pNN" (e.g., "p50", "p99", "p99.9"). The percentiles are exact,
+    so only the values of the columns that need them are retained in memory.
+    The telemetry samples (if any) are kept in their columnar form, chunk by chunk,
+    and converted into the (timestamp, metrics) pairs only when iterated over.
+    """
+
+    _SIMPLE_AGGREGATES = frozenset({"min", "max", "mean", "sum", "count", "last"})
+
+    def __init__(self, aggregates: Dict[str, List[str]],
+                 timestamp_column: Optional[str] = None):
+        """
+        Create a new aggregator.
+
+        Parameters
+        ----------
+        aggregates : Dict[str, List[str]]
+            Names of the aggregates to compute for each column, e.g.,
+            `{"latency": ["mean", "p99"]}`. The results are named `{column}_{aggregate}`.
+        timestamp_column : Optional[str]
+            Name of the column that contains the timestamps of the samples.
+            If specified, all numeric columns of each row are kept as a telemetry sample.
+        """
+        for (column, aggs) in aggregates.items():
+            for agg in aggs:
+                if agg not in self._SIMPLE_AGGREGATES and not _PERCENTILE_RE.match(agg):
+                    raise ValueError(f"Unknown aggregate for column {column}: {agg}")
+        self._aggregates = aggregates
+        self._timestamp_column = timestamp_column
+        self._count: Dict[str, int] = {col: 0 for col in aggregates}
+        self._sum: Dict[str, float] = {col: 0.0 for col in aggregates}
+        self._min: Dict[str, float] = {col: np.inf for col in aggregates}
+        self._max: Dict[str, float] = {col: -np.inf for col in aggregates}
+        self._last: Dict[str, float] = {col: np.nan for col in aggregates}
+        self._values: Dict[str, List[npt.NDArray]] = {
+            col: [] for (col, aggs) in aggregates.items()
+            if any(_PERCENTILE_RE.match(agg) for agg in aggs)
+        }
+        self._telemetry_chunks: List[pandas.DataFrame] = []
+
+    def update(self, chunk: pandas.DataFrame) -> None:
+        """
+        Add the next chunk of samples to the aggregates.
+
+        Parameters
+        ----------
+        chunk : pandas.DataFrame
+            Per-sample results, one sample per row.
+        """
+        for col in self._aggregates:
+            values = chunk[col].to_numpy(dtype=float)
+            values = values[~np.isnan(values)]
+            if len(values) == 0:
+                continue
+            self._count[col] += len(values)
+            self._sum[col] += float(values.sum())
+            self._min[col] = min(self._min[col], float(values.min()))
+            self._max[col] = max(self._max[col], float(values.max()))
+            self._last[col] = float(values[-1])
+            if col in self._values:
+                self._values[col].append(values)
+        if self._timestamp_column is not None:
+            metrics = chunk.drop(columns=[self._timestamp_column]).select_dtypes("number")
+            metrics.insert(0, self._timestamp_column, pandas.to_datetime(chunk[self._timestamp_column]))
+            self._telemetry_chunks.append(metrics)
+
+    def results(self) -> Dict[str, float]:
+        """
+        Get the aggregates of all samples seen so far.
+
+        Returns
+        -------
+        results : Dict[str, float]
+            The aggregates named `{column}_{aggregate}`. NaN if there were no samples.
+        """
+        results: Dict[str, float] = {}
+        for (col, aggs) in self._aggregates.items():
+            count = self._count[col]
+            values = np.concatenate(self._values[col]) if self._values.get(col) else None
+            for agg in aggs:
+                if agg == "count":
+                    results[f"{col}_{agg}"] = float(count)
+                elif count == 0:
+                    results[f"{col}_{agg}"] = np.nan
+                elif agg == "mean":
+                    results[f"{col}_{agg}"] = self._sum[col] / count
+                elif agg in self._SIMPLE_AGGREGATES:
+                    results[f"{col}_{agg}"] = getattr(self, f"_{agg}")[col]
+                else:
+                    assert values is not None
+                    match = _PERCENTILE_RE.match(agg)
+                    assert match is not None
+                    results[f"{col}_{agg}"] = float(np.percentile(values, float(match.group(1))))
+        return results
+
+    def iter_telemetry(self) -> Iterator[Tuple[datetime, Dict[str, float]]]:
+        """
+        Iterate over the (timestamp, metrics) samples seen so far,
+        converting one chunk at a time. Empty if the timestamp column is not specified.
+        """
+        for chunk in self._telemetry_chunks:
+            # Note: pandas.Timestamp is a subclass of datetime.
+            timestamps = chunk[self._timestamp_column].tolist()
+            metrics = chunk.drop(columns=[self._timestamp_column]).to_dict(orient="records")
+            yield from zip(timestamps, metrics)
+
+    @property
+    def telemetry(self) -> List[Tuple[datetime, Dict[str, float]]]:
+        """
+        The (timestamp, metrics) samples seen so far.
+        Empty if the timestamp column is not specified.
+        Use `.iter_telemetry()` to avoid materializing all samples at once.
+        """
+        return list(self.iter_telemetry())
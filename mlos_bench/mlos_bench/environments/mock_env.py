@@ -61,6 +61,26 @@ class MockEnv(Environment):
         self._metrics = self.config.get("metrics", ["score"])
         self._is_ready = True
 
+    def setup(self, tunables: TunableGroups, global_config: Optional[dict] = None) -> bool:
+        """
+        Set up the mock environment. Always succeeds.
+
+        Parameters
+        ----------
+        tunables : TunableGroups
+            A collection of tunable parameters along with their values.
+        global_config : dict
+            Free-format dictionary of global parameters of the environment
+            that are not used in the optimization process.
+
+        Returns
+        -------
+        is_success : bool
+            Always True.
+        """
+        self._is_ready = super().setup(tunables, global_config)
+        return self._is_ready
+
     def run(self) -> Tuple[Status, Optional[dict]]:
         """
         Produce mock benchmark data for one experiment.
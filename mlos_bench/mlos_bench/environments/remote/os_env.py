@@ -84,6 +84,11 @@ class OSEnv(Environment):
         if not super().setup(tunables, global_config):
             return False
 
+        if not self._is_setup_updated():
+            _LOG.info("OS is up to date, skip start: %s", self)
+            self._is_ready = True
+            return True
+
         (status, params) = self._host_service.vm_start(self._params)
         if status.is_pending:
             (status, _) = self._host_service.wait_vm_operation(params)
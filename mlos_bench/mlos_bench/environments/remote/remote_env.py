@@ -7,7 +7,7 @@ Remotely executed benchmark/script environment.
 """
 
 import logging
-from typing import Iterable, Optional, Tuple
+from typing import Iterable, List, Optional, Tuple
 
 from mlos_bench.environments.status import Status
 from mlos_bench.environments.script_env import ScriptEnv
@@ -43,7 +43,7 @@ class RemoteEnv(ScriptEnv):
             configuration. Each config must have at least the "tunable_params"
             and the "const_args" sections.
             `RemoteEnv` must also have at least some of the following parameters:
-            {setup, run, teardown, wait_boot}
+            {setup, run, teardown, wait_boot, async_run, fleet}
         global_config : dict
             Free-format dictionary of global parameters (e.g., security credentials)
             to be mixed in into the "const_args" section of the local config.
@@ -57,6 +57,14 @@ class RemoteEnv(ScriptEnv):
                          tunables=tunables, service=service)
 
         self._wait_boot = self.config.get("wait_boot", False)
+        # If True, `.run()` only submits the run script and returns PENDING;
+        # the caller is expected to poll `.status()` for the results.
+        self._async_run = self.config.get("async_run", False)
+        self._async_results: Optional[dict] = None
+        # If not empty, run the scripts on all these hosts (by "vmName") concurrently.
+        self._fleet: List[str] = list(self.config.get("fleet", []))
+        # Submission info, status, and output of the asynchronous run on each host of the fleet.
+        self._async_fleet_results: Optional[List[Tuple[dict, Status, dict]]] = None
 
         assert self._service is not None and isinstance(self._service, SupportsRemoteExec), \
             "RemoteEnv requires a service that supports remote execution operations"
@@ -89,13 +97,19 @@ class RemoteEnv(ScriptEnv):
         if not super().setup(tunables, global_config):
             return False
 
+        if not self._is_setup_updated():
+            _LOG.info("Remote environment is up to date, skip setup: %s", self)
+            self._is_ready = True
+            return True
+
         if self._wait_boot:
             _LOG.info("Wait for the remote environment to start: %s", self)
-            (status, params) = self._host_service.vm_start(self._params)
-            if status.is_pending:
-                (status, _) = self._host_service.wait_vm_operation(params)
-            if not status.is_succeeded:
-                return False
+            for host_params in self._host_params():
+                (status, params) = self._host_service.vm_start(host_params)
+                if status.is_pending:
+                    (status, _) = self._host_service.wait_vm_operation(params)
+                if not status.is_succeeded:
+                    return False
 
         if self._script_setup:
             _LOG.info("Set up the remote environment: %s", self)
@@ -122,16 +136,88 @@ class RemoteEnv(ScriptEnv):
             with the results or None if the status is not COMPLETED.
             If run script is a benchmark, then the score is usually expected to
             be in the `score` field.
+            If `async_run` is set, return PENDING right after submitting the script;
+            use `.status()` to poll for the results.
         """
         _LOG.info("Run script remotely on: %s", self)
+        self._async_results = None
+        self._async_fleet_results = None
         (status, _) = result = super().run()
         if not (status.is_ready and self._script_run):
             return result
 
+        if self._async_run and self._fleet:
+            fleet_results = self._remote_exec_fleet(self._script_run, wait=False)
+            (status, output) = self._get_fleet_status([(status, output) for (_, status, output) in fleet_results])
+            if status.is_pending:
+                _LOG.info("Remote run submitted to the fleet: %s", self)
+                self._async_fleet_results = fleet_results
+                return (Status.PENDING, None)
+            return (status, output)
+
+        if self._async_run:
+            (status, output) = self._remote_exec(self._script_run, wait=False)
+            if status.is_pending:
+                _LOG.info("Remote run submitted: %s", self)
+                self._async_results = output
+                return (Status.PENDING, None)
+            # Completed (or failed) right away.
+            return (status, output)
+
         result = self._remote_exec(self._script_run)
         _LOG.info("Remote run complete: %s :: %s", self, result)
         return result
 
+    def status(self) -> Tuple[Status, Optional[dict]]:
+        """
+        Check the status of the remote environment. If the run script has been
+        submitted asynchronously (see `async_run` config parameter), check the
+        status of the remote command once, without waiting for it to complete.
+
+        Returns
+        -------
+        (status, output) : (Status, dict)
+            A pair of (Status, output) values. While the run script is in progress,
+            the status is RUNNING. Once it completes, return the final status and
+            the results of the run.
+        """
+        if self._async_fleet_results is not None:
+            return self._poll_fleet()
+        if self._async_results is None:
+            return super().status()
+        (status, output) = self._remote_exec_service.poll_remote_exec_results(self._async_results)
+        _LOG.debug("Remote run status: %s :: %s %s", self, status, output)
+        if status.is_pending or status.is_running:
+            return (Status.RUNNING, None)
+        self._async_results = None
+        _LOG.info("Remote run complete: %s :: %s", self, status)
+        return (status, output)
+
+    def cancel(self) -> bool:
+        """
+        Stop the asynchronously running benchmark by restarting the remote host.
+        The environment has to be set up again after that.
+
+        Returns
+        -------
+        is_success : bool
+            True if the remote host has been restarted, False otherwise.
+        """
+        if self._async_results is None and self._async_fleet_results is None:
+            return super().cancel()
+        _LOG.info("Cancel remote run: %s", self)
+        is_success = True
+        for host_params in self._host_params():
+            (status, params) = self._host_service.vm_restart(host_params)
+            if status.is_pending:
+                (status, _) = self._host_service.wait_vm_operation(params)
+            _LOG.info("Remote run canceled: %s :: %s :: %s", self, host_params.get("vmName"), status)
+            is_success = is_success and status.is_succeeded
+        self._async_results = None
+        self._async_fleet_results = None
+        self._is_ready = False
+        return is_success
+
     def teardown(self) -> None:
         """
         Clean up and shut down the remote environment.
@@ -140,9 +226,19 @@ class RemoteEnv(ScriptEnv):
             _LOG.info("Remote teardown: %s", self)
             (status, _) = self._remote_exec(self._script_teardown)
             _LOG.info("Remote teardown complete: %s :: %s", self, status)
+        self._async_results = None
+        self._async_fleet_results = None
         super().teardown()
 
-    def _remote_exec(self, script: Iterable[str]) -> Tuple[Status, Optional[dict]]:
+    def _host_params(self) -> List[dict]:
+        """
+        Get the parameters of each remote host: one per host of the fleet, if any.
+        """
+        if not self._fleet:
+            return [self._params]
+        return [{**self._params, "vmName": vm_name} for vm_name in self._fleet]
+
+    def _remote_exec(self, script: Iterable[str], wait: bool = True) -> Tuple[Status, Optional[dict]]:
         """
         Run a script on the remote host.
 
@@ -150,20 +246,87 @@ class RemoteEnv(ScriptEnv):
         ----------
         script : [str]
             List of commands to be executed on the remote host.
+        wait : bool
+            If True (default), wait for the script to complete and get the results.
+            Otherwise, return PENDING and the submission info right after submitting the script.
 
         Returns
         -------
         result : (Status, dict)
             A pair of Status and dict with the benchmark/script results.
             Status is one of {PENDING, SUCCEEDED, FAILED, TIMED_OUT}
+            For a fleet, see `._get_fleet_status()`.
         """
+        if self._fleet:
+            return self._get_fleet_status([
+                (status, output) for (_, status, output) in self._remote_exec_fleet(script, wait)])
         env_params = self._get_env_params()
         _LOG.debug("Submit script: %s with %s", self, env_params)
         (status, output) = self._remote_exec_service.remote_exec(
             script, config=self._params, env_params=env_params)
         _LOG.debug("Script submitted: %s %s :: %s", self, status, output)
-        if status in {Status.PENDING, Status.SUCCEEDED}:
+        if wait and status in {Status.PENDING, Status.SUCCEEDED}:
             (status, output) = self._remote_exec_service.get_remote_exec_results(output)
             # TODO: extract the results from `output`.
         _LOG.debug("Status: %s :: %s", status, output)
         return (status, output)
+
+    def _remote_exec_fleet(self, script: Iterable[str], wait: bool = True) -> List[Tuple[dict, Status, dict]]:
+        """
+        Run a script on all hosts of the fleet concurrently.
+
+        Returns
+        -------
+        results : List[Tuple[dict, Status, dict]]
+            Submission info, status, and output of the script on each host of the fleet.
+        """
+        env_params = self._get_env_params()
+        _LOG.debug("Submit script to the fleet: %s %s with %s", self, self._fleet, env_params)
+        submitted = self._remote_exec_service.remote_exec_fleet(
+            script, configs=self._host_params(), env_params=env_params)
+        results = [(output, status, output) for (status, output) in submitted]
+        if wait:
+            pending = [i for (i, (_, status, _)) in enumerate(results) if status.is_pending]
+            fleet_results = self._remote_exec_service.get_remote_exec_fleet_results(
+                [results[i][0] for i in pending])
+            for (i, (status, output)) in zip(pending, fleet_results):
+                results[i] = (results[i][0], status, output)
+        return results
+
+    def _poll_fleet(self) -> Tuple[Status, Optional[dict]]:
+        """
+        Check the status of the asynchronous run on each host of the fleet once.
+        """
+        assert self._async_fleet_results is not None
+        results = self._async_fleet_results
+        for (i, (submitted, status, output)) in enumerate(results):
+            if status.is_pending or status.is_running:
+                (status, output) = self._remote_exec_service.poll_remote_exec_results(submitted)
+                results[i] = (submitted, status, output)
+        (status, output) = self._get_fleet_status([(status, output) for (_, status, output) in results])
+        if status.is_pending or status.is_running:
+            return (Status.RUNNING, None)
+        self._async_fleet_results = None
+        _LOG.info("Remote run complete on the fleet: %s :: %s", self, status)
+        return (status, output)
+
+    def _get_fleet_status(self, results: List[Tuple[Status, dict]]) -> Tuple[Status, dict]:
+        """
+        Combine the statuses of the script on each host of the fleet.
+
+        Returns
+        -------
+        result : (Status, dict)
+            SUCCEEDED if the script has succeeded on all hosts; otherwise, the first
+            FAILED or TIMED_OUT status, if any, or PENDING/RUNNING if still in progress.
+            The output has the "fleet" key with a dict of "vmName" -> {"status", "output"}
+            with the status name and the output of the script on each host.
+        """
+        fleet_output = {}
+        for (vm_name, (status, output)) in zip(self._fleet, results):
+            fleet_output[vm_name] = {"status": status.name, "output": output}
+            if status.is_failed or status.is_timed_out:
+                _LOG.warning("Remote script on: %s :: %s :: %s %s", self, vm_name, status, output)
+        status = next((status for (status, _) in results if status.is_failed or status.is_timed_out),
+                      next((status for (status, _) in results if not status.is_succeeded), Status.SUCCEEDED))
+        return (status, {"fleet": fleet_output})
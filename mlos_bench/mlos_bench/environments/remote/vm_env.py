@@ -80,6 +80,11 @@ class VMEnv(Environment):
         if not super().setup(tunables, global_config):
             return False
 
+        if not self._is_setup_updated():
+            _LOG.info("VM is up to date, skip provisioning: %s", self)
+            self._is_ready = True
+            return True
+
         (status, params) = self._vm_service.vm_provision(self._params)
         if status.is_pending:
             (status, _) = self._vm_service.wait_vm_deployment(True, params)
@@ -49,6 +49,26 @@ class Status(enum.Enum):
         """
         return self == Status.READY
 
+    @property
+    def is_running(self) -> bool:
+        """
+        Check if the status of the benchmark/environment is RUNNING.
+        """
+        return self == Status.RUNNING
+
+    @property
+    def is_completed(self) -> bool:
+        """
+        Check if the status of the benchmark/environment is final,
+        i.e., one of {SUCCEEDED, CANCELED, FAILED, TIMED_OUT}.
+        """
+        return self in {
+            Status.SUCCEEDED,
+            Status.CANCELED,
+            Status.FAILED,
+            Status.TIMED_OUT,
+        }
+
     @property
     def is_succeeded(self) -> bool:
         """
@@ -10,6 +10,8 @@ It is used in `mlos_bench.run` module to run the benchmark/optimizer from the
 command line.
 """
 
+import hashlib
+import json
 import logging
 import argparse
 from typing import Any, Dict, Iterable, List, Optional, Tuple, Type
@@ -19,6 +21,7 @@ from mlos_bench.util import BaseTypeVar
 
 from mlos_bench.tunables.tunable_groups import TunableGroups
 from mlos_bench.environments.base_environment import Environment
+from mlos_bench.environments.composite_env import CompositeEnv
 
 from mlos_bench.optimizers.base_optimizer import Optimizer
 from mlos_bench.optimizers.one_shot_optimizer import OneShotOptimizer
@@ -36,6 +39,36 @@ logging.basicConfig(level=_LOG_LEVEL, format=_LOG_FORMAT)
 _LOG = logging.getLogger(__name__)
 
 
+def _env_tree_params(env: Environment) -> List[Tuple[str, Dict[str, Any]]]:
+    """
+    Get the (name, parameters) pairs of the environment and all its descendants.
+    """
+    params = [(env.name, env.parameters)]
+    if isinstance(env, CompositeEnv):
+        for child in env.children:
+            params += _env_tree_params(child)
+    return params
+
+
+def worker_seed_of(seed: int, worker_id: str) -> int:
+    """
+    Derive a stable random seed for the given worker from the configured one.
+
+    Parameters
+    ----------
+    seed : int
+        The random seed of the optimizer in the config.
+    worker_id : str
+        ID of the worker that shares the experiment with others.
+
+    Returns
+    -------
+    seed : int
+        A 32-bit seed, same for all runs of the worker.
+    """
+    return int(hashlib.sha256(f"{seed}:{worker_id}".encode("utf-8")).hexdigest()[:8], 16)
+
+
 class Launcher:
     # pylint: disable=too-few-public-methods,too-many-instance-attributes
     """
@@ -81,7 +114,8 @@ class Launcher:
             args.globals or config.get("globals", []),
             args.config_path or config.get("config_path", []),
             args_rest,
-            {key: val for (key, val) in config.items() if key not in vars(args)},
+            {key: val for (key, val) in config.items()
+             if key not in vars(args) and key != "trial_runner_params"},
         )
 
         env_path = args.environment or config.get("environment")
@@ -91,17 +125,63 @@ class Launcher:
                          " Run `mlos_bench --help` and consult `README.md` for more info.")
         self.root_env_config = self._config_loader.resolve_path(env_path)
 
-        tunable_groups = TunableGroups()    # base tunable groups that all others get build on
-        self.environment: Environment = self._config_loader.load_environment(
-            self.root_env_config, tunable_groups, self.global_config, service=self._parent_service)
+        # Each trial that runs concurrently needs its own instance of the environment,
+        # with its own global parameters: the (1-based) `trialRunnerId`, and the
+        # entry of the `trial_runner_params` list (e.g., the `vmName`) for that slot.
+        self.trial_parallelism = int(args.trial_parallelism or config.get("trial_parallelism", 1))
+        if self.trial_parallelism < 1:
+            parser.error("--trial_parallelism must be a positive integer.")
+        trial_runner_params: List[Dict[str, Any]] = config.get("trial_runner_params", [])
+        if trial_runner_params and len(trial_runner_params) != self.trial_parallelism:
+            parser.error("trial_runner_params must have exactly one entry per trial runner" +
+                         f" (got {len(trial_runner_params)} for --trial_parallelism {self.trial_parallelism}).")
+        self.trial_runner_configs: List[Dict[str, Any]] = [
+            {**self.global_config, **(trial_runner_params[i] if trial_runner_params else {}),
+             "trialRunnerId": i + 1}
+            for i in range(self.trial_parallelism)
+        ]
 
-        # NOTE: Load the tunable values *before* the optimizer
+        tunable_groups = TunableGroups()    # base tunable groups that all others get build on
+        self.environments: List[Environment] = [
+            self._config_loader.load_environment(
+                self.root_env_config, tunable_groups if i == 0 else TunableGroups(),
+                runner_config, service=self._parent_service)
+            for (i, runner_config) in enumerate(self.trial_runner_configs)
+        ]
+        self.environment: Environment = self.environments[0]
+        if self.trial_parallelism > 1:
+            self._check_trial_runners(parser)
+
+        # NOTE: Load the tunable values and the storage *before* the optimizer
         self.tunables = self._load_tunable_values(args.tunable_values or config.get("tunable_values", []))
-        self.optimizer = self._load_optimizer(args.optimizer or config.get("optimizer"))
         self.storage = self._load_storage(args.storage or config.get("storage"))
+        self.optimizer = self._load_optimizer(args.optimizer or config.get("optimizer"))
 
         self.teardown = args.teardown or config.get("teardown", True)
 
+    @property
+    def env_configs(self) -> Dict[Environment, Dict[str, Any]]:
+        """
+        Global configs of the trial runners' environments, to use in their `.setup()`.
+        """
+        return dict(zip(self.environments, self.trial_runner_configs))
+
+    def _check_trial_runners(self, parser: argparse.ArgumentParser) -> None:
+        """
+        Make sure the environments of the concurrent trial runners do not collide, i.e.,
+        no two of them have the same parameters (and would, e.g., use the same VM).
+        The environments tell their instances apart by the `trialRunnerId` in their
+        `const_args` (or `required_args`), or by the `trial_runner_params` values.
+        """
+        seen: Dict[str, int] = {}
+        for (i, env) in enumerate(self.environments):
+            params = json.dumps(_env_tree_params(env), sort_keys=True, default=str)
+            if params in seen:
+                parser.error(f"Trial runners {seen[params]} and {i + 1} have identical environments." +
+                             " Use `trialRunnerId` in the environment's `const_args`, or specify" +
+                             " `trial_runner_params`, to give each trial runner its own resources.")
+            seen[params] = i + 1
+
     @staticmethod
     def _parse_args(parser: argparse.ArgumentParser) -> Tuple[argparse.Namespace, List[str]]:
         """
@@ -153,6 +233,11 @@ class Launcher:
             help='Path to one or more JSON files that contain additional' +
                  ' [private] parameters of the benchmarking environment.')
 
+        parser.add_argument(
+            '--trial_parallelism', required=False, type=int,
+            help='Number of trials to run concurrently, each in its own instance' +
+                 ' of the benchmarking environment. Default is 1 (run trials sequentially).')
+
         parser.add_argument(
             '--no_teardown', required=False, default=None,
             dest='teardown', action='store_false',
@@ -229,7 +314,26 @@ class Launcher:
         if args_optimizer is None:
             return OneShotOptimizer(
                 self.tunables, self._parent_service, self.global_config)
-        optimizer = self._load(Optimizer, args_optimizer, ConfigSchema.OPTIMIZER)   # type: ignore[type-abstract]
+        class_config = self._config_loader.load_config(args_optimizer, ConfigSchema.OPTIMIZER)
+        assert isinstance(class_config, Dict)
+        global_config = self.global_config
+        worker_id = self.storage.worker_id
+        opt_config = class_config.get("config", {})
+        seed = global_config.get("seed", opt_config.get("seed"))
+        if worker_id is not None and seed is not None:
+            # The workers that share the experiment must not all suggest the same configs.
+            worker_seed = worker_seed_of(int(seed), worker_id)
+            _LOG.info("Worker %s :: optimizer seed: %s -> %d", worker_id, seed, worker_seed)
+            class_config = {**class_config, "config": {**opt_config, "seed": worker_seed}}
+            global_config = {key: val for (key, val) in global_config.items() if key != "seed"}
+        optimizer = self._config_loader.build_generic(
+            base_cls=Optimizer,     # type: ignore[type-abstract]
+            tunables=self.tunables,
+            service=self._parent_service,
+            config=class_config,
+            global_config=global_config
+        )
+        assert isinstance(optimizer, Optimizer)
         return optimizer
 
     def _load_storage(self, args_storage: Optional[str]) -> Storage:
@@ -6,10 +6,14 @@
 Interfaces and wrapper classes for optimizers to be used in Autotune.
 """
 
+from typing import TYPE_CHECKING, Any
+
 from mlos_bench.optimizers.base_optimizer import Optimizer
 from mlos_bench.optimizers.mock_optimizer import MockOptimizer
 from mlos_bench.optimizers.one_shot_optimizer import OneShotOptimizer
-from mlos_bench.optimizers.mlos_core_optimizer import MlosCoreOptimizer
+
+if TYPE_CHECKING:
+    from mlos_bench.optimizers.mlos_core_optimizer import MlosCoreOptimizer
 
 __all__ = [
     'Optimizer',
@@ -17,3 +21,15 @@ __all__ = [
     'OneShotOptimizer',
     'MlosCoreOptimizer',
 ]
+
+
+def __getattr__(name: str) -> Any:
+    """
+    Import MlosCoreOptimizer (and mlos_core with its ML dependencies) on first use only,
+    so that the CLI starts fast for the configs that use the mock or one-shot optimizers.
+    """
+    if name == 'MlosCoreOptimizer':
+        # pylint: disable=import-outside-toplevel
+        from mlos_bench.optimizers.mlos_core_optimizer import MlosCoreOptimizer
+        return MlosCoreOptimizer
+    raise AttributeError(f"module {__name__!r} has no attribute {name!r}")
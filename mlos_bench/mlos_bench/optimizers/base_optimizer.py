@@ -7,13 +7,19 @@ Base class for an interface between the benchmarking framework
 and mlos_core optimizers.
 """
 
+import json
 import logging
-from typing import Dict, Optional, Sequence, Tuple, Union
+from typing import Any, Dict, List, Optional, Sequence, Tuple, Union
 from abc import ABCMeta, abstractmethod
 from distutils.util import strtobool    # pylint: disable=deprecated-module
 
+import numpy as np
+import pandas as pd
+
 from mlos_bench.services.base_service import Service
 from mlos_bench.environments.status import Status
+from mlos_bench.optimizers.early_stopping import MedianStoppingRule
+from mlos_bench.tunables.tunable import TunableValue
 from mlos_bench.tunables.tunable_groups import TunableGroups
 
 _LOG = logging.getLogger(__name__)
@@ -41,30 +47,85 @@ class Optimizer(metaclass=ABCMeta):     # pylint: disable=too-many-instance-attr
         self._tunables = tunables
         self._service = service
         self._iter = 1
+        self._pending: List[Dict[str, TunableValue]] = []
         self._use_defaults: bool = bool(strtobool(str(self._config.pop('use_defaults', True))))
         self._max_iter = int(self._config.pop('max_iterations', 25))
-        self._opt_target: str
-        _opt_target = self._config.pop('maximize', None)
-        if _opt_target is None:
-            self._opt_target = self._config.pop('minimize', 'score')
-            self._opt_sign = 1
-        else:
-            self._opt_target = _opt_target
-            if 'minimize' in self._config:
-                raise ValueError("Cannot specify both 'maximize' and 'minimize'.")
-            self._opt_sign = -1
+        # Target metric name -> sign (1 to minimize, -1 to maximize).
+        # The first target is the primary one (e.g., for early stopping and the best observation).
+        self._opt_targets: Dict[str, int] = self._get_opt_targets()
+        (self._opt_target, self._opt_sign) = next(iter(self._opt_targets.items()))
+        early_stopping_config = self._config.pop('early_stopping', None)
+        self._early_stopping: Optional[MedianStoppingRule] = None
+        if early_stopping_config is not None:
+            self._early_stopping = MedianStoppingRule(
+                early_stopping_config, self._opt_target, self._opt_sign)
+        warm_start_config = self._config.pop('warm_start', {})
+        self._warm_start_mode: str = warm_start_config.get('mode', 'observations')
+        if self._warm_start_mode not in {'observations', 'initial_design'}:
+            raise ValueError(f"Invalid warm start mode: {self._warm_start_mode}")
+        self._warm_start_top_k = int(warm_start_config.get('top_k', 5))
+        self._warm_start_queue: List[TunableGroups] = []
+
+    def _get_opt_targets(self) -> Dict[str, int]:
+        """
+        Pop the optimization targets from the config: either a single 'minimize' or 'maximize'
+        metric (default: minimize 'score'), or the 'optimization_targets' dict of
+        metric name -> "min" or "max" for multi-objective optimization.
+        """
+        opt_targets = self._config.pop('optimization_targets', None)
+        if opt_targets is not None:
+            if 'minimize' in self._config or 'maximize' in self._config:
+                raise ValueError("Cannot specify 'optimization_targets' with 'maximize' or 'minimize'.")
+            if not opt_targets:
+                raise ValueError("At least one optimization target is required.")
+            directions = {'min': 1, 'max': -1}
+            invalid = {name: direction for (name, direction) in opt_targets.items() if direction not in directions}
+            if invalid:
+                raise ValueError(f"Invalid optimization directions: {invalid}")
+            return {name: directions[direction] for (name, direction) in opt_targets.items()}
+        opt_target = self._config.pop('maximize', None)
+        if opt_target is None:
+            return {self._config.pop('minimize', 'score'): 1}
+        if 'minimize' in self._config:
+            raise ValueError("Cannot specify both 'maximize' and 'minimize'.")
+        return {opt_target: -1}
 
     def __repr__(self) -> str:
-        opt_direction = 'min' if self._opt_sign > 0 else 'max'
-        return f"{self.__class__.__name__}:{opt_direction}({self._opt_target})"
+        targets = ",".join(f"{'min' if sign > 0 else 'max'}({name})"
+                           for (name, sign) in self._opt_targets.items())
+        return f"{self.__class__.__name__}:{targets}"
 
     @property
     def target(self) -> str:
         """
         The name of the target metric to optimize.
+        For multi-objective optimization, the name of the primary (i.e., first) target.
         """
         return self._opt_target
 
+    @property
+    def targets(self) -> Dict[str, str]:
+        """
+        The names of all the target metrics to optimize (the primary one first),
+        and the direction of each ("min" or "max").
+        """
+        return {name: 'min' if sign > 0 else 'max' for (name, sign) in self._opt_targets.items()}
+
+    @property
+    def is_multi_objective(self) -> bool:
+        """
+        True if the optimizer has more than one target.
+        """
+        return len(self._opt_targets) > 1
+
+    @property
+    def early_stopping(self) -> Optional[MedianStoppingRule]:
+        """
+        The rule to stop the underperforming trials early based on their telemetry.
+        None if early stopping is disabled.
+        """
+        return self._early_stopping
+
     @abstractmethod
     def bulk_register(self, configs: Sequence[dict], scores: Sequence[Optional[float]],
                       status: Optional[Sequence[Status]] = None) -> bool:
@@ -93,6 +154,134 @@ class Optimizer(metaclass=ABCMeta):     # pylint: disable=too-many-instance-attr
             raise ValueError("Numbers of configs and status values do not match.")
         return bool(configs and scores)
 
+    def bulk_register_data(self, configs: pd.DataFrame, scores: Union[pd.Series, pd.DataFrame]) -> bool:
+        """
+        Pre-load the optimizer with the bulk data from previous experiments,
+        in the columnar format returned by `Storage.Experiment.load_data()`
+        (or by `Storage.Experiment.load_targets()` for multi-objective optimization).
+        Base implementation just converts the data to `.bulk_register()` format;
+        optimizers should override it if they can consume the data directly.
+
+        Parameters
+        ----------
+        configs : pd.DataFrame
+            Tunable values from other experiments, one row per trial.
+        scores : Union[pd.Series, pd.DataFrame]
+            Benchmark results from experiments that correspond to `configs`:
+            the primary target, or a dataframe with one column per target.
+
+        Returns
+        -------
+        is_not_empty : bool
+            True if there is data to register, false otherwise.
+        """
+        if isinstance(scores, pd.DataFrame):
+            scores = scores[self._opt_target]
+        return self.bulk_register(configs.to_dict(orient="records"), scores.tolist())
+
+    def warm_start(self, configs: pd.DataFrame, scores: Union[pd.Series, pd.DataFrame],
+                   exclude: Optional[pd.DataFrame] = None) -> bool:
+        """
+        Transfer the knowledge from the merged-in experiments
+        (e.g., from tuning the same system on its previous release), as returned
+        by `Storage.Experiment.load_merged_data()`.
+        The configs that do not fit the current tunables (e.g., their values are
+        outside of the current ranges) are skipped.
+
+        Depending on the `warm_start.mode` config parameter, either register the data
+        as regular observations (`observations`, the default), or re-evaluate
+        the `warm_start.top_k` best distinct configurations first, before the
+        ones the optimizer suggests (`initial_design`). The latter is more robust
+        when the absolute scores shift between the experiments.
+        For multi-objective optimization, the best configurations are the ones with
+        the best primary target.
+
+        Parameters
+        ----------
+        configs : pd.DataFrame
+            Tunable values from other experiments, one row per trial.
+        scores : Union[pd.Series, pd.DataFrame]
+            Benchmark results from experiments that correspond to `configs`:
+            the primary target, or a dataframe with one column per target.
+        exclude : Optional[pd.DataFrame]
+            The configs that have been tried in the current experiment already
+            (see `Storage.Experiment.load_configs()`). In the `initial_design` mode,
+            they are not re-evaluated again, e.g., when the experiment is resumed.
+
+        Returns
+        -------
+        is_not_empty : bool
+            True if there is data to transfer, false otherwise.
+        """
+        if len(configs) != len(scores):
+            raise ValueError("Numbers of configs and scores do not match.")
+        (configs, scores, tunables_list) = self._to_tunables(configs, scores)
+        if self._warm_start_mode == 'observations':
+            return self.bulk_register_data(configs, scores)
+        _LOG.info("Warm-start the optimizer with top %d configs out of %d",
+                  self._warm_start_top_k, len(configs))
+        if len(configs) == 0:
+            return False
+        if isinstance(scores, pd.DataFrame):
+            scores = scores[self._opt_target]
+        order = (scores * self._opt_sign).sort_values(kind="stable").index
+        top = {tunables.get_values_hash() for tunables in self._warm_start_queue}
+        tried = set()
+        if exclude is not None and len(exclude):
+            tried = {tunables.get_values_hash() for tunables in self._to_tunables(exclude)[2]}
+        for idx in order:
+            if len(top) >= self._warm_start_top_k:
+                break
+            tunables = tunables_list[idx]
+            values_hash = tunables.get_values_hash()
+            if values_hash in top:
+                continue
+            top.add(values_hash)
+            # The top configs that have been tried already still count towards `top_k`.
+            if values_hash in tried:
+                _LOG.info("Warm-start config has been tried already: %s", tunables)
+            else:
+                self._warm_start_queue.append(tunables)
+        return True
+
+    def _to_tunables(self, configs: pd.DataFrame, scores: Optional[Union[pd.Series, pd.DataFrame]] = None
+                     ) -> Tuple[pd.DataFrame, Any, List[TunableGroups]]:
+        """
+        Assign the configs (e.g., loaded from the storage) to the copies of the tunables.
+        Skip (and log) the rows that cannot be assigned, e.g., the ones from the merged-in
+        experiments with the values outside of the current tunable ranges,
+        so that the optimizer does not fail on them.
+
+        Returns
+        -------
+        (configs, scores, tunables) : (pd.DataFrame, Optional[Union[pd.Series, pd.DataFrame]], List[TunableGroups])
+            The valid configs and scores (re-indexed from 0), and their tunables.
+        """
+        tunables_list: List[TunableGroups] = []
+        is_valid: List[bool] = []
+        for params in configs.to_dict(orient="records"):
+            try:
+                tunables_list.append(self._tunables.copy().assign(params))
+                is_valid.append(True)
+            except (KeyError, TypeError, ValueError) as ex:
+                _LOG.warning("Skip the config that does not fit the tunables: %s :: %s", params, ex)
+                is_valid.append(False)
+        mask = np.array(is_valid, dtype=bool)
+        configs = configs.reset_index(drop=True).loc[mask].reset_index(drop=True)
+        if scores is not None:
+            scores = scores.reset_index(drop=True).loc[mask].reset_index(drop=True)
+        return (configs, scores, tunables_list)
+
+    def _pop_warm_start(self) -> Optional[TunableGroups]:
+        """
+        Get the next configuration to re-evaluate from the merged-in experiments (if any).
+        """
+        if not self._warm_start_queue:
+            return None
+        tunables = self._warm_start_queue.pop(0)
+        _LOG.info("Iteration %d :: Warm start suggest: %s", self._iter, tunables)
+        return tunables
+
     @abstractmethod
     def suggest(self) -> TunableGroups:
         """
@@ -106,9 +295,104 @@ class Optimizer(metaclass=ABCMeta):     # pylint: disable=too-many-instance-attr
             but with the values set to the next suggestion.
         """
 
+    def suggest_batch(self, n_suggestions: int,
+                      current_configs: Optional[Sequence[Optional[TunableGroups]]] = None) -> List[TunableGroups]:
+        """
+        Generate several suggestions at once, e.g., to fill a pool of benchmarking environments.
+        Base implementation just calls `.suggest()` `n_suggestions` times.
+
+        Parameters
+        ----------
+        n_suggestions : int
+            Number of configurations to suggest.
+        current_configs : Optional[Sequence[Optional[TunableGroups]]]
+            The configs the environments are currently set up with (None if unknown),
+            one per suggestion. The optimizers can use them to prefer the configs
+            that are cheap to switch to. Not used in the base implementation.
+
+        Returns
+        -------
+        tunables : List[TunableGroups]
+            The next configurations to benchmark.
+        """
+        # pylint: disable=unused-argument
+        return [self.suggest() for _ in range(n_suggestions)]
+
+    def register_pending(self, tunables: TunableGroups) -> None:
+        """
+        Register the configuration as "pending", i.e., suggested by the optimizer
+        and currently being benchmarked, but without the results yet.
+        The optimizer should take that into account to avoid suggesting
+        the same configuration again (e.g., when running trials in parallel).
+
+        Parameters
+        ----------
+        tunables : TunableGroups
+            The configuration that is being benchmarked.
+            Usually it's the same config that the `.suggest()` method returned.
+        """
+        _LOG.info("Iteration %d :: Register pending: %s", self._iter, tunables)
+        self._pending.append(tunables.get_param_values())
+
+    def release_pending(self, tunables: TunableGroups) -> None:
+        """
+        Forget the pending configuration without registering any results for it,
+        e.g., when another worker has taken over the trial in the coordinated mode.
+
+        Parameters
+        ----------
+        tunables : TunableGroups
+            The configuration registered via `.register_pending()`.
+        """
+        params = tunables.get_param_values()
+        if params in self._pending:
+            self._pending.remove(params)
+
+    def skip(self, tunables: TunableGroups) -> None:
+        """
+        Count the suggested configuration as an iteration of the optimization
+        without registering any results for it, e.g., when its results have
+        already been registered before (see the `trialRepeats` global config).
+
+        Parameters
+        ----------
+        tunables : TunableGroups
+            The configuration returned by the `.suggest()` method.
+        """
+        _LOG.info("Iteration %d :: Skip: %s", self._iter, tunables)
+        self._iter += 1
+
+    @property
+    def num_pending(self) -> int:
+        """
+        Number of configurations that have been registered as pending
+        but have not received the results yet.
+        """
+        return len(self._pending)
+
+    def get_budget(self, tunables: TunableGroups) -> Optional[float]:
+        """
+        Get the budget (i.e., fidelity, like benchmark duration) the optimizer
+        has assigned to the suggested configuration. The budget is passed
+        to the environments as the `trialBudget` parameter of the trial.
+
+        Parameters
+        ----------
+        tunables : TunableGroups
+            The configuration returned by the `.suggest()` method.
+
+        Returns
+        -------
+        budget : Optional[float]
+            The budget of the trial, or None if the optimizer is single-fidelity (the default).
+        """
+        # pylint: disable=unused-argument
+        return None
+
     @abstractmethod
     def register(self, tunables: TunableGroups, status: Status,
-                 score: Optional[Union[float, Dict[str, float]]] = None) -> Optional[float]:
+                 score: Optional[Union[float, Dict[str, float]]] = None,
+                 budget: Optional[float] = None) -> Optional[float]:
         """
         Register the observation for the given configuration.
 
@@ -122,16 +406,26 @@ class Optimizer(metaclass=ABCMeta):     # pylint: disable=too-many-instance-attr
         score : Union[float, Dict[str, float]]
             A scalar or a dict with the final benchmark results.
             None if the experiment was not successful.
+            Trials that have been stopped early (CANCELED) can have a censored score,
+            i.e., the worst intermediate result observed before the trial was stopped.
+        budget : Optional[float]
+            The budget the configuration has been benchmarked with (see `.get_budget()`).
+            Only used by the multi-fidelity optimizers.
 
         Returns
         -------
         value : float
             The scalar benchmark score extracted (and possibly transformed) from the dataframe that's being minimized.
+            For multi-objective optimization, the score of the primary target.
         """
+        # pylint: disable=unused-argument
         _LOG.info("Iteration %d :: Register: %s = %s score: %s",
                   self._iter, tunables, status, score)
-        if status.is_succeeded == (score is None):  # XOR
+        if status.is_succeeded == (score is None) and not status.is_canceled:  # XOR
             raise ValueError("Status and score must be consistent.")
+        params = tunables.get_param_values()
+        if params in self._pending:
+            self._pending.remove(params)
         return self._get_score(status, score)
 
     def _get_score(self, status: Status, score: Optional[Union[float, Dict[str, float]]]) -> Optional[float]:
@@ -152,19 +446,114 @@ class Optimizer(metaclass=ABCMeta):     # pylint: disable=too-many-instance-attr
         score : float
             A scalar benchmark score to be used as a primary target for MINIMIZATION.
         """
-        if not status.is_succeeded:
+        if not status.is_succeeded and not (status.is_canceled and score is not None):
             return None
         assert score is not None
         if isinstance(score, dict):
             score = score[self._opt_target]
         return float(score) * self._opt_sign
 
+    def _get_scores(self, status: Status,
+                    score: Optional[Union[float, Dict[str, float]]]) -> Optional[Dict[str, float]]:
+        """
+        Extract the benchmark scores of all targets from the results.
+        Change the sign of the ones we are maximizing.
+
+        Parameters
+        ----------
+        status : Status
+            Final status of the experiment (e.g., SUCCEEDED or FAILED).
+        score : Union[float, Dict[str, float]]
+            A scalar (for a single target only) or a dict with the final benchmark results.
+            None if the experiment was not successful.
+
+        Returns
+        -------
+        scores : Optional[Dict[str, float]]
+            Target name -> score to be used for MINIMIZATION, for all targets.
+            None if the trial was not successful, or it was stopped early
+            and its (censored) results do not have all the targets.
+        """
+        if not status.is_succeeded and not (status.is_canceled and score is not None):
+            return None
+        assert score is not None
+        if not isinstance(score, dict):
+            if self.is_multi_objective:
+                raise ValueError(f"Expected the results for all targets: {list(self._opt_targets)}")
+            score = {self._opt_target: score}
+        if status.is_canceled and not set(self._opt_targets).issubset(score):
+            return None
+        return {name: float(score[name]) * sign for (name, sign) in self._opt_targets.items()}
+
+    def checkpoint(self) -> bytes:
+        """
+        Take a snapshot of the optimizer state (including the state of the mlos_core
+        optimizer and its surrogate model, if any), e.g., to save it in the storage
+        along with the ID of the last trial registered. A new instance of the optimizer
+        can then resume from it via `.restore()` and register only the newer trials instead
+        of the whole history. The iteration count and the pending configs are not included,
+        so the resumed optimizer runs `max_iterations` new trials, same as after the full replay.
+
+        Returns
+        -------
+        checkpoint : bytes
+            The state serialized as JSON (data only, so restoring it never runs any code).
+        """
+        return json.dumps({
+            "class": self.__class__.__name__,
+            "targets": self._opt_targets,
+            "state": self._get_state(),
+        }).encode("utf-8")
+
+    def restore(self, checkpoint: bytes) -> None:
+        """
+        Resume from the snapshot taken by `.checkpoint()` of the optimizer
+        with the same class and targets, before registering any data.
+
+        Parameters
+        ----------
+        checkpoint : bytes
+            The state returned by `.checkpoint()`.
+
+        Raises
+        ------
+        ValueError
+            If the checkpoint is invalid or incompatible with the optimizer.
+        """
+        try:
+            data: Dict[str, Any] = json.loads(checkpoint)
+        except ValueError as ex:    # Includes JSONDecodeError and UnicodeDecodeError.
+            raise ValueError(f"Invalid checkpoint: {ex}") from ex
+        if not isinstance(data, dict) or "state" not in data:
+            raise ValueError(f"Invalid checkpoint for {self}")
+        if data.get("class") != self.__class__.__name__ or data.get("targets") != self._opt_targets:
+            raise ValueError(f"Incompatible checkpoint of {data.get('class')}:{data.get('targets')} for {self}")
+        self._set_state(data["state"])
+
+    def _get_state(self) -> Dict[str, Any]:
+        """
+        Get the state of the optimizer to include in the checkpoint.
+        Optimizers should extend it with the state of their own.
+        The state must be JSON-serializable.
+        """
+        return {
+            "warm_start_queue": [tunables.get_param_values() for tunables in self._warm_start_queue],
+        }
+
+    def _set_state(self, state: Dict[str, Any]) -> None:
+        """
+        Restore the state returned by `._get_state()`.
+        """
+        self._warm_start_queue = [self._tunables.copy().assign(params)
+                                  for params in state["warm_start_queue"]]
+
     def not_converged(self) -> bool:
         """
         Return True if not converged, False otherwise.
-        Base implementation just checks the iteration count.
+        Base implementation just checks the iteration count
+        (pending trials count as iterations in progress).
         """
-        return self._iter <= self._max_iter
+        return self._iter + len(self._pending) <= self._max_iter
 
     @abstractmethod
     def get_best_observation(self) -> Union[Tuple[float, TunableGroups], Tuple[None, None]]:
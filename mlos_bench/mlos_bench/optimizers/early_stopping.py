@@ -0,0 +1,119 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Early termination (pruning) of the underperforming trials based on their telemetry.
+"""
+
+import logging
+import math
+import statistics
+from typing import Dict, List, Optional
+
+_LOG = logging.getLogger(__name__)
+
+
+class MedianStoppingRule:
+    """
+    Median stopping rule: stop the trial if its best intermediate value of the
+    target metric after `s` telemetry samples is worse than the median of the
+    running averages of the completed trials over their first `s` samples.
+
+    The rule sees the telemetry that the environment returns from `.status()`
+    while an asynchronously submitted trial is RUNNING: e.g., the results that the
+    script of `LocalEnv` with `async_run` has written to its results file so far.
+
+    See Also: Golovin et al., "Google Vizier: A Service for Black-Box Optimization", KDD 2017.
+    """
+
+    def __init__(self, config: dict, opt_target: str, opt_sign: int):
+        """
+        Create a new early stopping rule for the given optimization target.
+
+        Parameters
+        ----------
+        config : dict
+            Free-format key/value pairs of configuration parameters.
+            Optional keys are `min_steps` (number of telemetry samples a trial
+            must report before it can be stopped; default 3), and `min_trials`
+            (number of completed trials required to compute the median; default 3).
+        opt_target : str
+            Name of the target metric in the telemetry data.
+        opt_sign : int
+            1 if the target is being minimized, -1 if it is being maximized.
+        """
+        self._opt_target = opt_target
+        self._opt_sign = opt_sign
+        self._min_steps = int(config.get("min_steps", 3))
+        self._min_trials = int(config.get("min_trials", 3))
+        # Intermediate values of the target metric (always minimized) for the running and completed trials.
+        self._running: Dict[int, List[float]] = {}
+        self._completed: List[List[float]] = []
+
+    def __repr__(self) -> str:
+        return f"{self.__class__.__name__}({self._opt_target}, " + \
+            f"min_steps={self._min_steps}, min_trials={self._min_trials})"
+
+    def update(self, trial_id: int, telemetry: Optional[dict]) -> bool:
+        """
+        Record a new telemetry sample of a running trial and check
+        whether the trial should be stopped.
+
+        Parameters
+        ----------
+        trial_id : int
+            ID of the running trial.
+        telemetry : Optional[dict]
+            Telemetry data of the trial. Samples without the target metric
+            (or with a NaN value, e.g., before any data is collected) are ignored.
+
+        Returns
+        -------
+        should_stop : bool
+            True if the trial performs worse than the median and should be stopped.
+        """
+        history = self._running.setdefault(trial_id, [])
+        value = (telemetry or {}).get(self._opt_target)
+        if value is None or math.isnan(float(value)):
+            return False
+        history.append(float(value) * self._opt_sign)
+
+        steps = len(history)
+        if steps < self._min_steps or len(self._completed) < self._min_trials:
+            return False
+
+        median = statistics.median(
+            statistics.mean(values[:steps]) for values in self._completed)
+        best = min(history)
+        if best > median:
+            _LOG.info("Early stop trial %d at step %d: %s = %s worse than median %s",
+                      trial_id, steps, self._opt_target,
+                      best * self._opt_sign, median * self._opt_sign)
+            return True
+        return False
+
+    def censored_score(self, trial_id: int) -> Optional[float]:
+        """
+        Get a pessimistic score for the (stopped) trial, i.e., the worst intermediate
+        value of the target metric it has reported. The trial is stopped because it
+        falls behind the others, so registering its best value so far would make the
+        optimizer's model too optimistic about that region of the search space.
+
+        Returns
+        -------
+        score : Optional[float]
+            The worst value of the target metric observed so far (in the original units),
+            or None if the trial has not reported any.
+        """
+        history = self._running.get(trial_id)
+        return max(history) * self._opt_sign if history else None
+
+    def complete(self, trial_id: int, is_succeeded: bool) -> None:
+        """
+        Stop tracking the trial. If it has completed successfully,
+        use its telemetry to compute the median for the other trials.
+        """
+        history = self._running.pop(trial_id, None)
+        if is_succeeded and history:
+            self._completed.append(history)
@@ -7,11 +7,14 @@ A wrapper for mlos_core optimizers for mlos_bench.
 """
 
 import logging
-from typing import Optional, Sequence, Tuple, Union
+from typing import Any, Dict, List, Optional, Sequence, Tuple, Union
 
+import numpy as np
+import numpy.typing as npt
 import pandas as pd
 
 from mlos_core.optimizers import BaseOptimizer, OptimizerType, OptimizerFactory, SpaceAdapterType, DEFAULT_OPTIMIZER_TYPE
+from mlos_core.optimizers.bayesian_optimizers import BaseBayesianOptimizer, SmacOptimizer
 
 from mlos_bench.environments.status import Status
 from mlos_bench.tunables.tunable_groups import TunableGroups
@@ -28,10 +31,16 @@ class MlosCoreOptimizer(Optimizer):
     A wrapper class for the mlos_core optimizers.
     """
 
+    _ACQUISITION_EPSILON = 1e-12
+    """Minimum acquisition value, so that the cheapest config wins among the equally good ones."""
+
     def __init__(self, tunables: TunableGroups, service: Optional[Service], config: dict):
 
         super().__init__(tunables, service, config)
 
+        # By default, hyperparameters in ConfigurationSpace are sorted by name:
+        self._param_names: List[str] = sorted(self._tunables.get_param_values())
+
         space = tunable_groups_to_configspace(tunables)
         _LOG.debug("ConfigSpace: %s", space)
 
@@ -44,6 +53,39 @@ class MlosCoreOptimizer(Optimizer):
         if space_adapter_type is not None:
             space_adapter_type = getattr(SpaceAdapterType, space_adapter_type)
 
+        # Cost-aware mode: pick the config with the best acquisition value per unit of cost
+        # out of several candidates suggested by the mlos_core optimizer.
+        cost_aware_config = self._config.pop('cost_aware', None)
+        self._cost_aware_candidates = 0
+        self._benchmark_cost = 1.0
+        if cost_aware_config is not None:
+            self._cost_aware_candidates = int(cost_aware_config.get('candidates', 10))
+            self._benchmark_cost = float(cost_aware_config.get('benchmark_cost', 1.0))
+            if self._cost_aware_candidates < 1 or self._benchmark_cost <= 0:
+                raise ValueError(f"Invalid cost-aware optimizer config: {cost_aware_config}")
+            # Only SMAC scores the candidates with its acquisition function; with the other
+            # optimizers (or a lossy space adapter), the pool would be ranked by the cost alone.
+            if opt_type != OptimizerType.SMAC or space_adapter_type not in {None, SpaceAdapterType.IDENTITY}:
+                raise ValueError(
+                    "Cost-aware mode requires an optimizer that can score the candidates " +
+                    "with its acquisition function (SMAC without a space adapter), got: " +
+                    f"optimizer_type={opt_type.name}, space_adapter_type=" +
+                    f"{None if space_adapter_type is None else space_adapter_type.name}")
+        # Candidates suggested by the mlos_core optimizer but not chosen yet.
+        # Dropped after each registration, as the model changes.
+        self._candidates = pd.DataFrame()
+        # SMAC keeps track of its suggestions until it gets their results, so we
+        # never drop them: we keep at most one SMAC suggestion at a time until it is chosen,
+        # and fill the rest of the pool with random configs scored by the acquisition function.
+        self._untold_suggestion: Optional[pd.DataFrame] = None
+        # The config of the last `.suggest()` call, i.e., the one the (only) environment is in.
+        # `.suggest_batch()` gets the current configs of the environments from the caller.
+        self._current_tunables: Optional[TunableGroups] = None
+
+        if self.is_multi_objective:
+            # mlos_core minimizes all objectives, so we flip the signs of the maximized ones.
+            self._config['objectives'] = list(self._opt_targets)
+
         self._opt: BaseOptimizer = OptimizerFactory.create(
             parameter_space=space,
             optimizer_type=opt_type,
@@ -56,47 +98,216 @@ class MlosCoreOptimizer(Optimizer):
                       status: Optional[Sequence[Status]] = None) -> bool:
         if not super().bulk_register(configs, scores, status):
             return False
-        # By default, hyperparameters in ConfigurationSpace are sorted by name:
-        tunables_names = sorted(self._tunables.get_param_values().keys())
-        df_configs = pd.DataFrame(configs)[tunables_names]
-        df_scores = pd.Series(scores, dtype=float) * self._opt_sign
+        df_configs = pd.DataFrame(configs)
+        df_scores = pd.Series(scores, dtype=float)
         if status is not None:
             # TODO: mlos_core currently does not support registration of failed trials:
             df_status_ok = pd.Series(status) == Status.SUCCEEDED
             df_configs = df_configs[df_status_ok]
             df_scores = df_scores[df_status_ok]
+        self._register_data(df_configs, df_scores)
+        return True
+
+    def bulk_register_data(self, configs: pd.DataFrame, scores: Union[pd.Series, pd.DataFrame]) -> bool:
+        _LOG.info("Warm-up the optimizer with: %d configs, %d scores", len(configs), len(scores))
+        if len(configs) != len(scores):
+            raise ValueError("Numbers of configs and scores do not match.")
+        if len(configs) == 0:
+            return False
+        self._register_data(configs, scores.astype(float))
+        return True
+
+    def _register_data(self, df_configs: pd.DataFrame, df_scores: Union[pd.Series, pd.DataFrame]) -> None:
+        """
+        Register the columnar warm-up data with the mlos_core optimizer.
+        The scores are either the primary target or a dataframe with one column per target.
+        """
+        df_configs = df_configs[self._param_names]
         # External data can have incorrect types (e.g., all strings).
         for (tunable, _group) in self._tunables:
             df_configs[tunable.name] = df_configs[tunable.name].astype(tunable.dtype)
-        self._opt.register(df_configs, df_scores)
+        if self.is_multi_objective:
+            if not isinstance(df_scores, pd.DataFrame):
+                raise ValueError(f"Expected the scores for all targets: {list(self._opt_targets)}")
+            self._opt.register(df_configs, df_scores[list(self._opt_targets)] * pd.Series(self._opt_targets))
+        else:
+            if isinstance(df_scores, pd.DataFrame):
+                df_scores = df_scores[self._opt_target]
+            self._opt.register(df_configs, df_scores * self._opt_sign)
+        self._candidates = pd.DataFrame()
         if _LOG.isEnabledFor(logging.DEBUG):
             (score, _) = self.get_best_observation()
             _LOG.debug("Warm-up end: %s = %s", self.target, score)
-        return True
+
+    def _to_df(self, configs: Sequence[TunableGroups]) -> pd.DataFrame:
+        """
+        Convert the configs into the dataframe that the mlos_core optimizer consumes:
+        one row per config, one column per tunable, in the ConfigurationSpace order.
+        """
+        return pd.DataFrame([[tunables[name] for name in self._param_names] for tunables in configs],
+                            columns=self._param_names)
+
+    def _from_df(self, df_configs: pd.DataFrame) -> List[TunableGroups]:
+        """
+        Convert the configs suggested by the mlos_core optimizer into the tunables.
+        """
+        return [self._tunables.copy().assign(params) for params in df_configs.to_dict(orient="records")]
 
     def suggest(self) -> TunableGroups:
-        use_defaults = self._use_defaults and self._iter == 1
-        df_config = self._opt.suggest(defaults=use_defaults)
-        _LOG.info("Iteration %d :: Suggest:\n%s", self._iter, df_config)
-        return self._tunables.copy().assign(df_config.loc[0].to_dict())
+        tunables = self._pop_warm_start()
+        if tunables is None:
+            use_defaults = self._use_defaults and self._iter == 1 and not self._pending
+            if self._cost_aware_candidates > 0 and not use_defaults:
+                tunables = self._suggest_cost_aware(self._current_tunables)
+                self._current_tunables = tunables
+                return tunables
+            df_config = self._opt.suggest(defaults=use_defaults)
+            _LOG.info("Iteration %d :: Suggest:\n%s", self._iter, df_config)
+            tunables = self._from_df(df_config)[0]
+        self._current_tunables = tunables
+        return tunables
+
+    def suggest_batch(self, n_suggestions: int,
+                      current_configs: Optional[Sequence[Optional[TunableGroups]]] = None) -> List[TunableGroups]:
+        suggestions: List[TunableGroups] = []
+        while len(suggestions) < n_suggestions and self._warm_start_queue:
+            suggestions.append(self._warm_start_queue.pop(0))
+        if len(suggestions) == n_suggestions:
+            return suggestions
+        use_defaults = self._use_defaults and self._iter == 1 and not self._pending
+        if self._cost_aware_candidates > 0 and not use_defaults:
+            if current_configs is None:
+                current_configs = [None] * n_suggestions
+            return suggestions + [self._suggest_cost_aware(current)
+                                  for current in current_configs[len(suggestions):n_suggestions]]
+        n_suggestions -= len(suggestions)
+        df_configs = self._opt.suggest(defaults=use_defaults, n_suggestions=n_suggestions)
+        _LOG.info("Iteration %d :: Suggest %d:\n%s", self._iter, n_suggestions, df_configs)
+        return suggestions + self._from_df(df_configs)
+
+    def _suggest_cost_aware(self, current: Optional[TunableGroups]) -> TunableGroups:
+        """
+        Choose the next config out of several candidates suggested by the mlos_core
+        optimizer, maximizing the acquisition value divided by the cost of switching
+        from the `current` config of the environment (i.e., the sum of the costs of
+        the covariant tunable groups that change) plus the cost of the benchmark itself.
+        The candidates that were not chosen are kept for the next suggestions
+        until the next registration changes the model.
+        """
+        self._fill_candidates()
+        df_candidates = self._candidates if self._untold_suggestion is None else \
+            pd.concat([self._untold_suggestion, self._candidates], ignore_index=True)
+        candidates = self._from_df(df_candidates)
+        costs = np.array([self._get_switch_cost(tunables, current) for tunables in candidates]) + self._benchmark_cost
+        idx = int(np.argmax(self._get_acquisition(df_candidates) / costs))
+        _LOG.info("Iteration %d :: Suggest cost-aware %d of %d, cost: %s\n%s",
+                  self._iter, idx, len(candidates), costs[idx], df_candidates.iloc[idx])
+        if self._untold_suggestion is not None:
+            if idx == 0:
+                self._untold_suggestion = None
+                return candidates[idx]
+            idx -= 1
+        self._candidates = self._candidates.drop(index=self._candidates.index[idx]).reset_index(drop=True)
+        return candidates[idx]
+
+    def _fill_candidates(self) -> None:
+        """
+        Top up the pool of the cost-aware candidates.
+        """
+        assert isinstance(self._opt, SmacOptimizer)
+        if self._untold_suggestion is None:
+            self._untold_suggestion = self._opt.suggest()
+        n_new = self._cost_aware_candidates - len(self._candidates) - 1
+        if n_new <= 0:
+            return
+        samples = self._opt.parameter_space.sample_configuration(size=n_new)
+        df_new = pd.DataFrame([config.get_dictionary() for config in (samples if n_new > 1 else [samples])],
+                              columns=self._param_names)
+        self._candidates = df_new if len(self._candidates) == 0 else \
+            pd.concat([self._candidates, df_new], ignore_index=True)
+
+    def _get_switch_cost(self, tunables: TunableGroups, current: Optional[TunableGroups]) -> int:
+        """
+        Get the cost of reconfiguring from the current config to the given one.
+        """
+        if current is None:
+            return self._tunables.get_total_cost()
+        return current.copy().reset().assign(tunables.get_param_values()).get_current_cost()
+
+    def _get_acquisition(self, df_configs: pd.DataFrame) -> npt.NDArray:
+        """
+        Get the non-negative acquisition values (the higher, the better) of the given configs.
+        Use the same value for all configs while the surrogate model of the mlos_core
+        optimizer is not trained yet (i.e., during the initial design).
+        """
+        assert isinstance(self._opt, BaseBayesianOptimizer)
+        values = np.zeros(len(df_configs))
+        try:
+            values = np.asarray(self._opt.acquisition_function(df_configs), dtype=float).reshape(-1)
+            values = values - min(values.min(), 0.0)
+        except (RuntimeError, ValueError) as ex:
+            _LOG.debug("Acquisition function is not available yet: %s", ex)
+        return values + self._ACQUISITION_EPSILON
+
+    def register_pending(self, tunables: TunableGroups) -> None:
+        super().register_pending(tunables)
+        df_config = self._to_df([tunables])
+        try:
+            self._opt.register_pending(df_config)
+        except NotImplementedError:
+            # Not all mlos_core optimizers support pending trials yet.
+            _LOG.debug("Optimizer %s does not support pending configs", self._opt)
+
+    def get_budget(self, tunables: TunableGroups) -> Optional[float]:
+        if not self._opt.is_multi_fidelity:
+            return None
+        return self._opt.get_budget(self._to_df([tunables]))
 
     def register(self, tunables: TunableGroups, status: Status,
-                 score: Optional[Union[float, dict]] = None) -> Optional[float]:
-        score = super().register(tunables, status, score)
-        # TODO: mlos_core currently does not support registration of failed trials:
-        if status.is_succeeded:
-            # By default, hyperparameters in ConfigurationSpace are sorted by name:
-            df_config = pd.DataFrame(dict(sorted(tunables.get_param_values().items())), index=[0])
+                 score: Optional[Union[float, dict]] = None,
+                 budget: Optional[float] = None) -> Optional[float]:
+        scores = self._get_scores(status, score) if self.is_multi_objective else None
+        score = super().register(tunables, status, score, budget)
+        budgets = None if budget is None else [budget]
+        df_config = self._to_df([tunables])
+        # Early stopped trials are registered with their censored score (if any).
+        if score is not None and not self.is_multi_objective:
             _LOG.debug("Score: %s Dataframe:\n%s", score, df_config)
-            self._opt.register(df_config, pd.Series([score], dtype=float))
+            self._opt.register(df_config, pd.Series([score], dtype=float), budgets=budgets)
+        elif score is not None and scores is not None:
+            _LOG.debug("Scores: %s Dataframe:\n%s", scores, df_config)
+            self._opt.register(df_config, pd.DataFrame([scores], dtype=float), budgets=budgets)
+        else:
+            # Failed trials, and the early stopped ones without (all) the targets.
+            _LOG.debug("Failed: %s Dataframe:\n%s", status, df_config)
+            self._opt.register_failed(df_config, budgets=budgets)
+        self._candidates = pd.DataFrame()
         self._iter += 1
         return score
 
+    def _get_state(self) -> Dict[str, Any]:
+        return {
+            **super()._get_state(),
+            # The mlos_core checkpoint is JSON, too.
+            "mlos_core": self._opt.checkpoint().decode("utf-8"),
+        }
+
+    def _set_state(self, state: Dict[str, Any]) -> None:
+        super()._set_state(state)
+        try:
+            # mlos_core rolls back its own state if the restore fails: undo ours, too.
+            self._opt.restore(state["mlos_core"].encode("utf-8"))
+        except Exception:
+            self._warm_start_queue = []
+            raise
+
     def get_best_observation(self) -> Union[Tuple[float, TunableGroups], Tuple[None, None]]:
         df_config = self._opt.get_best_observation()
         if len(df_config) == 0:
             return (None, None)
         params = df_config.iloc[0].to_dict()
         _LOG.debug("Best observation: %s", params)
-        score = params.pop("score") * self._opt_sign  # mlos_core always uses the `score` column
+        # mlos_core uses the `score` column, or one column per target for multi-objective optimization.
+        scores = {name: params.pop(name) for name in self._opt.objectives}
+        score = scores[self._opt.objectives[0]] * self._opt_sign
         return (score, self._tunables.copy().assign(params))
@@ -9,7 +9,7 @@ Mock optimizer for mlos_bench.
 import random
 import logging
 
-from typing import Callable, Dict, Optional, Sequence, Tuple, Union
+from typing import Any, Callable, Dict, Optional, Sequence, Tuple, Union
 
 from mlos_bench.environments.status import Status
 from mlos_bench.tunables.tunable import Tunable, TunableValue
@@ -56,9 +56,12 @@ class MockOptimizer(Optimizer):
         """
         Generate the next (random) suggestion.
         """
+        tunables = self._pop_warm_start()
+        if tunables is not None:
+            return tunables
         tunables = self._tunables.copy()
         for (tunable, _group) in tunables:
-            if self._use_defaults and self._iter == 1:
+            if self._use_defaults and self._iter == 1 and not self._pending:
                 tunable.value = tunable.default
             else:
                 tunable.value = self._random[tunable.type](tunable)
@@ -66,8 +69,9 @@ class MockOptimizer(Optimizer):
         return tunables
 
     def register(self, tunables: TunableGroups, status: Status,
-                 score: Optional[Union[float, dict]] = None) -> Optional[float]:
-        registered_score = super().register(tunables, status, score)
+                 score: Optional[Union[float, dict]] = None,
+                 budget: Optional[float] = None) -> Optional[float]:
+        registered_score = super().register(tunables, status, score, budget)
         if status.is_succeeded and (
             self._best_score is None or (registered_score is not None and registered_score < self._best_score)
         ):
@@ -76,6 +80,19 @@ class MockOptimizer(Optimizer):
         self._iter += 1
         return registered_score
 
+    def _get_state(self) -> Dict[str, Any]:
+        return {
+            **super()._get_state(),
+            "best_config": None if self._best_config is None else self._best_config.get_param_values(),
+            "best_score": self._best_score,
+        }
+
+    def _set_state(self, state: Dict[str, Any]) -> None:
+        best_config = None if state["best_config"] is None else \
+            self._tunables.copy().assign(state["best_config"])
+        super()._set_state(state)
+        (self._best_score, self._best_config) = (state["best_score"], best_config)
+
     def get_best_observation(self) -> Union[Tuple[float, TunableGroups], Tuple[None, None]]:
         if self._best_score is None:
             return (None, None)
@@ -11,18 +11,25 @@ Note: this script is also available as a CLI tool via pip under the name "mlos_b
 See `--help` output for details.
 """
 
+import time
 import logging
-from typing import Optional, Tuple, Dict, Any
+from datetime import datetime
+from concurrent.futures import FIRST_COMPLETED, Future, ThreadPoolExecutor, wait
+from typing import Optional, Tuple, Dict, Any, Iterable, List, Sequence, Set
 
 from mlos_bench.launcher import Launcher
 from mlos_bench.optimizers.base_optimizer import Optimizer
 from mlos_bench.environments.base_environment import Environment
-from mlos_bench.storage.base_storage import Storage
+from mlos_bench.storage.base_storage import Storage, TrialLeaseLostError
 from mlos_bench.environments.status import Status
+from mlos_bench.timing import PhaseTimer, active_timer, export_otel
 from mlos_bench.tunables.tunable_groups import TunableGroups
 
 _LOG = logging.getLogger(__name__)
 
+_POLL_INTERVAL = 10     # seconds
+"""Default interval for polling the asynchronously running trials (`pollInterval` global config)."""
+
 
 def _main() -> None:
 
@@ -33,20 +40,26 @@ def _main() -> None:
         launcher.optimizer,
         launcher.storage,
         launcher.root_env_config,
-        launcher.global_config
+        launcher.global_config,
+        env_pool=launcher.environments,
+        env_configs=launcher.env_configs,
     )
 
     _LOG.info("Final result: %s", result)
 
     if launcher.teardown:
-        launcher.environment.teardown()
+        for env in launcher.environments:
+            env.teardown()
 
 
 def _optimize(env: Environment,
               opt: Optimizer,
               storage: Storage,
               root_env_config: str,
-              global_config: Dict[str, Any]) -> Tuple[Optional[float], Optional[TunableGroups]]:
+              global_config: Dict[str, Any],
+              env_pool: Optional[Sequence[Environment]] = None,
+              env_configs: Optional[Dict[Environment, Dict[str, Any]]] = None,
+              ) -> Tuple[Optional[float], Optional[TunableGroups]]:
     """
     Main optimization loop.
 
@@ -62,12 +75,20 @@ def _optimize(env: Environment,
         A path to the root JSON configuration file of the benchmarking environment.
     global_config : dict
         Global configuration parameters.
+    env_pool : Optional[Sequence[Environment]]
+        Independent instances of the benchmarking environment to run the trials
+        in parallel, one trial per instance at a time. If None or contains just one
+        environment, run the trials sequentially in `env`.
+    env_configs : Optional[Dict[Environment, Dict[str, Any]]]
+        Global configs of the individual environments (e.g., with their `trialRunnerId`),
+        to pass to their `.setup()` instead of `global_config`.
     """
     if _LOG.isEnabledFor(logging.INFO):
         _LOG.info("Root Environment:\n%s", env.pprint())
 
     experiment_id = global_config["experimentId"].strip()
     trial_id = int(global_config.get("trialId", 1))
+    trial_repeats = _get_trial_repeats(global_config)
 
     # Start new or resume the existing experiment. Verify that the
     # experiment configuration is compatible with the previous runs.
@@ -77,33 +98,551 @@ def _optimize(env: Environment,
                             trial_id=trial_id,
                             root_env_config=root_env_config,
                             description=env.name,
-                            opt_target=opt.target) as exp:
+                            opt_target=opt.target,
+                            opt_targets=opt.targets) as exp:
 
         _LOG.info("Experiment: %s Env: %s Optimizer: %s", exp, env, opt)
 
-        # Load (tunable values, benchmark scores) to warm-up the optimizer.
-        # `.load()` returns data from ALL merged-in experiments and attempts
-        # to impute the missing tunable values.
-        (configs, scores) = exp.load()
-        opt.bulk_register(configs, scores)
+        merge_ids = global_config.get("merge", [])
+        if merge_ids:
+            exp.merge([merge_ids] if isinstance(merge_ids, str) else merge_ids)
+
+        _warm_up(exp, opt, global_config)
+
+        if env_pool and len(env_pool) > 1:
+            _run_parallel(env_pool, opt, exp, global_config, env_configs or {})
+            return _get_best_observation(env, opt, exp)
+
+        # Keep the environment's own parameters in its setup.
+        global_config = (env_configs or {}).get(env, global_config)
+
+        checkpoints = _Checkpoints(exp, opt, global_config)
 
         # First, complete any pending trials.
         for trial in exp.pending_trials():
-            _run(env, opt, trial, global_config)
+            if _run(env, opt, trial, global_config, PhaseTimer()):
+                checkpoints.registered(trial)
 
         # Then, run new trials until the optimizer is done.
+        reused: Set[str] = set()
         while opt.not_converged():
-            tunables = opt.suggest()
-            trial = exp.new_trial(tunables)
-            _run(env, opt, trial, global_config)
+            timer = PhaseTimer()
+            if exp.is_coordinated:
+                # Take over the trials abandoned by the other workers (if any).
+                trial = next(iter(exp.pending_trials()), None)
+                if trial is not None:
+                    _run(env, opt, trial, global_config, timer)
+                    continue
+                _sync_results(exp, opt)
+            with timer.phase("opt.suggest"):
+                tunables = opt.suggest()
+            if _reuse_results(exp, opt, tunables, trial_repeats, reused):
+                continue
+            with timer.phase("storage.new_trial"):
+                trial = _new_trial(exp, opt, tunables)
+            if _run(env, opt, trial, global_config, timer):
+                checkpoints.registered(trial)
+
+        checkpoints.save()
+        return _get_best_observation(env, opt, exp)
+
+
+def _warm_up(exp: Storage.Experiment, opt: Optimizer, global_config: Dict[str, Any]) -> None:
+    """
+    Register the results of the previous trials of the experiment with the optimizer,
+    then transfer the knowledge from the merged-in experiments (if any).
+
+    If the optimizer checkpoints are enabled (see `_Checkpoints`), restore the optimizer
+    from the latest checkpoint instead, and register only the trials that are newer.
+    """
+    after_trial_id: Optional[int] = None
+    if exp.is_coordinated:
+        # Keep track of the results that the other workers register later, too.
+        _sync_results(exp, opt)
+    else:
+        if _Checkpoints(exp, opt, global_config).enabled:
+            after_trial_id = _restore_checkpoint(exp, opt)
+        # Load (tunable values, benchmark scores) of this experiment to warm-up the optimizer.
+        # Multi-objective optimizers need the scores of all targets.
+        if opt.is_multi_objective:
+            (configs, scores) = exp.load_targets(list(opt.targets), include_merged=False,
+                                                 after_trial_id=after_trial_id)
+        else:
+            (configs, scores) = exp.load_data(include_merged=False, after_trial_id=after_trial_id)
+        opt.bulk_register_data(configs, scores)
+    if after_trial_id is not None:
+        # The checkpoint has the knowledge from the merged-in experiments already.
+        return
+    # `.load_merged_data()` attempts to impute the missing tunable values.
+    if opt.is_multi_objective:
+        (configs, scores) = exp.load_merged_targets(list(opt.targets))
+    else:
+        (configs, scores) = exp.load_merged_data()
+    if len(configs):
+        opt.warm_start(configs, scores, exclude=exp.load_configs())
+
+
+def _restore_checkpoint(exp: Storage.Experiment, opt: Optimizer) -> Optional[int]:
+    """
+    Restore the optimizer from the latest checkpoint of the experiment (if any).
+    If the checkpoint cannot be restored (e.g., it is corrupt or comes from an older
+    version of the optimizer), fall back to registering the full history of the experiment.
+
+    Returns
+    -------
+    trial_id : Optional[int]
+        ID of the last trial included in the checkpoint,
+        or None if the optimizer has not been restored.
+    """
+    checkpoint = exp.load_checkpoint()
+    if checkpoint is None:
+        return None
+    (state, trial_id) = checkpoint
+    try:
+        opt.restore(state)
+    except Exception as ex:  # pylint: disable=broad-except
+        # The optimizers roll back the partial state, so it is safe to replay the history.
+        _LOG.warning("Cannot restore the optimizer %s from the checkpoint of trial %s:%d: %s",
+                     opt, exp, trial_id, ex, exc_info=not isinstance(ex, ValueError))
+        return None
+    _LOG.info("Restored the optimizer %s from the checkpoint of trial %s:%d", opt, exp, trial_id)
+    return trial_id
+
+
+class _Checkpoints:
+    """
+    Save the optimizer checkpoints in the storage every `checkpointInterval`
+    registered trials (global config), so that the next run of the experiment
+    resumes from the checkpoint instead of registering all the previous trials again.
+    Disabled by default, and in the coordinated mode (where each worker's optimizer
+    also learns from the trials of the others).
+    """
 
+    def __init__(self, exp: Storage.Experiment, opt: Optimizer, global_config: Dict[str, Any]):
+        self._exp = exp
+        self._opt = opt
+        self._interval = 0 if exp.is_coordinated else int(global_config.get("checkpointInterval", 0))
+        self._last_trial_id: Optional[int] = None
+        self._unsaved = 0
+
+    @property
+    def enabled(self) -> bool:
+        """True if the checkpoints are enabled."""
+        return self._interval > 0
+
+    def registered(self, trial: Storage.Trial, in_flight: Iterable[Storage.Trial] = ()) -> None:
+        """
+        Count the trial that has been registered with the optimizer,
+        and save the checkpoint if it's time to.
+        """
+        if not self.enabled:
+            return
+        self._last_trial_id = max(trial.trial_id, self._last_trial_id or 0)
+        self._unsaved += 1
+        if self._unsaved >= self._interval:
+            self.save(in_flight)
+
+    def save(self, in_flight: Iterable[Storage.Trial] = ()) -> None:
+        """
+        Save the checkpoint with the trials registered so far, unless a trial before
+        the last registered one is still running: if it completes after the checkpoint,
+        its results would be neither in the checkpoint, nor in the trials loaded after it.
+        In that case, try again after the next trial.
+        """
+        if not self.enabled or self._unsaved == 0 or self._last_trial_id is None:
+            return
+        if any(trial.trial_id < self._last_trial_id for trial in in_flight):
+            return
+        self._exp.save_checkpoint(self._opt.checkpoint(), self._last_trial_id)
+        self._unsaved = 0
+
+
+def _sync_results(exp: Storage.Experiment, opt: Optimizer) -> None:
+    """
+    Register with the optimizer the results that the other workers
+    sharing the experiment have found since the last call.
+    """
+    (configs, scores) = exp.load_updates(list(opt.targets))
+    if len(scores):
+        _LOG.info("Register the results of %d trials of other workers", len(scores))
+        opt.bulk_register_data(configs, scores)
+
+
+def _get_best_observation(env: Environment, opt: Optimizer,
+                          exp: Storage.Experiment) -> Tuple[Optional[float], Optional[TunableGroups]]:
+    """
+    Get the best result of the optimization and log it.
+    For multi-objective optimization, also log the Pareto front of the experiment.
+    The best result is then the one with the best primary target.
+    """
     (best_score, best_config) = opt.get_best_observation()
     _LOG.info("Env: %s best score: %s", env, best_score)
+    if opt.is_multi_objective:
+        (configs, scores) = exp.pareto_front(opt.targets)
+        _LOG.info("Env: %s Pareto front of %d trials:\n%s", env, len(scores),
+                  scores.join(configs) if len(scores) else scores)
     return (best_score, best_config)
 
 
-def _run(env: Environment, opt: Optimizer,
-         trial: Storage.Trial, global_config: Dict[str, Any]) -> None:
+def _run_parallel(env_pool: Sequence[Environment], opt: Optimizer,
+                  exp: Storage.Experiment, global_config: Dict[str, Any],
+                  env_configs: Dict[Environment, Dict[str, Any]]) -> None:
+    """
+    Keep up to `len(env_pool)` trials in flight, each in its own environment.
+
+    Environments run in worker threads, while all storage and optimizer updates
+    happen in the calling thread as the trials complete (in any order).
+    New configurations are requested in batches, one per idle environment,
+    and registered with the optimizer as pending so that it does not suggest
+    the same configuration twice.
+
+    Parameters
+    ----------
+    env_pool : Sequence[Environment]
+        Independent instances of the benchmarking environment.
+    opt : Optimizer
+        An interface to mlos_core optimizers.
+    exp : Storage.Experiment
+        The experiment to persist the trial data into.
+    global_config : dict
+        Global configuration parameters.
+    env_configs : Dict[Environment, Dict[str, Any]]
+        Global configs of the individual environments to use in their `.setup()`
+        instead of `global_config` (e.g., with the `trialRunnerId` of each slot).
+    """
+    idle_envs: List[Environment] = list(env_pool)
+    pending_trials = iter(exp.pending_trials())
+    running: Dict[Future, Tuple[Environment, Storage.Trial, PhaseTimer]] = {}
+    polling: Dict[Environment, Tuple[Storage.Trial, PhaseTimer]] = {}
+    # Last status of each polled trial (by trial id), to save it only when it changes.
+    poll_status: Dict[int, Status] = {}
+    # The last config each environment has been set up with.
+    env_tunables: Dict[Environment, TunableGroups] = {}
+    # Hashes of the configs whose results have been reused (see `_reuse_results()`).
+    reused: Set[str] = set()
+    trial_repeats = _get_trial_repeats(global_config)
+    # New configs along with the environments they have been suggested for.
+    suggestions: List[Tuple[TunableGroups, Environment]] = []
+    # Start time and the per-configuration share of the last `.suggest_batch()` call.
+    suggest_time: Tuple[datetime, float] = (datetime.now(), 0.0)
+    poll_interval = float(global_config.get("pollInterval", _POLL_INTERVAL))
+    checkpoints = _Checkpoints(exp, opt, global_config)
+
+    with ThreadPoolExecutor(max_workers=len(env_pool), thread_name_prefix="mlos_bench_trial") as executor:
+        while True:
+            while idle_envs:
+                # First, complete any pending trials.
+                trial = next(pending_trials, None)
+                if trial is None and exp.is_coordinated:
+                    # Take over the trials abandoned by the other workers since the last check.
+                    pending_trials = iter(exp.pending_trials())
+                    trial = next(pending_trials, None)
+                timer = PhaseTimer()
+                slot_env: Optional[Environment] = None
+                if trial is None:
+                    # Then, run new trials until the optimizer is done.
+                    if not opt.not_converged():
+                        break
+                    if not suggestions:
+                        if exp.is_coordinated:
+                            _sync_results(exp, opt)
+                        (start_ts, start) = (datetime.now(), time.perf_counter())
+                        suggestions = list(zip(
+                            opt.suggest_batch(len(idle_envs), [env_tunables.get(env) for env in idle_envs]),
+                            idle_envs))
+                        suggest_time = (start_ts, (time.perf_counter() - start) / max(1, len(suggestions)))
+                    (tunables, slot_env) = suggestions.pop(0)
+                    # Each trial of the batch gets an equal share of the suggestion time.
+                    timer.add("opt.suggest", *suggest_time)
+                    if _reuse_results(exp, opt, tunables, trial_repeats, reused):
+                        continue
+                    with timer.phase("storage.new_trial"):
+                        trial = _new_trial(exp, opt, tunables)
+                with timer.phase("opt.register_pending"):
+                    opt.register_pending(trial.tunables)
+                if slot_env is None or slot_env not in idle_envs:
+                    # Prefer the environment that is the cheapest to reconfigure for this trial.
+                    slot_env = min(idle_envs, key=lambda e: e.get_setup_cost(trial.tunables))
+                env = slot_env
+                idle_envs.remove(env)
+                env_tunables[env] = trial.tunables
+                _LOG.info("Trial: %s on Env: %s", trial, env)
+                env_config = trial.config(env_configs.get(env, global_config))
+                future = executor.submit(_run_env, env, trial.tunables, env_config, timer)
+                running[future] = (env, trial, timer)
+
+            if not (running or polling):
+                break
+
+            if running:
+                # Do not block on setup/run if there are asynchronous trials to poll.
+                (done, _) = wait(running, timeout=(poll_interval if polling else None),
+                                 return_when=FIRST_COMPLETED)
+            else:
+                (done, _) = (set(), set())
+                time.sleep(poll_interval)
+
+            for future in done:
+                (env, trial, timer) = running.pop(future)
+                (telemetry, results) = future.result()
+                try:
+                    if _is_async(results):
+                        _save_telemetry(trial, timer, telemetry)
+                        polling[env] = (trial, timer)
+                        continue
+                    _register_results(opt, env, trial, timer, telemetry, results, global_config)
+                    checkpoints.registered(trial, _in_flight(running, polling))
+                except TrialLeaseLostError as ex:
+                    _drop_trial(opt, trial, ex)
+                idle_envs.append(env)
+
+            # Poll all asynchronously running trials at once from the main thread.
+            for (env, (trial, timer)) in list(polling.items()):
+                try:
+                    results = _poll_env(env, opt, trial, timer, poll_status)
+                    if results is None:
+                        continue
+                    del polling[env]
+                    _register_results(opt, env, trial, timer, None, results, global_config)
+                    checkpoints.registered(trial, _in_flight(running, polling))
+                except TrialLeaseLostError as ex:
+                    polling.pop(env, None)
+                    poll_status.pop(trial.trial_id, None)
+                    _drop_trial(opt, trial, ex)
+                idle_envs.append(env)
+
+    checkpoints.save()
+
+
+def _in_flight(running: Dict[Future, Tuple[Environment, Storage.Trial, PhaseTimer]],
+               polling: Dict[Environment, Tuple[Storage.Trial, PhaseTimer]]) -> List[Storage.Trial]:
+    """
+    Get the trials that are still running in `_run_parallel()`.
+    """
+    return [trial for (_, trial, _) in running.values()] + [trial for (trial, _) in polling.values()]
+
+
+def _drop_trial(opt: Optimizer, trial: Storage.Trial, ex: TrialLeaseLostError) -> None:
+    """
+    Forget the trial that another worker has taken over in the coordinated mode.
+    Its results (if any) reach the optimizer via `_sync_results()` once that worker finishes it.
+    """
+    _LOG.warning("Trial %s :: dropped: %s", trial, ex)
+    opt.release_pending(trial.tunables)
+    if opt.early_stopping:
+        opt.early_stopping.complete(trial.trial_id, False)
+
+
+def _new_trial(exp: Storage.Experiment, opt: Optimizer, tunables: TunableGroups) -> Storage.Trial:
+    """
+    Create a new trial for the suggested configuration. If the optimizer is
+    multi-fidelity, pass the budget of the trial to the environments
+    as the `trialBudget` parameter.
+    """
+    budget = opt.get_budget(tunables)
+    return exp.new_trial(tunables, None if budget is None else {"trialBudget": budget})
+
+
+def _get_trial_repeats(global_config: Dict[str, Any]) -> Optional[int]:
+    """
+    Get the `trialRepeats` value from the global config (None if not specified).
+
+    Raises
+    ------
+    ValueError
+        If the value is not a positive integer.
+    """
+    repeats = global_config.get("trialRepeats")
+    if repeats is None:
+        return None
+    if int(repeats) < 1:
+        raise ValueError(f"trialRepeats must be at least 1: {repeats}")
+    return int(repeats)
+
+
+def _reuse_results(exp: Storage.Experiment, opt: Optimizer,
+                   tunables: TunableGroups, repeats: Optional[int],
+                   reused: Set[str]) -> bool:
+    """
+    Short-circuit the trial, if the configuration has already been benchmarked
+    successfully at least `repeats` times (the `trialRepeats` global config;
+    if not specified, always run the trial). In that case, register the (averaged)
+    results of the previous trials with the optimizer instead of running the benchmark again.
+    The results are registered only the first time the config is reused
+    (its hash is added to `reused`); after that, the suggestion is just counted
+    as an iteration (see `Optimizer.skip()`), so the optimizer does not get
+    duplicate observations.
+
+    Returns
+    -------
+    is_reused : bool
+        True if the results have been reused and the trial must be skipped.
+    """
+    if repeats is None:
+        return False
+    if opt.get_budget(tunables) is not None:
+        # The results are cached per configuration, regardless of the budget
+        # they were obtained with, so they are not comparable in multi-fidelity mode.
+        return False
+    results = exp.get_results(tunables)
+    if len(results) < repeats:
+        return False
+    values_hash = tunables.get_values_hash()
+    if values_hash in reused:
+        _LOG.info("Results already reused: %s", tunables)
+        opt.skip(tunables)
+        return True
+    reused.add(values_hash)
+    output: Dict[str, Any] = {}
+    for (key, last_value) in results[-1].items():
+        try:
+            output[key] = sum(float(res[key]) for res in results) / len(results)
+        except (KeyError, TypeError, ValueError):
+            output[key] = last_value
+    _LOG.info("Reuse the results of %d trials: %s :: %s", len(results), tunables, output)
+    opt.register(tunables, Status.SUCCEEDED, output)
+    return True
+
+
+def _is_async(results: Tuple[Status, Optional[dict]]) -> bool:
+    """
+    Check if `Environment.run()` has only submitted the benchmark and
+    the results have to be polled via `Environment.status()`.
+    """
+    (status, _) = results
+    return status.is_pending or status.is_running
+
+
+def _poll_env(env: Environment, opt: Optimizer, trial: Storage.Trial,
+              timer: PhaseTimer, poll_status: Dict[int, Status]) -> Optional[Tuple[Status, Optional[dict]]]:
+    """
+    Check the status of the asynchronously running trial once.
+    Save the intermediate telemetry in the storage, if the trial is still running,
+    and stop the trial if the optimizer's early stopping rule says so.
+    The status is saved only when it differs from the last polled one
+    (kept in `poll_status` by trial id), or when there is new telemetry.
+    The time of each step is recorded in the trial's `timer`.
+
+    Returns
+    -------
+    results : Optional[Tuple[Status, dict]]
+        Final status of the trial and the benchmark results, if the trial has completed.
+        CANCELED and the censored score (if any), if the trial has been stopped early.
+        None if the trial is still running.
+    """
+    with active_timer(timer), timer.phase("env.status"):
+        (status, output) = env.status()
+    if status.is_completed:
+        poll_status.pop(trial.trial_id, None)
+        return (status, output)
+    _LOG.debug("Trial %s :: %s %s", trial, status, output)
+    if output or poll_status.get(trial.trial_id) != status:
+        try:
+            with timer.phase("storage.update_telemetry"):
+                trial.update_telemetry(status, output)
+        except TrialLeaseLostError:
+            # Another worker runs the trial now.
+            _cancel_env(env, timer)
+            raise
+        poll_status[trial.trial_id] = status
+    early_stopping = opt.early_stopping
+    if early_stopping and early_stopping.update(trial.trial_id, output) and _cancel_env(env, timer):
+        poll_status.pop(trial.trial_id, None)
+        score = early_stopping.censored_score(trial.trial_id)
+        _LOG.info("Trial %s :: stopped early with score %s", trial, score)
+        return (Status.CANCELED, None if score is None else {opt.target: score})
+    return None
+
+
+def _cancel_env(env: Environment, timer: PhaseTimer) -> bool:
+    """
+    Stop the asynchronously running benchmark and record the time it took.
+    """
+    with active_timer(timer), timer.phase("env.cancel"):
+        return env.cancel()
+
+
+def _run_env(env: Environment, tunables: TunableGroups, config: Dict[str, Any], timer: PhaseTimer
+             ) -> Tuple[List[Tuple[Status, Optional[dict], Optional[datetime]]], Tuple[Status, Optional[dict]]]:
+    """
+    Setup and run the benchmark in the given environment.
+    Does not touch the storage or the optimizer, so it is safe to call from a worker thread.
+    The time of each phase (and of the service calls made by the environment)
+    is recorded in the trial's `timer`.
+
+    Returns
+    -------
+    (telemetry, results) : (List[(Status, dict, datetime)], (Status, dict))
+        Intermediate status and telemetry samples of the environment (empty if setup failed),
+        and the final status and the benchmark results.
+    """
+    with active_timer(timer):
+        with timer.phase("env.setup"):
+            is_ready = env.setup(tunables, config)
+        if not is_ready:
+            _LOG.warning("Setup failed: %s :: %s", env, tunables)
+            return ([], (Status.FAILED, None))
+        (status, output) = env.status()
+        telemetry: List[Tuple[Status, Optional[dict], Optional[datetime]]] = [(status, output, None)]
+        with timer.phase("env.run"):
+            results = env.run()  # Block and wait for the final result.
+    return (telemetry, results)
+
+
+def _save_telemetry(trial: Storage.Trial, timer: PhaseTimer,
+                    telemetry: List[Tuple[Status, Optional[dict], Optional[datetime]]],
+                    series: Iterable[Tuple[datetime, Dict[str, float]]] = ()) -> None:
+    """
+    Save the telemetry samples returned by `_run_env()` in the storage,
+    followed by the time series the environment has collected (streamed in batches).
+    """
+    with timer.phase("storage.update_telemetry"):
+        for (status, metrics, timestamp) in telemetry:
+            trial.update_telemetry(status, metrics, timestamp)
+        trial.append_telemetry_series(series)
+
+
+def _save_timings(trial: Storage.Trial, timer: PhaseTimer, global_config: Dict[str, Any]) -> None:
+    """
+    Save the time of each phase of the trial as its telemetry, and export them
+    as OpenTelemetry spans and metrics if the `otelExport` global config is true.
+    """
+    timings = timer.metrics()
+    _LOG.debug("Trial %s :: timings: %s", trial, timings)
+    trial.append_telemetry(timings)
+    if global_config.get("otelExport"):
+        export_otel(timer, {
+            "mlos_bench.experiment_id": str(global_config.get("experimentId", "")).strip(),
+            "mlos_bench.trial_id": trial.trial_id,
+            "mlos_bench.config_id": trial.config_id,
+        })
+
+
+def _register_results(opt: Optimizer, env: Environment, trial: Storage.Trial, timer: PhaseTimer,
+                      telemetry: Optional[List[Tuple[Status, Optional[dict], Optional[datetime]]]],
+                      results: Tuple[Status, Optional[dict]], global_config: Dict[str, Any]) -> None:
+    """
+    Save the outcome of `_run_env()` in the storage and register it with the optimizer.
+    The storage goes first, so that the results are not lost if the optimizer fails,
+    and the optimizer does not learn the results that the storage has rejected.
+    The timings of the trial (including the registration) are appended afterwards.
+    """
+    _save_telemetry(trial, timer, telemetry or [], env.telemetry())
+    (status, output) = results
+    _LOG.info("Results: %s :: %s\n%s", trial.tunables, status, output)
+    with timer.phase("storage.update"):
+        trial.update(status, output)
+    # The trial parameters restored from the storage are strings.
+    budget = trial.config().get("trialBudget")
+    with timer.phase("opt.register"):
+        opt.register(trial.tunables, status, output, None if budget is None else float(budget))
+        if opt.early_stopping:
+            opt.early_stopping.complete(trial.trial_id, status.is_succeeded)
+    _save_timings(trial, timer, global_config)
+
+
+def _run(env: Environment, opt: Optimizer, trial: Storage.Trial,
+         global_config: Dict[str, Any], timer: PhaseTimer) -> bool:
     """
     Run a single trial.
 
@@ -113,28 +652,39 @@ def _run(env: Environment, opt: Optimizer,
         benchmarking environment to run the optimization on.
     opt : Optimizer
         An interface to mlos_core optimizers.
-    storage : Storage
-        A storage system to persist the experiment data.
+    trial : Storage.Trial
+        The trial to run.
     global_config : dict
         Global configuration parameters.
+    timer : PhaseTimer
+        Timings of the trial phases (including the time to suggest and create the trial).
+
+    Returns
+    -------
+    is_registered : bool
+        True if the results have been saved and registered with the optimizer,
+        False if another worker has taken over the trial in the coordinated mode.
     """
     _LOG.info("Trial: %s", trial)
-
-    if not env.setup(trial.tunables, trial.config(global_config)):
-        _LOG.warning("Setup failed: %s :: %s", env, trial.tunables)
-        trial.update(Status.FAILED)
-        opt.register(trial.tunables, Status.FAILED)
-        return
-
-    # In async mode, poll the environment for status and telemetry
-    # and update the storage with the intermediate results.
-    (status, telemetry) = env.status()
-    trial.update_telemetry(status, telemetry)
-
-    (status, results) = env.run()  # Block and wait for the final result.
-    _LOG.info("Results: %s :: %s\n%s", trial.tunables, status, results)
-    trial.update(status, results)
-    opt.register(trial.tunables, status, results)
+    (telemetry, results) = _run_env(env, trial.tunables, trial.config(global_config), timer)
+    try:
+        if _is_async(results):
+            # In async mode, poll the environment for status and telemetry
+            # and update the storage with the intermediate results.
+            _save_telemetry(trial, timer, telemetry)
+            telemetry = []
+            poll_interval = float(global_config.get("pollInterval", _POLL_INTERVAL))
+            poll_results = None
+            poll_status: Dict[int, Status] = {}
+            while poll_results is None:
+                time.sleep(poll_interval)
+                poll_results = _poll_env(env, opt, trial, timer, poll_status)
+            results = poll_results
+        _register_results(opt, env, trial, timer, telemetry, results, global_config)
+    except TrialLeaseLostError as ex:
+        _drop_trial(opt, trial, ex)
+        return False
+    return True
 
 
 if __name__ == "__main__":
@@ -12,6 +12,7 @@ import logging
 from typing import Callable, Dict, List, Optional, Union
 
 from mlos_bench.services.types.config_loader_type import SupportsConfigLoading
+from mlos_bench.timing import timed_service
 from mlos_bench.util import instantiate_from_config
 
 _LOG = logging.getLogger(__name__)
@@ -93,6 +94,7 @@ class Service:
     def register(self, services: Union[Dict[str, Callable], List[Callable]]) -> None:
         """
         Register new mix-in services.
+        Each call of a service is timed as a phase of the current trial (if any).
 
         Parameters
         ----------
@@ -101,6 +103,7 @@ class Service:
         """
         if not isinstance(services, dict):
             services = {svc.__name__: svc for svc in services}
+        services = {name: timed_service(name, svc) for (name, svc) in services.items()}
 
         if _LOG.isEnabledFor(logging.DEBUG):
             _LOG.debug("Service: %s Add methods: %s",
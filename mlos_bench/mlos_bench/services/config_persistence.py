@@ -11,10 +11,13 @@ service functions.
 import os
 import sys
 
-import json    # For logging only
+import hashlib
+import json    # For logging and the on-disk config cache
 import logging
 
-from typing import Any, Dict, Iterable, List, Optional, Tuple, Type
+from copy import deepcopy
+from threading import Lock
+from typing import Any, Dict, Iterable, List, NamedTuple, Optional, Set, Tuple, Type
 
 import json5    # To read configs with comments and other JSON5 syntax features
 from jsonschema import ValidationError, SchemaError
@@ -34,6 +37,18 @@ else:
 
 _LOG = logging.getLogger(__name__)
 
+# Directory of the on-disk cache of the parsed config files (disabled if not set).
+# Can also be set via the `config_cache_dir` parameter of the service.
+_CONFIG_CACHE_DIR_ENV = "MLOS_BENCH_CONFIG_CACHE_DIR"
+
+
+class _CachedConfig(NamedTuple):
+    """A parsed config file, along with the file's version and the schemas it's been validated against."""
+
+    stamp: Tuple[int, int]
+    config: Any
+    validated: Set[str]
+
 
 class ConfigPersistenceService(Service, SupportsConfigLoading):
     """
@@ -42,6 +57,11 @@ class ConfigPersistenceService(Service, SupportsConfigLoading):
 
     BUILTIN_CONFIG_PATH = str(files("mlos_bench.config").joinpath("")).replace("\\", "/")
 
+    # Process-wide cache of the parsed config files, keyed by the resolved path.
+    # The same files are often included many times across the composite configs.
+    _CONFIG_CACHE: Dict[str, _CachedConfig] = {}
+    _CONFIG_CACHE_LOCK = Lock()
+
     def __init__(self, config: Optional[Dict[str, Any]] = None,
                  parent: Optional[Service] = None):
         """
@@ -57,6 +77,8 @@ class ConfigPersistenceService(Service, SupportsConfigLoading):
         """
         super().__init__(config, parent)
         self._config_path: List[str] = self.config.get("config_path", [])
+        self._config_cache_dir: Optional[str] = self.config.get(
+            "config_cache_dir", os.environ.get(_CONFIG_CACHE_DIR_ENV))
         self._config_loader_service = self
 
         if self.BUILTIN_CONFIG_PATH not in self._config_path:
@@ -112,6 +134,11 @@ class ConfigPersistenceService(Service, SupportsConfigLoading):
         if the input path is not absolute.
         This method is exported to be used as a service.
 
+        The parsed and validated configs are cached in memory (per process) until
+        the file changes, and, optionally, the parsed configs are also cached on disk
+        (see `config_cache_dir` parameter or the `MLOS_BENCH_CONFIG_CACHE_DIR` env. variable).
+        The caller gets its own copy of the config and is free to modify it.
+
         Parameters
         ----------
         json_file_name : str
@@ -126,16 +153,28 @@ class ConfigPersistenceService(Service, SupportsConfigLoading):
         """
         json_file_name = self.resolve_path(json_file_name)
         _LOG.info("Load config: %s", json_file_name)
-        with open(json_file_name, mode='r', encoding='utf-8') as fh_json:
-            config = json5.load(fh_json)
-        if schema_type is not None:
+        cache_key = os.path.abspath(json_file_name)
+        file_stat = os.stat(json_file_name)
+        stamp = (file_stat.st_mtime_ns, file_stat.st_size)
+        with self._CONFIG_CACHE_LOCK:
+            cached = self._CONFIG_CACHE.get(cache_key)
+        if cached is None or cached.stamp != stamp:
+            cached = _CachedConfig(stamp, self._parse_config(json_file_name, stamp), set())
+            with self._CONFIG_CACHE_LOCK:
+                self._CONFIG_CACHE[cache_key] = cached
+        else:
+            _LOG.debug("Config cache hit: %s", json_file_name)
+        if schema_type is not None and schema_type.name not in cached.validated:
             try:
-                schema_type.validate(config)
+                schema_type.validate(cached.config)
             except (ValidationError, SchemaError) as ex:
                 _LOG.error("Failed to validate config %s against schema type %s at %s",
                            json_file_name, schema_type.name, schema_type.value)
                 raise ValueError(f"Failed to validate config {json_file_name} against " +
                                  f"schema type {schema_type.name} at {schema_type.value}") from ex
+            cached.validated.add(schema_type.name)
+        config = deepcopy(cached.config)
+        if schema_type is not None:
             if isinstance(config, dict) and config.get("$schema"):
                 # Remove $schema attributes from the config after we've validated
                 # them to avoid passing them on to other objects
@@ -146,6 +185,45 @@ class ConfigPersistenceService(Service, SupportsConfigLoading):
                 del config["$schema"]
         return config   # type: ignore[no-any-return]
 
+    def _parse_config(self, json_file_name: str, stamp: Tuple[int, int]) -> Any:
+        """
+        Parse the JSON5 config file, or load it from the on-disk cache (if enabled).
+        The cache entry is keyed by the file path and its (mtime, size) `stamp`;
+        the entries are stored as plain JSON, which is much faster to parse than JSON5.
+        """
+        cache_file: Optional[str] = None
+        if self._config_cache_dir:
+            key = json.dumps([os.path.abspath(json_file_name), *stamp])
+            cache_file = os.path.join(self._config_cache_dir,
+                                      hashlib.sha256(key.encode("utf-8")).hexdigest() + ".json")
+            try:
+                with open(cache_file, mode='r', encoding='utf-8') as fh_cache:
+                    _LOG.debug("Config disk cache hit: %s -> %s", json_file_name, cache_file)
+                    return json.load(fh_cache)
+            except (OSError, ValueError):
+                pass    # Not in the cache (or a corrupted entry): parse the config and (re)write it.
+        with open(json_file_name, mode='r', encoding='utf-8') as fh_json:
+            config = json5.load(fh_json)
+        if cache_file is not None:
+            self._save_cached_config(cache_file, config)
+        return config
+
+    @staticmethod
+    def _save_cached_config(cache_file: str, config: Any) -> None:
+        """
+        Atomically write the parsed config to the on-disk cache. Errors are not fatal.
+        """
+        tmp_file = f"{cache_file}.{os.getpid()}.tmp"
+        try:
+            os.makedirs(os.path.dirname(cache_file), exist_ok=True)
+            with open(tmp_file, mode='w', encoding='utf-8') as fh_cache:
+                json.dump(config, fh_cache)
+            os.replace(tmp_file, cache_file)
+        except (OSError, TypeError, ValueError) as ex:
+            _LOG.warning("Failed to save config cache: %s :: %s", cache_file, ex)
+            if os.path.exists(tmp_file):
+                os.remove(tmp_file)
+
     def prepare_class_load(self, config: Dict[str, Any],
                            global_config: Optional[Dict[str, Any]] = None) -> Tuple[str, Dict[str, Any]]:
         """
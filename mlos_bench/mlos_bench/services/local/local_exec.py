@@ -10,12 +10,16 @@ import errno
 import logging
 import os
 import shlex
+import signal
 import subprocess
 import sys
+import threading
+import weakref
 
-from typing import Dict, Iterable, Mapping, Optional, Tuple, TYPE_CHECKING
+from typing import Dict, IO, Iterable, List, Mapping, Optional, Tuple, TYPE_CHECKING
 
 from mlos_bench.services.base_service import Service
+from mlos_bench.services.local.python_worker import PythonWorkerPool
 from mlos_bench.services.local.temp_dir_context import TempDirContextService
 from mlos_bench.services.types.local_exec_type import SupportsLocalExec
 
@@ -25,6 +29,73 @@ if TYPE_CHECKING:
 _LOG = logging.getLogger(__name__)
 
 
+class LocalProcess:
+    """
+    Handle of the script running in the background, as started by
+    `LocalExecService.local_exec_start()`. Collects the output of the process
+    (and logs it line by line) as it arrives.
+    """
+
+    def __init__(self, proc: subprocess.Popen):
+        assert proc.stdout is not None and proc.stderr is not None
+        self._proc = proc
+        self._stdout: List[str] = []
+        self._stderr: List[str] = []
+        self._threads = [
+            threading.Thread(target=LocalExecService._read_stream, args=(proc.stdout, "stdout", self._stdout)),
+            threading.Thread(target=LocalExecService._read_stream, args=(proc.stderr, "stderr", self._stderr)),
+        ]
+        for thread in self._threads:
+            thread.start()
+
+    def __repr__(self) -> str:
+        return f"{self.__class__.__name__}(pid={self._proc.pid})"
+
+    def poll(self) -> Optional[int]:
+        """
+        Check if the process has exited, without waiting.
+
+        Returns
+        -------
+        return_code : Optional[int]
+            Return code of the process, or None if it is still running.
+        """
+        return_code = self._proc.poll()
+        if return_code is not None:
+            self._join()
+        return return_code
+
+    def kill(self) -> None:
+        """
+        Kill the process along with the commands it has started, and wait for it to exit.
+        """
+        if self._proc.poll() is None:
+            _LOG.info("Kill: %s", self)
+            if sys.platform == 'win32':
+                self._proc.kill()
+            else:
+                os.killpg(self._proc.pid, signal.SIGKILL)
+        self._proc.wait()
+        self._join()
+
+    @property
+    def output(self) -> Tuple[str, str]:
+        """
+        The (stdout, stderr) output of the process received so far.
+        """
+        return ("".join(self._stdout), "".join(self._stderr))
+
+    def _join(self) -> None:
+        """
+        Wait for the rest of the output of the exited process and close the pipes.
+        """
+        for thread in self._threads:
+            thread.join()
+        for stream in (self._proc.stdout, self._proc.stderr):
+            if stream is not None:
+                stream.close()
+
+
 class LocalExecService(TempDirContextService, SupportsLocalExec):
     """
     Collection of methods to run scripts and commands in an external process
@@ -45,7 +116,24 @@ class LocalExecService(TempDirContextService, SupportsLocalExec):
             An optional parent service that can provide mixin functions.
         """
         super().__init__(config, parent)
-        self.register([self.local_exec])
+        # Run consecutive shell commands of the script in a single shell session.
+        self._batch_scripts = bool(self.config.get("batch_scripts", False)) and sys.platform != 'win32'
+        # Run the Python scripts in persistent worker processes.
+        self._python_workers: Optional[PythonWorkerPool] = None
+        if self.config.get("python_worker", False):
+            timeout = self.config.get("python_worker_timeout")
+            self._python_workers = PythonWorkerPool(None if timeout is None else float(timeout))
+            # Stop the workers even if `.teardown()` is never called.
+            weakref.finalize(self, self._python_workers.stop)
+        self.register([self.local_exec, self.local_exec_start])
+
+    def teardown(self) -> None:
+        """
+        Stop the persistent Python worker processes (if any).
+        New workers are started on demand if the service is used again.
+        """
+        if self._python_workers is not None:
+            self._python_workers.stop()
 
     def local_exec(self, script_lines: Iterable[str],
                    env: Optional[Mapping[str, "TunableValue"]] = None,
@@ -72,14 +160,17 @@ class LocalExecService(TempDirContextService, SupportsLocalExec):
         -------
         (return_code, stdout, stderr) : (int, str, str)
             A 3-tuple of return code, stdout, and stderr of the script process.
+            If `batch_scripts` config parameter is set, the consecutive shell commands
+            run in one shell session (so, e.g., `cd` affects the following lines),
+            and the return code is the one of the last command executed.
         """
         (return_code, stdout_list, stderr_list) = (0, [], [])
         with self.temp_dir_context(cwd) as temp_dir:
 
             _LOG.debug("Run in directory: %s", temp_dir)
 
-            for line in script_lines:
-                (return_code, stdout, stderr) = self._local_exec_script(line, env, temp_dir)
+            for cmds in self._split_script(script_lines):
+                (return_code, stdout, stderr) = self._local_exec_cmds(cmds, env, temp_dir, return_on_error)
                 stdout_list.append(stdout)
                 stderr_list.append(stderr)
                 if return_code != 0 and return_on_error:
@@ -93,41 +184,139 @@ class LocalExecService(TempDirContextService, SupportsLocalExec):
 
         return (return_code, stdout, stderr)
 
-    def _local_exec_script(self, script_line: str,
-                           env_params: Optional[Mapping[str, "TunableValue"]],
-                           cwd: str) -> Tuple[int, str, str]:
+    def local_exec_start(self, script_lines: Iterable[str],
+                         env: Optional[Mapping[str, "TunableValue"]] = None,
+                         cwd: Optional[str] = None) -> LocalProcess:
         """
-        Execute the script from `script_path` in a local process.
+        Start the script lines in a single local shell process in the background,
+        without waiting for it to complete. The commands run one after another,
+        and the script stops on the first error.
 
         Parameters
         ----------
-        script_line : str
-            Line of the script to tun in the local process.
-        args : Iterable[str]
-            Command line arguments for the script.
-        env_params : Mapping[str, Union[int, float, str]]
-            Environment variables.
+        script_lines : Iterable[str]
+            Lines of the script to run locally.
+        env : Mapping[str, Union[int, float, str]]
+            Environment variables (optional).
         cwd : str
-            Work directory to run the script at.
+            Work directory to run the script at. The caller must keep it
+            until the process exits.
 
         Returns
         -------
-        (return_code, stdout, stderr) : (int, str, str)
-            A 3-tuple of return code, stdout, and stderr of the script process.
+        process : LocalProcess
+            Handle to poll the process for completion, or to kill it.
+        """
+        env_vars = {key: str(val) for (key, val) in (env or {}).items()}
+        cmds = [" ".join(self._python_cmd(self._resolve_cmd(line))) for line in script_lines]
+        script = " && ".join(cmds) if sys.platform == 'win32' else "\n".join(["set -e"] + cmds)
+        _LOG.info("Start in background:\n%s", script)
+        # Run in a new session to kill the entire process group on cancellation.
+        proc = subprocess.Popen(  # pylint: disable=consider-using-with
+            script, env=env_vars or None, cwd=cwd, shell=True, text=True,
+            stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+            start_new_session=(sys.platform != 'win32'))
+        return LocalProcess(proc)
+
+    def _resolve_cmd(self, script_line: str) -> List[str]:
+        """
+        Split the script line into the command and its arguments,
+        and resolve the path to the script (if it is a file in the config paths).
         """
         cmd = shlex.split(script_line)
         script_path = self.config_loader_service.resolve_path(cmd[0])
         if os.path.exists(script_path):
             script_path = os.path.abspath(script_path)
+        return [script_path] + cmd[1:]
+
+    @staticmethod
+    def _is_python_script(cmd: List[str]) -> bool:
+        """
+        Check if the command is a Python script.
+        """
+        return cmd[0].strip().lower().endswith(".py")
 
-        cmd = [script_path] + cmd[1:]
-        if script_path.strip().lower().endswith(".py"):
-            cmd = [sys.executable] + cmd
+    def _is_worker_script(self, cmd: List[str]) -> bool:
+        """
+        Check if the command is a Python script file that can run in a persistent worker.
+        """
+        return self._python_workers is not None and self._is_python_script(cmd) and os.path.isfile(cmd[0])
+
+    def _split_script(self, script_lines: Iterable[str]) -> List[List[List[str]]]:
+        """
+        Group the commands of the script into the batches to execute at once.
+        Without batching, each command is a batch on its own. Otherwise,
+        consecutive shell commands make a batch, and Python scripts that can run
+        in a persistent worker are always executed separately.
+        """
+        batches: List[List[List[str]]] = []
+        in_shell_batch = False
+        for line in script_lines:
+            cmd = self._resolve_cmd(line)
+            is_worker_script = self._is_worker_script(cmd)
+            if self._batch_scripts and in_shell_batch and not is_worker_script:
+                batches[-1].append(cmd)
+            else:
+                batches.append([cmd])
+            in_shell_batch = not is_worker_script
+        return batches
 
+    def _local_exec_cmds(self, cmds: List[List[str]],
+                         env_params: Optional[Mapping[str, "TunableValue"]],
+                         cwd: str, return_on_error: bool) -> Tuple[int, str, str]:
+        """
+        Execute a batch of commands, either in a shell session or in a Python worker.
+        """
         env: Dict[str, str] = {}
         if env_params:
             env = {key: str(val) for (key, val) in env_params.items()}
 
+        if len(cmds) == 1:
+            cmd = cmds[0]
+            if self._python_workers is not None and self._is_worker_script(cmd):
+                _LOG.info("Run in Python worker: %s", cmd)
+                try:
+                    return self._python_workers.run(cmd[0], cmd[1:], env, cwd)
+                except TimeoutError as ex:
+                    _LOG.warning("Python worker timed out: %s", cmd, exc_info=ex)
+                    return (errno.ETIMEDOUT, "", str(ex))
+            return self._local_exec_script(cmd, env, cwd)
+
+        # Run the batch as a single shell script. Stop on first error, if requested.
+        script = ["set -e"] if return_on_error else []
+        script += [" ".join(self._python_cmd(cmd)) for cmd in cmds]
+        _LOG.info("Run batch:\n%s", "\n".join(script))
+        return self._run_process(["\n".join(script)], env, cwd)
+
+    @staticmethod
+    def _python_cmd(cmd: List[str]) -> List[str]:
+        """
+        Prepend the Python interpreter to the command if it is a Python script.
+        """
+        return [sys.executable] + cmd if LocalExecService._is_python_script(cmd) else cmd
+
+    def _local_exec_script(self, cmd: List[str], env: Dict[str, str],
+                           cwd: str) -> Tuple[int, str, str]:
+        """
+        Execute the script from `script_path` in a local process.
+
+        Parameters
+        ----------
+        cmd : List[str]
+            The command to run in the local process and its arguments,
+            as returned by `._resolve_cmd()`.
+        env : Dict[str, str]
+            Environment variables.
+        cwd : str
+            Work directory to run the script at.
+
+        Returns
+        -------
+        (return_code, stdout, stderr) : (int, str, str)
+            A 3-tuple of return code, stdout, and stderr of the script process.
+        """
+        cmd = self._python_cmd(cmd)
+
         if sys.platform == 'win32':
             # A hack to run Python on Windows with env variables set:
             env_copy = os.environ.copy()
@@ -137,17 +326,47 @@ class LocalExecService(TempDirContextService, SupportsLocalExec):
 
         _LOG.info("Run: %s", cmd)
 
-        try:
-            if sys.platform != 'win32':
-                cmd = [" ".join(cmd)]
+        if sys.platform != 'win32':
+            cmd = [" ".join(cmd)]
+
+        return self._run_process(cmd, env, cwd)
 
-            proc = subprocess.run(cmd, env=env or None, cwd=cwd, shell=True,
-                                  text=True, check=False, capture_output=True)
+    @staticmethod
+    def _run_process(cmd: List[str], env: Dict[str, str], cwd: str) -> Tuple[int, str, str]:
+        """
+        Run the command in a shell and log its output line by line as it arrives.
+
+        Returns
+        -------
+        (return_code, stdout, stderr) : (int, str, str)
+            A 3-tuple of return code, stdout, and stderr of the process.
+        """
+        try:
+            with subprocess.Popen(cmd, env=env or None, cwd=cwd, shell=True, text=True,
+                                  stdout=subprocess.PIPE, stderr=subprocess.PIPE) as proc:
+                assert proc.stdout is not None and proc.stderr is not None
+                stderr_lines: List[str] = []
+                stderr_thread = threading.Thread(
+                    target=LocalExecService._read_stream, args=(proc.stderr, "stderr", stderr_lines))
+                stderr_thread.start()
+                stdout_lines: List[str] = []
+                LocalExecService._read_stream(proc.stdout, "stdout", stdout_lines)
+                stderr_thread.join()
+                return_code = proc.wait()
 
-            _LOG.debug("Run: return code = %d", proc.returncode)
-            return (proc.returncode, proc.stdout, proc.stderr)
+            _LOG.debug("Run: return code = %d", return_code)
+            return (return_code, "".join(stdout_lines), "".join(stderr_lines))
 
         except FileNotFoundError as ex:
             _LOG.warning("File not found: %s", cmd, exc_info=ex)
 
         return (errno.ENOENT, "", "File not found")
+
+    @staticmethod
+    def _read_stream(stream: IO[str], name: str, lines: List[str]) -> None:
+        """
+        Read the output of the process line by line and log it as it arrives.
+        """
+        for line in stream:
+            _LOG.debug("Run: %s: %s", name, line.rstrip("\n"))
+            lines.append(line)
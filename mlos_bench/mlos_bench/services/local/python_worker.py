@@ -0,0 +1,249 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+A persistent Python process to run the (in-tree) Python helper scripts
+without paying the interpreter startup and module import costs on every call.
+
+When executed as a script, this module runs the worker loop: it reads
+the requests (one JSON object per line) from stdin, runs the requested script
+in-process via `runpy`, and writes the responses (one JSON object per line).
+The `PythonWorkerPool` class manages such worker processes on the scheduler side.
+
+NOTE: Do not import anything from mlos_bench here, as the worker process
+runs this file directly, without mlos_bench on its path.
+"""
+
+import io
+import json
+import logging
+import os
+import runpy
+import subprocess
+import sys
+import threading
+import traceback
+
+from contextlib import redirect_stderr, redirect_stdout
+from typing import Any, Dict, List, Mapping, Optional, Sequence, TextIO, Tuple
+
+_LOG = logging.getLogger(__name__)
+
+
+def _run_request(request: Dict[str, Any]) -> Dict[str, Any]:
+    """
+    Run a single Python script in the worker process and capture its output.
+    Restore the working directory, environment, `sys.argv`, `sys.path`,
+    and `sys.modules` afterwards.
+    """
+    (stdout, stderr) = (io.StringIO(), io.StringIO())
+    (old_cwd, old_env, old_argv, old_path) = (os.getcwd(), os.environ.copy(), sys.argv, sys.path)
+    old_modules = sys.modules.copy()
+    script_dir = os.path.dirname(request["path"])
+    return_code = 0
+    try:
+        os.chdir(request["cwd"])
+        if request["env"]:
+            # Same as the subprocess: the request env replaces the worker's one.
+            os.environ.clear()
+            os.environ.update(request["env"])
+        sys.argv = [request["path"]] + request["args"]
+        # Same as `python script.py`: let the script import its sibling modules.
+        sys.path = [script_dir] + old_path
+        with redirect_stdout(stdout), redirect_stderr(stderr):
+            try:
+                runpy.run_path(request["path"], run_name="__main__")
+            except SystemExit as ex:
+                if isinstance(ex.code, int):
+                    return_code = ex.code
+                elif ex.code is not None:
+                    print(ex.code, file=sys.stderr)
+                    return_code = 1
+            except Exception:  # pylint: disable=broad-except
+                traceback.print_exc()
+                return_code = 1
+    finally:
+        _restore_modules(old_modules, script_dir)
+        sys.path = old_path
+        sys.argv = old_argv
+        os.environ.clear()
+        os.environ.update(old_env)
+        os.chdir(old_cwd)
+    return {"return_code": return_code, "stdout": stdout.getvalue(), "stderr": stderr.getvalue()}
+
+
+def _restore_modules(old_modules: Dict[str, Any], script_dir: str) -> None:
+    """
+    Restore the modules the script has replaced, and unload the ones it has imported
+    from its own directory, so the next run does not see the stale sibling modules.
+    New modules from elsewhere (the standard and the third-party libraries)
+    stay loaded: caching them is the point of the persistent worker.
+    """
+    prefix = os.path.join(os.path.abspath(script_dir), "")
+    for (name, module) in list(sys.modules.items()):
+        old_module = old_modules.get(name)
+        if old_module is not None:
+            if module is not old_module:
+                sys.modules[name] = old_module
+        elif os.path.abspath(getattr(module, "__file__", None) or os.sep).startswith(prefix):
+            del sys.modules[name]
+
+
+def _main() -> None:
+    """
+    Worker loop: process the requests from stdin until it is closed.
+    """
+    # Keep private copies of stdin and stdout for the protocol, and redirect
+    # the original stdin file descriptor to /dev/null and stdout to stderr, so the scripts
+    # (or the processes they spawn) that use the file descriptors directly cannot
+    # consume the requests or corrupt the responses.
+    requests = os.fdopen(os.dup(sys.stdin.fileno()), "rt", encoding="utf-8")
+    responses = os.fdopen(os.dup(sys.stdout.fileno()), "wt", encoding="utf-8")
+    devnull = os.open(os.devnull, os.O_RDONLY)
+    os.dup2(devnull, sys.stdin.fileno())
+    os.close(devnull)
+    os.dup2(sys.stderr.fileno(), sys.stdout.fileno())
+    for line in requests:
+        if line.strip():
+            responses.write(json.dumps(_run_request(json.loads(line))) + "\n")
+            responses.flush()
+
+
+class _PythonWorker:
+    """
+    Scheduler-side handle of a single worker process.
+    """
+
+    def __init__(self) -> None:
+        self._proc = subprocess.Popen(   # pylint: disable=consider-using-with
+            [sys.executable, os.path.abspath(__file__)],
+            stdin=subprocess.PIPE, stdout=subprocess.PIPE,
+            text=True, encoding="utf-8")
+        _LOG.info("Started Python worker: pid=%d", self._proc.pid)
+
+    @property
+    def is_alive(self) -> bool:
+        """True if the worker process is still running."""
+        return self._proc.poll() is None
+
+    def run(self, request: Dict[str, Any], timeout: Optional[float] = None) -> Dict[str, Any]:
+        """
+        Send the request to the worker and wait for the response.
+        Kill the worker and raise `TimeoutError` if the response
+        does not arrive within `timeout` seconds.
+        """
+        assert self._proc.stdin is not None and self._proc.stdout is not None
+        self._proc.stdin.write(json.dumps(request) + "\n")
+        self._proc.stdin.flush()
+        if timeout is None:
+            response = self._proc.stdout.readline()
+        else:
+            stdout = self._proc.stdout
+            lines: List[str] = []
+            reader = threading.Thread(target=lambda: lines.append(stdout.readline()),
+                                      name="mlos_bench_python_worker", daemon=True)
+            reader.start()
+            reader.join(timeout)
+            if reader.is_alive():
+                self._proc.kill()
+                raise TimeoutError(f"Python worker {self._proc.pid} timed out after {timeout}s")
+            response = lines[0] if lines else ""
+        if not response:
+            raise ChildProcessError(f"Python worker {self._proc.pid} exited with code {self._proc.poll()}")
+        result: Dict[str, Any] = json.loads(response)
+        return result
+
+    def stop(self) -> None:
+        """
+        Stop the worker process by closing its stdin.
+        """
+        streams: List[Optional[TextIO]] = [self._proc.stdin, self._proc.stdout]
+        for stream in streams:
+            if stream is not None:
+                stream.close()
+        try:
+            self._proc.wait(timeout=5)
+        except subprocess.TimeoutExpired:
+            self._proc.kill()
+
+
+class PythonWorkerPool:
+    """
+    A pool of persistent Python worker processes.
+    Each concurrent call gets its own worker; the workers are reused across calls.
+    """
+
+    def __init__(self, timeout: Optional[float] = None):
+        """
+        Create a new (empty) pool of the Python workers.
+
+        Parameters
+        ----------
+        timeout : Optional[float]
+            Max. time (in seconds) to wait for a script to complete.
+            If None (default), wait indefinitely.
+        """
+        self._timeout = timeout
+        self._lock = threading.Lock()
+        self._idle: List[_PythonWorker] = []
+
+    def run(self, script_path: str, args: Sequence[str],
+            env: Mapping[str, str], cwd: str) -> Tuple[int, str, str]:
+        """
+        Run the Python script in one of the worker processes.
+
+        Parameters
+        ----------
+        script_path : str
+            Absolute path to the Python script.
+        args : Sequence[str]
+            Command line arguments for the script.
+        env : Mapping[str, str]
+            Environment variables for the duration of the script. If not empty,
+            they replace the worker's environment, same as for a subprocess.
+        cwd : str
+            Work directory to run the script at.
+
+        Returns
+        -------
+        (return_code, stdout, stderr) : (int, str, str)
+            A 3-tuple of return code, stdout, and stderr of the script.
+
+        Raises
+        ------
+        TimeoutError
+            If the script does not complete within the pool's timeout.
+            The worker is killed in that case.
+        """
+        with self._lock:
+            worker = self._idle.pop() if self._idle else None
+        if worker is None or not worker.is_alive:
+            worker = _PythonWorker()
+        try:
+            result = worker.run({
+                "path": script_path,
+                "args": list(args),
+                "env": dict(env),
+                "cwd": os.path.abspath(cwd),
+            }, self._timeout)
+        except (ChildProcessError, OSError, ValueError):
+            worker.stop()
+            raise
+        with self._lock:
+            self._idle.append(worker)
+        return (result["return_code"], result["stdout"], result["stderr"])
+
+    def stop(self) -> None:
+        """
+        Stop all idle worker processes.
+        """
+        with self._lock:
+            (workers, self._idle) = (self._idle, [])
+        for worker in workers:
+            worker.stop()
+
+
+if __name__ == "__main__":
+    _main()
@@ -11,6 +11,8 @@ import json
 import logging
 import subprocess
 
+from threading import Lock
+
 from mlos_bench.services.base_service import Service
 from mlos_bench.services.types.authenticator_type import SupportsAuth
 
@@ -46,19 +48,28 @@ class AzureAuthService(Service, SupportsAuth):
 
         self._access_token = "RENEW *NOW*"
         self._token_expiration_ts = datetime.datetime.now()  # Typically, some future timestamp.
+        # Concurrent requests (e.g., fleet-level operations) must renew the token only once.
+        self._lock = Lock()
 
     def get_access_token(self) -> str:
         """
         Get the access token from Azure CLI, if expired.
+        The token is cached and reused until it is about to expire.
+        """
+        with self._lock:
+            ts_diff = (self._token_expiration_ts - datetime.datetime.now()).total_seconds()
+            if ts_diff < self._req_interval:
+                self._renew_access_token()
+            return self._access_token
+
+    def _renew_access_token(self) -> None:
+        """
+        Request a new access token from Azure CLI.
         """
-        ts_diff = (self._token_expiration_ts - datetime.datetime.now()).total_seconds()
-        _LOG.debug("Time to renew the token: %.2f sec.", ts_diff)
-        if ts_diff < self._req_interval:
-            _LOG.debug("Request new accessToken")
-            # TODO: Use azure-identity SDK and a key valut instead of `az` CLI.
-            res = json.loads(subprocess.check_output(
-                'az account get-access-token', shell=True, text=True))
-            self._token_expiration_ts = datetime.datetime.fromisoformat(res["expiresOn"])
-            self._access_token = res["accessToken"]
-            _LOG.info("Got new accessToken. Expiration time: %s", self._token_expiration_ts)
-        return self._access_token
+        _LOG.debug("Request new accessToken")
+        # TODO: Use azure-identity SDK and a key valut instead of `az` CLI.
+        res = json.loads(subprocess.check_output(
+            'az account get-access-token', shell=True, text=True))
+        self._token_expiration_ts = datetime.datetime.fromisoformat(res["expiresOn"])
+        self._access_token = res["accessToken"]
+        _LOG.info("Got new accessToken. Expiration time: %s", self._token_expiration_ts)
@@ -6,15 +6,20 @@
 A collection FileShare functions for interacting with Azure File Shares.
 """
 
+import hashlib
 import os
 import logging
 
-from typing import Set
+from concurrent.futures import ThreadPoolExecutor
+from threading import Lock
+from typing import Callable, Dict, List, Set, Tuple
 
+from azure.core.pipeline.transport import RequestsTransport
 from azure.storage.fileshare import ShareClient
 
 from mlos_bench.services.base_service import Service
 from mlos_bench.services.base_fileshare import FileShareService
+from mlos_bench.services.remote.azure.azure_http import create_http_session
 from mlos_bench.util import check_required_params
 
 _LOG = logging.getLogger(__name__)
@@ -27,6 +32,9 @@ class AzureFileShareService(FileShareService):
 
     _SHARE_URL = "https://{account_name}.file.core.windows.net/{fs_name}"
 
+    _HASH_BLOCK_SIZE = 1 << 20
+    """Size of the blocks to read when computing the hash of a local file."""
+
     def __init__(self, config: dict, parent: Service):
         """
         Create a new file share Service for Azure environments with a given config.
@@ -56,10 +64,35 @@ class AzureFileShareService(FileShareService):
                 fs_name=config["storageFileShareName"],
             ),
             credential=config["storageAccountKey"],
+            # Reuse the keep-alive connections of the other Azure services.
+            # The session is our own (the SDK shares it between its transfer threads),
+            # and it must not be closed, as that would close the shared connection pool.
+            transport=RequestsTransport(session=create_http_session(), session_owner=False),
         )
 
+        # Number of files to transfer concurrently. Also used for the
+        # concurrent (chunked) transfer of the individual large files.
+        self._max_concurrency = int(config.get("maxConcurrency", 4))
+        # If True, skip uploading the files that have not changed since we last uploaded them.
+        self._incremental_upload = bool(config.get("incrementalUpload", False))
+        self._lock = Lock()
+        # Remote directories known to exist.
+        self._remote_dirs: Set[str] = set()
+        # Remote path -> (size, mtime_ns, sha256) of the local file we last uploaded there.
+        self._uploaded: Dict[str, Tuple[int, int, str]] = {}
+
     def download(self, remote_path: str, local_path: str, recursive: bool = True) -> None:
         super().download(remote_path, local_path, recursive)
+        files: List[Tuple[str, str]] = []
+        self._list_remote_files(remote_path, local_path, recursive, files)
+        self._transfer_files(self._download_file, files)
+
+    def _list_remote_files(self, remote_path: str, local_path: str, recursive: bool,
+                           files: List[Tuple[str, str]]) -> None:
+        """
+        Walk the remote directory tree, create the local directories,
+        and collect the (remote, local) paths of the files to download.
+        """
         dir_client = self._share_client.get_directory_client(remote_path)
         if dir_client.exists():
             os.makedirs(local_path, exist_ok=True)
@@ -68,24 +101,34 @@ class AzureFileShareService(FileShareService):
                 local_target = f"{local_path}/{name}"
                 remote_target = f"{remote_path}/{name}"
                 if recursive or not content["is_directory"]:
-                    self.download(remote_target, local_target, recursive)
+                    self._list_remote_files(remote_target, local_target, recursive, files)
         else:  # Must be a file
             # Ensure parent folders exist
             folder, _ = os.path.split(local_path)
             os.makedirs(folder, exist_ok=True)
-            file_client = self._share_client.get_file_client(remote_path)
-            data = file_client.download_file()
-            with open(local_path, "wb") as output_file:
-                _LOG.debug("Download file: %s -> %s", remote_path, local_path)
-                data.readinto(output_file)  # type: ignore[no-untyped-call]
+            files.append((remote_path, local_path))
+
+    def _download_file(self, remote_path: str, local_path: str) -> None:
+        """
+        Download a single file from the file share.
+        """
+        file_client = self._share_client.get_file_client(remote_path)
+        data = file_client.download_file(max_concurrency=self._max_concurrency)
+        with open(local_path, "wb") as output_file:
+            _LOG.debug("Download file: %s -> %s", remote_path, local_path)
+            data.readinto(output_file)  # type: ignore[no-untyped-call]
 
     def upload(self, local_path: str, remote_path: str, recursive: bool = True) -> None:
         super().upload(local_path, remote_path, recursive)
-        self._upload(local_path, remote_path, recursive, set())
+        files: List[Tuple[str, str]] = []
+        self._upload(local_path, remote_path, recursive, set(), files)
+        self._transfer_files(self._upload_file, files)
 
-    def _upload(self, local_path: str, remote_path: str, recursive: bool, seen: Set[str]) -> None:
+    def _upload(self, local_path: str, remote_path: str, recursive: bool,
+                seen: Set[str], files: List[Tuple[str, str]]) -> None:
         """
-        Upload contents from a local path to an Azure file share.
+        Walk the local directory tree, create the remote directories, and collect
+        the (local, remote) paths of the files to upload to an Azure file share.
         This method is called from `.upload()` above. We need it to avoid exposing
         the `seen` parameter and to make `.upload()` match the base class' virtual
         method.
@@ -101,6 +144,8 @@ class AzureFileShareService(FileShareService):
             if True (the default), upload the entire directory tree.
         seen: Set[str]
             Helper set for keeping track of visited directories to break circular paths.
+        files : List[Tuple[str, str]]
+            Output list of (local, remote) paths of the files to upload.
         """
         local_path = os.path.abspath(local_path)
         if local_path in seen:
@@ -109,28 +154,78 @@ class AzureFileShareService(FileShareService):
         seen.add(local_path)
 
         if os.path.isdir(local_path):
-            dir_client = self._share_client.get_directory_client(remote_path)
-            if not dir_client.exists():
-                dir_client.create_directory()
+            self._remote_makedirs(remote_path)
             for entry in os.scandir(local_path):
                 name = entry.name
                 local_target = f"{local_path}/{name}"
                 remote_target = f"{remote_path}/{name}"
                 if recursive or not entry.is_dir():
-                    self._upload(local_target, remote_target, recursive, seen)
+                    self._upload(local_target, remote_target, recursive, seen, files)
         else:
             # Ensure parent folders exist
             folder, _ = os.path.split(remote_path)
             self._remote_makedirs(folder)
-            file_client = self._share_client.get_file_client(remote_path)
-            with open(local_path, "rb") as file_data:
-                _LOG.debug("Upload file: %s -> %s", local_path, remote_path)
-                file_client.upload_file(file_data)
+            files.append((local_path, remote_path))
+
+    def _upload_file(self, local_path: str, remote_path: str) -> None:
+        """
+        Upload a single file to the file share. In the incremental mode, skip the file
+        if its size and mtime, or its content hash, match the ones we uploaded last time.
+        """
+        stamp = None
+        if self._incremental_upload:
+            stat = os.stat(local_path)
+            with self._lock:
+                prev_stamp = self._uploaded.get(remote_path)
+            if prev_stamp is not None and prev_stamp[:2] == (stat.st_size, stat.st_mtime_ns):
+                _LOG.debug("Skip unchanged file: %s -> %s", local_path, remote_path)
+                return
+            stamp = (stat.st_size, stat.st_mtime_ns, self._file_hash(local_path))
+            if prev_stamp is not None and prev_stamp[2] == stamp[2]:
+                _LOG.debug("Skip file with unchanged content: %s -> %s", local_path, remote_path)
+                with self._lock:
+                    self._uploaded[remote_path] = stamp
+                return
+        file_client = self._share_client.get_file_client(remote_path)
+        with open(local_path, "rb") as file_data:
+            _LOG.debug("Upload file: %s -> %s", local_path, remote_path)
+            file_client.upload_file(file_data, max_concurrency=self._max_concurrency)
+        if stamp is not None:
+            with self._lock:
+                self._uploaded[remote_path] = stamp
+
+    @classmethod
+    def _file_hash(cls, local_path: str) -> str:
+        """
+        Compute the SHA-256 hash of the local file contents.
+        """
+        digest = hashlib.sha256()
+        with open(local_path, "rb") as file_data:
+            for block in iter(lambda: file_data.read(cls._HASH_BLOCK_SIZE), b""):
+                digest.update(block)
+        return digest.hexdigest()
+
+    def _transfer_files(self, transfer: Callable[[str, str], None],
+                        files: List[Tuple[str, str]]) -> None:
+        """
+        Transfer the files using a pool of `maxConcurrency` threads.
+        Raise the first exception (if any) after all transfers complete.
+        """
+        if self._max_concurrency <= 1 or len(files) <= 1:
+            for (source, target) in files:
+                transfer(source, target)
+            return
+        with ThreadPoolExecutor(max_workers=min(self._max_concurrency, len(files)),
+                                thread_name_prefix="azure_fileshare") as executor:
+            futures = [executor.submit(transfer, source, target) for (source, target) in files]
+        for future in futures:
+            future.result()
 
     def _remote_makedirs(self, remote_path: str) -> None:
         """
         Create remote directories for the entire path.
         Succeeds even some or all directories along the path already exist.
+        Remember the directories that exist, so we check each one only once.
 
         Parameters
         ----------
@@ -142,6 +237,9 @@ class AzureFileShareService(FileShareService):
             if not folder:
                 continue
             path += folder + "/"
+            if path in self._remote_dirs:
+                continue
             dir_client = self._share_client.get_directory_client(path)
             if not dir_client.exists():
                 dir_client.create_directory()
+            self._remote_dirs.add(path)
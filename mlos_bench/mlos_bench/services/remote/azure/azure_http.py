@@ -0,0 +1,76 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+HTTP sessions for the Azure services that share one connection pool.
+Reusing the (keep-alive) connections saves a TLS handshake on every REST API
+call and keeps the number of open connections to the Azure endpoints low.
+"""
+
+import logging
+
+from threading import Lock, local
+from typing import Optional
+
+import requests
+import requests.adapters
+
+_LOG = logging.getLogger(__name__)
+
+_POOL_SIZE = 16
+"""Max. number of connections to keep open per host."""
+
+_LOCK = Lock()
+_ADAPTER: Optional[requests.adapters.HTTPAdapter] = None
+_THREAD_DATA = local()
+
+
+def _get_http_adapter() -> requests.adapters.HTTPAdapter:
+    """
+    Get the HTTPS adapter (i.e., the connection pool) shared by all sessions
+    of the process. Create it on the first call.
+    The underlying urllib3 pool manager is thread-safe.
+    """
+    global _ADAPTER  # pylint: disable=global-statement
+    with _LOCK:
+        if _ADAPTER is None:
+            _LOG.debug("Create HTTP connection pool of size: %d", _POOL_SIZE)
+            _ADAPTER = requests.adapters.HTTPAdapter(
+                pool_connections=_POOL_SIZE, pool_maxsize=_POOL_SIZE)
+        return _ADAPTER
+
+
+def create_http_session() -> requests.Session:
+    """
+    Create a new HTTP session that uses the shared connection pool.
+    The session itself (e.g., its cookie jar) is not thread-safe,
+    so it must not be used by several threads at the same time.
+    Do not close it: that would also close the shared connection pool.
+
+    Returns
+    -------
+    session : requests.Session
+        A new session with a connection pool large enough
+        for the concurrent fleet-level operations.
+    """
+    session = requests.Session()
+    session.mount("https://", _get_http_adapter())
+    return session
+
+
+def get_http_session() -> requests.Session:
+    """
+    Get the HTTP session of the calling thread for the Azure services.
+    Create it on the first call in each thread. The sessions of all threads
+    share the same connection pool.
+
+    Returns
+    -------
+    session : requests.Session
+        The session of the current thread (see `create_http_session()`).
+    """
+    session: Optional[requests.Session] = getattr(_THREAD_DATA, "session", None)
+    if session is None:
+        session = _THREAD_DATA.session = create_http_session()
+    return session
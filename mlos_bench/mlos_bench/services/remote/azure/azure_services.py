@@ -10,12 +10,15 @@ import json
 import time
 import logging
 
-from typing import Callable, Iterable, Tuple
+from concurrent.futures import Future, ThreadPoolExecutor
+from threading import Lock
+from typing import Callable, Dict, Iterable, List, Optional, Sequence, Tuple
 
 import requests
 
 from mlos_bench.environments.status import Status
 from mlos_bench.services.base_service import Service
+from mlos_bench.services.remote.azure.azure_http import get_http_session
 from mlos_bench.services.types.authenticator_type import SupportsAuth
 from mlos_bench.services.types.remote_exec_type import SupportsRemoteExec
 from mlos_bench.services.types.vm_provisioner_type import SupportsVMOps
@@ -33,6 +36,10 @@ class AzureVMService(Service, SupportsVMOps, SupportsRemoteExec):
     _POLL_TIMEOUT = 300    # seconds
     _REQUEST_TIMEOUT = 5   # seconds
 
+    _MAX_CONCURRENCY = 8        # concurrent requests in the fleet operations
+    _POLL_BACKOFF = 1.5         # growth of the poll interval while the operation is running
+    _POLL_MAX_INTERVAL = 30     # seconds; upper bound for the adaptive poll interval
+
     # Azure Resources Deployment REST API as described in
     # https://docs.microsoft.com/en-us/rest/api/resources/deployments
 
@@ -138,12 +145,21 @@ class AzureVMService(Service, SupportsVMOps, SupportsRemoteExec):
             self.vm_restart,
             self.remote_exec,
             self.get_remote_exec_results,
+            self.poll_remote_exec_results,
+            self.remote_exec_fleet,
+            self.get_remote_exec_fleet_results,
         ])
 
         # These parameters can come from command line as strings, so conversion is needed.
         self._poll_interval = float(config.get("pollInterval", self._POLL_INTERVAL))
         self._poll_timeout = float(config.get("pollTimeout", self._POLL_TIMEOUT))
         self._request_timeout = float(config.get("requestTimeout", self._REQUEST_TIMEOUT))
+        self._max_concurrency = int(config.get("maxConcurrency", self._MAX_CONCURRENCY))
+
+        # Status checks of the same operation that are in progress (by URL).
+        # Concurrent callers wait for the same response instead of sending their own request.
+        self._status_lock = Lock()
+        self._status_checks: Dict[str, Future] = {}
 
         # TODO: Provide external schema validation?
         template = self.config_loader_service.load_config(
@@ -200,7 +216,7 @@ class AzureVMService(Service, SupportsVMOps, SupportsRemoteExec):
         """
         _LOG.debug("Request: POST %s", url)
 
-        response = requests.post(url, headers=self._get_headers(), timeout=self._request_timeout)
+        response = get_http_session().post(url, headers=self._get_headers(), timeout=self._request_timeout)
         _LOG.debug("Response: %s", response)
 
         # Logical flow for async operations based on:
@@ -240,32 +256,72 @@ class AzureVMService(Service, SupportsVMOps, SupportsRemoteExec):
             Status is one of {PENDING, RUNNING, SUCCEEDED, FAILED}
             Result is info on the operation runtime if SUCCEEDED, otherwise {}.
         """
+        (status, result, _) = self._get_vm_operation_status(params)
+        return (status, result)
+
+    def _get_vm_operation_status(self, params: dict) -> Tuple[Status, dict, Optional[float]]:
+        """
+        Same as `_check_vm_operation_status()`, but also return the poll interval
+        suggested by the API (if any). Concurrent checks of the same operation
+        are coalesced into a single request.
+
+        Returns
+        -------
+        result : (Status, dict, Optional[float])
+            A 3-tuple of Status, result, and the value of the `Retry-After` header.
+        """
         url = params.get("asyncResultsUrl")
         if url is None:
-            return Status.PENDING, {}
+            return Status.PENDING, {}, None
+
+        future: Future = Future()
+        with self._status_lock:
+            pending = self._status_checks.setdefault(url, future)
+        if pending is not future:
+            _LOG.debug("Wait for the status check in progress: %s", url)
+            result: Tuple[Status, dict, Optional[float]] = pending.result()
+            return result
 
         try:
-            response = requests.get(url, headers=self._get_headers(), timeout=self._request_timeout)
+            result = self._request_vm_operation_status(url)
+            future.set_result(result)
+            return result
+        except BaseException as ex:
+            future.set_exception(ex)
+            raise
+        finally:
+            with self._status_lock:
+                del self._status_checks[url]
+
+    def _request_vm_operation_status(self, url: str) -> Tuple[Status, dict, Optional[float]]:
+        """
+        Send the request to check the status of a pending operation.
+        """
+        try:
+            response = get_http_session().get(url, headers=self._get_headers(), timeout=self._request_timeout)
         except requests.exceptions.ReadTimeout:
             _LOG.warning("Request timed out: %s", url)
             # return Status.TIMED_OUT, {}
-            return Status.RUNNING, {}
+            return Status.RUNNING, {}, None
 
         if _LOG.isEnabledFor(logging.DEBUG):
             _LOG.debug("Response: %s\n%s", response,
                        json.dumps(response.json(), indent=2)
                        if response.content else "")
 
+        retry_after = float(response.headers["Retry-After"]) \
+            if "Retry-After" in response.headers else None
+
         if response.status_code == 200:
             output = response.json()
             status = output.get("status")
             if status == "InProgress":
-                return Status.RUNNING, {}
+                return Status.RUNNING, {}, retry_after
             elif status == "Succeeded":
-                return Status.SUCCEEDED, output
+                return Status.SUCCEEDED, output, retry_after
 
         _LOG.error("Response: %s :: %s", response, response.text)
-        return Status.FAILED, {}
+        return Status.FAILED, {}, None
 
     def wait_vm_deployment(self, is_setup: bool, params: dict) -> Tuple[Status, dict]:
         """
@@ -398,7 +454,7 @@ class AzureVMService(Service, SupportsVMOps, SupportsRemoteExec):
             deployment_name=config["deploymentName"],
         )
 
-        response = requests.head(url, headers=self._get_headers(), timeout=self._request_timeout)
+        response = get_http_session().head(url, headers=self._get_headers(), timeout=self._request_timeout)
         _LOG.debug("Response: %s", response)
 
         if response.status_code == 204:
@@ -455,8 +511,8 @@ class AzureVMService(Service, SupportsVMOps, SupportsRemoteExec):
         if _LOG.isEnabledFor(logging.DEBUG):
             _LOG.debug("Request: PUT %s\n%s", url, json.dumps(json_req, indent=2))
 
-        response = requests.put(url, json=json_req,
-                                headers=self._get_headers(), timeout=self._request_timeout)
+        response = get_http_session().put(url, json=json_req,
+                                          headers=self._get_headers(), timeout=self._request_timeout)
 
         if _LOG.isEnabledFor(logging.DEBUG):
             _LOG.debug("Response: %s\n%s", response,
@@ -625,6 +681,14 @@ class AzureVMService(Service, SupportsVMOps, SupportsRemoteExec):
         result : (Status, dict)
             A pair of Status and result.
             Status is one of {PENDING, SUCCEEDED, FAILED}
+            If the command has completed right away (SUCCEEDED), the result is its output;
+            if PENDING, the result can be passed to `get_remote_exec_results()`.
+        """
+        return self._remote_exec(list(script), config, env_params)
+
+    def _remote_exec(self, script: List[str], config: dict, env_params: dict) -> Tuple[Status, dict]:
+        """
+        Implementation of `remote_exec()` for a script that is already a list of lines.
         """
         config = merge_parameters(
             dest=self.config.copy(),
@@ -641,7 +705,7 @@ class AzureVMService(Service, SupportsVMOps, SupportsRemoteExec):
 
         json_req = {
             "commandId": "RunShellScript",
-            "script": list(script),
+            "script": script,
             "parameters": [{"name": key, "value": val} for (key, val) in env_params.items()]
         }
 
@@ -654,7 +718,7 @@ class AzureVMService(Service, SupportsVMOps, SupportsRemoteExec):
         if _LOG.isEnabledFor(logging.DEBUG):
             _LOG.debug("Request: POST %s\n%s", url, json.dumps(json_req, indent=2))
 
-        response = requests.post(
+        response = get_http_session().post(
             url, json=json_req, headers=self._get_headers(), timeout=self._request_timeout)
 
         if _LOG.isEnabledFor(logging.DEBUG):
@@ -665,13 +729,17 @@ class AzureVMService(Service, SupportsVMOps, SupportsRemoteExec):
             _LOG.info("Response: %s", response)
 
         if response.status_code == 200:
-            # TODO: extract the results from JSON response
-            return (Status.SUCCEEDED, config)
+            # The command has completed right away: the response has its output
+            # (same as the "output" of the completed asynchronous operation).
+            return (Status.SUCCEEDED, response.json() if response.content else {})
         elif response.status_code == 202:
-            return (Status.PENDING, {
+            result = {
                 **config,
                 "asyncResultsUrl": response.headers.get("Azure-AsyncOperation")
-            })
+            }
+            if "Retry-After" in response.headers:
+                result["pollInterval"] = float(response.headers["Retry-After"])
+            return (Status.PENDING, result)
         else:
             _LOG.error("Response: %s :: %s", response, response.text)
             # _LOG.error("Bad Request:\n%s", response.request.body)
@@ -700,3 +768,143 @@ class AzureVMService(Service, SupportsVMOps, SupportsRemoteExec):
             return (status, result.get("properties", {}).get("output", {}))
         else:
             return (status, result)
+
+    def poll_remote_exec_results(self, config: dict) -> Tuple[Status, dict]:
+        """
+        Check the status of the asynchronously running command once, without waiting.
+
+        Parameters
+        ----------
+        config : dict
+            Flat dictionary of (key, value) pairs of tunable parameters.
+            Must have the "asyncResultsUrl" key to get the results.
+            If the key is not present, return Status.PENDING.
+
+        Returns
+        -------
+        result : (Status, dict)
+            A pair of Status and result.
+            Status is one of {PENDING, RUNNING, SUCCEEDED, FAILED}
+        """
+        _LOG.debug("Poll the results on VM: %s", config.get("vmName"))
+        (status, result) = self._check_vm_operation_status(config)
+        if status.is_succeeded:
+            return (status, result.get("properties", {}).get("output", {}))
+        else:
+            return (status, result)
+
+    def remote_exec_fleet(self, script: Iterable[str], configs: Sequence[dict],
+                          env_params: dict) -> List[Tuple[Status, dict]]:
+        """
+        Run the same command on several Azure VMs concurrently.
+
+        Parameters
+        ----------
+        script : Iterable[str]
+            A list of lines to execute as a script on each remote VM.
+        configs : Sequence[dict]
+            Environment parameters for each VM, as in `remote_exec()`.
+            Each config must have its own "vmName".
+        env_params : dict
+            Parameters to pass as *shell* environment variables into the script.
+
+        Returns
+        -------
+        results : List[(Status, dict)]
+            The results of `remote_exec()` for each VM, in the same order as `configs`.
+            Pass them to `get_remote_exec_fleet_results()` to wait for all operations.
+            A request that fails on one VM does not affect the others: its status is FAILED,
+            and the result has the "vmName" and (if the request has raised) the "error" keys.
+        """
+        script = list(script)
+        if not configs:
+            return []
+        pool_size = min(len(configs), self._max_concurrency)
+        with ThreadPoolExecutor(max_workers=pool_size, thread_name_prefix="azure_rexec") as executor:
+            futures = [executor.submit(self._remote_exec, script, config, env_params) for config in configs]
+            results: List[Tuple[Status, dict]] = []
+            for (config, future) in zip(configs, futures):
+                try:
+                    (status, output) = future.result()
+                    if not status.is_succeeded and not status.is_pending:
+                        output = {"vmName": config.get("vmName"), **output}
+                except Exception as ex:  # pylint: disable=broad-except
+                    _LOG.error("Failed to run a script on VM: %s", config.get("vmName"), exc_info=True)
+                    (status, output) = (Status.FAILED, {"vmName": config.get("vmName"), "error": str(ex)})
+                results.append((status, output))
+            return results
+
+    def get_remote_exec_fleet_results(self, configs: Sequence[dict]) -> List[Tuple[Status, dict]]:
+        """
+        Wait for the results of several asynchronously running commands.
+
+        All pending operations are tracked together: each operation is polled on
+        its own schedule, starting from its "pollInterval" (the `Retry-After` value
+        of the initial request, if any). While the operation is running, the next
+        `Retry-After` is honored; without it, the interval grows geometrically
+        up to a limit. The overall `pollTimeout` applies to the entire fleet.
+
+        Parameters
+        ----------
+        configs : Sequence[dict]
+            The results of `remote_exec()` or `remote_exec_fleet()`.
+            Each must have the "asyncResultsUrl" key to get the results.
+            If the key is not present, the status of that operation is Status.PENDING.
+
+        Returns
+        -------
+        results : List[(Status, dict)]
+            A pair of Status and result for each operation, in the same order as `configs`.
+            Status is one of {PENDING, SUCCEEDED, FAILED, TIMED_OUT}
+            If the status check of an operation raises, only that operation FAILED,
+            and its result has the "error" key.
+        """
+        results: List[Tuple[Status, dict]] = [(Status.PENDING, {}) for _ in configs]
+        ts_start = time.time()
+        ts_timeout = ts_start + self._poll_timeout
+        # Index of the operation -> (time of the next poll, current poll interval).
+        pending: Dict[int, Tuple[float, float]] = {}
+        for (i, config) in enumerate(configs):
+            if config.get("asyncResultsUrl") is not None:
+                interval = float(config.get("pollInterval", self._poll_interval))
+                pending[i] = (ts_start + interval, interval)
+
+        _LOG.info("Wait for %d of %d operations to complete", len(pending), len(configs))
+        pool_size = max(1, min(len(pending), self._max_concurrency))
+        with ThreadPoolExecutor(max_workers=pool_size, thread_name_prefix="azure_poll") as executor:
+            while pending:
+                ts_next = min(ts_poll for (ts_poll, _) in pending.values())
+                if ts_next > ts_timeout:
+                    break
+                delay = ts_next - time.time()
+                if delay > 0:
+                    time.sleep(delay)
+                ts_now = time.time()
+                due = [i for (i, (ts_poll, _)) in pending.items() if ts_poll <= ts_now]
+                futures = [executor.submit(self._get_vm_operation_status, configs[i]) for i in due]
+                for (i, future) in zip(due, futures):
+                    try:
+                        (status, output, retry_after) = future.result()
+                    except Exception as ex:  # pylint: disable=broad-except
+                        _LOG.error("Failed to check the operation on VM: %s", configs[i].get("vmName"),
+                                   exc_info=True)
+                        del pending[i]
+                        results[i] = (Status.FAILED, {"error": str(ex)})
+                        continue
+                    if status == Status.RUNNING:
+                        interval = retry_after if retry_after is not None else \
+                            min(pending[i][1] * self._POLL_BACKOFF, self._POLL_MAX_INTERVAL)
+                        pending[i] = (time.time() + interval, interval)
+                        _LOG.debug("Operation on VM %s is running; next poll in %.1f s",
+                                   configs[i].get("vmName"), interval)
+                        continue
+                    del pending[i]
+                    if status.is_succeeded:
+                        output = output.get("properties", {}).get("output", {})
+                    _LOG.info("Operation on VM %s: %s", configs[i].get("vmName"), status)
+                    results[i] = (status, output)
+
+        for i in pending:
+            _LOG.warning("Request timed out: %s", configs[i].get("asyncResultsUrl"))
+            results[i] = (Status.TIMED_OUT, {})
+        return results
@@ -7,13 +7,16 @@ Protocol interface for Service types that provide helper functions to run
 scripts and commands locally on the scheduler side.
 """
 
-from typing import Iterable, Mapping, Optional, Tuple, Union, Protocol, runtime_checkable
+from typing import Iterable, Mapping, Optional, Tuple, Union, Protocol, runtime_checkable, TYPE_CHECKING
 
 import tempfile
 import contextlib
 
 from mlos_bench.tunables.tunable import TunableValue
 
+if TYPE_CHECKING:
+    from mlos_bench.services.local.local_exec import LocalProcess
+
 
 @runtime_checkable
 class SupportsLocalExec(Protocol):
@@ -52,6 +55,29 @@ class SupportsLocalExec(Protocol):
             A 3-tuple of return code, stdout, and stderr of the script process.
         """
 
+    def local_exec_start(self, script_lines: Iterable[str],
+                         env: Optional[Mapping[str, TunableValue]] = None,
+                         cwd: Optional[str] = None) -> "LocalProcess":
+        """
+        Start the script lines in a local process in the background, without waiting
+        for it to complete. The script stops on the first error.
+
+        Parameters
+        ----------
+        script_lines : Iterable[str]
+            Lines of the script to run locally.
+        env : Mapping[str, Union[int, float, str]]
+            Environment variables (optional).
+        cwd : str
+            Work directory to run the script at. The caller must keep it
+            until the process exits.
+
+        Returns
+        -------
+        process : LocalProcess
+            Handle to poll the process for completion, or to kill it.
+        """
+
     def temp_dir_context(self, path: Optional[str] = None) -> Union[tempfile.TemporaryDirectory, contextlib.nullcontext]:
         """
         Create a temp directory or use the provided path.
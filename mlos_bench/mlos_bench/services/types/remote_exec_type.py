@@ -7,7 +7,7 @@ Protocol interface for Service types that provide helper functions to run
 scripts on a remote host OS.
 """
 
-from typing import Iterable, Tuple, Protocol, runtime_checkable, TYPE_CHECKING
+from typing import Iterable, List, Sequence, Tuple, Protocol, runtime_checkable, TYPE_CHECKING
 
 if TYPE_CHECKING:
     from mlos_bench.environments.status import Status
@@ -61,3 +61,59 @@ class SupportsRemoteExec(Protocol):
             A pair of Status and result.
             Status is one of {PENDING, SUCCEEDED, FAILED, TIMED_OUT}
         """
+
+    def remote_exec_fleet(self, script: Iterable[str], configs: Sequence[dict],
+                          env_params: dict) -> List[Tuple["Status", dict]]:
+        """
+        Run the same command on several remote hosts concurrently.
+
+        Parameters
+        ----------
+        script : Iterable[str]
+            A list of lines to execute as a script on each remote host.
+        configs : Sequence[dict]
+            Parameters for each host, as in `remote_exec()`.
+        env_params : dict
+            Parameters to pass as *shell* environment variables into the script.
+
+        Returns
+        -------
+        results : List[(Status, dict)]
+            A pair of Status and result for each host, in the same order as `configs`.
+            Status is one of {PENDING, SUCCEEDED, FAILED}
+            A failure on one host does not affect the results of the others.
+        """
+
+    def get_remote_exec_fleet_results(self, configs: Sequence[dict]) -> List[Tuple["Status", dict]]:
+        """
+        Wait for the results of several asynchronously running commands.
+
+        Parameters
+        ----------
+        configs : Sequence[dict]
+            The results of `remote_exec_fleet()` (or `remote_exec()`).
+
+        Returns
+        -------
+        results : List[(Status, dict)]
+            A pair of Status and result for each command, in the same order as `configs`.
+            Status is one of {PENDING, SUCCEEDED, FAILED, TIMED_OUT}
+        """
+
+    def poll_remote_exec_results(self, config: dict) -> Tuple["Status", dict]:
+        """
+        Check the status of the asynchronously running command once, without waiting.
+
+        Parameters
+        ----------
+        config : dict
+            Flat dictionary of (key, value) pairs of tunable parameters.
+            Must have the "asyncResultsUrl" key to get the results.
+            If the key is not present, return Status.PENDING.
+
+        Returns
+        -------
+        result : (Status, dict)
+            A pair of Status and result.
+            Status is one of {PENDING, RUNNING, SUCCEEDED, FAILED}
+        """
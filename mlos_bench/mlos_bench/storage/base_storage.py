@@ -8,11 +8,15 @@ Base interface for saving and restoring the benchmark data.
 
 import logging
 from abc import ABCMeta, abstractmethod
+from datetime import datetime
 
 from types import TracebackType
-from typing import Optional, Union, List, Tuple, Dict, Iterator, Type, Any
+from typing import Optional, Union, List, Tuple, Dict, Iterable, Iterator, Sequence, Type, Any
 from typing_extensions import Literal
 
+import numpy as np
+import pandas as pd
+
 from mlos_bench.environments.status import Status
 from mlos_bench.services.base_service import Service
 from mlos_bench.tunables.tunable_groups import TunableGroups
@@ -21,6 +25,14 @@ from mlos_bench.util import get_git_info
 _LOG = logging.getLogger(__name__)
 
 
+class TrialLeaseLostError(RuntimeError):
+    """
+    Raised when a worker updates the trial that another worker has taken over
+    in the coordinated mode, e.g., after the worker's lease on it has expired.
+    The worker should drop the trial and move on.
+    """
+
+
 class Storage(metaclass=ABCMeta):
     # pylint: disable=too-few-public-methods,too-many-instance-attributes
     """
@@ -46,19 +58,28 @@ class Storage(metaclass=ABCMeta):
         self._service = service
         self._config = config.copy()
 
+    @property
+    def worker_id(self) -> Optional[str]:
+        """
+        ID of this worker if the storage is shared with other workers (see
+        `Storage.Experiment.is_coordinated`), None otherwise. Base implementation is not shared.
+        """
+        return None
+
     @abstractmethod
     def experiment(self, *,
                    experiment_id: str,
                    trial_id: int,
                    root_env_config: str,
                    description: str,
-                   opt_target: str) -> 'Storage.Experiment':
+                   opt_target: str,
+                   opt_targets: Optional[Dict[str, str]] = None) -> 'Storage.Experiment':
         """
         Create a new experiment in the storage.
 
         We need the `opt_target` parameter here to know what metric to retrieve
-        when we load the data from previous trials. Later we will replace it with
-        full metadata about the optimization direction, multiple objectives, etc.
+        when we load the data from previous trials, and the `opt_targets`
+        to compute the Pareto front of a multi-objective optimization.
 
         Parameters
         ----------
@@ -72,6 +93,10 @@ class Storage(metaclass=ABCMeta):
             Human-readable description of the experiment.
         opt_target : str
             Name of metric we're optimizing for.
+            For multi-objective optimization, the name of the primary target.
+        opt_targets : Optional[Dict[str, str]]
+            Names of all the metrics we're optimizing for and the direction
+            of each ("min" or "max"). Default is to minimize `opt_target`.
 
         Returns
         -------
@@ -122,6 +147,14 @@ class Storage(metaclass=ABCMeta):
         def __repr__(self) -> str:
             return self._experiment_id
 
+        @property
+        def is_coordinated(self) -> bool:
+            """
+            True if several workers share this experiment, i.e., claim its pending trials
+            and add new trials concurrently. Base implementation is not coordinated.
+            """
+            return False
+
         def _setup(self) -> None:
             """
             Create a record of the new experiment or find an existing one in the storage.
@@ -146,6 +179,8 @@ class Storage(metaclass=ABCMeta):
             """
             Merge in the results of other (compatible) experiments trials.
             Used to help warm up the optimizer for this experiment.
+            The data of the merged-in experiments is returned by `.load()`
+            and `.load_merged_data()` calls afterwards.
 
             Parameters
             ----------
@@ -161,10 +196,216 @@ class Storage(metaclass=ABCMeta):
             to impute the missing tunable values.
             """
 
+        def load_data(self, opt_target: Optional[str] = None,
+                      include_merged: bool = True,
+                      after_trial_id: Optional[int] = None) -> Tuple[pd.DataFrame, pd.Series]:
+            """
+            Load the same data as `.load()`, but in the columnar format
+            that can be passed to `Optimizer.bulk_register_data()` directly.
+            Base implementation just converts the output of `.load()`;
+            storage backends should override it if they can do better.
+
+            Parameters
+            ----------
+            opt_target : Optional[str]
+                Name of the metric to load. Default is the target of the experiment.
+            include_merged : bool
+                If True (the default), also return the data of the merged-in experiments.
+                Backends that support `.merge()` must override this method.
+            after_trial_id : Optional[int]
+                If specified, return only the trials of this experiment with the greater IDs,
+                e.g., the ones that are not in the optimizer checkpoint yet.
+                Backends that support `.save_checkpoint()` must override this method.
+
+            Returns
+            -------
+            (configs, scores) : (pd.DataFrame, pd.Series)
+                Tunable values (one column per tunable, one row per trial)
+                and the corresponding benchmark scores.
+            """
+            # pylint: disable=unused-argument
+            if after_trial_id is not None:
+                raise NotImplementedError(f"{self.__class__.__name__} cannot load the trials by ID")
+            (configs, scores) = self.load(opt_target)
+            return (pd.DataFrame(configs), pd.Series(scores, dtype=float))
+
+        def load_configs(self) -> pd.DataFrame:
+            """
+            Load the distinct configs of all trials of this experiment, regardless of
+            their status (but without the merged-in experiments), e.g., to skip the
+            configs that have been tried already. Base implementation returns the configs
+            of the successful trials only.
+
+            Returns
+            -------
+            configs : pd.DataFrame
+                Tunable values, one column per tunable, one row per config.
+            """
+            (configs, _scores) = self.load_data(include_merged=False)
+            return configs.drop_duplicates().reset_index(drop=True)
+
+        def load_merged_data(self, opt_target: Optional[str] = None) -> Tuple[pd.DataFrame, pd.Series]:
+            """
+            Load the data of the merged-in experiments only, in the same format
+            as `.load_data()`. The tunables missing in the merged-in experiments
+            are imputed with their default values.
+            Base implementation returns no data.
+
+            Returns
+            -------
+            (configs, scores) : (pd.DataFrame, pd.Series)
+                Tunable values (one column per tunable, one row per trial)
+                and the corresponding benchmark scores.
+            """
+            # pylint: disable=unused-argument
+            return (pd.DataFrame(), pd.Series(dtype=float))
+
+        def load_targets(self, opt_targets: Sequence[str],
+                         include_merged: bool = True,
+                         after_trial_id: Optional[int] = None) -> Tuple[pd.DataFrame, pd.DataFrame]:
+            """
+            Load the same data as `.load_data()`, but with the scores of several targets,
+            e.g., to warm-up a multi-objective optimizer.
+            Only the trials that have the results for all targets are returned.
+            Base implementation supports a single target only;
+            storage backends should override it.
+
+            Parameters
+            ----------
+            opt_targets : Sequence[str]
+                Names of the metrics to load.
+            include_merged : bool
+                If True (the default), also return the data of the merged-in experiments.
+            after_trial_id : Optional[int]
+                If specified, return only the trials of this experiment with the greater IDs.
+
+            Returns
+            -------
+            (configs, scores) : (pd.DataFrame, pd.DataFrame)
+                Tunable values (one column per tunable, one row per trial)
+                and the corresponding benchmark scores (one column per target).
+            """
+            if len(opt_targets) != 1:
+                raise NotImplementedError(f"{self.__class__.__name__} cannot load multiple targets")
+            (configs, scores) = self.load_data(opt_targets[0], include_merged, after_trial_id)
+            return (configs, scores.to_frame(opt_targets[0]))
+
+        def load_merged_targets(self, opt_targets: Sequence[str]) -> Tuple[pd.DataFrame, pd.DataFrame]:
+            """
+            Load the data of the merged-in experiments only, in the same format
+            as `.load_targets()`. Base implementation returns no data.
+            """
+            return (pd.DataFrame(), pd.DataFrame(columns=list(opt_targets), dtype=float))
+
+        def save_checkpoint(self, checkpoint: bytes, trial_id: int) -> None:
+            """
+            Save the snapshot of the optimizer state (see `Optimizer.checkpoint()`),
+            replacing the previous one. Base implementation does not keep the checkpoints.
+
+            Parameters
+            ----------
+            checkpoint : bytes
+                The optimizer state.
+            trial_id : int
+                ID of the last trial of this experiment registered with the optimizer.
+                All trials with the smaller IDs must be either registered, too, or still pending.
+            """
+            # pylint: disable=unused-argument
+            _LOG.debug("Experiment %s :: checkpoints are not supported", self)
+
+        def load_checkpoint(self) -> Optional[Tuple[bytes, int]]:
+            """
+            Load the latest snapshot of the optimizer state saved by `.save_checkpoint()`.
+
+            Returns
+            -------
+            (checkpoint, trial_id) : Optional[Tuple[bytes, int]]
+                The optimizer state and the ID of the last trial it includes;
+                pass the ID to `.load_data()` to get the newer trials.
+                None if there is no checkpoint.
+            """
+            return None
+
+        def load_updates(self, opt_targets: Sequence[str]) -> Tuple[pd.DataFrame, pd.DataFrame]:
+            """
+            Load the results of the successful trials that are new since the previous call
+            (the first call returns all of them), skipping the trials created or claimed by
+            this worker. In the coordinated mode, the workers use it to register with
+            their optimizers the results found by the others.
+            Base implementation returns no data.
+
+            Parameters
+            ----------
+            opt_targets : Sequence[str]
+                Names of the metrics to load.
+
+            Returns
+            -------
+            (configs, scores) : (pd.DataFrame, pd.DataFrame)
+                Same format as `.load_targets()`.
+            """
+            return (pd.DataFrame(), pd.DataFrame(columns=list(opt_targets), dtype=float))
+
+        @abstractmethod
+        def pareto_front(self, opt_targets: Optional[Dict[str, str]] = None) -> Tuple[pd.DataFrame, pd.DataFrame]:
+            """
+            Get the Pareto front of the experiment, i.e., the successful trials
+            that are not dominated by any other trial on all targets.
+            That is the multi-objective counterpart of the best observation.
+
+            Parameters
+            ----------
+            opt_targets : Optional[Dict[str, str]]
+                Names of the metrics and the direction of each ("min" or "max").
+                Default is the targets of the experiment.
+
+            Returns
+            -------
+            (configs, scores) : (pd.DataFrame, pd.DataFrame)
+                Tunable values and the corresponding benchmark scores (one column per target)
+                of the Pareto-optimal trials, indexed by the trial ID.
+            """
+
+        @staticmethod
+        def _pareto_mask(scores: pd.DataFrame, opt_targets: Dict[str, str]) -> pd.Series:
+            """
+            Find the non-dominated rows of the scores, given the direction of each target.
+            Quadratic in the number of rows, but vectorized over the columns.
+            """
+            signs = np.array([1.0 if opt_targets[name] == "min" else -1.0 for name in scores.columns])
+            costs = scores.to_numpy(dtype=float) * signs
+            mask = np.ones(len(costs), dtype=bool)
+            for (i, point) in enumerate(costs):
+                dominated = (costs <= point).all(axis=1) & (costs < point).any(axis=1)
+                mask[i] = not dominated.any()
+            return pd.Series(mask, index=scores.index)
+
+        def get_results(self, tunables: TunableGroups) -> List[Dict[str, Any]]:
+            """
+            Get the results of the successful trials of this experiment
+            that had the same tunable values. Backends are expected to answer
+            from memory, so it is cheap to call before every new trial.
+            Base implementation returns no results.
+
+            Parameters
+            ----------
+            tunables : TunableGroups
+                Tunable values of the configuration to look up.
+
+            Returns
+            -------
+            results : List[Dict[str, Any]]
+                Metrics of each successful trial of the configuration, oldest first.
+            """
+            # pylint: disable=unused-argument
+            return []
+
         @abstractmethod
         def pending_trials(self) -> Iterator['Storage.Trial']:
             """
             Return an iterator over the pending trial runs for this experiment.
+            In the coordinated mode, only the trials this worker has claimed are returned,
+            i.e., the ones abandoned by other workers or not leased to any worker.
             """
 
         @abstractmethod
@@ -267,9 +508,12 @@ class Storage(metaclass=ABCMeta):
 
         @abstractmethod
         def update_telemetry(self, status: Status,
-                             metrics: Optional[Dict[str, float]] = None) -> None:
+                             metrics: Optional[Dict[str, float]] = None,
+                             timestamp: Optional[datetime] = None) -> None:
             """
             Save the experiment's telemetry data and intermediate status.
+            The storage may buffer the telemetry, but it must be saved
+            before the final results of the trial (see `.update()`).
 
             Parameters
             ----------
@@ -277,5 +521,40 @@ class Storage(metaclass=ABCMeta):
                 Current status of the trial.
             metrics : Optional[Dict[str, float]]
                 Telemetry data.
+            timestamp : Optional[datetime]
+                The time when the telemetry sample has been collected.
+                Use current time if not specified.
+            """
+            _LOG.debug("Store telemetry: %s :: %s %s", self, status, metrics)
+
+        @abstractmethod
+        def append_telemetry(self, metrics: Dict[str, float],
+                             timestamp: Optional[datetime] = None) -> None:
+            """
+            Save more telemetry data of the trial without changing its status,
+            e.g., the timings of the trial phases collected after its final results.
+
+            Parameters
+            ----------
+            metrics : Dict[str, float]
+                Telemetry data.
+            timestamp : Optional[datetime]
+                The time when the telemetry sample has been collected.
+                Use current time if not specified.
+            """
+            _LOG.debug("Append telemetry: %s :: %s", self, metrics)
+
+        def append_telemetry_series(self, samples: Iterable[Tuple[datetime, Dict[str, float]]]) -> None:
+            """
+            Save the time series the environment has collected during the run
+            (see `Environment.telemetry()`) without changing the trial status.
+            Base implementation saves the samples one by one via `.append_telemetry()`;
+            the storages should override it to write the samples in batches.
+
+            Parameters
+            ----------
+            samples : Iterable[Tuple[datetime, Dict[str, float]]]
+                Pairs of (timestamp, metrics) values.
             """
-            _LOG.info("Store telemetry: %s :: %s %s", self, status, metrics)
+            for (timestamp, metrics) in samples:
+                self.append_telemetry(metrics, timestamp)
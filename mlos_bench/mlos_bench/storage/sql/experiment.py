@@ -7,19 +7,25 @@ Saving and restoring the benchmark data using SQLAlchemy.
 """
 
 import logging
-import hashlib
-from datetime import datetime
-from typing import Optional, Tuple, List, Dict, Iterator, Any
+import threading
+from datetime import datetime, timedelta
+from typing import Optional, Tuple, List, Dict, Iterator, Sequence, Set, Any
 
-from sqlalchemy import Engine, Connection, Table, column, func
+import pandas as pd
+from sqlalchemy import Engine, Connection, Row, Table, column, func, select
+from sqlalchemy.exc import IntegrityError
 
 from mlos_bench.tunables.tunable_groups import TunableGroups
 from mlos_bench.storage.base_storage import Storage
 from mlos_bench.storage.sql.schema import DbSchema
+from mlos_bench.storage.sql.telemetry_writer import TelemetryWriter
 from mlos_bench.storage.sql.trial import Trial
 
 _LOG = logging.getLogger(__name__)
 
+_NEW_TRIAL_ATTEMPTS = 10
+"""Max. number of attempts to allocate a trial ID concurrently with the other workers."""
+
 
 class Experiment(Storage.Experiment):
     """
@@ -29,21 +35,67 @@ class Experiment(Storage.Experiment):
     def __init__(self, *,
                  engine: Engine,
                  schema: DbSchema,
+                 telemetry: TelemetryWriter,
                  tunables: TunableGroups,
                  experiment_id: str,
                  trial_id: int,
                  root_env_config: str,
                  description: str,
-                 opt_target: str):
+                 opt_target: str,
+                 opt_targets: Optional[Dict[str, str]] = None,
+                 worker_id: Optional[str] = None,
+                 lease_duration: float = 300):
         super().__init__(tunables, experiment_id, root_env_config)
         self._engine = engine
         self._schema = schema
+        self._telemetry = telemetry
         self._trial_id = trial_id
         self._description = description
         self._opt_target = opt_target
+        self._opt_targets: Dict[str, str] = dict(opt_targets or {opt_target: "min"})
+        self._merged_ids: List[str] = []
+        # In-memory caches to look up the configs and results without DB round-trips.
+        # Config hash -> config_id, for the configs seen in this experiment.
+        self._config_ids: Dict[str, int] = {}
+        # config_id -> metrics of the successful trials of this experiment (shared with the trials).
+        self._results: Dict[int, List[Dict[str, Any]]] = {}
+        # Coordinated mode: ID of this worker (None if the experiment is not shared).
+        self._worker_id = worker_id
+        self._lease_duration = timedelta(seconds=lease_duration)
+        # IDs of the trials created or claimed by this worker, or returned by `.load_updates()`.
+        self._known_trial_ids: Set[int] = set()
+        self._updates_ts: Optional[datetime] = None
+        self._heartbeat_stop = threading.Event()
+        self._heartbeat_thread: Optional[threading.Thread] = None
+
+    @property
+    def is_coordinated(self) -> bool:
+        return self._worker_id is not None
 
     def _setup(self) -> None:
         super()._setup()
+        try:
+            self._setup_experiment()
+        except IntegrityError:
+            if not self.is_coordinated:
+                raise
+            # Another worker has created the same experiment concurrently.
+            _LOG.info("Experiment %s created by another worker", self._experiment_id)
+            self._setup_experiment()
+        if self.is_coordinated:
+            # In-memory SQLite DB is private to the thread that created it (and to the process).
+            is_memory_db = self._engine.dialect.name == "sqlite" and \
+                self._engine.url.database in {None, "", ":memory:"}
+            if not is_memory_db:
+                self._heartbeat_stop.clear()
+                self._heartbeat_thread = threading.Thread(
+                    target=self._run_heartbeat, name="mlos_bench_heartbeat", daemon=True)
+                self._heartbeat_thread.start()
+
+    def _setup_experiment(self) -> None:
+        """
+        Create a new experiment record in the DB or resume the existing one.
+        """
         with self._engine.begin() as conn:
             # Get git info and the last trial ID for the experiment.
             # pylint: disable=not-callable
@@ -83,39 +135,330 @@ class Experiment(Storage.Experiment):
                 if exp_info.git_commit != self._git_commit:
                     _LOG.warning("Experiment %s git expected: %s %s",
                                  self, exp_info.git_repo, exp_info.git_commit)
+                self._load_results_cache(conn)
+
+    def _load_results_cache(self, conn: Connection) -> None:
+        """
+        Populate the in-memory caches with the results of the successful trials
+        of the experiment (in one query).
+        """
+        cur_results = conn.execute(
+            self._schema.trial.select().with_only_columns(
+                self._schema.trial.c.trial_id,
+                self._schema.trial.c.config_id,
+                self._schema.config.c.config_hash,
+                self._schema.trial_result.c.metric_id,
+                self._schema.trial_result.c.metric_num,
+                self._schema.trial_result.c.metric_value,
+            ).join(
+                self._schema.config,
+                self._schema.config.c.config_id == self._schema.trial.c.config_id
+            ).join(
+                self._schema.trial_result, (
+                    (self._schema.trial.c.exp_id == self._schema.trial_result.c.exp_id) &
+                    (self._schema.trial.c.trial_id == self._schema.trial_result.c.trial_id)
+                )
+            ).where(
+                self._schema.trial.c.exp_id == self._experiment_id,
+                self._schema.trial.c.status == 'SUCCEEDED',
+            ).order_by(
+                self._schema.trial.c.trial_id.asc(),
+            )
+        )
+        trial_results: Dict[int, Dict[str, Any]] = {}
+        for row in cur_results.fetchall():
+            self._config_ids[row.config_hash] = row.config_id
+            metrics = trial_results.get(row.trial_id)
+            if metrics is None:
+                metrics = trial_results[row.trial_id] = {}
+                self._results.setdefault(row.config_id, []).append(metrics)
+            metrics[row.metric_id] = row.metric_value if row.metric_num is None else row.metric_num
+        _LOG.debug("Cached results of %d trials for %d configs",
+                   len(trial_results), len(self._results))
+
+    def _teardown(self, is_ok: bool) -> None:
+        if self._heartbeat_thread is not None:
+            self._heartbeat_stop.set()
+            self._heartbeat_thread.join()
+            self._heartbeat_thread = None
+        self._telemetry.close()
+        super()._teardown(is_ok)
+
+    def _run_heartbeat(self) -> None:
+        """
+        Background thread: renew the leases of the trials of this worker
+        three times per lease period.
+        """
+        while not self._heartbeat_stop.wait(self._lease_duration.total_seconds() / 3):
+            try:
+                self.heartbeat()
+            except Exception:   # pylint: disable=broad-except
+                _LOG.exception("Failed to renew the trial leases of: %s", self._worker_id)
+
+    def heartbeat(self) -> int:
+        """
+        Renew the leases of all unfinished trials of this worker (coordinated mode only).
+
+        Returns
+        -------
+        count : int
+            Number of trials with the renewed leases.
+        """
+        if self._worker_id is None:
+            return 0
+        with self._engine.begin() as conn:
+            cur_trials = conn.execute(
+                self._schema.trial.update().where(
+                    self._schema.trial.c.exp_id == self._experiment_id,
+                    self._schema.trial.c.worker_id == self._worker_id,
+                    self._schema.trial.c.ts_end.is_(None),
+                ).values(
+                    ts_lease=datetime.now() + self._lease_duration,
+                )
+            )
+        _LOG.debug("Worker %s renewed %d leases", self._worker_id, cur_trials.rowcount)
+        return int(cur_trials.rowcount)
 
     def merge(self, experiment_ids: List[str]) -> None:
         _LOG.info("Merge: %s <- %s", self._experiment_id, experiment_ids)
-        raise NotImplementedError()
+        experiment_ids = [exp_id for exp_id in experiment_ids
+                          if exp_id != self._experiment_id and exp_id not in self._merged_ids]
+        if not experiment_ids:
+            return
+        with self._engine.connect() as conn:
+            cur_exp = conn.execute(
+                self._schema.experiment.select().with_only_columns(
+                    self._schema.experiment.c.exp_id,
+                    self._schema.experiment.c.root_env_config,
+                ).where(
+                    self._schema.experiment.c.exp_id.in_(experiment_ids),
+                )
+            )
+            root_env_configs = {row.exp_id: row.root_env_config for row in cur_exp.fetchall()}
+        missing_ids = [exp_id for exp_id in experiment_ids if exp_id not in root_env_configs]
+        if missing_ids:
+            raise ValueError(f"Cannot merge in unknown experiments: {missing_ids}")
+        for exp_id in experiment_ids:
+            if root_env_configs[exp_id] != self._root_env_config:
+                _LOG.warning("Merge experiment %s with a different root config: %s",
+                             exp_id, root_env_configs[exp_id])
+            self._merged_ids.append(exp_id)
+
+    def _load_results(self, conn: Connection, opt_targets: Sequence[str],
+                      experiment_ids: List[str], *conditions: Any) -> List[Row]:
+        """
+        Get the scores and the tunable values of all successful trials of the given
+        experiments in one query. Returns one row per (experiment, trial, target, tunable) tuple,
+        ordered by experiment and trial ID. Extra `conditions` on the trials are optional.
+        """
+        if not experiment_ids:
+            return []
+        return list(conn.execute(
+            self._schema.trial.select().with_only_columns(
+                self._schema.trial.c.exp_id,
+                self._schema.trial.c.trial_id,
+                self._schema.trial_result.c.metric_id,
+                self._schema.trial_result.c.metric_num,
+                self._schema.config_param.c.param_id,
+                self._schema.config_param.c.param_value,
+            ).join(
+                self._schema.trial_result, (
+                    (self._schema.trial.c.exp_id == self._schema.trial_result.c.exp_id) &
+                    (self._schema.trial.c.trial_id == self._schema.trial_result.c.trial_id)
+                )
+            ).join(
+                self._schema.config_param,
+                self._schema.config_param.c.config_id == self._schema.trial.c.config_id,
+                isouter=True
+            ).where(
+                self._schema.trial.c.status == 'SUCCEEDED',
+                self._schema.trial.c.exp_id.in_(experiment_ids),
+                self._schema.trial_result.c.metric_id.in_(opt_targets),
+                self._schema.trial_result.c.metric_num.isnot(None),
+                *conditions,
+            ).order_by(
+                self._schema.trial.c.exp_id.asc(),
+                self._schema.trial.c.trial_id.asc(),
+            )
+        ).fetchall())
 
     def load(self, opt_target: Optional[str] = None) -> Tuple[List[dict], List[float]]:
-        configs = []
-        scores = []
+        configs: List[dict] = []
+        scores: List[float] = []
         with self._engine.connect() as conn:
-            cur_trials = conn.execute(
-                self._schema.trial.select().with_only_columns(
-                    self._schema.trial.c.trial_id,
-                    self._schema.trial.c.config_id,
-                    self._schema.trial_result.c.metric_value,
-                ).join(
-                    self._schema.trial_result, (
-                        (self._schema.trial.c.exp_id == self._schema.trial_result.c.exp_id) &
-                        (self._schema.trial.c.trial_id == self._schema.trial_result.c.trial_id)
+            last_trial_key = None
+            for row in self._load_results(conn, [opt_target or self._opt_target],
+                                          [self._experiment_id] + self._merged_ids):
+                if (row.exp_id, row.trial_id) != last_trial_key:
+                    last_trial_key = (row.exp_id, row.trial_id)
+                    configs.append({})
+                    scores.append(float(row.metric_num))
+                if row.param_id is not None:
+                    configs[-1][row.param_id] = row.param_value
+        # Impute the tunables missing in the merged-in experiments with their defaults.
+        defaults = self._tunable_defaults()
+        configs = [
+            {key: config.get(key, val) for (key, val) in defaults.items()}
+            for config in configs
+        ]
+        return (configs, scores)
+
+    def load_data(self, opt_target: Optional[str] = None,
+                  include_merged: bool = True,
+                  after_trial_id: Optional[int] = None) -> Tuple[pd.DataFrame, pd.Series]:
+        experiment_ids = [self._experiment_id]
+        if include_merged:
+            experiment_ids += self._merged_ids
+        return self._load_data(opt_target, experiment_ids, *self._after_trial(after_trial_id))
+
+    def load_configs(self) -> pd.DataFrame:
+        with self._engine.connect() as conn:
+            cur_params = conn.execute(
+                self._schema.config_param.select().where(
+                    self._schema.config_param.c.config_id.in_(
+                        select(self._schema.trial.c.config_id).where(
+                            self._schema.trial.c.exp_id == self._experiment_id)
                     )
-                ).where(
-                    self._schema.trial.c.status == 'SUCCEEDED',
-                    self._schema.trial.c.exp_id == self._experiment_id,
-                    self._schema.trial_result.c.metric_id == (opt_target or self._opt_target),
-                ).order_by(
-                    self._schema.trial.c.trial_id.asc(),
                 )
             )
-            for trial in cur_trials.fetchall():
-                tunables = self._get_params(
-                    conn, self._schema.config_param, config_id=trial.config_id)
-                configs.append(tunables)
-                scores.append(float(trial.metric_value))
+            df_params = pd.DataFrame(
+                [(row.config_id, row.param_id, row.param_value) for row in cur_params.fetchall()],
+                columns=["config_id", "param_id", "param_value"])
+        if df_params.empty:
+            return pd.DataFrame()
+        configs = df_params.pivot(index="config_id", columns="param_id", values="param_value")
+        configs.columns.name = None
+        return configs.reset_index(drop=True)
+
+    def load_merged_data(self, opt_target: Optional[str] = None) -> Tuple[pd.DataFrame, pd.Series]:
+        return self._load_data(opt_target, self._merged_ids)
+
+    def load_targets(self, opt_targets: Sequence[str],
+                     include_merged: bool = True,
+                     after_trial_id: Optional[int] = None) -> Tuple[pd.DataFrame, pd.DataFrame]:
+        experiment_ids = [self._experiment_id]
+        if include_merged:
+            experiment_ids += self._merged_ids
+        (configs, scores) = self._load_targets(opt_targets, experiment_ids, *self._after_trial(after_trial_id))
+        return (configs.reset_index(drop=True), scores.reset_index(drop=True))
+
+    def _after_trial(self, after_trial_id: Optional[int]) -> List[Any]:
+        """
+        SQL conditions to load only the trials of this experiment after the given one
+        (and all trials of the merged-in experiments).
+        """
+        if after_trial_id is None:
+            return []
+        return [
+            (self._schema.trial.c.exp_id != self._experiment_id) |
+            (self._schema.trial.c.trial_id > after_trial_id)
+        ]
+
+    def save_checkpoint(self, checkpoint: bytes, trial_id: int) -> None:
+        _LOG.info("Save optimizer checkpoint: %s:%d (%d bytes)", self._experiment_id, trial_id, len(checkpoint))
+        with self._engine.begin() as conn:
+            conn.execute(self._schema.optimizer_checkpoint.delete().where(
+                self._schema.optimizer_checkpoint.c.exp_id == self._experiment_id,
+            ))
+            conn.execute(self._schema.optimizer_checkpoint.insert().values(
+                exp_id=self._experiment_id,
+                trial_id=trial_id,
+                ts=datetime.now(),
+                checkpoint=checkpoint,
+            ))
+
+    def load_checkpoint(self) -> Optional[Tuple[bytes, int]]:
+        with self._engine.connect() as conn:
+            row = conn.execute(
+                self._schema.optimizer_checkpoint.select().where(
+                    self._schema.optimizer_checkpoint.c.exp_id == self._experiment_id,
+                ).order_by(
+                    self._schema.optimizer_checkpoint.c.trial_id.desc(),
+                ).limit(1)
+            ).fetchone()
+        if row is None:
+            return None
+        _LOG.info("Load optimizer checkpoint: %s:%d", self._experiment_id, row.trial_id)
+        return (bytes(row.checkpoint), int(row.trial_id))
+
+    def load_merged_targets(self, opt_targets: Sequence[str]) -> Tuple[pd.DataFrame, pd.DataFrame]:
+        (configs, scores) = self._load_targets(opt_targets, self._merged_ids)
+        return (configs.reset_index(drop=True), scores.reset_index(drop=True))
+
+    def pareto_front(self, opt_targets: Optional[Dict[str, str]] = None) -> Tuple[pd.DataFrame, pd.DataFrame]:
+        opt_targets = opt_targets or self._opt_targets
+        (configs, scores) = self._load_targets(list(opt_targets), [self._experiment_id])
+        if scores.empty:
+            return (configs, scores)
+        mask = self._pareto_mask(scores, opt_targets)
+        return (configs[mask].droplevel("exp_id"), scores[mask].droplevel("exp_id"))
+
+    def _load_data(self, opt_target: Optional[str],
+                   experiment_ids: List[str], *conditions: Any) -> Tuple[pd.DataFrame, pd.Series]:
+        """
+        Load the results of the given experiments in the columnar format.
+        The tunables missing in some experiments are imputed with their default values,
+        and the parameters that are not among the tunables of this experiment are dropped.
+        """
+        opt_target = opt_target or self._opt_target
+        (configs, scores) = self._load_targets([opt_target], experiment_ids, *conditions)
+        if scores.empty:
+            return (pd.DataFrame(), pd.Series(dtype=float))
+        return (configs.reset_index(drop=True), scores[opt_target].reset_index(drop=True))
+
+    def load_updates(self, opt_targets: Sequence[str]) -> Tuple[pd.DataFrame, pd.DataFrame]:
+        update_ts = datetime.now()
+        conditions = []
+        if self._updates_ts is not None:
+            # The trials are finished by the clocks of other workers:
+            # allow for the clock skew (much less than the lease duration).
+            conditions.append(self._schema.trial.c.ts_end >= self._updates_ts - self._lease_duration)
+        (configs, scores) = self._load_targets(opt_targets, [self._experiment_id], *conditions)
+        self._updates_ts = update_ts
+        if scores.empty:
             return (configs, scores)
+        trial_ids = scores.index.get_level_values("trial_id")
+        is_new = ~trial_ids.isin(list(self._known_trial_ids))
+        self._known_trial_ids.update(int(trial_id) for trial_id in trial_ids[is_new])
+        _LOG.debug("Loaded the results of %d new trials", is_new.sum())
+        return (configs[is_new].reset_index(drop=True), scores[is_new].reset_index(drop=True))
+
+    def _load_targets(self, opt_targets: Sequence[str],
+                      experiment_ids: List[str], *conditions: Any) -> Tuple[pd.DataFrame, pd.DataFrame]:
+        """
+        Load the results of the given experiments for the given targets in the columnar format,
+        indexed by (experiment ID, trial ID). Only the trials with the results for all targets are returned.
+        The tunables missing in some experiments are imputed with their default values,
+        and the parameters that are not among the tunables of this experiment are dropped.
+        """
+        with self._engine.connect() as conn:
+            df_results = pd.DataFrame(
+                self._load_results(conn, opt_targets, experiment_ids, *conditions),
+                columns=["exp_id", "trial_id", "metric_id", "metric_num", "param_id", "param_value"])
+        if df_results.empty:
+            return (pd.DataFrame(), pd.DataFrame(columns=list(opt_targets), dtype=float))
+        # Pivot the (trial, target) pairs into one row per trial and one column per target.
+        trial_key = ["exp_id", "trial_id"]
+        scores = df_results.groupby(trial_key + ["metric_id"])["metric_num"].first().unstack("metric_id")
+        scores = scores.reindex(columns=list(opt_targets)).dropna().astype(float)
+        scores.columns.name = None
+        # Pivot the (trial, tunable) pairs into one row per trial and one column per tunable.
+        df_params = df_results[df_results["param_id"].notna()].drop_duplicates(subset=trial_key + ["param_id"])
+        configs = df_params.pivot(index=trial_key, columns="param_id", values="param_value")
+        configs = configs.reindex(index=scores.index)
+        defaults = self._tunable_defaults()
+        configs = configs.reindex(columns=list(defaults))
+        # Impute the tunables missing in the merged-in experiments with their defaults.
+        for (key, val) in defaults.items():
+            configs[key] = configs[key].where(configs[key].notna(), val)
+        configs.columns.name = None
+        return (configs, scores)
+
+    def _tunable_defaults(self) -> Dict[str, Any]:
+        """
+        Get the default values of the tunables of this experiment.
+        """
+        return {tunable.name: tunable.default for (tunable, _group) in self._tunables}
 
     @staticmethod
     def _get_params(conn: Connection, table: Table, **kwargs: Any) -> Dict[str, Any]:
@@ -135,81 +478,208 @@ class Experiment(Storage.Experiment):
             for (key, val) in params.items()
         ])
 
+    def _is_claimable(self, timestamp: datetime) -> Any:
+        """
+        SQL condition for the unfinished trials that this worker can claim:
+        the ones without a lease (e.g., created in the non-coordinated mode),
+        with an expired lease, or leased by this worker in its previous run.
+        """
+        return (
+            (self._schema.trial.c.exp_id == self._experiment_id) &
+            self._schema.trial.c.ts_end.is_(None) & (
+                self._schema.trial.c.worker_id.is_(None) |
+                (self._schema.trial.c.ts_lease < timestamp) |
+                (self._schema.trial.c.worker_id == self._worker_id)
+            )
+        )
+
+    def _claim(self, trial_id: int) -> bool:
+        """
+        Take over the lease of the unfinished trial, unless another worker has done it first.
+        The conditional update makes the claim atomic in all DB engines
+        (not only in the ones that support `SELECT ... FOR UPDATE SKIP LOCKED`).
+        """
+        timestamp = datetime.now()
+        with self._engine.begin() as conn:
+            cur_trial = conn.execute(
+                self._schema.trial.update().where(
+                    self._is_claimable(timestamp),
+                    self._schema.trial.c.trial_id == trial_id,
+                ).values(
+                    worker_id=self._worker_id,
+                    ts_lease=timestamp + self._lease_duration,
+                )
+            )
+        return bool(cur_trial.rowcount == 1)
+
     def pending_trials(self) -> Iterator[Storage.Trial]:
         _LOG.info("Retrieve pending trials for: %s", self._experiment_id)
         with self._engine.connect() as conn:
-            cur_trials = conn.execute(self._schema.trial.select().where(
-                self._schema.trial.c.exp_id == self._experiment_id,
-                self._schema.trial.c.ts_end.is_(None)
-            ))
-            for trial in cur_trials.fetchall():
-                tunables = self._get_params(
-                    conn, self._schema.config_param,
-                    config_id=trial.config_id)
-                config = self._get_params(
-                    conn, self._schema.trial_param,
-                    exp_id=self._experiment_id, trial_id=trial.trial_id)
-                yield Trial(
-                    engine=self._engine,
-                    schema=self._schema,
-                    # Reset .is_updated flag after the assignment:
-                    tunables=self._tunables.copy().assign(tunables).reset(),
-                    experiment_id=self._experiment_id,
-                    trial_id=trial.trial_id,
-                    config_id=trial.config_id,
-                    opt_target=self._opt_target,
-                    config=config,
+            if self._worker_id is None:
+                is_pending = (
+                    (self._schema.trial.c.exp_id == self._experiment_id) &
+                    self._schema.trial.c.ts_end.is_(None)
                 )
+            else:
+                is_pending = self._is_claimable(datetime.now())
+            cur_trials = conn.execute(self._schema.trial.select().where(is_pending))
+            trials = cur_trials.fetchall()
+            if not trials:
+                return
+            # Load the tunables and the trial parameters of ALL pending trials
+            # in two queries instead of two queries per trial.
+            tunables: Dict[int, Dict[str, Any]] = {}
+            cur_params = conn.execute(
+                self._schema.config_param.select().join(
+                    self._schema.trial,
+                    self._schema.trial.c.config_id == self._schema.config_param.c.config_id
+                ).where(is_pending).distinct()
+            )
+            for row in cur_params.fetchall():
+                tunables.setdefault(row.config_id, {})[row.param_id] = row.param_value
+            configs: Dict[int, Dict[str, Any]] = {}
+            cur_params = conn.execute(
+                self._schema.trial_param.select().join(
+                    self._schema.trial, (
+                        (self._schema.trial.c.exp_id == self._schema.trial_param.c.exp_id) &
+                        (self._schema.trial.c.trial_id == self._schema.trial_param.c.trial_id)
+                    )
+                ).where(is_pending)
+            )
+            for row in cur_params.fetchall():
+                configs.setdefault(row.trial_id, {})[row.param_id] = row.param_value
+        for trial in trials:
+            # Claim the trials one at a time, right before running them,
+            # so that the other workers can take the rest.
+            # Skip the trials this worker is running already.
+            if self._worker_id is not None:
+                if trial.trial_id in self._known_trial_ids or not self._claim(trial.trial_id):
+                    continue
+                _LOG.info("Worker %s claimed trial: %s:%d",
+                          self._worker_id, self._experiment_id, trial.trial_id)
+                self._known_trial_ids.add(trial.trial_id)
+            yield Trial(
+                engine=self._engine,
+                schema=self._schema,
+                telemetry=self._telemetry,
+                # Reset .is_updated flag after the assignment:
+                tunables=self._tunables.copy().assign(tunables.get(trial.config_id, {})).reset(),
+                experiment_id=self._experiment_id,
+                trial_id=trial.trial_id,
+                config_id=trial.config_id,
+                opt_target=self._opt_target,
+                config=configs.get(trial.trial_id, {}),
+                results_cache=self._results,
+                worker_id=self._worker_id,
+            )
+
+    @staticmethod
+    def _config_hash(tunables: TunableGroups) -> str:
+        """
+        Get the hash of the tunable values to identify the config in the `config` table.
+        """
+        return tunables.get_values_hash()
 
     def _get_config_id(self, conn: Connection, tunables: TunableGroups) -> int:
         """
         Get the config ID for the given tunables. If the config does not exist,
         create a new record for it.
         """
-        config_hash = hashlib.sha256(str(tunables).encode('utf-8')).hexdigest()
+        config_hash = self._config_hash(tunables)
+        config_id = self._config_ids.get(config_hash)
+        if config_id is not None:
+            return config_id
         cur_config = conn.execute(self._schema.config.select().where(
             self._schema.config.c.config_hash == config_hash
         )).fetchone()
         if cur_config is not None:
-            return int(cur_config.config_id)  # mypy doesn't know it's always int
-        # Config not found, create a new one:
-        config_id: int = conn.execute(self._schema.config.insert().values(
-            config_hash=config_hash)).inserted_primary_key[0]
-        self._save_params(
-            conn, self._schema.config_param,
-            {tunable.name: tunable.value for (tunable, _group) in tunables},
-            config_id=config_id)
+            config_id = int(cur_config.config_id)  # mypy doesn't know it's always int
+        else:
+            # Config not found, create a new one:
+            config_id = int(conn.execute(self._schema.config.insert().values(
+                config_hash=config_hash)).inserted_primary_key[0])
+            self._save_params(
+                conn, self._schema.config_param,
+                {tunable.name: tunable.value for (tunable, _group) in tunables},
+                config_id=config_id)
+        self._config_ids[config_hash] = config_id
         return config_id
 
+    def get_results(self, tunables: TunableGroups) -> List[Dict[str, Any]]:
+        config_id = self._config_ids.get(self._config_hash(tunables))
+        if config_id is None:
+            return []
+        return list(self._results.get(config_id, []))
+
     def new_trial(self, tunables: TunableGroups,
                   config: Optional[Dict[str, Any]] = None) -> Storage.Trial:
-        _LOG.debug("Create trial: %s:%d", self._experiment_id, self._trial_id)
+        if self._worker_id is None:
+            return self._new_trial(tunables, config)
+        # In the coordinated mode, another worker might take the same trial ID first.
+        attempt = 1
+        while True:
+            try:
+                return self._new_trial(tunables, config)
+            except IntegrityError:
+                if attempt >= _NEW_TRIAL_ATTEMPTS:
+                    raise
+                attempt += 1
+                _LOG.info("Trial ID %s:%d is taken by another worker; retry",
+                          self._experiment_id, self._trial_id)
+
+    def _new_trial(self, tunables: TunableGroups, config: Optional[Dict[str, Any]]) -> Storage.Trial:
+        """
+        Create a new trial record in the DB. In the coordinated mode, allocate
+        the next trial ID in the same transaction and lease the trial to this worker.
+        """
         with self._engine.begin() as conn:
             try:
+                timestamp = datetime.now()
+                trial_id = self._trial_id
+                if self._worker_id is not None:
+                    # pylint: disable=not-callable
+                    last_trial_id = conn.execute(
+                        self._schema.trial.select().with_only_columns(
+                            func.max(self._schema.trial.c.trial_id),
+                        ).where(
+                            self._schema.trial.c.exp_id == self._experiment_id,
+                        )
+                    ).scalar()
+                    if last_trial_id is not None:
+                        trial_id = max(trial_id, last_trial_id + 1)
+                _LOG.debug("Create trial: %s:%d", self._experiment_id, trial_id)
                 config_id = self._get_config_id(conn, tunables)
                 conn.execute(self._schema.trial.insert().values(
                     exp_id=self._experiment_id,
-                    trial_id=self._trial_id,
+                    trial_id=trial_id,
                     config_id=config_id,
-                    ts_start=datetime.now(),
+                    ts_start=timestamp,
                     status='PENDING',
+                    worker_id=self._worker_id,
+                    ts_lease=None if self._worker_id is None else timestamp + self._lease_duration,
                 ))
                 if config is not None:
                     self._save_params(
                         conn, self._schema.trial_param, config,
-                        exp_id=self._experiment_id, trial_id=self._trial_id)
+                        exp_id=self._experiment_id, trial_id=trial_id)
                 trial = Trial(
                     engine=self._engine,
                     schema=self._schema,
+                    telemetry=self._telemetry,
                     tunables=tunables,
                     experiment_id=self._experiment_id,
-                    trial_id=self._trial_id,
+                    trial_id=trial_id,
                     config_id=config_id,
                     opt_target=self._opt_target,
                     config=config,
+                    results_cache=self._results,
+                    worker_id=self._worker_id,
                 )
-                self._trial_id += 1
+                self._trial_id = trial_id + 1
+                self._known_trial_ids.add(trial_id)
                 return trial
             except Exception:
                 conn.rollback()
+                # The config record might have been rolled back, too.
+                self._config_ids.pop(self._config_hash(tunables), None)
                 raise
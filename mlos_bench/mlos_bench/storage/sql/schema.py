@@ -7,13 +7,16 @@ DB schema definition.
 """
 
 import logging
-from typing import List, Any
+import math
+from contextlib import contextmanager
+from typing import Dict, Iterator, List, Any, Optional, Set, Tuple
 
 from sqlalchemy import (
-    Engine, MetaData, Dialect, create_mock_engine,
-    Table, Column, Sequence, Integer, String, DateTime,
+    Engine, Connection, MetaData, Dialect, create_mock_engine, inspect, func, select, cast, text,
+    Table, Column, Sequence, Integer, Float, String, DateTime, LargeBinary, Index,
     PrimaryKeyConstraint, ForeignKeyConstraint, UniqueConstraint,
 )
+from sqlalchemy.exc import IntegrityError, OperationalError, ProgrammingError
 
 _LOG = logging.getLogger(__name__)
 
@@ -41,11 +44,50 @@ class _DDL:
         return res + ";" if res else ""
 
 
+# Text metric values that `_migrate_v1()` moves to the typed `metric_num` column.
+_NUMERIC_REGEXP = r"^[-+]?([0-9]+[.]?[0-9]*|[.][0-9]+)([eE][-+]?[0-9]+)?$"
+
+
+def split_metric_value(value: Any) -> Tuple[Optional[float], Optional[str]]:
+    """
+    Convert the metric value into the (numeric, text) pair to store in the
+    `metric_num` and `metric_value` columns. The text value is always kept;
+    numeric values (and strings that can be parsed as numbers) also go into
+    the typed `metric_num` column, except for NaN and infinity: some DBs
+    (e.g., MySQL) reject them in a FLOAT column, so they are kept as text only.
+    """
+    if value is None:
+        return (None, None)
+    try:
+        num_value = float(value)
+    except (TypeError, ValueError):
+        return (None, str(value))
+    return (num_value if math.isfinite(num_value) else None, str(value))
+
+
+# Statements to acquire and release the session-level lock that serializes
+# the schema creation and migration among the workers sharing the DB (by dialect).
+_SCHEMA_LOCK_SQL: Dict[str, Tuple[str, str]] = {
+    "postgresql": ("SELECT pg_advisory_lock(7268227)", "SELECT pg_advisory_unlock(7268227)"),
+    "mysql": ("SELECT GET_LOCK('mlos_bench_schema', 600)", "SELECT RELEASE_LOCK('mlos_bench_schema')"),
+    "mariadb": ("SELECT GET_LOCK('mlos_bench_schema', 600)", "SELECT RELEASE_LOCK('mlos_bench_schema')"),
+}
+
+
 class DbSchema:
     """
     A class to define and create the DB schema.
     """
 
+    _CREATE_ATTEMPTS = 3
+    """Number of attempts to create (or upgrade) the schema when racing with other workers."""
+
+    # Version 1: all values stored as strings.
+    # Version 2: typed numeric metrics (`metric_num` column) and indexes for the analytic queries.
+    # Version 3: trial leases (`worker_id` and `ts_lease` columns) for the distributed workers.
+    # Version 4: optimizer checkpoints (`optimizer_checkpoint` table).
+    VERSION = 4
+
     def __init__(self, engine: Engine):
         """
         Declare the SQLAlchemy schema for the database.
@@ -54,6 +96,14 @@ class DbSchema:
         self._engine = engine
         self._meta = MetaData()
 
+        self.schema_version = Table(
+            "schema_version",
+            self._meta,
+            Column("version", Integer, nullable=False),
+
+            PrimaryKeyConstraint("version"),
+        )
+
         self.experiment = Table(
             "experiment",
             self._meta,
@@ -93,10 +143,15 @@ class DbSchema:
             Column("ts_end", DateTime),
             # Should match the text IDs of `mlos_bench.environments.Status` enum:
             Column("status", String(16), nullable=False),
+            # The worker that runs the trial and the expiration time of its lease
+            # (only in the coordinated mode; see `SqlStorage`).
+            Column("worker_id", String(255)),
+            Column("ts_lease", DateTime),
 
             PrimaryKeyConstraint("exp_id", "trial_id"),
             ForeignKeyConstraint(["exp_id"], [self.experiment.c.exp_id]),
             ForeignKeyConstraint(["config_id"], [self.config.c.config_id]),
+            Index("ix_trial_exp_status", "exp_id", "status"),
         )
 
         # Values of the tunable parameters of the experiment,
@@ -133,11 +188,14 @@ class DbSchema:
             Column("exp_id", String(255), nullable=False),
             Column("trial_id", Integer, nullable=False),
             Column("metric_id", String(255), nullable=False),
+            # Text value of the metric; if numeric, also stored in `metric_num`.
             Column("metric_value", String(255)),
+            Column("metric_num", Float),
 
             PrimaryKeyConstraint("exp_id", "trial_id", "metric_id"),
             ForeignKeyConstraint(["exp_id", "trial_id"],
                                  [self.trial.c.exp_id, self.trial.c.trial_id]),
+            Index("ix_trial_result_exp_metric", "exp_id", "metric_id"),
         )
 
         self.trial_telemetry = Table(
@@ -148,22 +206,123 @@ class DbSchema:
             Column("ts", DateTime, nullable=False, default="now"),
             Column("metric_id", String(255), nullable=False),
             Column("metric_value", String(255)),
+            Column("metric_num", Float),
 
             UniqueConstraint("exp_id", "trial_id", "ts", "metric_id"),
             ForeignKeyConstraint(["exp_id", "trial_id"],
                                  [self.trial.c.exp_id, self.trial.c.trial_id]),
+            Index("ix_trial_telemetry_exp_metric", "exp_id", "metric_id"),
+        )
+
+        # The latest snapshot of the optimizer state, and the ID of the last trial it includes.
+        self.optimizer_checkpoint = Table(
+            "optimizer_checkpoint",
+            self._meta,
+            Column("exp_id", String(255), nullable=False),
+            Column("trial_id", Integer, nullable=False),
+            Column("ts", DateTime, nullable=False, default="now"),
+            # Up to 4GB (LONGBLOB in MySQL).
+            Column("checkpoint", LargeBinary(length=2**32 - 1), nullable=False),
+
+            PrimaryKeyConstraint("exp_id", "trial_id"),
+            ForeignKeyConstraint(["exp_id"], [self.experiment.c.exp_id]),
         )
 
         _LOG.debug("Schema: %s", self._meta)
 
     def create(self) -> 'DbSchema':
         """
-        Create the DB schema.
+        Create the DB schema, or upgrade it to the current version.
+
+        Several workers can call it concurrently on the same DB: where the DB
+        supports it, the workers take turns under a DB lock. Otherwise (e.g., SQLite),
+        the worker that loses the race retries after re-reading the schema version.
+        All steps are idempotent, so each one is only applied once.
         """
         _LOG.info("Create the DB schema")
-        self._meta.create_all(self._engine)
+        for attempt in range(1, self._CREATE_ATTEMPTS + 1):
+            try:
+                with self._engine.connect() as conn, self._schema_lock(conn):
+                    with conn.begin():
+                        self._meta.create_all(conn)
+                        self._upgrade(conn)
+                return self
+            except (IntegrityError, OperationalError, ProgrammingError) as ex:
+                if attempt == self._CREATE_ATTEMPTS:
+                    raise
+                _LOG.warning("Schema creation failed (attempt %d); another worker may be creating it: %s",
+                             attempt, ex)
         return self
 
+    @staticmethod
+    @contextmanager
+    def _schema_lock(conn: Connection) -> Iterator[None]:
+        """
+        Hold the session-level DB lock for the schema creation, if the DB supports it.
+        """
+        lock_sql = _SCHEMA_LOCK_SQL.get(conn.dialect.name)
+        if lock_sql is None:
+            yield
+            return
+        (lock, unlock) = lock_sql
+        conn.execute(text(lock))
+        conn.commit()
+        try:
+            yield
+        finally:
+            conn.rollback()
+            conn.execute(text(unlock))
+            conn.commit()
+
+    def _upgrade(self, conn: Connection) -> None:
+        """
+        Check the schema version in the DB and upgrade the DB to the current version, if needed.
+        """
+        version = conn.execute(select(func.max(self.schema_version.c.version))).scalar()
+        if version is None or version < self.VERSION:
+            if "metric_num" not in self._get_columns(conn, self.trial_result):
+                self._migrate_v1(conn)
+            if "worker_id" not in self._get_columns(conn, self.trial):
+                self._migrate_v2(conn)
+            conn.execute(self.schema_version.insert().values(version=self.VERSION))
+        elif version > self.VERSION:
+            raise ValueError(f"Unsupported DB schema version: {version} > {self.VERSION}")
+
+    @staticmethod
+    def _get_columns(conn: Connection, table: Table) -> Set[str]:
+        """
+        Get the names of the columns of the table as it exists in the DB.
+        """
+        return {col["name"] for col in inspect(conn).get_columns(table.name)}
+
+    def _migrate_v1(self, conn: Connection) -> None:
+        """
+        Upgrade the DB created by the earlier versions of mlos_bench
+        (where all metrics were stored as strings) to the version 2 schema.
+        """
+        _LOG.info("Migrate the DB schema to version 2")
+        for table in (self.trial_result, self.trial_telemetry):
+            conn.exec_driver_sql(f"ALTER TABLE {table.name} ADD COLUMN metric_num FLOAT")
+            # Copy the numeric values to the typed column (in one statement per table).
+            conn.execute(
+                table.update().where(
+                    table.c.metric_value.regexp_match(_NUMERIC_REGEXP)
+                ).values(metric_num=cast(table.c.metric_value, Float))
+            )
+        for table in (self.trial, self.trial_result, self.trial_telemetry):
+            for index in table.indexes:
+                index.create(conn, checkfirst=True)
+
+    def _migrate_v2(self, conn: Connection) -> None:
+        """
+        Add the trial lease columns to the DB created by the earlier versions of mlos_bench.
+        The existing trials are not leased by any worker.
+        """
+        _LOG.info("Migrate the DB schema to version 3")
+        for col in (self.trial.c.worker_id, self.trial.c.ts_lease):
+            conn.exec_driver_sql(
+                f"ALTER TABLE {self.trial.name} ADD COLUMN {col.name} {col.type.compile(dialect=conn.dialect)}")
+
     def __repr__(self) -> str:
         """
         Produce a string with all SQL statements required to create the schema
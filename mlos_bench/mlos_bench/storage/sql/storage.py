@@ -6,8 +6,10 @@
 Saving and restoring the benchmark data in SQL database.
 """
 
+import os
+import socket
 import logging
-from typing import Optional
+from typing import Dict, Optional
 
 from sqlalchemy import URL, create_engine
 
@@ -16,6 +18,7 @@ from mlos_bench.services.base_service import Service
 from mlos_bench.storage.base_storage import Storage
 from mlos_bench.storage.sql.schema import DbSchema
 from mlos_bench.storage.sql.experiment import Experiment
+from mlos_bench.storage.sql.telemetry_writer import TelemetryWriter
 
 _LOG = logging.getLogger(__name__)
 
@@ -23,22 +26,39 @@ _LOG = logging.getLogger(__name__)
 class SqlStorage(Storage):
     """
     An implementation of the Storage interface using SQLAlchemy backend.
+
+    In the coordinated mode (`"coordinated": true` in the config), several workers
+    (e.g., mlos_bench processes on different nodes) can share one experiment
+    in the same DB: each worker allocates the trial IDs atomically and claims
+    the trials it runs with a lease that expires in `lease_duration` seconds
+    unless the worker renews it. Trials whose lease has expired (e.g., because
+    their worker died) are reclaimed by the other workers.
     """
 
     def __init__(self, tunables: TunableGroups, service: Optional[Service], config: dict):
         super().__init__(tunables, service, config)
         lazy_schema_create = self._config.pop("lazy_schema_create", False)
         self._log_sql = self._config.pop("log_sql", False)
+        self._telemetry_flush_interval = float(self._config.pop("telemetry_flush_interval", 1.0))
+        self._telemetry_batch_size = int(self._config.pop("telemetry_batch_size", 1000))
+        self._coordinated = bool(self._config.pop("coordinated", False))
+        self._worker_id = str(self._config.pop("worker_id", f"{socket.gethostname()}:{os.getpid()}"))
+        self._lease_duration = float(self._config.pop("lease_duration", 300))
         self._url = URL.create(**self._config)
         self._repr = f"{self._url.get_backend_name()}:{self._url.database}"
         _LOG.info("Connect to the database: %s", self)
         self._engine = create_engine(self._url, echo=self._log_sql)
         self._db_schema: DbSchema
+        self._telemetry_writer: TelemetryWriter
         if not lazy_schema_create:
             assert self._schema
         else:
             _LOG.info("Using lazy schema create for database: %s", self)
 
+    @property
+    def worker_id(self) -> Optional[str]:
+        return self._worker_id if self._coordinated else None
+
     @property
     def _schema(self) -> DbSchema:
         """Lazily create schema upon first access."""
@@ -48,6 +68,20 @@ class SqlStorage(Storage):
                 _LOG.debug("DDL statements:\n%s", self._schema)
         return self._db_schema
 
+    @property
+    def _telemetry(self) -> TelemetryWriter:
+        """
+        Create the (shared) buffered telemetry writer upon first access,
+        or after the previous experiment has closed it.
+        """
+        if not hasattr(self, '_telemetry_writer') or self._telemetry_writer.is_closed:
+            self._telemetry_writer = TelemetryWriter(
+                self._engine, self._schema,
+                flush_interval=self._telemetry_flush_interval,
+                batch_size=self._telemetry_batch_size,
+            )
+        return self._telemetry_writer
+
     def __repr__(self) -> str:
         return self._repr
 
@@ -56,14 +90,19 @@ class SqlStorage(Storage):
                    trial_id: int,
                    root_env_config: str,
                    description: str,
-                   opt_target: str) -> Storage.Experiment:
+                   opt_target: str,
+                   opt_targets: Optional[Dict[str, str]] = None) -> Storage.Experiment:
         return Experiment(
             engine=self._engine,
             schema=self._schema,
+            telemetry=self._telemetry,
             tunables=self._tunables,
             experiment_id=experiment_id,
             trial_id=trial_id,
             root_env_config=root_env_config,
             description=description,
             opt_target=opt_target,
+            opt_targets=opt_targets,
+            worker_id=self._worker_id if self._coordinated else None,
+            lease_duration=self._lease_duration,
         )
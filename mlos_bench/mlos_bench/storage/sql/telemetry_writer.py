@@ -0,0 +1,232 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Buffered writer for the trial telemetry data.
+"""
+
+import logging
+import threading
+from datetime import datetime
+from typing import Any, Dict, Iterable, List, Optional, Tuple
+
+from sqlalchemy import Engine
+from sqlalchemy.exc import IntegrityError
+
+from mlos_bench.storage.sql.schema import DbSchema, split_metric_value
+
+_LOG = logging.getLogger(__name__)
+
+
+class TelemetryWriter:
+    """
+    Collect the telemetry samples of all trials in memory and write them
+    to the DB in batches, either in a background thread every `flush_interval`
+    seconds, or right away once the buffer reaches `batch_size` rows.
+    """
+
+    def __init__(self, engine: Engine, schema: DbSchema,
+                 flush_interval: float = 1.0, batch_size: int = 1000):
+        """
+        Create a new telemetry writer.
+
+        Parameters
+        ----------
+        engine : Engine
+            SQLAlchemy engine to write the data with.
+        schema : DbSchema
+            The DB schema.
+        flush_interval : float
+            Max. time (in seconds) the samples stay in the buffer.
+            If 0, write each sample synchronously.
+        batch_size : int
+            Max. number of rows to keep in the buffer.
+        """
+        self._engine = engine
+        self._schema = schema
+        self._flush_interval = flush_interval
+        self._batch_size = batch_size
+        self._buffer: List[Dict[str, Any]] = []
+        self._lock = threading.Lock()
+        # Serialize the flushes so the batches are written in order.
+        self._flush_lock = threading.Lock()
+        self._wakeup = threading.Event()
+        self._stop = threading.Event()
+        self._thread: Optional[threading.Thread] = None
+        # In-memory SQLite DB is private to the thread that created it,
+        # so we cannot write to it from the background thread.
+        is_memory_db = engine.dialect.name == "sqlite" and engine.url.database in {None, "", ":memory:"}
+        if flush_interval > 0 and not is_memory_db:
+            self._thread = threading.Thread(
+                target=self._run, name="mlos_bench_telemetry", daemon=True)
+            self._thread.start()
+
+    def __repr__(self) -> str:
+        return f"{self.__class__.__name__}(flush_interval={self._flush_interval}, " + \
+            f"batch_size={self._batch_size}, async={self._thread is not None})"
+
+    def append(self, experiment_id: str, trial_id: int,
+               timestamp: datetime, metrics: Dict[str, Any]) -> None:
+        """
+        Add the telemetry sample of the given trial to the buffer.
+
+        Parameters
+        ----------
+        experiment_id : str
+            ID of the experiment.
+        trial_id : int
+            ID of the trial.
+        timestamp : datetime
+            The time when the sample has been collected.
+        metrics : Dict[str, Any]
+            Telemetry data.
+        """
+        rows = [_make_row(experiment_id, trial_id, timestamp, key, val)
+                for (key, val) in metrics.items()]
+        with self._lock:
+            self._buffer.extend(rows)
+            is_full = len(self._buffer) >= self._batch_size
+        if self._thread is None:
+            if is_full or self._flush_interval <= 0:
+                self.flush()
+        elif is_full:
+            self._wakeup.set()
+
+    def extend(self, experiment_id: str, trial_id: int,
+               samples: Iterable[Tuple[datetime, Dict[str, Any]]]) -> int:
+        """
+        Write a (possibly long) time series of the given trial to the DB,
+        `batch_size` rows at a time, so the entire series is never held in memory.
+        Duplicate (timestamp, metric) records within a batch are dropped
+        (the last value wins); the ones across the batches are skipped on insert.
+
+        Parameters
+        ----------
+        experiment_id : str
+            ID of the experiment.
+        trial_id : int
+            ID of the trial.
+        samples : Iterable[Tuple[datetime, Dict[str, Any]]]
+            Pairs of (timestamp, metrics) values.
+
+        Returns
+        -------
+        count : int
+            Number of the telemetry records written (including the skipped duplicates).
+        """
+        count = 0
+        batch: Dict[Tuple[datetime, str], Dict[str, Any]] = {}
+        for (timestamp, metrics) in samples:
+            for (key, val) in metrics.items():
+                batch[(timestamp, key)] = _make_row(experiment_id, trial_id, timestamp, key, val)
+            if len(batch) >= self._batch_size:
+                count += len(batch)
+                self._write_batch(list(batch.values()))
+                batch = {}
+        if batch:
+            count += len(batch)
+            self._write_batch(list(batch.values()))
+        return count
+
+    def _write_batch(self, rows: List[Dict[str, Any]]) -> None:
+        """
+        Add the rows to the buffer and write it synchronously once it is full,
+        so the producer cannot outpace the background thread.
+        """
+        with self._lock:
+            self._buffer.extend(rows)
+            is_full = len(self._buffer) >= self._batch_size
+        if is_full or self._flush_interval <= 0:
+            self.flush()
+
+    @property
+    def is_closed(self) -> bool:
+        """
+        True if the writer has been closed and must not be used anymore.
+        """
+        return self._stop.is_set()
+
+    def flush(self) -> None:
+        """
+        Write all buffered samples to the DB in one transaction.
+        If the batch has duplicate records, write the rest of it row by row.
+        On any other DB error, put the rows back into the buffer and re-raise.
+        """
+        with self._flush_lock:
+            with self._lock:
+                (rows, self._buffer) = (self._buffer, [])
+            if not rows:
+                return
+            _LOG.debug("Write %d telemetry records", len(rows))
+            try:
+                with self._engine.begin() as conn:
+                    conn.execute(self._schema.trial_telemetry.insert(), rows)
+            except IntegrityError:
+                _LOG.warning("Duplicate telemetry records; write %d records one by one", len(rows))
+                self._write_rows(rows)
+            except Exception:
+                self._requeue(rows)
+                raise
+
+    def _write_rows(self, rows: List[Dict[str, Any]]) -> None:
+        """
+        Write the telemetry records one by one, skipping the duplicates.
+        """
+        for (i, row) in enumerate(rows):
+            try:
+                with self._engine.begin() as conn:
+                    conn.execute(self._schema.trial_telemetry.insert(), row)
+            except IntegrityError:
+                _LOG.warning("Skip duplicate telemetry record: %s", row)
+            except Exception:
+                self._requeue(rows[i:])
+                raise
+
+    def _requeue(self, rows: List[Dict[str, Any]]) -> None:
+        """
+        Put the rows that could not be written back at the head of the buffer.
+        """
+        with self._lock:
+            self._buffer[:0] = rows
+
+    def close(self) -> None:
+        """
+        Stop the background thread (if any) and write the remaining samples to the DB.
+        """
+        self._stop.set()
+        if self._thread is not None:
+            self._wakeup.set()
+            self._thread.join()
+            self._thread = None
+        self.flush()
+
+    def _run(self) -> None:
+        """
+        Background thread: flush the buffer periodically or when it is full.
+        """
+        while not self._stop.is_set():
+            self._wakeup.wait(self._flush_interval)
+            self._wakeup.clear()
+            if self._stop.is_set():
+                break   # `.close()` writes the rest of the buffer.
+            try:
+                self.flush()
+            except Exception:   # pylint: disable=broad-except
+                _LOG.exception("Failed to write the telemetry data; retry later")
+
+
+def _make_row(experiment_id: str, trial_id: int, timestamp: datetime,
+              key: str, val: Any) -> Dict[str, Any]:
+    """
+    Make a record of the `trial_telemetry` table.
+    """
+    (num_value, text_value) = split_metric_value(val)
+    return {
+        "exp_id": experiment_id,
+        "trial_id": trial_id,
+        "ts": timestamp,
+        "metric_id": key,
+        "metric_num": num_value,
+        "metric_value": text_value,
+    }
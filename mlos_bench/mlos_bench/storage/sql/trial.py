@@ -8,14 +8,15 @@ Saving and updating benchmark data using SQLAlchemy backend.
 
 import logging
 from datetime import datetime
-from typing import Optional, Union, Dict, Any
+from typing import Optional, Union, Dict, Iterable, List, Tuple, Any
 
 from sqlalchemy import Engine, Table
 
 from mlos_bench.environments.status import Status
 from mlos_bench.tunables.tunable_groups import TunableGroups
-from mlos_bench.storage.base_storage import Storage
-from mlos_bench.storage.sql.schema import DbSchema
+from mlos_bench.storage.base_storage import Storage, TrialLeaseLostError
+from mlos_bench.storage.sql.schema import DbSchema, split_metric_value
+from mlos_bench.storage.sql.telemetry_writer import TelemetryWriter
 
 _LOG = logging.getLogger(__name__)
 
@@ -26,9 +27,11 @@ class Trial(Storage.Trial):
     """
 
     def __init__(self, *,
-                 engine: Engine, schema: DbSchema, tunables: TunableGroups,
-                 experiment_id: str, trial_id: int, config_id: int,
-                 opt_target: str, config: Optional[Dict[str, Any]] = None):
+                 engine: Engine, schema: DbSchema, telemetry: TelemetryWriter,
+                 tunables: TunableGroups, experiment_id: str, trial_id: int, config_id: int,
+                 opt_target: str, config: Optional[Dict[str, Any]] = None,
+                 results_cache: Optional[Dict[int, List[Dict[str, Any]]]] = None,
+                 worker_id: Optional[str] = None):
         super().__init__(
             tunables=tunables,
             experiment_id=experiment_id,
@@ -39,6 +42,13 @@ class Trial(Storage.Trial):
         )
         self._engine = engine
         self._schema = schema
+        self._telemetry = telemetry
+        # Last status saved by `.update_telemetry()`, to avoid rewriting the trial record.
+        self._status: Optional[Status] = None
+        # The experiment's in-memory cache of config_id -> results of the successful trials.
+        self._results_cache = results_cache
+        # In the coordinated mode, only the worker that holds the lease can update the trial.
+        self._worker_id = worker_id
 
     def _update(self, table: Table, timestamp: Optional[datetime],
                 status: Status, metrics: Optional[Dict[str, float]] = None) -> None:
@@ -50,6 +60,7 @@ class Trial(Storage.Trial):
         table: str
             The name of the table to store the results in.
             Must be either 'trial_telemetry' or 'trail_results'.
+            (Telemetry is written by the `TelemetryWriter`, so use it only to update the status).
         timestamp: datetime
             The timestamp of the final results. (Use `None` for telemetry).
         status: Status
@@ -58,36 +69,44 @@ class Trial(Storage.Trial):
             Pairs of (key, value): intermediate or final results of the trial.
         """
         _LOG.debug("Updating experiment run: %s", self)
+        conditions = [
+            self._schema.trial.c.exp_id == self._experiment_id,
+            self._schema.trial.c.trial_id == self._trial_id,
+            self._schema.trial.c.status.notin_(
+                ['SUCCEEDED', 'CANCELED', 'FAILED', 'TIMED_OUT']),
+        ]
+        if self._worker_id is not None:
+            conditions.append(self._schema.trial.c.worker_id == self._worker_id)
         with self._engine.begin() as conn:
             try:
                 # FIXME: Use the actual timestamp from the benchmark.
                 cur_status = conn.execute(
-                    self._schema.trial.update().where(
-                        self._schema.trial.c.exp_id == self._experiment_id,
-                        self._schema.trial.c.trial_id == self._trial_id,
-                        self._schema.trial.c.status.notin_(
-                            ['SUCCEEDED', 'CANCELED', 'FAILED', 'TIMED_OUT']),
-                    ).values(
+                    self._schema.trial.update().where(*conditions).values(
                         status=status.name,
                         ts_end=timestamp,
                     )
                 )
                 if cur_status.rowcount not in {1, -1}:
                     _LOG.warning("Trial %s :: update failed: %s", self, status)
+                    if self._worker_id is not None:
+                        # In the coordinated mode, the trial might have been reclaimed by another worker.
+                        raise TrialLeaseLostError(
+                            f"Trial {self} is no longer leased to worker {self._worker_id}")
                     raise RuntimeError(
                         f"Failed to update the status of the trial {self} to {status}." +
                         f" ({cur_status.rowcount} rows)")
-                # FIXME: Save timestamps for the telemetry data.
                 if metrics:
-                    conn.execute(table.insert().values([
-                        {
+                    rows = []
+                    for (key, val) in metrics.items():
+                        (num_value, text_value) = split_metric_value(val)
+                        rows.append({
                             "exp_id": self._experiment_id,
                             "trial_id": self._trial_id,
                             "metric_id": key,
-                            "metric_value": None if val is None else str(val),
-                        }
-                        for (key, val) in metrics.items()
-                    ]))
+                            "metric_num": num_value,
+                            "metric_value": text_value,
+                        })
+                    conn.execute(table.insert().values(rows))
             except Exception:
                 conn.rollback()
                 raise
@@ -96,10 +115,31 @@ class Trial(Storage.Trial):
                metrics: Optional[Union[Dict[str, float], float]] = None
                ) -> Optional[Dict[str, float]]:
         metrics = super().update(status, metrics)
+        # Make sure all telemetry of the trial is saved before the final results.
+        self._telemetry.flush()
         self._update(self._schema.trial_result, datetime.now(), status, metrics)
+        if self._results_cache is not None and status.is_succeeded and metrics:
+            self._results_cache.setdefault(self._config_id, []).append(metrics.copy())
         return metrics
 
     def update_telemetry(self, status: Status,
-                         metrics: Optional[Dict[str, float]] = None) -> None:
-        super().update_telemetry(status, metrics)
-        self._update(self._schema.trial_telemetry, None, status, metrics)
+                         metrics: Optional[Dict[str, float]] = None,
+                         timestamp: Optional[datetime] = None) -> None:
+        super().update_telemetry(status, metrics, timestamp)
+        if status != self._status:
+            self._update(self._schema.trial_telemetry, None, status)
+            self._status = status
+        if metrics:
+            self._telemetry.append(self._experiment_id, self._trial_id,
+                                   timestamp or datetime.now(), metrics)
+
+    def append_telemetry(self, metrics: Dict[str, float],
+                         timestamp: Optional[datetime] = None) -> None:
+        super().append_telemetry(metrics, timestamp)
+        if metrics:
+            self._telemetry.append(self._experiment_id, self._trial_id,
+                                   timestamp or datetime.now(), metrics)
+
+    def append_telemetry_series(self, samples: Iterable[Tuple[datetime, Dict[str, float]]]) -> None:
+        count = self._telemetry.extend(self._experiment_id, self._trial_id, samples)
+        _LOG.debug("Append %d telemetry records: %s", count, self)
@@ -6,8 +6,12 @@
 Unit tests for composite environment.
 """
 
+import threading
+from typing import List, Optional
+
 import pytest
 
+from mlos_bench.environments.base_environment import Environment
 from mlos_bench.environments.composite_env import CompositeEnv
 from mlos_bench.tunables.tunable_groups import TunableGroups
 from mlos_bench.services.config_persistence import ConfigPersistenceService
@@ -98,3 +102,133 @@ def test_composite_env_setup(composite_env: CompositeEnv, tunable_groups: Tunabl
         "EnvId": 2,                 # const_args from the child
         "idle": "mwait",            # tunable_params from the parent
     }
+
+
+def _make_dag_env(tunable_groups: TunableGroups, dependencies: Optional[dict]) -> CompositeEnv:
+    """
+    Create a CompositeEnv with three mock children and the given dependencies (if any).
+    """
+    config: dict = {
+        "children": [
+            {
+                "name": name,
+                "class": "mlos_bench.environments.mock_env.MockEnv",
+                "config": {"tunable_params": ["provision"]},
+            }
+            for name in ("A", "B", "C")
+        ],
+    }
+    if dependencies is not None:
+        config["dependencies"] = dependencies
+    return CompositeEnv(
+        name="Composite DAG Environment",
+        config=config,
+        tunables=tunable_groups,
+        service=ConfigPersistenceService({}),
+    )
+
+
+def _trace_teardown(env: Environment, trace: List[str]) -> None:
+    """
+    Replace the `.teardown()` method of the environment with one that records the calls.
+    """
+    setattr(env, "teardown", lambda: trace.append(env.name))
+
+
+def _trace_setup(env: Environment, trace: List[str],
+                 barrier: Optional[threading.Barrier] = None, is_ok: bool = True) -> None:
+    """
+    Replace the `.setup()` method of the environment with one that records the calls.
+    """
+    def _setup(*_args: object) -> bool:
+        if barrier is not None:
+            barrier.wait()   # Fails if the siblings are not set up concurrently.
+        trace.append(env.name)
+        return is_ok
+
+    setattr(env, "setup", _setup)
+
+
+def test_composite_env_setup_dag(tunable_groups: TunableGroups) -> None:
+    """
+    Check that the independent children are set up concurrently,
+    and the dependent one waits for its parents.
+    """
+    env = _make_dag_env(tunable_groups, {"C": ["A", "B"]})
+    trace: List[str] = []
+    barrier = threading.Barrier(2, timeout=10)
+    (env_a, env_b, env_c) = env.children
+    _trace_setup(env_a, trace, barrier)
+    _trace_setup(env_b, trace, barrier)
+    _trace_setup(env_c, trace)
+    assert env.setup(tunable_groups)
+    assert sorted(trace[:2]) == ["A", "B"]
+    assert trace[2] == "C"
+    env.teardown()
+
+
+def test_composite_env_setup_dag_failure(tunable_groups: TunableGroups) -> None:
+    """
+    Check that the failure of one child prevents the setup of its dependents.
+    """
+    env = _make_dag_env(tunable_groups, {"B": ["A"], "C": ["B"]})
+    trace: List[str] = []
+    (env_a, env_b, env_c) = env.children
+    _trace_setup(env_a, trace)
+    _trace_setup(env_b, trace, is_ok=False)
+    _trace_setup(env_c, trace)
+    teardown_trace: List[str] = []
+    for child in env.children:
+        _trace_teardown(child, teardown_trace)
+    assert not env.setup(tunable_groups)
+    assert trace == ["A", "B"]
+    # Only the child that has been set up successfully is torn down.
+    assert teardown_trace == ["A"]
+
+
+def test_composite_env_setup_dag_failure_siblings(tunable_groups: TunableGroups) -> None:
+    """
+    Check that the siblings of the failed child that complete their setup are torn down.
+    """
+    env = _make_dag_env(tunable_groups, {"C": ["A", "B"]})
+    trace: List[str] = []
+    barrier = threading.Barrier(2, timeout=10)
+    (env_a, env_b, env_c) = env.children
+    _trace_setup(env_a, trace, barrier)
+    _trace_setup(env_b, trace, barrier, is_ok=False)
+    _trace_setup(env_c, trace)
+    teardown_trace: List[str] = []
+    for child in env.children:
+        _trace_teardown(child, teardown_trace)
+    assert not env.setup(tunable_groups)
+    assert sorted(trace) == ["A", "B"]
+    assert teardown_trace == ["A"]
+
+
+def test_composite_env_setup_failure_sequential(tunable_groups: TunableGroups) -> None:
+    """
+    Check that the children set up before the failed one are torn down
+    when there are no dependencies in the config.
+    """
+    env = _make_dag_env(tunable_groups, None)
+    trace: List[str] = []
+    (env_a, env_b, env_c) = env.children
+    _trace_setup(env_a, trace)
+    _trace_setup(env_b, trace)
+    _trace_setup(env_c, trace, is_ok=False)
+    teardown_trace: List[str] = []
+    for child in env.children:
+        _trace_teardown(child, teardown_trace)
+    assert not env.setup(tunable_groups)
+    assert trace == ["A", "B", "C"]
+    assert teardown_trace == ["B", "A"]
+
+
+def test_composite_env_bad_dependencies(tunable_groups: TunableGroups) -> None:
+    """
+    Check that unknown children and circular dependencies are rejected.
+    """
+    with pytest.raises(ValueError):
+        _make_dag_env(tunable_groups, {"C": ["D"]})
+    with pytest.raises(ValueError):
+        _make_dag_env(tunable_groups, {"A": ["C"], "B": ["A"], "C": ["B"]})
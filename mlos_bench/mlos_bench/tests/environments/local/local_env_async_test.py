@@ -0,0 +1,147 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Unit tests for running the scripts of LocalEnv in background,
+and for stopping them early based on their partial results.
+"""
+import math
+import time
+from pathlib import Path
+
+import pytest
+
+from sqlalchemy import select
+
+from mlos_bench.run import _optimize
+from mlos_bench.environments.local.local_env import LocalEnv
+from mlos_bench.environments.status import Status
+from mlos_bench.optimizers.mock_optimizer import MockOptimizer
+from mlos_bench.services.config_persistence import ConfigPersistenceService
+from mlos_bench.services.local.local_exec import LocalExecService
+from mlos_bench.storage.sql.storage import SqlStorage
+from mlos_bench.tunables.tunable_groups import TunableGroups
+
+# pylint: disable=redefined-outer-name
+
+# The benchmark writes one sample per row. The first run is fast and good,
+# all other runs are slow and bad. The script leaves a marker when it completes.
+_BENCHMARK_SCRIPT = """
+import os
+import sys
+import time
+
+root = sys.argv[1]
+run_id = len([name for name in os.listdir(root) if name.startswith("start-")])
+open(os.path.join(root, f"start-{run_id}"), "w").close()
+(score, n_samples) = (1.0, 5) if run_id == 0 else (100.0, 50)
+with open("results.csv", "w", encoding="utf-8") as fh_results:
+    fh_results.write("ts,score\\n")
+    for i in range(n_samples):
+        fh_results.write(f"2024-01-01 00:00:{i:02d},{score}\\n")
+        fh_results.flush()
+        time.sleep(0.2)
+open(os.path.join(root, f"done-{run_id}"), "w").close()
+"""
+
+
+@pytest.fixture
+def async_local_env(tmp_path: Path, tunable_groups: TunableGroups) -> LocalEnv:
+    """
+    Test fixture for LocalEnv that runs the benchmark script in background.
+    """
+    script = tmp_path / "benchmark.py"
+    script.write_text(_BENCHMARK_SCRIPT, encoding="utf-8")
+    return LocalEnv(
+        name="Test Async Local Env",
+        config={
+            "run": [f"{script} {tmp_path}"],
+            "async_run": True,
+            "read_results_file": "results.csv",
+            "read_results_aggregate": {"score": ["mean"]},
+            "read_results_timestamp": "ts",
+        },
+        tunables=tunable_groups,
+        service=LocalExecService(parent=ConfigPersistenceService()),
+    )
+
+
+def test_local_env_async_run(async_local_env: LocalEnv, tunable_groups: TunableGroups, tmp_path: Path) -> None:
+    """
+    Poll the script running in background for its partial and final results.
+    """
+    env = async_local_env
+    assert env.setup(tunable_groups)
+    assert env.run() == (Status.PENDING, None)
+    partial = []
+    while True:
+        (status, output) = env.status()
+        if not status.is_running:
+            break
+        # Skip the NaN aggregates before the first sample.
+        if output and not math.isnan(output["score_mean"]):
+            partial.append(output["score_mean"])
+        time.sleep(0.05)
+    assert status.is_succeeded
+    assert output == {"score_mean": 1.0}
+    assert partial and set(partial) == {1.0}
+    assert len(list(env.telemetry())) == 5
+    assert (tmp_path / "done-0").exists()
+    env.teardown()
+
+
+def test_local_env_async_cancel(async_local_env: LocalEnv, tunable_groups: TunableGroups, tmp_path: Path) -> None:
+    """
+    Kill the script running in background.
+    """
+    env = async_local_env
+    assert env.setup(tunable_groups)
+    assert env.run() == (Status.PENDING, None)
+    assert env.status()[0] == Status.RUNNING
+    assert env.cancel()
+    assert not env.cancel()
+    # The environment has to be set up again.
+    assert env.status() == (Status.PENDING, None)
+    assert not (tmp_path / "done-0").exists()
+    env.teardown()
+
+
+def test_optimize_early_stopping(async_local_env: LocalEnv, tunable_groups: TunableGroups, tmp_path: Path) -> None:
+    """
+    Run the optimization loop with the early stopping rule and make sure the trial
+    that falls behind the first one is canceled and registered with its censored score.
+    """
+    opt = MockOptimizer(
+        tunables=tunable_groups,
+        service=None,
+        config={
+            "minimize": "score_mean",
+            "max_iterations": 2,
+            "seed": 42,
+            "early_stopping": {"min_steps": 2, "min_trials": 1},
+        },
+    )
+    storage = SqlStorage(
+        tunables=tunable_groups,
+        service=None,
+        config={
+            "drivername": "sqlite",
+            "database": ":memory:",
+        }
+    )
+    (score, _tunables) = _optimize(
+        async_local_env, opt, storage, "environment.jsonc",
+        {"experimentId": "Test-Early-Stopping", "pollInterval": 0.02})
+
+    assert score == pytest.approx(1.0)
+    assert opt.num_pending == 0
+    assert (tmp_path / "done-0").exists()
+    assert (tmp_path / "start-1").exists()
+    assert not (tmp_path / "done-1").exists()
+
+    schema = storage._schema  # pylint: disable=protected-access
+    with storage._engine.connect() as conn:  # pylint: disable=protected-access
+        statuses = conn.execute(
+            select(schema.trial.c.status).order_by(schema.trial.c.trial_id)).scalars().all()
+    assert statuses == [Status.SUCCEEDED.name, Status.CANCELED.name]
@@ -0,0 +1,81 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Unit tests for the streaming readers of the local benchmark results.
+"""
+
+from datetime import datetime
+from pathlib import Path
+
+import pytest
+
+from mlos_bench.environments.local.results_reader import (
+    CsvResultsReader, ParquetResultsReader, ResultsAggregator, get_results_reader, read_results,
+)
+
+
+def test_get_results_reader() -> None:
+    """
+    Check that the reader is chosen by the format or the file extension.
+    """
+    assert isinstance(get_results_reader("results.csv"), CsvResultsReader)
+    assert isinstance(get_results_reader("results"), CsvResultsReader)
+    assert isinstance(get_results_reader("results.PARQUET"), ParquetResultsReader)
+    assert isinstance(get_results_reader("results.txt", "parquet"), ParquetResultsReader)
+    with pytest.raises(ValueError):
+        get_results_reader("results.csv", "xml")
+
+
+def test_read_results_wide_and_long(tmp_path: Path) -> None:
+    """
+    Read the results in wide and long formats, in several chunks.
+    """
+    wide_file = tmp_path / "wide.csv"
+    wide_file.write_text("score,latency\n1.0,10\n2.0,20\n3.0,30\n", encoding="utf-8")
+    long_file = tmp_path / "long.csv"
+    long_file.write_text("metric,value\nscore,1.5\nlatency,15\nscore,2.5\n", encoding="utf-8")
+
+    reader = CsvResultsReader(chunk_size=2)
+    assert read_results(reader, str(wide_file)) == {"score": 3.0, "latency": 30}
+    assert read_results(reader, str(long_file)) == {"score": 2.5, "latency": 15}
+
+
+def test_results_aggregator(tmp_path: Path) -> None:
+    """
+    Compute the aggregates and collect the telemetry while streaming the file in chunks.
+    """
+    results_file = tmp_path / "samples.csv"
+    results_file.write_text(
+        "ts,latency,qps,host\n" +
+        "".join(f"2023-07-01 12:00:{i:02d},{i + 1},{100 * i},vm1\n" for i in range(10)),
+        encoding="utf-8")
+
+    aggregator = ResultsAggregator(
+        {"latency": ["min", "max", "mean", "p50", "p90", "count"], "qps": ["sum", "last"]},
+        timestamp_column="ts")
+    for chunk in CsvResultsReader(chunk_size=3).read_chunks(str(results_file)):
+        aggregator.update(chunk)
+
+    assert aggregator.results() == pytest.approx({
+        "latency_min": 1.0,
+        "latency_max": 10.0,
+        "latency_mean": 5.5,
+        "latency_p50": 5.5,
+        "latency_p90": 9.1,
+        "latency_count": 10.0,
+        "qps_sum": 4500.0,
+        "qps_last": 900.0,
+    })
+    telemetry = aggregator.telemetry
+    assert len(telemetry) == 10
+    assert telemetry[3] == (datetime(2023, 7, 1, 12, 0, 3), {"latency": 4, "qps": 300})
+
+
+def test_results_aggregator_bad_aggregate() -> None:
+    """
+    Make sure unknown aggregates are rejected.
+    """
+    with pytest.raises(ValueError):
+        ResultsAggregator({"latency": ["median"]})
@@ -92,3 +92,70 @@ def test_mock_env_no_noise_assign(mock_env_no_noise: MockEnv,
         assert status.is_succeeded
         assert data is not None
         assert data["score"] == pytest.approx(expected_score, 0.01)
+
+
+def test_mock_env_skip_unchanged_setup(tunable_groups: TunableGroups) -> None:
+    """
+    Check that the environment keeps track of the tunables changed since the last setup.
+    """
+    # pylint: disable=protected-access
+    env = MockEnv(
+        name="Test Env Skip Setup",
+        config={
+            "tunable_params": ["provision", "boot", "kernel"],
+            "skip_unchanged_setup": True,
+            "range": [60, 120],
+            "metrics": ["score"],
+        },
+        tunables=tunable_groups
+    )
+    # Nothing is set up yet: everything has to be (re)configured.
+    assert env.get_setup_cost(tunable_groups) == 1301
+    assert env.setup(tunable_groups)
+    assert env._is_setup_updated()
+
+    tunables = tunable_groups.copy().assign({"kernel_sched_migration_cost_ns": 40000})
+    assert env.get_setup_cost(tunables) == 1
+    assert env.setup(tunables)
+    assert env._is_setup_updated()
+    assert env._is_setup_updated(["kernel"])
+    assert not env._is_setup_updated(["provision", "boot"])
+
+    # Same values again: nothing to do.
+    assert env.get_setup_cost(tunables) == 0
+    assert env.setup(tunables)
+    assert not env._is_setup_updated()
+
+    # Must redo everything after the teardown.
+    env.teardown()
+    assert env.get_setup_cost(tunables) == 1301
+    assert env.setup(tunables)
+    assert env._is_setup_updated()
+
+    # Must redo everything after a failed setup.
+    assert env.setup(tunables)
+    assert not env._is_setup_updated()
+    env._is_ready = False
+    assert env.setup(tunables)
+    assert env._is_setup_updated()
+
+    # Must redo everything if the non-tunable parameters have changed.
+    assert env.setup(tunables, {"vmName": "other-vm"})
+    assert env._is_setup_updated()
+    assert env.setup(tunables, {"vmName": "other-vm"})
+    assert not env._is_setup_updated()
+
+
+def test_mock_env_skip_setup_no_tunables(tunable_groups: TunableGroups) -> None:
+    """
+    Check that the environment without its own tunables never skips the setup.
+    """
+    # pylint: disable=protected-access
+    env = MockEnv(
+        name="Test Env No Tunables",
+        config={"skip_unchanged_setup": True},
+        tunables=tunable_groups
+    )
+    assert env.setup(tunable_groups)
+    assert env.setup(tunable_groups)
+    assert env._is_setup_updated()
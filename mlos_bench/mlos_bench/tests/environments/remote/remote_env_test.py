@@ -0,0 +1,103 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Unit tests for running the scripts of RemoteEnv on a fleet of VMs.
+"""
+
+from typing import Any, Dict, List, Sequence, Tuple
+
+from mlos_bench.environments.remote.remote_env import RemoteEnv
+from mlos_bench.environments.status import Status
+from mlos_bench.services.base_service import Service
+from mlos_bench.tests.services.remote import MockRemoteExecService, MockVMService
+from mlos_bench.tunables.tunable_groups import TunableGroups
+
+
+def _fleet_service() -> Service:
+    """
+    Mock service that runs the scripts on a fleet: the script always fails on "vm-2".
+    """
+    def remote_exec_fleet(*_args: Any, configs: Sequence[dict], **_kwargs: Any) -> List[Tuple[Status, dict]]:
+        return [(Status.FAILED if config["vmName"] == "vm-2" else Status.SUCCEEDED, {"vmName": config["vmName"]})
+                for config in configs]
+
+    service = MockVMService(config={}, parent=MockRemoteExecService(config={}, parent=None))
+    service.register({"remote_exec_fleet": remote_exec_fleet})
+    return service
+
+
+def test_remote_env_fleet(tunable_groups: TunableGroups) -> None:
+    """
+    Check that the results of the script on each VM of the fleet are reported,
+    and a failure on one VM fails the run.
+    """
+    env = RemoteEnv(
+        name="Test Remote Fleet",
+        config={
+            "run": ["/bin/bash -c true"],
+            "fleet": ["vm-1", "vm-2", "vm-3"],
+        },
+        tunables=tunable_groups,
+        service=_fleet_service(),
+    )
+    assert env.setup(tunable_groups)
+    (status, output) = env.run()
+    assert status.is_failed
+    assert output == {
+        "fleet": {
+            "vm-1": {"status": "SUCCEEDED", "output": {"vmName": "vm-1"}},
+            "vm-2": {"status": "FAILED", "output": {"vmName": "vm-2"}},
+            "vm-3": {"status": "SUCCEEDED", "output": {"vmName": "vm-3"}},
+        }
+    }
+
+
+def test_remote_env_fleet_async(tunable_groups: TunableGroups) -> None:
+    """
+    Check that the asynchronous run completes only when the script completes on all VMs.
+    """
+    polls: Dict[str, int] = {}
+
+    def remote_exec_fleet(*_args: Any, configs: Sequence[dict], **_kwargs: Any) -> List[Tuple[Status, dict]]:
+        return [(Status.PENDING, {"vmName": config["vmName"], "asyncResultsUrl": config["vmName"]})
+                for config in configs]
+
+    def poll_remote_exec_results(config: dict) -> Tuple[Status, dict]:
+        url = config["asyncResultsUrl"]
+        polls[url] = polls.get(url, 0) + 1
+        # vm-2 takes one more poll to complete.
+        if polls[url] < (3 if url == "vm-2" else 2):
+            return (Status.RUNNING, {})
+        return (Status.SUCCEEDED, {"score": 1.0})
+
+    service = _fleet_service()
+    service.register({
+        "remote_exec_fleet": remote_exec_fleet,
+        "poll_remote_exec_results": poll_remote_exec_results,
+    })
+    env = RemoteEnv(
+        name="Test Remote Fleet Async",
+        config={
+            "run": ["/bin/bash -c true"],
+            "async_run": True,
+            "fleet": ["vm-1", "vm-2"],
+        },
+        tunables=tunable_groups,
+        service=service,
+    )
+    assert env.setup(tunable_groups)
+    assert env.run() == (Status.PENDING, None)
+    assert env.status() == (Status.RUNNING, None)
+    assert env.status() == (Status.RUNNING, None)
+    (status, output) = env.status()
+    assert status.is_succeeded
+    assert output == {
+        "fleet": {
+            "vm-1": {"status": "SUCCEEDED", "output": {"score": 1.0}},
+            "vm-2": {"status": "SUCCEEDED", "output": {"score": 1.0}},
+        }
+    }
+    # The completed VMs are not polled again.
+    assert polls == {"vm-1": 2, "vm-2": 3}
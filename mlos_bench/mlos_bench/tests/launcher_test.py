@@ -5,16 +5,26 @@
 """
 Unit tests to check the main CLI launcher.
 """
+import json
 import os
+import subprocess
+import sys
 
 import pytest
 
+from mlos_bench.launcher import worker_seed_of
 from mlos_bench.services.local.local_exec import LocalExecService
 from mlos_bench.services.config_persistence import ConfigPersistenceService
 from mlos_bench.util import path_join
 
 # pylint: disable=redefined-outer-name
 
+STARTUP_BUDGET_SEC = 5.0
+"""
+Max. time to import the mlos_bench entry point in a fresh interpreter.
+Generous, to keep the test stable on the slow CI machines; the typical time is well under a second.
+"""
+
 
 @pytest.fixture
 def root_path() -> str:
@@ -58,3 +68,41 @@ def test_launch_main_app(root_path: str,
                 ln for ln in best_score_lines
                 if " best score: 60.0" in ln
             ]) == 1
+
+
+def test_launch_parallel_collision(root_path: str,
+                                   local_exec_service: LocalExecService) -> None:
+    """
+    Reject the concurrent trial runners whose environments cannot be told apart.
+    """
+    cmd = "./mlos_bench/mlos_bench/run.py" + \
+          " --config mlos_bench/mlos_bench/tests/config/cli/mock-1shot.jsonc" + \
+          " --trial_parallelism 2"
+    (return_code, _stdout, stderr) = local_exec_service.local_exec([cmd], cwd=root_path)
+    assert return_code != 0
+    assert "Trial runners 1 and 2 have identical environments" in stderr
+
+
+def test_launch_startup_budget() -> None:
+    """
+    Check that the mlos_bench entry point loads quickly and does not import
+    mlos_core and the ML stacks of its optimizers unless the config uses them.
+    """
+    heavy_modules = ["mlos_core", "ConfigSpace", "smac", "emukit", "flaml", "sklearn"]
+    code = "import json, sys, time; start = time.perf_counter(); import mlos_bench.run; " + \
+        "print(json.dumps({'elapsed': time.perf_counter() - start, " + \
+        f"'loaded': [name for name in {heavy_modules!r} if name in sys.modules]}}))"
+    output = subprocess.run([sys.executable, "-c", code], check=True, capture_output=True, text=True).stdout
+    startup = json.loads(output.strip().splitlines()[-1])
+    assert startup["loaded"] == []
+    assert startup["elapsed"] < STARTUP_BUDGET_SEC
+
+
+def test_worker_seed() -> None:
+    """
+    The workers sharing the experiment get different, but stable, optimizer seeds.
+    """
+    assert worker_seed_of(42, "host-a:1") == worker_seed_of(42, "host-a:1")
+    assert worker_seed_of(42, "host-a:1") != worker_seed_of(42, "host-b:1")
+    assert worker_seed_of(42, "host-a:1") != worker_seed_of(43, "host-a:1")
+    assert 0 <= worker_seed_of(42, "host-a:1") < 2**32
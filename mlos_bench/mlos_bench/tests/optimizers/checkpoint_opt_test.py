@@ -0,0 +1,82 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Unit tests for the checkpoints of the mlos_bench optimizers.
+"""
+
+import pytest
+
+from mlos_bench.environments.status import Status
+from mlos_bench.optimizers.mock_optimizer import MockOptimizer
+from mlos_bench.optimizers.mlos_core_optimizer import MlosCoreOptimizer
+from mlos_bench.tunables.tunable_groups import TunableGroups
+
+
+def _score(tunables: TunableGroups) -> float:
+    (tunable, _group) = tunables.get_tunable("kernel_sched_migration_cost_ns")
+    return tunable.numerical_value / 1000
+
+
+@pytest.mark.parametrize(("optimizer_type"), ["SMAC", "RANDOM"])
+def test_mlos_core_checkpoint(tunable_groups: TunableGroups, optimizer_type: str) -> None:
+    """
+    Resume the mlos_core optimizer from a checkpoint instead of replaying the history.
+    """
+    config = {
+        "optimizer_type": optimizer_type,
+        "max_iterations": 10,
+        "seed": 42,
+    }
+    opt = MlosCoreOptimizer(tunables=tunable_groups, service=None, config=config)
+    for _ in range(5):
+        tunables = opt.suggest()
+        opt.register(tunables, Status.SUCCEEDED, {"score": _score(tunables)})
+    checkpoint = opt.checkpoint()
+
+    restored = MlosCoreOptimizer(tunables=tunable_groups, service=None, config=config)
+    restored.restore(checkpoint)
+    assert restored.get_best_observation() == opt.get_best_observation()
+    tunables = restored.suggest()
+    restored.register(tunables, Status.SUCCEEDED, {"score": _score(tunables)})
+    # pylint: disable=protected-access
+    assert len(restored._opt.get_observations()) == 6
+
+
+def test_checkpoint_incompatible(tunable_groups: TunableGroups) -> None:
+    """
+    The checkpoints of a different optimizer or targets are rejected.
+    """
+    opt = MockOptimizer(tunables=tunable_groups, service=None, config={"seed": 42})
+    tunables = opt.suggest()
+    opt.register(tunables, Status.SUCCEEDED, {"score": 1.0})
+    checkpoint = opt.checkpoint()
+
+    restored = MockOptimizer(tunables=tunable_groups, service=None, config={"seed": 42})
+    restored.restore(checkpoint)
+    assert restored.get_best_observation() == opt.get_best_observation()
+
+    with pytest.raises(ValueError):
+        MockOptimizer(tunables=tunable_groups, service=None,
+                      config={"maximize": "score"}).restore(checkpoint)
+    with pytest.raises(ValueError):
+        MlosCoreOptimizer(tunables=tunable_groups, service=None,
+                          config={"optimizer_type": "RANDOM"}).restore(checkpoint)
+
+
+@pytest.mark.parametrize(("blob"), [
+    b"",
+    b"garbage",
+    b'{"class": "MockOptimizer"}',
+    # A pickle is never loaded.
+    b"\x80\x04\x95\x1d\x00\x00\x00\x00\x00\x00\x00\x8c\x02os\x94\x8c\x06system\x94\x93\x94.",
+])
+def test_checkpoint_invalid(tunable_groups: TunableGroups, blob: bytes) -> None:
+    """
+    Malformed or non-JSON checkpoints are rejected with a ValueError.
+    """
+    opt = MockOptimizer(tunables=tunable_groups, service=None, config={"seed": 42})
+    with pytest.raises(ValueError):
+        opt.restore(blob)
+    assert opt.get_best_observation() == (None, None)
@@ -0,0 +1,193 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Unit tests for the cost-aware mode of the mlos_core optimizers.
+"""
+
+from typing import Any, Dict, List, Optional
+
+import numpy as np
+import pandas as pd
+import pytest
+
+from mlos_core.optimizers.bayesian_optimizers import SmacOptimizer
+
+from mlos_bench.environments.status import Status
+from mlos_bench.optimizers.mlos_core_optimizer import MlosCoreOptimizer
+from mlos_bench.tunables.tunable_groups import TunableGroups
+
+# pylint: disable=protected-access
+
+
+def _cost_aware_smac(tunable_groups: TunableGroups, monkeypatch: pytest.MonkeyPatch,
+                     cost_aware_config: dict) -> MlosCoreOptimizer:
+    """
+    Create a cost-aware SMAC optimizer with the same acquisition value for all configs.
+    """
+    opt = MlosCoreOptimizer(
+        tunables=tunable_groups,
+        service=None,
+        config={
+            "optimizer_type": "SMAC",
+            "max_iterations": 10,
+            "seed": 42,
+            "cost_aware": cost_aware_config,
+        },
+    )
+    monkeypatch.setattr(opt._opt, "acquisition_function",
+                        lambda configs, context=None: np.ones(len(configs)))
+    return opt
+
+
+def _get_pool(opt: MlosCoreOptimizer) -> List[TunableGroups]:
+    """
+    Get all candidates of the cost-aware optimizer, including the SMAC suggestion.
+    """
+    opt._fill_candidates()
+    assert opt._untold_suggestion is not None
+    return opt._from_df(pd.concat([opt._untold_suggestion, opt._candidates], ignore_index=True))
+
+
+def test_cost_aware_suggest(tunable_groups: TunableGroups, monkeypatch: pytest.MonkeyPatch) -> None:
+    """
+    With the same acquisition values, the cost-aware optimizer
+    must always choose the candidate that is the cheapest to switch to.
+    """
+    opt = _cost_aware_smac(tunable_groups, monkeypatch, {"candidates": 5, "benchmark_cost": 10})
+    tunables = opt.suggest()    # Defaults first.
+    assert tunables.get_param_values() == tunable_groups.get_param_values()
+    opt.register(tunables, Status.SUCCEEDED, 1.0)
+    for i in range(5):
+        prev_tunables = opt._current_tunables
+        assert prev_tunables is not None
+        pool = _get_pool(opt)
+        assert len(pool) == 5
+        tunables = opt.suggest()
+        assert opt._current_tunables is tunables
+        costs = [opt._get_switch_cost(config, prev_tunables) for config in pool]
+        assert opt._get_switch_cost(tunables, prev_tunables) == min(costs)
+        opt.register(tunables, Status.SUCCEEDED, float(i))
+
+
+def test_cost_aware_suggest_batch(tunable_groups: TunableGroups, monkeypatch: pytest.MonkeyPatch) -> None:
+    """
+    Check that the cost of each suggestion of the batch is computed
+    relative to the current config of its own environment.
+    """
+    opt = _cost_aware_smac(tunable_groups, monkeypatch, {"candidates": 5})
+    tunables = opt.suggest()    # Defaults first.
+    opt.register(tunables, Status.SUCCEEDED, 1.0)
+    current_configs = [
+        tunable_groups.copy(),
+        tunable_groups.copy().assign({"vmSize": "Standard_B2s", "idle": "mwait"}),
+    ]
+    for current in current_configs:
+        pool = _get_pool(opt)
+        tunables = opt.suggest_batch(1, [current])[0]
+        costs = [opt._get_switch_cost(config, current) for config in pool]
+        assert opt._get_switch_cost(tunables, current) == min(costs)
+    # The batch does not change the current config of the sequential mode.
+    assert opt._current_tunables is not None
+    assert opt._current_tunables.get_param_values() == tunable_groups.get_param_values()
+    # The pool is dropped after the registration.
+    opt.register(tunables, Status.SUCCEEDED, 2.0)
+    assert len(opt._candidates) == 0
+
+
+def test_cost_aware_smac(tunable_groups: TunableGroups) -> None:
+    """
+    Check that the cost-aware mode never leaves more than one SMAC suggestion without the results.
+    """
+    opt = MlosCoreOptimizer(
+        tunables=tunable_groups,
+        service=None,
+        config={
+            "optimizer_type": "SMAC",
+            "max_iterations": 10,
+            "n_random_init": 2,
+            "seed": 42,
+            "cost_aware": {"candidates": 5},
+        },
+    )
+    smac = opt._opt
+    assert isinstance(smac, SmacOptimizer)
+    tunables = opt.suggest()    # Defaults first.
+    opt.register(tunables, Status.SUCCEEDED, 1.0)
+    for i in range(5):
+        suggestions = opt.suggest_batch(2, [tunables, None])
+        assert len(suggestions) == 2
+        assert len(smac.trial_info_map) <= 1
+        for (j, tunables) in enumerate(suggestions):
+            opt.register(tunables, Status.SUCCEEDED, float(i + j))
+            assert len(opt._candidates) == 0
+        assert len(smac.trial_info_map) <= 1
+    assert len(smac.get_observations()) == 11
+
+
+def test_cost_aware_bad_config(tunable_groups: TunableGroups) -> None:
+    """
+    Check that the optimizer rejects non-positive benchmark cost.
+    """
+    with pytest.raises(ValueError):
+        MlosCoreOptimizer(
+            tunables=tunable_groups,
+            service=None,
+            config={
+                "optimizer_type": "SMAC",
+                "cost_aware": {"benchmark_cost": 0},
+            },
+        )
+
+
+@pytest.mark.parametrize(("optimizer_type", "space_adapter_type"), [
+    ("RANDOM", None),
+    ("FLAML", None),
+    ("EMUKIT", None),
+    ("SMAC", "LLAMATUNE"),
+])
+def test_cost_aware_no_acquisition(tunable_groups: TunableGroups,
+                                   optimizer_type: str, space_adapter_type: Optional[str]) -> None:
+    """
+    Check that the cost-aware mode is rejected for the optimizers
+    that cannot score the candidates with the acquisition function.
+    """
+    config: Dict[str, Any] = {
+        "optimizer_type": optimizer_type,
+        "cost_aware": {"candidates": 5},
+    }
+    if space_adapter_type is not None:
+        config["space_adapter_type"] = space_adapter_type
+    with pytest.raises(ValueError, match="acquisition function"):
+        MlosCoreOptimizer(tunables=tunable_groups, service=None, config=config)
+
+
+def test_cost_aware_acquisition(tunable_groups: TunableGroups) -> None:
+    """
+    Check that SMAC scores the cost-aware candidates once its model is trained.
+    """
+    opt = MlosCoreOptimizer(
+        tunables=tunable_groups,
+        service=None,
+        config={
+            "optimizer_type": "SMAC",
+            "max_iterations": 10,
+            "n_random_init": 2,
+            "seed": 42,
+            "cost_aware": {"candidates": 5},
+        },
+    )
+    smac = opt._opt
+    assert isinstance(smac, SmacOptimizer)
+    for i in range(5):
+        suggestion = smac.suggest()
+        smac.register(suggestion, pd.Series([float(i)]))
+    df_pool = opt._to_df(_get_pool(opt))   # Trains the model.
+    # The factory always sets the (identity) space adapter.
+    assert smac.space_adapter is not None
+    raw_values = smac.acquisition_function(df_pool)
+    assert raw_values.shape == (5,)
+    values = opt._get_acquisition(df_pool)
+    assert (values > 0).all()
+    assert values == pytest.approx(raw_values - min(raw_values.min(), 0.0) + opt._ACQUISITION_EPSILON)
@@ -0,0 +1,90 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Unit tests for the median stopping rule.
+"""
+
+import pytest
+
+from mlos_bench.environments.status import Status
+from mlos_bench.optimizers.early_stopping import MedianStoppingRule
+from mlos_bench.optimizers.mock_optimizer import MockOptimizer
+from mlos_bench.tunables.tunable_groups import TunableGroups
+
+
+def _complete_trials(rule: MedianStoppingRule, scores: list) -> None:
+    """
+    Feed the telemetry of several completed trials into the rule.
+    """
+    for (trial_id, values) in enumerate(scores):
+        for val in values:
+            assert not rule.update(trial_id, {"score": val})
+        rule.complete(trial_id, is_succeeded=True)
+
+
+def test_median_stopping_minimize() -> None:
+    """
+    Stop the trial that is worse than the median when minimizing the score.
+    """
+    rule = MedianStoppingRule({"min_steps": 2, "min_trials": 3}, "score", 1)
+    _complete_trials(rule, [[10, 8, 6], [12, 10, 8], [14, 12, 10]])
+
+    # The first step never stops the trial.
+    assert not rule.update(100, {"score": 50})
+    # Best value so far is 50 vs. median of the running means 11.
+    assert rule.update(100, {"score": 60})
+    # The censored score is pessimistic: the worst value so far.
+    assert rule.censored_score(100) == 60
+
+    # A good trial keeps running.
+    assert not rule.update(101, {"score": 9})
+    assert not rule.update(101, {"score": 7})
+
+
+def test_median_stopping_maximize() -> None:
+    """
+    Stop the trial that is worse than the median when maximizing the score.
+    """
+    rule = MedianStoppingRule({"min_steps": 2, "min_trials": 1}, "score", -1)
+    _complete_trials(rule, [[10, 20]])
+    assert not rule.update(100, {"score": 1})
+    assert rule.update(100, {"score": 2})
+    assert rule.censored_score(100) == 1
+
+
+def test_median_stopping_not_enough_trials() -> None:
+    """
+    Do not stop any trials until enough successful trials have completed.
+    """
+    rule = MedianStoppingRule({"min_steps": 1, "min_trials": 2}, "score", 1)
+    _complete_trials(rule, [[10]])
+    # Failed trials do not count towards the median.
+    rule.update(1, {"score": 1})
+    rule.complete(1, is_succeeded=False)
+    assert not rule.update(100, {"score": 100})
+    # Samples without the target metric are ignored.
+    assert not rule.update(101, {"other": 1})
+    assert rule.censored_score(101) is None
+
+
+def test_register_canceled(tunable_groups: TunableGroups) -> None:
+    """
+    Register the censored score of the trial that has been stopped early.
+    """
+    opt = MockOptimizer(
+        tunables=tunable_groups,
+        service=None,
+        config={
+            "minimize": "score",
+            "max_iterations": 5,
+            "early_stopping": {"min_steps": 2},
+        },
+    )
+    assert opt.early_stopping is not None
+    tunables = opt.suggest()
+    assert opt.register(tunables, Status.CANCELED, {"score": 42.0}) == pytest.approx(42.0)
+    assert opt.register(tunables, Status.CANCELED) is None
+    with pytest.raises(ValueError):
+        opt.register(tunables, Status.FAILED, {"score": 42.0})
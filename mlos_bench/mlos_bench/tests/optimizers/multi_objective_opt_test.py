@@ -0,0 +1,93 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Unit tests for the multi-objective optimization in mlos_bench.
+"""
+
+import pytest
+import pandas as pd
+
+from mlos_bench.environments.status import Status
+from mlos_bench.optimizers.mock_optimizer import MockOptimizer
+from mlos_bench.optimizers.mlos_core_optimizer import MlosCoreOptimizer
+from mlos_bench.tunables.tunable_groups import TunableGroups
+
+
+def test_opt_targets_config(tunable_groups: TunableGroups) -> None:
+    """
+    Check the parsing of the optimization targets in the optimizer config.
+    """
+    opt = MockOptimizer(tunables=tunable_groups, service=None, config={
+        "optimization_targets": {"latency": "min", "throughput": "max"},
+    })
+    assert opt.is_multi_objective
+    assert opt.target == "latency"
+    assert opt.targets == {"latency": "min", "throughput": "max"}
+    assert repr(opt) == "MockOptimizer:min(latency),max(throughput)"
+
+    opt = MockOptimizer(tunables=tunable_groups, service=None, config={"maximize": "throughput"})
+    assert not opt.is_multi_objective
+    assert opt.targets == {"throughput": "max"}
+    assert repr(opt) == "MockOptimizer:max(throughput)"
+
+    for config in [
+        {"optimization_targets": {}},
+        {"optimization_targets": {"latency": "lowest"}},
+        {"optimization_targets": {"latency": "min"}, "minimize": "score"},
+    ]:
+        with pytest.raises(ValueError):
+            MockOptimizer(tunables=tunable_groups, service=None, config=config)
+
+
+def test_mlos_core_multi_objective(tunable_groups: TunableGroups) -> None:
+    """
+    Register the results of several targets with the mlos_core optimizer.
+    """
+    opt = MlosCoreOptimizer(tunables=tunable_groups, service=None, config={
+        "optimization_targets": {"latency": "min", "throughput": "max"},
+        "optimizer_type": "SMAC",
+        "max_iterations": 10,
+        "seed": 42,
+    })
+    results = []
+    while opt.not_converged():
+        tunables = opt.suggest()
+        (tunable, _group) = tunables.get_tunable("kernel_sched_migration_cost_ns")
+        latency = tunable.numerical_value / 1000
+        result = {"latency": latency, "throughput": 2 * latency, "memory": 1.0}
+        results.append(result)
+        assert opt.register(tunables, Status.SUCCEEDED, result) == latency
+    # Early stopped trials without all the targets are not registered.
+    opt.register(opt.suggest(), Status.CANCELED, {"latency": 0.0})
+
+    (score, _) = opt.get_best_observation()
+    assert score == min(res["latency"] for res in results)
+
+    # The mlos_core optimizer minimizes all objectives.
+    observations = opt._opt.get_observations()  # pylint: disable=protected-access
+    assert len(observations) == len(results)
+    assert observations["throughput"].tolist() == [-res["throughput"] for res in results]
+
+    # All results are required for each target.
+    with pytest.raises(ValueError):
+        opt.register(opt.suggest(), Status.SUCCEEDED, 1.0)
+
+
+def test_mlos_core_multi_objective_bulk_register(tunable_groups: TunableGroups) -> None:
+    """
+    Warm up the multi-objective mlos_core optimizer with the data from the storage.
+    """
+    opt = MlosCoreOptimizer(tunables=tunable_groups, service=None, config={
+        "optimization_targets": {"latency": "min", "throughput": "max"},
+        "optimizer_type": "RANDOM",
+    })
+    configs = pd.DataFrame([tunable_groups.get_param_values()] * 2)
+    scores = pd.DataFrame({"latency": [10.0, 5.0], "throughput": [1.0, 2.0]})
+    assert opt.bulk_register_data(configs, scores)
+    (score, _) = opt.get_best_observation()
+    assert score == 5.0
+    # The scores of all targets are required.
+    with pytest.raises(ValueError):
+        opt.bulk_register_data(configs, scores["latency"])
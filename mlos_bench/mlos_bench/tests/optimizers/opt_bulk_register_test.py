@@ -9,11 +9,13 @@ Unit tests for mock mlos_bench optimizer.
 from typing import Optional, List
 
 import pytest
+import pandas as pd
 
 from mlos_bench.environments.status import Status
 from mlos_bench.optimizers.base_optimizer import Optimizer
 from mlos_bench.optimizers.mock_optimizer import MockOptimizer
 from mlos_bench.optimizers.mlos_core_optimizer import MlosCoreOptimizer
+from mlos_bench.tunables.tunable_groups import TunableGroups
 
 # pylint: disable=redefined-outer-name
 
@@ -167,3 +169,107 @@ def test_update_smac(smac_opt: MlosCoreOptimizer, mock_configs: List[dict],
     Test the bulk update of the SMAC optimizer.
     """
     _test_opt_update_min(smac_opt, mock_configs, mock_scores, mock_status)
+
+
+@pytest.mark.parametrize(("opt_fixture"), ["mock_opt", "flaml_opt"])
+def test_update_data(request: pytest.FixtureRequest, opt_fixture: str,
+                     mock_configs_str: List[dict], mock_scores: List[float]) -> None:
+    """
+    Test the bulk update of the optimizers with the columnar (all-strings) data
+    as it is returned by `Storage.Experiment.load_data()`.
+    """
+    opt: Optimizer = request.getfixturevalue(opt_fixture)
+    # Only the successful trials get loaded from the storage.
+    opt.bulk_register_data(pd.DataFrame(mock_configs_str[1:]), pd.Series(mock_scores[1:]))
+    (score, tunables) = opt.get_best_observation()
+    assert score == pytest.approx(66.66, 0.01)
+    assert tunables is not None
+    assert tunables.get_param_values() == {
+        "vmSize": "Standard_B4ms",
+        "idle": "mwait",
+        "kernel_sched_migration_cost_ns": 100000,
+        'kernel_sched_latency_ns': 3000000,
+    }
+
+
+def test_warm_start_initial_design(tunable_groups: TunableGroups, mock_configs_str: List[dict],
+                                   mock_scores: List[float]) -> None:
+    """
+    Check that in the `initial_design` warm start mode the optimizer
+    re-evaluates the best configs of the merged-in experiments first.
+    """
+    opt = MockOptimizer(
+        tunables=tunable_groups,
+        service=None,
+        config={
+            "minimize": "score",
+            "max_iterations": 5,
+            "seed": 42,
+            "warm_start": {"mode": "initial_design", "top_k": 2},
+        },
+    )
+    assert opt.warm_start(pd.DataFrame(mock_configs_str[1:]), pd.Series(mock_scores[1:]))
+    # The scores of the merged-in data are not registered as observations.
+    assert opt.get_best_observation() == (None, None)
+    suggestions = opt.suggest_batch(3)
+    assert [tunables.get_param_values() for tunables in suggestions[:2]] == [
+        {
+            "vmSize": "Standard_B4ms",
+            "idle": "mwait",
+            "kernel_sched_migration_cost_ns": 100000,
+            'kernel_sched_latency_ns': 3000000,
+        },
+        {
+            "vmSize": "Standard_B4ms",
+            "idle": "halt",
+            "kernel_sched_migration_cost_ns": 40000,
+            'kernel_sched_latency_ns': 2000000,
+        },
+    ]
+
+
+def test_warm_start_skip_tried(tunable_groups: TunableGroups, mock_configs_str: List[dict],
+                               mock_scores: List[float]) -> None:
+    """
+    Check that the `initial_design` warm start does not re-evaluate the configs
+    that have been tried in the current experiment already (e.g., on resume),
+    and skips the configs that do not fit the current tunables.
+    """
+    opt = MockOptimizer(
+        tunables=tunable_groups,
+        service=None,
+        config={
+            "minimize": "score",
+            "max_iterations": 5,
+            "seed": 42,
+            "warm_start": {"mode": "initial_design", "top_k": 2},
+        },
+    )
+    # The best config of all is outside of the current tunable ranges.
+    out_of_range = {**mock_configs_str[1], "kernel_sched_migration_cost_ns": "9999999"}
+    configs = pd.DataFrame(mock_configs_str[1:] + [out_of_range])
+    assert opt.warm_start(configs, pd.Series(mock_scores[1:] + [1.0]),
+                          exclude=pd.DataFrame([mock_configs_str[2]]))
+    # The best config has been tried already, but it still counts towards `top_k`.
+    assert opt.suggest().get_param_values() == {
+        "vmSize": "Standard_B4ms",
+        "idle": "halt",
+        "kernel_sched_migration_cost_ns": 40000,
+        'kernel_sched_latency_ns': 2000000,
+    }
+    assert opt._pop_warm_start() is None   # pylint: disable=protected-access
+
+
+@pytest.mark.parametrize(("opt_fixture"), ["mock_opt", "flaml_opt"])
+def test_warm_start_out_of_range(request: pytest.FixtureRequest, opt_fixture: str,
+                                 mock_configs_str: List[dict], mock_scores: List[float]) -> None:
+    """
+    Check that the configs that do not fit the current tunables are skipped
+    instead of failing the warm start.
+    """
+    opt: Optimizer = request.getfixturevalue(opt_fixture)
+    out_of_range = {**mock_configs_str[1], "idle": "poll"}
+    assert opt.warm_start(pd.DataFrame(mock_configs_str[1:] + [out_of_range]),
+                          pd.Series(mock_scores[1:] + [1.0]))
+    (score, _tunables) = opt.get_best_observation()
+    assert score == pytest.approx(66.66, 0.01)
@@ -0,0 +1,345 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Unit tests for running the optimization loop with several trials in flight.
+"""
+from pathlib import Path
+from typing import Any, Dict, List, Optional, Tuple
+
+import pytest
+
+from sqlalchemy import select
+
+from mlos_bench.run import _optimize
+from mlos_bench.environments.mock_env import MockEnv
+from mlos_bench.environments.status import Status
+from mlos_bench.optimizers.mock_optimizer import MockOptimizer
+from mlos_bench.storage.sql.experiment import Experiment
+from mlos_bench.storage.sql.storage import SqlStorage
+from mlos_bench.storage.sql.trial import Trial
+from mlos_bench.tunables.tunable_groups import TunableGroups
+
+# pylint: disable=redefined-outer-name
+
+
+class AsyncMockEnv(MockEnv):
+    """
+    MockEnv that only submits the benchmark in `.run()`
+    and produces the results after a few `.status()` calls.
+    """
+
+    def __init__(self, **kwargs: Any):
+        super().__init__(**kwargs)
+        self._polls_left: Optional[int] = None
+        self.num_polls = 0
+
+    def run(self) -> Tuple[Status, Optional[dict]]:
+        self._polls_left = 2
+        return (Status.PENDING, None)
+
+    def status(self) -> Tuple[Status, Optional[dict]]:
+        if self._polls_left is None:
+            return super().status()
+        self.num_polls += 1
+        if self._polls_left > 0:
+            self._polls_left -= 1
+            return (Status.RUNNING, None)
+        self._polls_left = None
+        return super().run()
+
+
+class StealingMockEnv(MockEnv):
+    """
+    MockEnv that hands the first trial it runs over to another worker
+    sharing the experiment, as if the lease on the trial has been lost.
+    """
+
+    def __init__(self, *, storage: SqlStorage, **kwargs: Any):
+        super().__init__(**kwargs)
+        self._storage = storage
+        self.stolen = False
+
+    def run(self) -> Tuple[Status, Optional[dict]]:
+        if not self.stolen:
+            self.stolen = True
+            # pylint: disable=protected-access
+            schema = self._storage._schema
+            with self._storage._engine.begin() as conn:
+                conn.execute(schema.trial.update().values(worker_id="worker-b"))
+        return super().run()
+
+
+@pytest.fixture
+def mock_env_pool(tunable_groups: TunableGroups) -> List[MockEnv]:
+    """
+    Test fixture for a pool of independent MockEnv instances.
+    """
+    return [
+        MockEnv(
+            name=f"Test Env {i}",
+            config={
+                "range": [60, 120],
+                "metrics": ["score"],
+            },
+            tunables=tunable_groups.copy()
+        )
+        for i in range(3)
+    ]
+
+
+@pytest.fixture
+def async_mock_env_pool(tunable_groups: TunableGroups) -> List[AsyncMockEnv]:
+    """
+    Test fixture for a pool of independent AsyncMockEnv instances.
+    """
+    return [
+        AsyncMockEnv(
+            name=f"Test Async Env {i}",
+            config={
+                "range": [60, 120],
+                "metrics": ["score"],
+            },
+            tunables=tunable_groups.copy()
+        )
+        for i in range(2)
+    ]
+
+
+@pytest.fixture
+def mock_opt(tunable_groups: TunableGroups) -> MockOptimizer:
+    """
+    Test fixture for MockOptimizer (same as in `optimizers/conftest.py`).
+    """
+    return MockOptimizer(
+        tunables=tunable_groups,
+        service=None,
+        config={
+            "minimize": "score",
+            "max_iterations": 5,
+            "seed": 42
+        },
+    )
+
+
+@pytest.fixture
+def storage(tunable_groups: TunableGroups) -> SqlStorage:
+    """
+    Test fixture for in-memory SQLite3 storage.
+    """
+    return SqlStorage(
+        tunables=tunable_groups,
+        service=None,
+        config={
+            "drivername": "sqlite",
+            "database": ":memory:",
+        }
+    )
+
+
+def test_optimize_parallel(mock_env_pool: List[MockEnv],
+                           mock_opt: MockOptimizer,
+                           storage: SqlStorage) -> None:
+    """
+    Run the optimization loop with several environments and make sure
+    all trials complete and none of them exceed the iteration budget.
+    """
+    (score, tunables) = _optimize(
+        mock_env_pool[0], mock_opt, storage, "environment.jsonc",
+        {"experimentId": "Test-Parallel-001"}, env_pool=mock_env_pool)
+
+    assert isinstance(score, float) and 60 <= score <= 120
+    assert isinstance(tunables, TunableGroups)
+    assert mock_opt.num_pending == 0
+    assert not mock_opt.not_converged()
+
+    with storage.experiment(experiment_id="Test-Parallel-001",
+                            trial_id=1,
+                            root_env_config="environment.jsonc",
+                            description="pytest experiment",
+                            opt_target="score") as exp:
+        assert not list(exp.pending_trials())
+        (configs, scores) = exp.load()
+        assert len(configs) == len(scores) == 5
+
+
+@pytest.mark.parametrize(("n_envs"), [1, 2])
+def test_optimize_async(async_mock_env_pool: List[AsyncMockEnv],
+                        mock_opt: MockOptimizer,
+                        storage: SqlStorage,
+                        n_envs: int,
+                        monkeypatch: pytest.MonkeyPatch) -> None:
+    """
+    Run the optimization loop with the environments that run the benchmarks
+    asynchronously and make sure the results are polled until completion.
+    """
+    statuses: List[Status] = []
+    update_telemetry = Trial.update_telemetry
+
+    def _update_telemetry(self: Trial, status: Status, *args: Any, **kwargs: Any) -> None:
+        statuses.append(status)
+        update_telemetry(self, status, *args, **kwargs)
+
+    monkeypatch.setattr(Trial, "update_telemetry", _update_telemetry)
+    env_pool = async_mock_env_pool[:n_envs]
+    (score, _tunables) = _optimize(
+        env_pool[0], mock_opt, storage, "environment.jsonc",
+        {"experimentId": f"Test-Async-{n_envs}", "pollInterval": 0}, env_pool=env_pool)
+
+    assert isinstance(score, float) and 60 <= score <= 120
+    assert mock_opt.num_pending == 0
+    # Each of the 5 trials is polled 3 times: 2x RUNNING, then SUCCEEDED.
+    assert sum(env.num_polls for env in env_pool) == 5 * 3
+    # The RUNNING status without telemetry is saved only once per trial.
+    assert statuses.count(Status.RUNNING) == 5
+
+
+def test_optimize_reuse_results(mock_env_pool: List[MockEnv],
+                                mock_opt: MockOptimizer,
+                                storage: SqlStorage,
+                                tunable_groups: TunableGroups,
+                                monkeypatch: pytest.MonkeyPatch) -> None:
+    """
+    Make the optimizer suggest the same configuration over and over
+    and check that it is benchmarked only `trialRepeats` times,
+    and the reused results are registered with the optimizer only once.
+    """
+    monkeypatch.setattr(mock_opt, "suggest", tunable_groups.copy)
+    registered: List[Status] = []
+    register = mock_opt.register
+
+    def _register(tunables: TunableGroups, status: Status, *args: Any, **kwargs: Any) -> Optional[float]:
+        registered.append(status)
+        return register(tunables, status, *args, **kwargs)
+
+    monkeypatch.setattr(mock_opt, "register", _register)
+    (score, _tunables) = _optimize(
+        mock_env_pool[0], mock_opt, storage, "environment.jsonc",
+        {"experimentId": "Test-Reuse-001", "trialRepeats": 2})
+
+    assert isinstance(score, float) and 60 <= score <= 120
+    assert not mock_opt.not_converged()
+    # Two trials, plus their averaged results reused once.
+    assert registered == [Status.SUCCEEDED] * 3
+    # The later repeats are skipped without leaving any pending configs behind.
+    assert mock_opt.num_pending == 0
+
+    with storage.experiment(experiment_id="Test-Reuse-001",
+                            trial_id=1,
+                            root_env_config="environment.jsonc",
+                            description="pytest experiment",
+                            opt_target="score") as exp:
+        (configs, scores) = exp.load()
+        assert len(configs) == len(scores) == 2
+        assert len(exp.get_results(tunable_groups)) == 2
+
+
+@pytest.mark.parametrize(("trial_repeats"), [0, -1])
+def test_optimize_bad_trial_repeats(mock_env_pool: List[MockEnv],
+                                    mock_opt: MockOptimizer,
+                                    storage: SqlStorage,
+                                    trial_repeats: int) -> None:
+    """
+    Make sure non-positive `trialRepeats` values are rejected.
+    """
+    with pytest.raises(ValueError):
+        _optimize(mock_env_pool[0], mock_opt, storage, "environment.jsonc",
+                  {"experimentId": "Test-Reuse-002", "trialRepeats": trial_repeats})
+
+
+@pytest.mark.parametrize(("n_envs"), [1, 3])
+def test_optimize_timings(mock_env_pool: List[MockEnv],
+                          mock_opt: MockOptimizer,
+                          storage: SqlStorage,
+                          n_envs: int) -> None:
+    """
+    Check that the time of each phase of every trial is saved as its telemetry.
+    """
+    env_pool = mock_env_pool[:n_envs]
+    _optimize(env_pool[0], mock_opt, storage, "environment.jsonc",
+              {"experimentId": f"Test-Timings-{n_envs}"}, env_pool=env_pool)
+
+    with storage.experiment(experiment_id=f"Test-Timings-{n_envs}",
+                            trial_id=1,
+                            root_env_config="environment.jsonc",
+                            description="pytest experiment",
+                            opt_target="score") as exp:
+        assert isinstance(exp, Experiment)
+        table = exp._schema.trial_telemetry  # pylint: disable=protected-access
+        with exp._engine.connect() as conn:  # pylint: disable=protected-access
+            rows = conn.execute(select(table.c.trial_id, table.c.metric_id, table.c.metric_num)).fetchall()
+
+    timings: Dict[int, Dict[str, float]] = {}
+    for (trial_id, metric, value) in rows:
+        timings.setdefault(trial_id, {})[metric] = value
+    assert len(timings) == 5
+    for metrics in timings.values():
+        for phase in ("opt.suggest", "storage.new_trial", "env.setup", "env.run",
+                      "storage.update", "opt.register"):
+            assert metrics[f"timing.{phase}"] >= 0
+            assert metrics[f"timing.{phase}.calls"] == 1
+
+
+def test_register_pending(mock_opt: MockOptimizer) -> None:
+    """
+    Check that pending configurations count towards the iteration budget
+    and are released once the results are registered.
+    """
+    suggestions = []
+    while mock_opt.not_converged():
+        tunables = mock_opt.suggest()
+        mock_opt.register_pending(tunables)
+        suggestions.append(tunables)
+
+    assert len(suggestions) == 5
+    assert mock_opt.num_pending == 5
+    # Only the first suggestion uses the default values.
+    assert suggestions[1] != suggestions[0]
+
+    for tunables in reversed(suggestions):
+        mock_opt.register(tunables, Status.SUCCEEDED, 100.0)
+
+    assert mock_opt.num_pending == 0
+    assert not mock_opt.not_converged()
+
+
+def test_optimize_lease_lost(tmp_path: Path, mock_opt: MockOptimizer,
+                             tunable_groups: TunableGroups) -> None:
+    """
+    The worker drops the trial that another worker has taken over and moves on.
+    """
+    storage = SqlStorage(
+        tunables=tunable_groups,
+        service=None,
+        config={
+            "drivername": "sqlite",
+            "database": str(tmp_path / "mlos_bench.sqlite"),
+            "coordinated": True,
+            "worker_id": "worker-a",
+        }
+    )
+    env = StealingMockEnv(
+        storage=storage,
+        name="Test Env",
+        config={
+            "range": [60, 120],
+            "metrics": ["score"],
+        },
+        tunables=tunable_groups.copy(),
+    )
+    (score, _tunables) = _optimize(env, mock_opt, storage, "environment.jsonc",
+                                   {"experimentId": "Test-Lease-Lost"})
+    assert env.stolen
+    assert isinstance(score, float) and 60 <= score <= 120
+    assert mock_opt.num_pending == 0
+    assert not mock_opt.not_converged()
+
+    with storage.experiment(experiment_id="Test-Lease-Lost",
+                            trial_id=1,
+                            root_env_config="environment.jsonc",
+                            description="pytest experiment",
+                            opt_target="score") as exp:
+        (configs, scores) = exp.load()
+        # The first trial still belongs to the other worker.
+        assert len(configs) == len(scores) == 5
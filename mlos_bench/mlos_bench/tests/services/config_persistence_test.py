@@ -8,6 +8,10 @@ Unit tests for configuration persistence service.
 
 import os
 import sys
+
+from pathlib import Path
+
+import json5
 import pytest
 
 from mlos_bench.config.schemas import ConfigSchema
@@ -84,3 +88,35 @@ def test_load_config(config_persistence_service: ConfigPersistenceService) -> No
     assert tunables_data is not None
     assert isinstance(tunables_data, dict)
     assert len(tunables_data) >= 1
+
+
+def test_load_config_cached(tmp_path: Path, monkeypatch: pytest.MonkeyPatch) -> None:
+    """
+    Check that the parsed configs are cached in memory and on disk,
+    the callers get their own copies, and the changed files are re-read.
+    """
+    config_file = os.path.join(tmp_path, "tunable-values.jsonc")
+    with open(config_file, mode="w", encoding="utf-8") as fh_config:
+        fh_config.write('{"kernel_sched_migration_cost_ns": 40000}  // JSON5\n')
+    cache_dir = os.path.join(tmp_path, "cache")
+    service = ConfigPersistenceService({"config_path": [str(tmp_path)], "config_cache_dir": cache_dir})
+
+    config = service.load_config("tunable-values.jsonc", ConfigSchema.TUNABLE_VALUES)
+    assert config == {"kernel_sched_migration_cost_ns": 40000}
+    config["kernel_sched_migration_cost_ns"] = -1
+    assert len(os.listdir(cache_dir)) == 1
+
+    # The in-memory cache is hit, and it is not affected by the changes of the copy.
+    monkeypatch.setattr(json5, "load", None)
+    assert service.load_config("tunable-values.jsonc", None) == {"kernel_sched_migration_cost_ns": 40000}
+
+    # The on-disk cache is hit when the in-memory cache is gone (e.g., on the next launch).
+    monkeypatch.setattr(ConfigPersistenceService, "_CONFIG_CACHE", {})
+    assert service.load_config("tunable-values.jsonc", None) == {"kernel_sched_migration_cost_ns": 40000}
+
+    # Changing the file invalidates the cache.
+    monkeypatch.undo()
+    with open(config_file, mode="w", encoding="utf-8") as fh_config:
+        fh_config.write('{"kernel_sched_migration_cost_ns": [40000, 50000]}\n')
+    with pytest.raises(ValueError):
+        service.load_config("tunable-values.jsonc", ConfigSchema.TUNABLE_VALUES)
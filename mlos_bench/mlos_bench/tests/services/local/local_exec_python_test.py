@@ -8,7 +8,9 @@ Unit tests for LocalExecService to run Python scripts locally.
 
 from typing import Dict
 
+import errno
 import json
+import os
 
 import pytest
 
@@ -62,3 +64,89 @@ def test_run_python_script(local_exec_service: LocalExecService) -> None:
                 'echo "40000" > /proc/sys/kernel/sched_migration_cost_ns',
                 'echo "800000" > /proc/sys/kernel/sched_granularity_ns',
             ]
+
+
+def test_run_python_worker() -> None:
+    """
+    Run a Python script several times in a persistent worker process.
+    """
+    local_exec_service = LocalExecService(
+        config={"python_worker": True}, parent=ConfigPersistenceService())
+
+    with local_exec_service.temp_dir_context() as temp_dir:
+
+        script_path = path_join(temp_dir, "print_pid.py")
+        with open(script_path, "wt", encoding="utf-8") as fh_script:
+            fh_script.write("import os, sys\n" +
+                            "print(os.getpid(), os.environ['MLOS_VAR'], *sys.argv[1:])\n" +
+                            "sys.exit(int(sys.argv[1]))\n")
+
+        pids = set()
+        for i in range(3):
+            (return_code, stdout, stderr) = local_exec_service.local_exec(
+                [f"{script_path} {i % 2} arg"], cwd=temp_dir, env={"MLOS_VAR": i})
+            assert return_code == i % 2
+            assert stderr.strip() == ""
+            (pid, var, *args) = stdout.split()
+            assert var == str(i)
+            assert args == [str(i % 2), "arg"]
+            pids.add(pid)
+
+        # The same worker process is reused, and it is not the current process.
+        assert len(pids) == 1
+        assert pids != {str(os.getpid())}
+
+
+def test_python_worker_isolation() -> None:
+    """
+    Make sure the scripts in a persistent worker do not see the environment,
+    the stdin, and the sibling modules of the previous runs.
+    """
+    local_exec_service = LocalExecService(
+        config={"python_worker": True}, parent=ConfigPersistenceService())
+
+    with local_exec_service.temp_dir_context() as temp_dir:
+
+        script_path = path_join(temp_dir, "print_env.py")
+        with open(script_path, "wt", encoding="utf-8") as fh_script:
+            fh_script.write("import os, sys\n" +
+                            "import helper\n" +
+                            "print(sorted(os.environ), repr(sys.stdin.read()), helper.VALUE)\n")
+
+        for i in range(2):
+            with open(path_join(temp_dir, "helper.py"), "wt", encoding="utf-8") as fh_helper:
+                # Different sizes so the cached bytecode of the old version is not reused.
+                fh_helper.write(f"VALUE = {10 ** i}\n")
+            env = {"MLOS_VAR_A": "a"} if i == 0 else {"MLOS_VAR_B": "b"}
+            (return_code, stdout, stderr) = local_exec_service.local_exec(
+                [script_path], cwd=temp_dir, env=env)
+            assert return_code == 0, stderr
+            # The request env replaces the worker's one; stdin is empty.
+            assert stdout.strip() == f"{sorted(env)} '' {10 ** i}"
+
+        local_exec_service.teardown()
+
+
+def test_python_worker_timeout() -> None:
+    """
+    Kill the persistent worker if the script runs for too long, and start a new one.
+    """
+    local_exec_service = LocalExecService(
+        config={"python_worker": True, "python_worker_timeout": 0.5},
+        parent=ConfigPersistenceService())
+
+    with local_exec_service.temp_dir_context() as temp_dir:
+
+        script_path = path_join(temp_dir, "sleep.py")
+        with open(script_path, "wt", encoding="utf-8") as fh_script:
+            fh_script.write("import sys, time\n" +
+                            "time.sleep(float(sys.argv[1]))\n")
+
+        (return_code, _, stderr) = local_exec_service.local_exec([f"{script_path} 60"], cwd=temp_dir)
+        assert return_code == errno.ETIMEDOUT
+        assert "timed out" in stderr
+
+        (return_code, _, _) = local_exec_service.local_exec([f"{script_path} 0"], cwd=temp_dir)
+        assert return_code == 0
+
+        local_exec_service.teardown()
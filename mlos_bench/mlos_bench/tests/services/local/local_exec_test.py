@@ -120,3 +120,25 @@ def test_run_script_fail(local_exec_service: LocalExecService) -> None:
     (return_code, stdout, _stderr) = local_exec_service.local_exec(["foo_bar_baz hello"])
     assert return_code != 0
     assert stdout.strip() == ""
+
+
+@pytest.mark.skipif(sys.platform == 'win32', reason="Batching is not supported on Windows")
+def test_run_script_batch() -> None:
+    """
+    Run a multiline script in a single shell session.
+    """
+    local_exec_service = LocalExecService(
+        config={"batch_scripts": True}, parent=ConfigPersistenceService())
+    (return_code, stdout, _stderr) = local_exec_service.local_exec([
+        "var=shared",
+        "echo $var",
+        "false",
+        "echo world",
+    ], return_on_error=True)
+    # The variable is visible in the same session; we stop at the first failure.
+    assert return_code != 0
+    assert stdout.strip().split() == ["shared"]
+
+    (return_code, stdout, _stderr) = local_exec_service.local_exec(["false", "echo world"])
+    assert return_code == 0
+    assert stdout.strip() == "world"
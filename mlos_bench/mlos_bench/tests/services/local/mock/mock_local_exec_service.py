@@ -7,9 +7,12 @@ A collection Service functions for mocking local exec.
 """
 
 import logging
+import subprocess
+import sys
 from typing import Iterable, Mapping, Optional, Tuple, TYPE_CHECKING
 
 from mlos_bench.services.base_service import Service
+from mlos_bench.services.local.local_exec import LocalProcess
 from mlos_bench.services.local.temp_dir_context import TempDirContextService
 from mlos_bench.services.types.local_exec_type import SupportsLocalExec
 
@@ -26,10 +29,18 @@ class MockLocalExecService(TempDirContextService, SupportsLocalExec):
 
     def __init__(self, config: Optional[dict] = None, parent: Optional[Service] = None):
         super().__init__(config, parent)
-        self.register([self.local_exec])
+        self.register([self.local_exec, self.local_exec_start])
 
     def local_exec(self, script_lines: Iterable[str],
                    env: Optional[Mapping[str, "TunableValue"]] = None,
                    cwd: Optional[str] = None,
                    return_on_error: bool = False) -> Tuple[int, str, str]:
         return (0, "", "")
+
+    def local_exec_start(self, script_lines: Iterable[str],
+                         env: Optional[Mapping[str, "TunableValue"]] = None,
+                         cwd: Optional[str] = None) -> LocalProcess:
+        # A process that does nothing and succeeds.
+        return LocalProcess(subprocess.Popen(  # pylint: disable=consider-using-with
+            [sys.executable, "-c", "pass"], text=True, stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+            start_new_session=(sys.platform != 'win32')))
@@ -7,8 +7,10 @@ Tests for mlos_bench.services.remote.azure.azure_fileshare
 """
 
 import os
+from pathlib import Path
 from unittest.mock import MagicMock, Mock, patch, call
 
+from mlos_bench.services.config_persistence import ConfigPersistenceService
 from mlos_bench.services.remote.azure.azure_fileshare import AzureFileShareService
 
 # pylint: disable=missing-function-docstring
@@ -222,3 +224,52 @@ def test_upload_directory_recursive(mock_scandir: MagicMock,
         call(f"{remote_folder}/a_file_1.csv"),
         call(f"{remote_folder}/a_folder/a_file_2.csv"),
     ], any_order=True)
+
+
+def test_upload_incremental(tmp_path: Path, config_persistence_service: ConfigPersistenceService) -> None:
+    """
+    Upload the same directory several times and make sure only the changed files
+    are re-uploaded and the remote directories are checked only once.
+    """
+    with patch("mlos_bench.services.remote.azure.azure_fileshare.ShareClient"):
+        azure_fileshare = AzureFileShareService(config={
+            "storageAccountName": "TEST_ACCOUNT_NAME",
+            "storageFileShareName": "TEST_FS_NAME",
+            "storageAccountKey": "TEST_ACCOUNT_KEY",
+            "maxConcurrency": 2,
+            "incrementalUpload": True,
+        }, parent=config_persistence_service)
+
+    local_folder = tmp_path / "bundle"
+    (local_folder / "a_folder").mkdir(parents=True)
+    (local_folder / "a_file_1.csv").write_text("1,2,3\n", encoding="utf-8")
+    (local_folder / "a_folder" / "a_file_2.csv").write_text("4,5,6\n", encoding="utf-8")
+    remote_folder = "a/remote/folder"
+
+    mock_share_client = azure_fileshare._share_client   # pylint: disable=protected-access
+    with patch.object(mock_share_client, "get_file_client") as mock_get_file_client, \
+         patch.object(mock_share_client, "get_directory_client") as mock_get_directory_client:
+
+        azure_fileshare.upload(str(local_folder), remote_folder)
+        mock_get_file_client.assert_has_calls([
+            call(f"{remote_folder}/a_file_1.csv"),
+            call(f"{remote_folder}/a_folder/a_file_2.csv"),
+        ], any_order=True)
+        assert mock_get_file_client.call_count == 2
+        n_dir_calls = mock_get_directory_client.call_count
+
+        # Nothing has changed.
+        azure_fileshare.upload(str(local_folder), remote_folder)
+        assert mock_get_file_client.call_count == 2
+        assert mock_get_directory_client.call_count == n_dir_calls
+
+        # Same content, new mtime: still nothing to upload.
+        os.utime(local_folder / "a_file_1.csv", ns=(0, 0))
+        azure_fileshare.upload(str(local_folder), remote_folder)
+        assert mock_get_file_client.call_count == 2
+
+        # New content.
+        (local_folder / "a_folder" / "a_file_2.csv").write_text("7,8,9,10\n", encoding="utf-8")
+        azure_fileshare.upload(str(local_folder), remote_folder)
+        assert mock_get_file_client.call_count == 3
+        mock_get_file_client.assert_called_with(f"{remote_folder}/a_folder/a_file_2.csv")
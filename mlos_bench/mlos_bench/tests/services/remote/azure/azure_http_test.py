@@ -0,0 +1,25 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Tests for the HTTP sessions of the Azure services.
+"""
+
+from concurrent.futures import ThreadPoolExecutor
+
+from mlos_bench.services.remote.azure.azure_http import create_http_session, get_http_session
+
+
+def test_http_session_per_thread() -> None:
+    """
+    Check that each thread gets its own session, and all sessions share the connection pool.
+    """
+    session = get_http_session()
+    assert get_http_session() is session
+    with ThreadPoolExecutor(max_workers=1) as executor:
+        other = executor.submit(get_http_session).result()
+    assert other is not session
+    assert create_http_session() is not session
+    assert other.get_adapter("https://") is session.get_adapter("https://")
+    assert create_http_session().get_adapter("https://") is session.get_adapter("https://")
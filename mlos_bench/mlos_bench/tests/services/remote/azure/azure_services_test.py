@@ -6,6 +6,8 @@
 Tests for mlos_bench.services.remote.azure.azure_services
 """
 
+from threading import Event, Thread
+from typing import Any, Dict, List, Tuple
 from unittest.mock import MagicMock, patch
 
 import pytest
@@ -32,13 +34,13 @@ from mlos_bench.services.remote.azure.azure_services import AzureVMService
         (401, Status.FAILED),
         (404, Status.FAILED),
     ])
-@patch("mlos_bench.services.remote.azure.azure_services.requests")
-def test_vm_operation_status(mock_requests: MagicMock, azure_vm_service: AzureVMService, operation_name: str,
+@patch("requests.Session.post")
+def test_vm_operation_status(mock_post: MagicMock, azure_vm_service: AzureVMService, operation_name: str,
                              accepts_params: bool, http_status_code: int, operation_status: Status) -> None:
 
     mock_response = MagicMock()
     mock_response.status_code = http_status_code
-    mock_requests.post.return_value = mock_response
+    mock_post.return_value = mock_response
 
     operation = getattr(azure_vm_service, operation_name)
     if accepts_params:
@@ -50,8 +52,8 @@ def test_vm_operation_status(mock_requests: MagicMock, azure_vm_service: AzureVM
 
 
 @patch("mlos_bench.services.remote.azure.azure_services.time.sleep")
-@patch("mlos_bench.services.remote.azure.azure_services.requests")
-def test_wait_vm_operation_ready(mock_requests: MagicMock, mock_sleep: MagicMock, azure_vm_service: AzureVMService) -> None:
+@patch("requests.Session.get")
+def test_wait_vm_operation_ready(mock_get: MagicMock, mock_sleep: MagicMock, azure_vm_service: AzureVMService) -> None:
 
     # Mock response header
     async_url = "DUMMY_ASYNC_URL"
@@ -66,17 +68,17 @@ def test_wait_vm_operation_ready(mock_requests: MagicMock, mock_sleep: MagicMock
     mock_status_response.json.return_value = {
         "status": "Succeeded",
     }
-    mock_requests.get.return_value = mock_status_response
+    mock_get.return_value = mock_status_response
 
     status, _ = azure_vm_service.wait_vm_operation(params)
 
-    assert (async_url, ) == mock_requests.get.call_args[0]
+    assert (async_url, ) == mock_get.call_args[0]
     assert (retry_after, ) == mock_sleep.call_args[0]
     assert status.is_succeeded
 
 
-@patch("mlos_bench.services.remote.azure.azure_services.requests")
-def test_wait_vm_operation_timeout(mock_requests: MagicMock, azure_vm_service: AzureVMService) -> None:
+@patch("requests.Session.get")
+def test_wait_vm_operation_timeout(mock_get: MagicMock, azure_vm_service: AzureVMService) -> None:
 
     # Mock response header
     params = {
@@ -89,7 +91,7 @@ def test_wait_vm_operation_timeout(mock_requests: MagicMock, azure_vm_service: A
     mock_status_response.json.return_value = {
         "status": "InProgress",
     }
-    mock_requests.get.return_value = mock_status_response
+    mock_get.return_value = mock_status_response
 
     (status, _) = azure_vm_service.wait_vm_operation(params)
     assert status == Status.TIMED_OUT
@@ -102,22 +104,37 @@ def test_wait_vm_operation_timeout(mock_requests: MagicMock, azure_vm_service: A
         (401, Status.FAILED),
         (404, Status.FAILED),
     ])
-@patch("mlos_bench.services.remote.azure.azure_services.requests")
-def test_remote_exec_status(mock_requests: MagicMock, azure_vm_service: AzureVMService,
+@patch("requests.Session.post")
+def test_remote_exec_status(mock_post: MagicMock, azure_vm_service: AzureVMService,
                             http_status_code: int, operation_status: Status) -> None:
     script = ["command_1", "command_2"]
 
     mock_response = MagicMock()
     mock_response.status_code = http_status_code
-    mock_requests.post.return_value = mock_response
+    mock_post.return_value = mock_response
 
     status, _ = azure_vm_service.remote_exec(script, config={}, env_params={})
 
     assert status == operation_status
 
 
-@patch("mlos_bench.services.remote.azure.azure_services.requests")
-def test_remote_exec_headers_output(mock_requests: MagicMock, azure_vm_service: AzureVMService) -> None:
+@patch("requests.Session.post")
+def test_remote_exec_completed_output(mock_post: MagicMock, azure_vm_service: AzureVMService) -> None:
+    """
+    Check that the output of the command that completes right away is returned as the results.
+    """
+    output = {"value": [{"message": "DUMMY_STDOUT_STDERR"}]}
+    mock_post.return_value = MagicMock(status_code=200, content=b"...", json=MagicMock(return_value=output))
+
+    (status, cmd_output) = azure_vm_service.remote_exec(
+        ["command_1"], config={"vmName": "test-vm"}, env_params={})
+
+    assert status == Status.SUCCEEDED
+    assert cmd_output == output
+
+
+@patch("requests.Session.post")
+def test_remote_exec_headers_output(mock_post: MagicMock, azure_vm_service: AzureVMService) -> None:
 
     async_url_key = "asyncResultsUrl"
     async_url_value = "DUMMY_ASYNC_URL"
@@ -128,7 +145,7 @@ def test_remote_exec_headers_output(mock_requests: MagicMock, azure_vm_service:
     mock_response.headers = {
         "Azure-AsyncOperation": async_url_value
     }
-    mock_requests.post.return_value = mock_response
+    mock_post.return_value = mock_response
 
     _, cmd_output = azure_vm_service.remote_exec(script, config={}, env_params={
         "param_1": 123,
@@ -138,7 +155,7 @@ def test_remote_exec_headers_output(mock_requests: MagicMock, azure_vm_service:
     assert async_url_key in cmd_output
     assert cmd_output[async_url_key] == async_url_value
 
-    assert mock_requests.post.call_args[1]["json"] == {
+    assert mock_post.call_args[1]["json"] == {
         "commandId": "RunShellScript",
         "script": script,
         "parameters": [
@@ -176,3 +193,134 @@ def test_get_remote_exec_results(azure_vm_service: AzureVMService, operation_sta
 
     assert status == operation_status
     assert cmd_output == results_output
+
+
+@pytest.mark.parametrize(
+    ("operation_status", "check_output", "results_output"), [
+        (Status.SUCCEEDED, {
+            "properties": {
+                "output": [
+                    {"message": "DUMMY_STDOUT_STDERR"},
+                ]
+            }
+        }, [
+            {"message": "DUMMY_STDOUT_STDERR"},
+        ]),
+        (Status.RUNNING, {}, {}),
+        (Status.FAILED, {}, {}),
+    ])
+def test_poll_remote_exec_results(azure_vm_service: AzureVMService, operation_status: Status,
+                                  check_output: dict, results_output: dict) -> None:
+
+    params = {"asyncResultsUrl": "DUMMY_ASYNC_URL"}
+
+    mock_check_vm_operation_status = MagicMock()
+    mock_check_vm_operation_status.return_value = (operation_status, check_output)
+    setattr(azure_vm_service, "_check_vm_operation_status", mock_check_vm_operation_status)
+    mock_wait_vm_operation = MagicMock()
+    setattr(azure_vm_service, "wait_vm_operation", mock_wait_vm_operation)
+
+    status, cmd_output = azure_vm_service.poll_remote_exec_results(params)
+
+    assert status == operation_status
+    assert cmd_output == results_output
+    # Polling must never block waiting for the operation to complete.
+    mock_wait_vm_operation.assert_not_called()
+
+
+@patch("requests.Session.post")
+def test_remote_exec_fleet(mock_post: MagicMock, azure_vm_service: AzureVMService) -> None:
+
+    script = ["command_1", "command_2"]
+
+    mock_response = MagicMock()
+    mock_response.status_code = 202
+    mock_response.headers = {
+        "Azure-AsyncOperation": "DUMMY_ASYNC_URL",
+        "Retry-After": "3",
+    }
+    mock_post.return_value = mock_response
+
+    results = azure_vm_service.remote_exec_fleet(
+        script, [{"vmName": "vm-1"}, {"vmName": "vm-2"}], env_params={"param_1": 123})
+
+    assert [status for (status, _) in results] == [Status.PENDING, Status.PENDING]
+    assert [output["vmName"] for (_, output) in results] == ["vm-1", "vm-2"]
+    assert all(output["asyncResultsUrl"] == "DUMMY_ASYNC_URL" for (_, output) in results)
+    assert all(output["pollInterval"] == 3.0 for (_, output) in results)
+    # All requests go through the shared session.
+    assert mock_post.call_count == 2
+
+
+@patch("mlos_bench.services.remote.azure.azure_services.time.sleep")
+@patch("requests.Session.get")
+def test_get_remote_exec_fleet_results(mock_get: MagicMock, mock_sleep: MagicMock,
+                                       azure_vm_service: AzureVMService) -> None:
+
+    output = [{"message": "DUMMY_STDOUT_STDERR"}]
+    in_progress = MagicMock(status_code=200, headers={"Retry-After": "0"})
+    in_progress.json.return_value = {"status": "InProgress"}
+    succeeded = MagicMock(status_code=200, headers={})
+    succeeded.json.return_value = {"status": "Succeeded", "properties": {"output": output}}
+    failed = MagicMock(status_code=404, headers={})
+
+    responses = {
+        "URL_1": [in_progress, succeeded],
+        "URL_2": [failed],
+    }
+    mock_get.side_effect = lambda url, **_kwargs: responses[url].pop(0)
+
+    results = azure_vm_service.get_remote_exec_fleet_results([
+        {"vmName": "vm-1", "asyncResultsUrl": "URL_1", "pollInterval": 0},
+        {"vmName": "vm-2", "asyncResultsUrl": "URL_2", "pollInterval": 0},
+        {"vmName": "vm-3"},
+        # Polls after the timeout, so is never checked.
+        {"vmName": "vm-4", "asyncResultsUrl": "URL_4", "pollInterval": 10},
+    ])
+
+    assert results == [
+        (Status.SUCCEEDED, output),
+        (Status.FAILED, {}),
+        (Status.PENDING, {}),
+        (Status.TIMED_OUT, {}),
+    ]
+    assert mock_get.call_count == 3
+    # Zero poll intervals (and Retry-After) mean no waiting.
+    mock_sleep.assert_not_called()
+
+
+@patch("requests.Session.get")
+def test_poll_remote_exec_results_coalesced(mock_get: MagicMock, azure_vm_service: AzureVMService) -> None:
+    """
+    Check that the concurrent status checks of the same operation send only one request.
+    """
+    # pylint: disable=protected-access
+    params = {"asyncResultsUrl": "DUMMY_ASYNC_URL", "vmName": "test-vm"}
+    output = [{"message": "DUMMY_STDOUT_STDERR"}]
+    mock_response = MagicMock(status_code=200, headers={})
+    mock_response.json.return_value = {"status": "Succeeded", "properties": {"output": output}}
+
+    other_waits = Event()
+
+    class _NotifyDict(dict):
+        def setdefault(self, key: Any, default: Any = None) -> Any:
+            value = super().setdefault(key, default)
+            if value is not default:
+                other_waits.set()
+            return value
+
+    azure_vm_service._status_checks = _NotifyDict()
+    other_results: List[Tuple[Status, Dict]] = []
+    other = Thread(target=lambda: other_results.append(azure_vm_service.poll_remote_exec_results(params)))
+
+    def _get(*_args: Any, **_kwargs: Any) -> MagicMock:
+        # Let the other thread join the status check in progress.
+        other.start()
+        assert other_waits.wait(timeout=10)
+        return mock_response
+
+    mock_get.side_effect = _get
+    assert azure_vm_service.poll_remote_exec_results(params) == (Status.SUCCEEDED, output)
+    other.join()
+    assert other_results == [(Status.SUCCEEDED, output)]
+    assert mock_get.call_count == 1
@@ -6,6 +6,9 @@
 A collection Service functions for mocking remote script execution.
 """
 
+from typing import Any, Iterable, List, Sequence, Tuple
+
+from mlos_bench.environments.status import Status
 from mlos_bench.services.base_service import Service
 from mlos_bench.services.types.remote_exec_type import SupportsRemoteExec
 from mlos_bench.tests.services.remote.mock import mock_operation
@@ -32,4 +35,16 @@ class MockRemoteExecService(Service, SupportsRemoteExec):
         self.register({
             "remote_exec": mock_operation,
             "get_remote_exec_results": mock_operation,
+            "poll_remote_exec_results": mock_operation,
+            "remote_exec_fleet": self._remote_exec_fleet,
+            "get_remote_exec_fleet_results": self._get_remote_exec_fleet_results,
         })
+
+    @staticmethod
+    def _remote_exec_fleet(_script: Iterable[str], configs: Sequence[dict],
+                           *_args: Any, **_kwargs: Any) -> List[Tuple[Status, dict]]:
+        return [mock_operation() for _ in configs]
+
+    @staticmethod
+    def _get_remote_exec_fleet_results(configs: Sequence[dict]) -> List[Tuple[Status, dict]]:
+        return [mock_operation() for _ in configs]
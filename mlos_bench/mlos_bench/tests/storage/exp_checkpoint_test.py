@@ -0,0 +1,66 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Unit tests for saving and loading the optimizer checkpoints in the storage.
+"""
+
+import pytest
+
+from mlos_bench.run import _warm_up
+from mlos_bench.environments.status import Status
+from mlos_bench.optimizers.mock_optimizer import MockOptimizer
+from mlos_bench.tunables.tunable_groups import TunableGroups
+from mlos_bench.storage.base_storage import Storage
+
+
+def test_exp_checkpoint(exp_storage_memory_sql: Storage.Experiment) -> None:
+    """
+    Only the latest checkpoint is kept.
+    """
+    assert exp_storage_memory_sql.load_checkpoint() is None
+    exp_storage_memory_sql.save_checkpoint(b"first", 1)
+    exp_storage_memory_sql.save_checkpoint(b"second", 3)
+    assert exp_storage_memory_sql.load_checkpoint() == (b"second", 3)
+
+
+def test_exp_load_data_after_trial(exp_storage_memory_sql: Storage.Experiment,
+                                   tunable_groups: TunableGroups) -> None:
+    """
+    Load only the trials that are newer than the checkpoint.
+    """
+    trial_ids = []
+    for score in [1.0, 2.0, 3.0]:
+        trial = exp_storage_memory_sql.new_trial(tunable_groups)
+        trial.update(Status.SUCCEEDED, {"score": score})
+        trial_ids.append(trial.trial_id)
+
+    (_, scores) = exp_storage_memory_sql.load_data()
+    assert scores.tolist() == [1.0, 2.0, 3.0]
+    (configs, scores) = exp_storage_memory_sql.load_data(after_trial_id=trial_ids[0])
+    assert scores.tolist() == [2.0, 3.0]
+    assert len(configs) == 2
+    (_, scores) = exp_storage_memory_sql.load_targets(["score"], after_trial_id=trial_ids[-1])
+    assert scores.empty
+
+
+@pytest.mark.parametrize(("blob"), [
+    b"garbage",
+    b"\x80\x04\x95\x1d\x00\x00\x00\x00\x00\x00\x00\x8c\x02os\x94\x8c\x06system\x94\x93\x94.",
+    b'{"class": "MockOptimizer", "targets": {"score": 1}, "state": {}}',
+])
+def test_exp_restore_corrupt_checkpoint(exp_storage_memory_sql: Storage.Experiment,
+                                        tunable_groups: TunableGroups, blob: bytes) -> None:
+    """
+    A checkpoint that cannot be restored falls back to registering the full history.
+    """
+    for score in [3.0, 1.0, 2.0]:
+        trial = exp_storage_memory_sql.new_trial(tunable_groups)
+        trial.update(Status.SUCCEEDED, {"score": score})
+    exp_storage_memory_sql.save_checkpoint(blob, trial.trial_id)
+
+    opt = MockOptimizer(tunables=tunable_groups, service=None, config={"seed": 42})
+    _warm_up(exp_storage_memory_sql, opt, {"checkpointInterval": 1})
+    (score, _) = opt.get_best_observation()
+    assert score == 1.0
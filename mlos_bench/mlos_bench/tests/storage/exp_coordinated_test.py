@@ -0,0 +1,112 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Unit tests for several workers sharing one experiment in the coordinated mode.
+"""
+from datetime import datetime, timedelta
+from pathlib import Path
+
+import pytest
+
+from mlos_bench.environments.status import Status
+from mlos_bench.tunables.tunable_groups import TunableGroups
+from mlos_bench.storage.base_storage import Storage, TrialLeaseLostError
+from mlos_bench.storage.sql.experiment import Experiment
+from mlos_bench.storage.sql.storage import SqlStorage
+
+
+def _worker_storage(db_path: str, worker_id: str, tunable_groups: TunableGroups) -> SqlStorage:
+    """
+    Create the storage of one worker in the coordinated mode.
+    """
+    return SqlStorage(
+        tunables=tunable_groups,
+        service=None,
+        config={
+            "drivername": "sqlite",
+            "database": db_path,
+            "coordinated": True,
+            "worker_id": worker_id,
+            "lease_duration": 60,
+        }
+    )
+
+
+def _experiment(storage: SqlStorage) -> Experiment:
+    """
+    Start (or join) the shared experiment.
+    """
+    # pylint: disable=unnecessary-dunder-call
+    exp = storage.experiment(
+        experiment_id="Test-Shared",
+        trial_id=1,
+        root_env_config="environment.jsonc",
+        description="pytest experiment",
+        opt_target="score",
+    ).__enter__()
+    assert isinstance(exp, Experiment)
+    return exp
+
+
+def test_exp_coordinated_workers(tmp_path: Path, tunable_groups: TunableGroups) -> None:
+    """
+    Allocate the trial IDs, claim and reclaim the trials, and exchange the results
+    between two workers.
+    """
+    db_path = str(tmp_path / "mlos_bench.sqlite")
+    storage_a = _worker_storage(db_path, "worker-a", tunable_groups)
+    storage_b = _worker_storage(db_path, "worker-b", tunable_groups)
+    exp_a = _experiment(storage_a)
+    exp_b = _experiment(storage_b)
+    assert exp_a.is_coordinated and exp_b.is_coordinated
+
+    # The trial IDs are unique across the workers.
+    trial_a1 = exp_a.new_trial(tunable_groups)
+    trial_b2 = exp_b.new_trial(tunable_groups.copy().assign({"kernel_sched_migration_cost_ns": 10000}))
+    trial_a3 = exp_a.new_trial(tunable_groups)
+    assert [trial_a1.trial_id, trial_b2.trial_id, trial_a3.trial_id] == [1, 2, 3]
+
+    # The running trials are leased to their workers.
+    assert not list(exp_a.pending_trials())
+    assert not list(exp_b.pending_trials())
+    assert exp_a.heartbeat() == 2
+
+    # Worker A dies; worker B takes over its trials once the leases expire.
+    with storage_a._engine.begin() as conn:     # pylint: disable=protected-access
+        schema = storage_a._schema                # pylint: disable=protected-access
+        conn.execute(schema.trial.update().where(
+            schema.trial.c.worker_id == "worker-a",
+        ).values(ts_lease=datetime.now() - timedelta(seconds=1)))
+    reclaimed = {trial.trial_id: trial for trial in exp_b.pending_trials()}
+    assert sorted(reclaimed) == [1, 3]
+    assert not list(exp_b.pending_trials())
+    # Late results of worker A are rejected.
+    with pytest.raises(TrialLeaseLostError):
+        trial_a1.update(Status.SUCCEEDED, {"score": 1.0})
+    reclaimed[1].update(Status.SUCCEEDED, {"score": 2.0})
+
+    # Worker A learns the results of the trials started by worker B (once).
+    trial_b2.update(Status.SUCCEEDED, {"score": 3.0})
+    (configs, scores) = exp_a.load_updates(["score"])
+    assert scores["score"].tolist() == [3.0]
+    assert configs["kernel_sched_migration_cost_ns"].astype(int).tolist() == [10000]
+    (configs, scores) = exp_a.load_updates(["score"])
+    assert scores.empty
+    # Worker B has registered all these results itself.
+    (configs, scores) = exp_b.load_updates(["score"])
+    assert scores.empty
+
+    exp_a.__exit__(None, None, None)  # pylint: disable=unnecessary-dunder-call
+    exp_b.__exit__(None, None, None)  # pylint: disable=unnecessary-dunder-call
+
+
+def test_exp_not_coordinated(exp_storage_memory_sql: Storage.Experiment,
+                             tunable_groups: TunableGroups) -> None:
+    """
+    By default, the experiment is private to the worker.
+    """
+    assert not exp_storage_memory_sql.is_coordinated
+    trial = exp_storage_memory_sql.new_trial(tunable_groups)
+    assert [pending.trial_id for pending in exp_storage_memory_sql.pending_trials()] == [trial.trial_id]
@@ -115,3 +115,57 @@ def test_exp_trial_pending_3(exp_storage_memory_sql: Storage.Experiment,
     assert len(scores) == 1
     assert scores[0] == score
     assert tunable_groups.copy().assign(configs[0]).reset() == trial_succ.tunables
+
+
+def test_exp_load_data(exp_storage_memory_sql: Storage.Experiment,
+                       tunable_groups: TunableGroups) -> None:
+    """
+    Finish several trials and check that `.load_data()` returns the same data
+    as `.load()`, but in the columnar format.
+    """
+    config1 = tunable_groups.copy().assign({'idle': 'mwait'})
+    config2 = tunable_groups.copy().assign({'idle': 'noidle'})
+    exp_storage_memory_sql.new_trial(config1).update(Status.SUCCEEDED, 99.9)
+    exp_storage_memory_sql.new_trial(config2).update(Status.FAILED)
+    exp_storage_memory_sql.new_trial(config2).update(Status.SUCCEEDED, 88.8)
+
+    (configs, scores) = exp_storage_memory_sql.load()
+    (df_configs, df_scores) = exp_storage_memory_sql.load_data()
+    assert df_scores.tolist() == scores == [99.9, 88.8]
+    assert df_configs.to_dict(orient="records") == configs
+    assert list(df_configs["idle"]) == ["mwait", "noidle"]
+
+
+def test_exp_pending_trial_config(exp_storage_memory_sql: Storage.Experiment,
+                                  tunable_groups: TunableGroups) -> None:
+    """
+    Start several trials with different configs and parameters
+    and check that they are restored correctly.
+    """
+    config1 = tunable_groups.copy().assign({'idle': 'mwait'})
+    config2 = tunable_groups.copy().assign({'idle': 'noidle'})
+    exp_storage_memory_sql.new_trial(config1, {"trialBudget": 10})
+    exp_storage_memory_sql.new_trial(config2)
+    exp_storage_memory_sql.new_trial(config1, {"trialBudget": 30})
+    (trial1, trial2, trial3) = sorted(exp_storage_memory_sql.pending_trials(),
+                                      key=lambda trial: trial.trial_id)
+    assert trial1.tunables == trial3.tunables == config1.reset()
+    assert trial2.tunables == config2.reset()
+    assert trial1.config()["trialBudget"] == "10"
+    assert "trialBudget" not in trial2.config()
+    assert trial3.config()["trialBudget"] == "30"
+
+
+def test_exp_load_configs(exp_storage_memory_sql: Storage.Experiment,
+                          tunable_groups: TunableGroups) -> None:
+    """
+    Load the distinct configs of all trials, regardless of their status.
+    """
+    assert exp_storage_memory_sql.load_configs().empty
+    tunables = tunable_groups.copy().assign({"kernel_sched_migration_cost_ns": 10000})
+    exp_storage_memory_sql.new_trial(tunable_groups).update(Status.SUCCEEDED, 1.0)
+    exp_storage_memory_sql.new_trial(tunable_groups).update(Status.FAILED)
+    exp_storage_memory_sql.new_trial(tunables)  # Pending.
+    configs = exp_storage_memory_sql.load_configs()
+    assert sorted(configs.columns) == sorted(tunable_groups.get_param_values())
+    assert sorted(configs["kernel_sched_migration_cost_ns"].astype(int)) == [-1, 10000]
@@ -0,0 +1,63 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Unit tests for merging the data of other experiments into the current one.
+"""
+import pytest
+
+from mlos_bench.environments.status import Status
+from mlos_bench.tunables.tunable_groups import TunableGroups
+from mlos_bench.storage.sql.storage import SqlStorage
+
+
+def test_exp_merge(tunable_groups: TunableGroups) -> None:
+    """
+    Merge in an older experiment that has only a subset of the tunables
+    and check that the missing values are imputed with the defaults.
+    """
+    storage = SqlStorage(
+        tunables=tunable_groups,
+        service=None,
+        config={
+            "drivername": "sqlite",
+            "database": ":memory:",
+        }
+    )
+    old_tunables = tunable_groups.subgroup(["boot"])
+    with storage.experiment(experiment_id="Test-Old",
+                            trial_id=1,
+                            root_env_config="environment.jsonc",
+                            description="pytest experiment",
+                            opt_target="score") as exp_old:
+        exp_old.new_trial(old_tunables.copy().assign({"idle": "mwait"})).update(Status.SUCCEEDED, 80.0)
+        exp_old.new_trial(old_tunables.copy().assign({"idle": "noidle"})).update(Status.FAILED)
+
+    with storage.experiment(experiment_id="Test-New",
+                            trial_id=1,
+                            root_env_config="environment.jsonc",
+                            description="pytest experiment",
+                            opt_target="score") as exp:
+        with pytest.raises(ValueError):
+            exp.merge(["Test-Unknown"])
+        exp.new_trial(tunable_groups.copy().assign({"vmSize": "Standard_B2s"})).update(Status.SUCCEEDED, 90.0)
+
+        (configs, scores) = exp.load_merged_data()
+        assert len(configs) == 0 and len(scores) == 0
+
+        exp.merge(["Test-Old", "Test-New"])
+        (configs, scores) = exp.load_data(include_merged=False)
+        assert scores.tolist() == [90.0]
+
+        (configs, scores) = exp.load_merged_data()
+        assert scores.tolist() == [80.0]
+        assert set(configs.columns) == set(tunable_groups.get_param_values())
+        restored = tunable_groups.copy().assign(configs.iloc[0].to_dict()).reset()
+        assert restored == tunable_groups.copy().assign({"idle": "mwait"}).reset()
+
+        (configs_all, scores_all) = exp.load()
+        assert sorted(scores_all) == [80.0, 90.0]
+        (df_configs, df_scores) = exp.load_data()
+        assert df_scores.tolist() == scores_all
+        assert df_configs.to_dict(orient="records") == configs_all
@@ -0,0 +1,67 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Unit tests for loading the results of several targets and computing the Pareto front.
+"""
+
+from mlos_bench.environments.status import Status
+from mlos_bench.tunables.tunable_groups import TunableGroups
+from mlos_bench.storage.sql.storage import SqlStorage
+
+
+def test_exp_pareto_front(tunable_groups: TunableGroups) -> None:
+    """
+    Store the results of several targets and check the multi-objective queries.
+    """
+    storage = SqlStorage(
+        tunables=tunable_groups,
+        service=None,
+        config={
+            "drivername": "sqlite",
+            "database": ":memory:",
+        }
+    )
+    opt_targets = {"latency": "min", "throughput": "max"}
+    with storage.experiment(experiment_id="Test-Pareto",
+                            trial_id=1,
+                            root_env_config="environment.jsonc",
+                            description="pytest experiment",
+                            opt_target="latency",
+                            opt_targets=opt_targets) as exp:
+        (configs, scores) = exp.pareto_front()
+        assert len(configs) == 0 and len(scores) == 0
+
+        results = [
+            {"latency": 10.0, "throughput": 100.0, "memory": 1.0},
+            {"latency": 20.0, "throughput": 200.0, "memory": 1.0},
+            {"latency": 30.0, "throughput": 150.0, "memory": 1.0},  # Dominated by trial 2.
+            {"latency": 5.0},   # No throughput: skipped.
+        ]
+        for (i, result) in enumerate(results):
+            tunables = tunable_groups.copy().assign({"kernel_sched_migration_cost_ns": 10000 * (i + 1)})
+            exp.new_trial(tunables).update(Status.SUCCEEDED, result)
+        exp.new_trial(tunable_groups.copy()).update(Status.FAILED)
+
+        (configs, scores) = exp.load_targets(list(opt_targets))
+        assert list(scores.columns) == ["latency", "throughput"]
+        assert scores.to_dict(orient="records") == [
+            {"latency": 10.0, "throughput": 100.0},
+            {"latency": 20.0, "throughput": 200.0},
+            {"latency": 30.0, "throughput": 150.0},
+        ]
+        assert configs["kernel_sched_migration_cost_ns"].astype(int).tolist() == [10000, 20000, 30000]
+
+        # Single-objective data is still available for each target.
+        (configs, latency) = exp.load_data()
+        assert latency.tolist() == [10.0, 20.0, 30.0, 5.0]
+
+        (configs, scores) = exp.pareto_front()
+        assert scores.index.tolist() == [1, 2]
+        assert configs.index.tolist() == [1, 2]
+        assert scores["throughput"].tolist() == [100.0, 200.0]
+
+        # Other directions give different fronts.
+        (configs, scores) = exp.pareto_front({"latency": "min", "memory": "min"})
+        assert scores.index.tolist() == [1]
@@ -0,0 +1,50 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Unit tests for the in-memory cache of the trial results of the experiment.
+"""
+
+from mlos_bench.environments.status import Status
+from mlos_bench.tunables.tunable_groups import TunableGroups
+from mlos_bench.storage.sql.storage import SqlStorage
+
+
+def test_exp_get_results(tunable_groups: TunableGroups) -> None:
+    """
+    Check that the results of the successful trials are returned by config,
+    and are restored from the database when the experiment is resumed.
+    """
+    storage = SqlStorage(
+        tunables=tunable_groups,
+        service=None,
+        config={
+            "drivername": "sqlite",
+            "database": ":memory:",
+        }
+    )
+    tunables_a = tunable_groups.copy().assign({"idle": "mwait"})
+    tunables_b = tunable_groups.copy().assign({"idle": "noidle"})
+
+    with storage.experiment(experiment_id="Test-Cache",
+                            trial_id=1,
+                            root_env_config="environment.jsonc",
+                            description="pytest experiment",
+                            opt_target="score") as exp:
+        assert not exp.get_results(tunables_a)
+        exp.new_trial(tunables_a).update(Status.SUCCEEDED, 80.0)
+        exp.new_trial(tunables_b).update(Status.FAILED)
+        exp.new_trial(tunables_a.copy()).update(Status.SUCCEEDED, {"score": 90.0, "note": "ok"})
+        assert exp.get_results(tunables_a) == [{"score": 80.0}, {"score": 90.0, "note": "ok"}]
+        assert not exp.get_results(tunables_b)
+
+    with storage.experiment(experiment_id="Test-Cache",
+                            trial_id=1,
+                            root_env_config="environment.jsonc",
+                            description="pytest experiment",
+                            opt_target="score") as exp:
+        assert exp.get_results(tunables_a) == [{"score": 80.0}, {"score": 90.0, "note": "ok"}]
+        assert not exp.get_results(tunables_b)
+        # The config IDs are also cached.
+        assert exp.new_trial(tunables_a).config_id == exp.new_trial(tunables_a.copy()).config_id
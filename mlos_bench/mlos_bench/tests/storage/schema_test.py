@@ -0,0 +1,184 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Unit tests for the DB schema versioning and migration.
+"""
+import sqlite3
+from pathlib import Path
+from typing import List
+
+import pytest
+
+from sqlalchemy import Connection, create_engine, func, select
+from sqlalchemy.exc import IntegrityError
+
+from mlos_bench.environments.status import Status
+from mlos_bench.tunables.tunable_groups import TunableGroups
+from mlos_bench.storage.base_storage import Storage
+from mlos_bench.storage.sql.schema import DbSchema, split_metric_value
+from mlos_bench.storage.sql.storage import SqlStorage
+
+
+def test_split_metric_value() -> None:
+    """
+    Check that numeric metrics also go to the typed column and all values are kept as text.
+    """
+    assert split_metric_value(None) == (None, None)
+    assert split_metric_value(99.9) == (99.9, "99.9")
+    assert split_metric_value("123") == (123.0, "123")
+    assert split_metric_value("Standard_B4ms") == (None, "Standard_B4ms")
+    # Non-finite values are text only.
+    assert split_metric_value(float("nan")) == (None, "nan")
+    assert split_metric_value(float("-inf")) == (None, "-inf")
+    assert split_metric_value("inf") == (None, "inf")
+
+
+def test_save_non_finite_results(exp_storage_memory_sql: Storage.Experiment,
+                                 tunable_groups: TunableGroups) -> None:
+    """
+    Check that the NaN results (e.g., the aggregates without samples) are saved as text only.
+    """
+    trial = exp_storage_memory_sql.new_trial(tunable_groups)
+    trial.update(Status.SUCCEEDED, {"score": 1.0, "latency_p99": float("nan")})
+    schema = exp_storage_memory_sql._schema  # pylint: disable=protected-access
+    with exp_storage_memory_sql._engine.connect() as conn:  # pylint: disable=protected-access
+        rows = conn.execute(select(
+            schema.trial_result.c.metric_id,
+            schema.trial_result.c.metric_num,
+            schema.trial_result.c.metric_value,
+        ).order_by(schema.trial_result.c.metric_id)).fetchall()
+    assert [tuple(row) for row in rows] == [("latency_p99", None, "nan"), ("score", 1.0, "1.0")]
+
+
+def test_schema_migrate_v1(tmp_path: Path, tunable_groups: TunableGroups) -> None:
+    """
+    Create the DB with the old (all-strings) schema and make sure it gets upgraded.
+    """
+    db_path = str(tmp_path / "mlos_bench.sqlite")
+    with sqlite3.connect(db_path) as db_conn:
+        db_conn.executescript("""
+            CREATE TABLE trial_result (
+                exp_id VARCHAR(255) NOT NULL,
+                trial_id INTEGER NOT NULL,
+                metric_id VARCHAR(255) NOT NULL,
+                metric_value VARCHAR(255),
+                PRIMARY KEY (exp_id, trial_id, metric_id)
+            );
+            CREATE TABLE trial_telemetry (
+                exp_id VARCHAR(255) NOT NULL,
+                trial_id INTEGER NOT NULL,
+                ts DATETIME NOT NULL,
+                metric_id VARCHAR(255) NOT NULL,
+                metric_value VARCHAR(255),
+                UNIQUE (exp_id, trial_id, ts, metric_id)
+            );
+            INSERT INTO trial_result VALUES ('Test-001', 1, 'score', '99.9');
+            INSERT INTO trial_result VALUES ('Test-001', 1, 'size', '-1e3');
+            INSERT INTO trial_result VALUES ('Test-001', 1, 'vm', 'Standard_B4ms');
+            INSERT INTO trial_result VALUES ('Test-001', 1, 'zone', '1a');
+        """)
+    db_conn.close()
+
+    storage = SqlStorage(
+        tunables=tunable_groups,
+        service=None,
+        config={
+            "drivername": "sqlite",
+            "database": db_path,
+        }
+    )
+    schema: DbSchema = storage._schema  # pylint: disable=protected-access
+    with storage._engine.connect() as conn:  # pylint: disable=protected-access
+        assert conn.execute(select(schema.schema_version.c.version)).scalar() == DbSchema.VERSION
+        rows = conn.execute(
+            select(schema.trial_result.c.metric_id,
+                   schema.trial_result.c.metric_num,
+                   schema.trial_result.c.metric_value,
+                   ).order_by(schema.trial_result.c.metric_id)
+        ).fetchall()
+    assert [tuple(row) for row in rows] == [
+        ("score", 99.9, "99.9"),
+        ("size", -1000.0, "-1e3"),
+        ("vm", None, "Standard_B4ms"),
+        ("zone", None, "1a"),
+    ]
+
+
+def test_schema_migrate_v2(tmp_path: Path, tunable_groups: TunableGroups) -> None:
+    """
+    Create the DB without the trial leases and make sure it gets upgraded.
+    """
+    db_path = str(tmp_path / "mlos_bench.sqlite")
+    with sqlite3.connect(db_path) as db_conn:
+        db_conn.executescript("""
+            CREATE TABLE schema_version (
+                version INTEGER NOT NULL,
+                PRIMARY KEY (version)
+            );
+            CREATE TABLE trial (
+                exp_id VARCHAR(255) NOT NULL,
+                trial_id INTEGER NOT NULL,
+                config_id INTEGER NOT NULL,
+                ts_start DATETIME NOT NULL,
+                ts_end DATETIME,
+                status VARCHAR(16) NOT NULL,
+                PRIMARY KEY (exp_id, trial_id)
+            );
+            INSERT INTO schema_version VALUES (2);
+            INSERT INTO trial VALUES ('Test-001', 1, 1, '2024-01-01 00:00:00', NULL, 'PENDING');
+        """)
+    db_conn.close()
+
+    storage = SqlStorage(
+        tunables=tunable_groups,
+        service=None,
+        config={
+            "drivername": "sqlite",
+            "database": db_path,
+        }
+    )
+    schema: DbSchema = storage._schema  # pylint: disable=protected-access
+    with storage._engine.connect() as conn:  # pylint: disable=protected-access
+        assert conn.execute(select(func.max(schema.schema_version.c.version))).scalar() == DbSchema.VERSION
+        rows = conn.execute(
+            select(schema.trial.c.trial_id, schema.trial.c.worker_id, schema.trial.c.ts_lease)
+        ).fetchall()
+    assert [tuple(row) for row in rows] == [(1, None, None)]
+
+
+def test_schema_create_twice(tmp_path: Path) -> None:
+    """
+    Make sure several workers can create (or upgrade) the schema of the same DB.
+    """
+    engine = create_engine(f"sqlite:///{tmp_path / 'mlos_bench.sqlite'}")
+    DbSchema(engine).create()
+    schema = DbSchema(engine).create()
+    with engine.connect() as conn:
+        versions = conn.execute(select(schema.schema_version.c.version)).scalars().all()
+    assert versions == [DbSchema.VERSION]
+
+
+def test_schema_create_race(tmp_path: Path, monkeypatch: pytest.MonkeyPatch) -> None:
+    """
+    Make sure the worker that loses the race to create the schema re-reads the version and succeeds.
+    """
+    engine = create_engine(f"sqlite:///{tmp_path / 'mlos_bench.sqlite'}")
+    schema = DbSchema(engine)
+    upgrade = schema._upgrade   # pylint: disable=protected-access
+    calls: List[int] = []
+
+    def _upgrade(conn: Connection) -> None:
+        calls.append(1)
+        if len(calls) == 1:
+            # As if another worker has inserted the same schema version first.
+            raise IntegrityError("INSERT INTO schema_version", {}, Exception("UNIQUE constraint failed"))
+        upgrade(conn)
+
+    monkeypatch.setattr(schema, "_upgrade", _upgrade)
+    schema.create()
+    assert len(calls) == 2
+    with engine.connect() as conn:
+        versions = conn.execute(select(schema.schema_version.c.version)).scalars().all()
+    assert versions == [DbSchema.VERSION]
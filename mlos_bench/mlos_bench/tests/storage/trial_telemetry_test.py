@@ -0,0 +1,205 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Unit tests for saving the trial telemetry data.
+"""
+import time
+from datetime import datetime, timedelta
+from pathlib import Path
+from typing import List, Tuple
+
+import pytest
+from sqlalchemy import select
+
+from mlos_bench.environments.status import Status
+from mlos_bench.tunables.tunable_groups import TunableGroups
+from mlos_bench.storage.sql.experiment import Experiment
+from mlos_bench.storage.sql.storage import SqlStorage
+
+# pylint: disable=protected-access
+
+
+def _load_telemetry(exp: Experiment) -> List[Tuple[datetime, str, float]]:
+    """
+    Get the (timestamp, metric, value) telemetry records of the experiment.
+    """
+    table = exp._schema.trial_telemetry
+    with exp._engine.connect() as conn:
+        rows = conn.execute(
+            select(table.c.ts, table.c.metric_id, table.c.metric_num).where(
+                table.c.exp_id == exp._experiment_id,
+            ).order_by(table.c.ts, table.c.metric_id)
+        ).fetchall()
+    return [tuple(row) for row in rows]
+
+
+def test_trial_telemetry(exp_storage_memory_sql: Experiment,
+                         tunable_groups: TunableGroups) -> None:
+    """
+    Save several telemetry samples with their timestamps and make sure
+    they all are in the DB once the trial completes.
+    """
+    trial = exp_storage_memory_sql.new_trial(tunable_groups)
+    ts0 = datetime(2023, 7, 1, 12, 0, 0)
+    for i in range(3):
+        trial.update_telemetry(Status.RUNNING, {"qps": 100 + i, "latency": 0.5},
+                               timestamp=ts0 + timedelta(seconds=i))
+    trial.update(Status.SUCCEEDED, {"score": 99.9})
+    assert _load_telemetry(exp_storage_memory_sql) == [
+        (ts0, "latency", 0.5),
+        (ts0, "qps", 100.0),
+        (ts0 + timedelta(seconds=1), "latency", 0.5),
+        (ts0 + timedelta(seconds=1), "qps", 101.0),
+        (ts0 + timedelta(seconds=2), "latency", 0.5),
+        (ts0 + timedelta(seconds=2), "qps", 102.0),
+    ]
+
+
+def test_trial_telemetry_async(tmp_path: Path, tunable_groups: TunableGroups) -> None:
+    """
+    Save the telemetry of several trials from the background thread.
+    """
+    storage = SqlStorage(
+        tunables=tunable_groups,
+        service=None,
+        config={
+            "drivername": "sqlite",
+            "database": str(tmp_path / "mlos_bench.sqlite"),
+            "telemetry_flush_interval": 60,
+            "telemetry_batch_size": 3,
+        }
+    )
+    with storage.experiment(experiment_id="Test-Telemetry",
+                            trial_id=1,
+                            root_env_config="environment.jsonc",
+                            description="pytest experiment",
+                            opt_target="score") as exp:
+        assert isinstance(exp, Experiment)
+        trials = [exp.new_trial(tunable_groups) for _ in range(2)]
+        ts0 = datetime(2023, 7, 1, 12, 0, 0)
+        for (i, trial) in enumerate(trials):
+            trial.update_telemetry(Status.RUNNING, {"qps": i}, timestamp=ts0 + timedelta(seconds=i))
+        # Neither the interval nor the batch size has been reached yet.
+        storage._telemetry.flush()
+        assert len(_load_telemetry(exp)) == 2
+        trials[0].update_telemetry(Status.RUNNING, {"qps": 10}, timestamp=ts0 + timedelta(seconds=10))
+        trials[1].update(Status.FAILED)
+        assert len(_load_telemetry(exp)) == 3
+
+
+def test_trial_telemetry_duplicate(exp_storage_memory_sql: Experiment,
+                                   tunable_groups: TunableGroups) -> None:
+    """
+    Skip the duplicate telemetry records without losing the rest of the batch.
+    """
+    trial = exp_storage_memory_sql.new_trial(tunable_groups)
+    ts0 = datetime(2023, 7, 1, 12, 0, 0)
+    trial.update_telemetry(Status.RUNNING, {"qps": 1}, timestamp=ts0)
+    trial.update_telemetry(Status.RUNNING, {"qps": 2, "latency": 0.5}, timestamp=ts0)
+    trial.update(Status.SUCCEEDED, {"score": 99.9})
+    assert _load_telemetry(exp_storage_memory_sql) == [
+        (ts0, "latency", 0.5),
+        (ts0, "qps", 1.0),
+    ]
+
+
+def test_trial_telemetry_series(tunable_groups: TunableGroups) -> None:
+    """
+    Stream a long time series into the storage in batches, dropping the duplicates.
+    """
+    storage = SqlStorage(
+        tunables=tunable_groups,
+        service=None,
+        config={
+            "drivername": "sqlite",
+            "database": ":memory:",
+            "telemetry_batch_size": 4,
+        }
+    )
+    with storage.experiment(experiment_id="Test-Telemetry",
+                            trial_id=1,
+                            root_env_config="environment.jsonc",
+                            description="pytest experiment",
+                            opt_target="score") as exp:
+        assert isinstance(exp, Experiment)
+        trial = exp.new_trial(tunable_groups)
+        ts0 = datetime(2023, 7, 1, 12, 0, 0)
+        samples = [(ts0 + timedelta(seconds=i), {"qps": i, "latency": 0.5}) for i in range(5)]
+        # Duplicate timestamps within the same batch and across the batches.
+        samples.insert(1, (ts0, {"qps": 100}))
+        samples.append((ts0 + timedelta(seconds=1), {"qps": 200}))
+        trial.append_telemetry_series(iter(samples))
+        trial.update(Status.SUCCEEDED, {"score": 99.9})
+        telemetry = _load_telemetry(exp)
+        assert len(telemetry) == 10
+        assert (ts0, "qps", 100.0) in telemetry
+        assert (ts0 + timedelta(seconds=1), "qps", 1.0) in telemetry
+
+
+class _BrokenEngine:
+    """
+    Stand-in for the SQLAlchemy engine that fails to open a transaction.
+    """
+
+    def begin(self) -> None:
+        """
+        Fail as if the DB were unavailable.
+        """
+        raise RuntimeError("DB is down")
+
+
+def test_trial_telemetry_retry(exp_storage_memory_sql: Experiment,
+                               tunable_groups: TunableGroups,
+                               monkeypatch: pytest.MonkeyPatch) -> None:
+    """
+    Keep the telemetry records in the buffer if the DB write fails.
+    """
+    writer = exp_storage_memory_sql._telemetry
+    trial = exp_storage_memory_sql.new_trial(tunable_groups)
+    ts0 = datetime(2023, 7, 1, 12, 0, 0)
+    trial.update_telemetry(Status.RUNNING, {"qps": 1}, timestamp=ts0)
+    with monkeypatch.context() as patch:
+        patch.setattr(writer, "_engine", _BrokenEngine())
+        with pytest.raises(RuntimeError):
+            writer.flush()
+    writer.flush()
+    assert _load_telemetry(exp_storage_memory_sql) == [(ts0, "qps", 1.0)]
+
+
+def test_trial_telemetry_background(tmp_path: Path, tunable_groups: TunableGroups) -> None:
+    """
+    Write the telemetry from the background thread without explicit flushes,
+    and stop the thread when the experiment is over.
+    """
+    storage = SqlStorage(
+        tunables=tunable_groups,
+        service=None,
+        config={
+            "drivername": "sqlite",
+            "database": str(tmp_path / "mlos_bench.sqlite"),
+            "telemetry_flush_interval": 0.05,
+        }
+    )
+    writer = storage._telemetry
+    with storage.experiment(experiment_id="Test-Telemetry",
+                            trial_id=1,
+                            root_env_config="environment.jsonc",
+                            description="pytest experiment",
+                            opt_target="score") as exp:
+        assert isinstance(exp, Experiment)
+        trial = exp.new_trial(tunable_groups)
+        ts0 = datetime(2023, 7, 1, 12, 0, 0)
+        trial.update_telemetry(Status.RUNNING, {"qps": 1}, timestamp=ts0)
+        deadline = time.monotonic() + 10
+        while not _load_telemetry(exp) and time.monotonic() < deadline:
+            time.sleep(0.01)
+        assert _load_telemetry(exp) == [(ts0, "qps", 1.0)]
+        # The last sample is written by `.close()` on teardown.
+        trial.update_telemetry(Status.RUNNING, {"qps": 2}, timestamp=ts0 + timedelta(seconds=1))
+    assert writer.is_closed
+    assert writer._thread is None
+    assert len(_load_telemetry(exp)) == 2
+    # The next experiment gets a fresh writer.
+    assert storage._telemetry is not writer
@@ -0,0 +1,99 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Unit tests for the timing of the trial phases and the service calls.
+"""
+import contextvars
+
+from concurrent.futures import ThreadPoolExecutor
+
+import pytest
+
+from mlos_bench.services.base_service import Service
+from mlos_bench.timing import PhaseTimer, active_timer, timed_phase
+
+
+def test_phase_timer() -> None:
+    """
+    Record several phases, including a failed one, and check the totals.
+    """
+    timer = PhaseTimer()
+    with timer.phase("env.setup"):
+        pass
+    with pytest.raises(ValueError):
+        with timer.phase("env.setup"):
+            raise ValueError("setup failed")
+    timer.add("opt.suggest", timer.spans[0].start, 0.5)
+    metrics = timer.metrics()
+    assert metrics["timing.env.setup.calls"] == 2
+    assert metrics["timing.env.setup"] >= 0
+    assert metrics["timing.opt.suggest"] == 0.5
+    assert metrics["timing.opt.suggest.calls"] == 1
+
+
+def _record(name: str) -> None:
+    """
+    Record an empty phase in the active timer (if any).
+    """
+    with timed_phase(name):
+        pass
+
+
+def test_active_timer() -> None:
+    """
+    Only the phases within the active timer context are recorded,
+    including the ones that run in the worker threads with the copied context.
+    """
+    timer = PhaseTimer()
+    _record("outside")
+    with active_timer(timer):
+        _record("inside")
+        with ThreadPoolExecutor(max_workers=1) as executor:
+            executor.submit(contextvars.copy_context().run, _record, "worker").result()
+            # Plain `executor.submit()` does not carry the context over.
+            executor.submit(_record, "lost").result()
+    _record("after")
+    assert sorted(span.name for span in timer.spans) == ["inside", "worker"]
+
+
+def test_timed_service() -> None:
+    """
+    The calls of the registered services are timed, and the re-exported ones
+    are not wrapped twice.
+    """
+    def local_exec(value: int) -> int:
+        return value + 1
+
+    parent = Service()
+    parent.register([local_exec])
+    child = Service(parent=parent)
+    timer = PhaseTimer()
+    with active_timer(timer):
+        assert child.export()["local_exec"](1) == 2
+    assert child.export()["local_exec"] is parent.export()["local_exec"]
+    assert timer.metrics() == {
+        "timing.service.local_exec": timer.spans[0].duration,
+        "timing.service.local_exec.calls": 1,
+    }
+
+
+def test_timed_service_nested() -> None:
+    """
+    The services called from other services are not counted twice.
+    """
+    service = Service()
+
+    def local_exec(value: int) -> int:
+        return value + 1
+
+    def remote_exec(value: int) -> int:
+        return int(service.export()["local_exec"](value)) * 2
+
+    service.register([local_exec, remote_exec])
+    timer = PhaseTimer()
+    with active_timer(timer):
+        assert service.export()["remote_exec"](1) == 4
+        assert service.export()["local_exec"](1) == 2
+    assert sorted(span.name for span in timer.spans) == ["service.local_exec", "service.remote_exec"]
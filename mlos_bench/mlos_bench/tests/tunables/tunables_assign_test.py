@@ -162,3 +162,16 @@ def test_tunable_assign_null_to_float(tunable_float: Tunable) -> None:
         tunable_float.value = None
     with pytest.raises(TypeError):
         tunable_float.numerical_value = None    # type: ignore[assignment]
+
+
+def test_tunables_assign_same_value(tunable_groups: TunableGroups) -> None:
+    """
+    Check that assigning the current value does not mark the covariant group as updated,
+    and that only the updated groups contribute to the current cost.
+    """
+    tunable_groups.reset()
+    tunable_groups.assign({"vmSize": tunable_groups["vmSize"], "idle": "mwait"})
+    assert not tunable_groups.is_updated(["provision"])
+    assert tunable_groups.is_updated(["boot"])
+    assert tunable_groups.get_current_cost() == 300
+    assert tunable_groups.get_total_cost() == 1301
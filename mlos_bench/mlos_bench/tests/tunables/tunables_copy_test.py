@@ -49,3 +49,22 @@ def test_copy_covariant_group(covariant_group: CovariantTunableGroup) -> None:
     assert covariant_group_copy.is_updated()
     assert not covariant_group.is_updated()
     assert covariant_group != covariant_group_copy
+
+
+def test_copy_tunable_groups_independent(tunable_groups: TunableGroups) -> None:
+    """
+    Check that the copies share the metadata, but not the values of the tunables.
+    """
+    tunable_groups_copy = tunable_groups.copy()
+    (tunable, group) = tunable_groups.get_tunable("kernel_sched_migration_cost_ns")
+    (tunable_copy, group_copy) = tunable_groups_copy.get_tunable("kernel_sched_migration_cost_ns")
+    assert tunable is not tunable_copy
+    assert group is not group_copy
+    assert tunable.range is tunable_copy.range
+    # Both the index and the groups of the copy point to the new tunables.
+    tunable_copy.numerical_value = 10000
+    assert tunable_groups_copy["kernel_sched_migration_cost_ns"] == 10000
+    assert tunable_groups_copy.get_param_values()["kernel_sched_migration_cost_ns"] == 10000
+    assert tunable.numerical_value == -1
+    assert list(tunable_groups_copy.get_param_values()) == list(tunable_groups.get_param_values())
+    assert str(tunable_groups_copy.copy()) == str(tunable_groups_copy)
@@ -7,6 +7,8 @@ Unit tests to make sure we always produce a string representation
 of a TunableGroup in canonical form.
 """
 
+import hashlib
+
 from mlos_bench.tunables.tunable_groups import TunableGroups
 
 
@@ -56,3 +58,21 @@ def test_tunable_groups_str(tunable_groups: TunableGroups) -> None:
         },
     })
     assert str(tunable_groups) == str(tunables_other)
+
+
+def test_tunable_groups_hash(tunable_groups: TunableGroups) -> None:
+    """
+    Check that the cached hash of the config follows the changes of the tunable values.
+    """
+    values_hash = tunable_groups.get_values_hash()
+    assert values_hash == hashlib.sha256(str(tunable_groups).encode('utf-8')).hexdigest()
+    assert tunable_groups.get_values_hash() == values_hash
+    tunables_copy = tunable_groups.copy()
+    assert tunables_copy.get_values_hash() == values_hash
+    tunables_copy["vmSize"] = "Standard_B2ms"
+    assert tunables_copy.get_values_hash() != values_hash
+    # Updates that bypass the TunableGroups are detected, too.
+    (tunable, _group) = tunables_copy.get_tunable("vmSize")
+    tunable.value = tunable.default
+    assert tunables_copy.get_values_hash() == values_hash
+    assert tunable_groups.get_values_hash() == values_hash
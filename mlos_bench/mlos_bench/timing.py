@@ -0,0 +1,195 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Wall-clock timing of the phases of the trial lifecycle and of the service calls.
+
+The optimization loop creates a `PhaseTimer` for each trial and activates it
+(via `active_timer()`) in the thread that runs the trial. The environments and
+services then record their phases with `timed_phase()` without knowing which
+trial they belong to; the calls outside of any trial are not recorded.
+"""
+
+import functools
+import logging
+
+from contextlib import contextmanager
+from contextvars import ContextVar
+from datetime import datetime
+from threading import Lock
+from time import perf_counter
+from typing import Any, Callable, Dict, Iterator, List, Mapping, NamedTuple, Optional
+
+_LOG = logging.getLogger(__name__)
+
+TIMING_METRIC_PREFIX = "timing."
+"""Prefix of the telemetry metrics that hold the phase timings."""
+
+
+class PhaseSpan(NamedTuple):
+    """A single timed interval of a phase."""
+
+    name: str
+    start: datetime
+    duration: float
+
+
+class PhaseTimer:
+    """
+    Collect the wall-clock time of the phases of a single trial.
+    Thread-safe, so the phases may run concurrently (e.g., the children of a CompositeEnv).
+    """
+
+    def __init__(self) -> None:
+        self._lock = Lock()
+        self._spans: List[PhaseSpan] = []
+
+    def __repr__(self) -> str:
+        return f"{self.__class__.__name__}(spans={len(self._spans)})"
+
+    @contextmanager
+    def phase(self, name: str) -> Iterator[None]:
+        """
+        Time the enclosed block as the phase `name`.
+        The time is recorded even if the block raises an exception.
+        """
+        start_ts = datetime.now()
+        start = perf_counter()
+        try:
+            yield
+        finally:
+            self.add(name, start_ts, perf_counter() - start)
+
+    def add(self, name: str, start: datetime, duration: float) -> None:
+        """
+        Record a phase that has been timed elsewhere.
+
+        Parameters
+        ----------
+        name : str
+            Name of the phase, e.g., "opt.suggest" or "service.remote_exec".
+        start : datetime
+            When the phase started.
+        duration : float
+            Duration of the phase, in seconds.
+        """
+        with self._lock:
+            self._spans.append(PhaseSpan(name, start, duration))
+
+    @property
+    def spans(self) -> List[PhaseSpan]:
+        """All phases recorded so far, in the order of completion."""
+        with self._lock:
+            return list(self._spans)
+
+    def metrics(self) -> Dict[str, float]:
+        """
+        Get the total time (in seconds) and the number of calls of each phase.
+
+        Returns
+        -------
+        metrics : Dict[str, float]
+            `timing.{phase}` -> total seconds and `timing.{phase}.calls` -> number of calls.
+        """
+        metrics: Dict[str, float] = {}
+        for span in self.spans:
+            key = TIMING_METRIC_PREFIX + span.name
+            metrics[key] = metrics.get(key, 0.0) + span.duration
+            metrics[key + ".calls"] = metrics.get(key + ".calls", 0) + 1
+        return metrics
+
+
+_ACTIVE_TIMER: ContextVar[Optional[PhaseTimer]] = ContextVar("mlos_bench_active_timer", default=None)
+
+# True within a timed service call, so that the services it calls are not counted twice.
+_IN_SERVICE_CALL: ContextVar[bool] = ContextVar("mlos_bench_in_service_call", default=False)
+
+
+@contextmanager
+def active_timer(timer: Optional[PhaseTimer]) -> Iterator[Optional[PhaseTimer]]:
+    """
+    Make `timer` record the phases of the enclosed block (in the current thread).
+    Use `contextvars.copy_context().run()` to carry the timer over to the worker threads.
+    """
+    token = _ACTIVE_TIMER.set(timer)
+    try:
+        yield timer
+    finally:
+        _ACTIVE_TIMER.reset(token)
+
+
+@contextmanager
+def timed_phase(name: str) -> Iterator[None]:
+    """
+    Time the enclosed block as the phase `name` of the active trial (if any).
+    """
+    timer = _ACTIVE_TIMER.get()
+    if timer is None:
+        yield
+    else:
+        with timer.phase(name):
+            yield
+
+
+def timed_service(name: str, func: Callable) -> Callable:
+    """
+    Wrap the service method to record each call as the phase `service.{name}`.
+    Only the outermost service call is recorded: the time of the nested ones
+    (e.g., `remote_exec` calling `wait_remote_exec_operation`) is already included.
+    Idempotent: the methods that are already wrapped are returned as is.
+    """
+    if getattr(func, "_mlos_bench_timed", False):
+        return func
+
+    @functools.wraps(func)
+    def _timed(*args: Any, **kwargs: Any) -> Any:
+        if _IN_SERVICE_CALL.get():
+            return func(*args, **kwargs)
+        token = _IN_SERVICE_CALL.set(True)
+        try:
+            with timed_phase("service." + name):
+                return func(*args, **kwargs)
+        finally:
+            _IN_SERVICE_CALL.reset(token)
+
+    setattr(_timed, "_mlos_bench_timed", True)
+    return _timed
+
+
+def export_otel(timer: PhaseTimer, attributes: Mapping[str, Any]) -> None:
+    """
+    Export the phases as OpenTelemetry spans (children of one "mlos_bench.trial" span)
+    and as a histogram metric of the phase durations.
+    The exporters must be configured by the application via the OpenTelemetry SDK;
+    without it, the OpenTelemetry API is a no-op.
+
+    Parameters
+    ----------
+    timer : PhaseTimer
+        The timings of a single trial.
+    attributes : Mapping[str, Any]
+        Attributes to attach to all spans and data points, e.g., the trial ID.
+    """
+    try:
+        # pylint: disable=import-outside-toplevel
+        from opentelemetry import metrics, trace
+    except ImportError:
+        _LOG.warning("OpenTelemetry export requested, but opentelemetry-api is not installed")
+        return
+    spans = timer.spans
+    if not spans:
+        return
+    tracer = trace.get_tracer("mlos_bench")
+    histogram = metrics.get_meter("mlos_bench").create_histogram(
+        "mlos_bench.phase.duration", unit="s", description="Duration of the trial lifecycle phases")
+    start_ns = min(int(span.start.timestamp() * 1e9) for span in spans)
+    end_ns = max(int((span.start.timestamp() + span.duration) * 1e9) for span in spans)
+    trial_span = tracer.start_span("mlos_bench.trial", start_time=start_ns, attributes=dict(attributes))
+    context = trace.set_span_in_context(trial_span)
+    for span in spans:
+        span_start_ns = int(span.start.timestamp() * 1e9)
+        tracer.start_span(span.name, context=context, start_time=span_start_ns, attributes=dict(attributes)
+                          ).end(end_time=span_start_ns + int(span.duration * 1e9))
+        histogram.record(span.duration, {**attributes, "phase": span.name})
+    trial_span.end(end_time=end_ns)
@@ -66,15 +66,18 @@ class CovariantTunableGroup:
 
     def copy(self) -> "CovariantTunableGroup":
         """
-        Deep copy of the CovariantTunableGroup object.
+        Copy of the CovariantTunableGroup object and its tunables.
+        See `Tunable.copy()` for the details.
 
         Returns
         -------
         group : CovariantTunableGroup
             A new instance of the CovariantTunableGroup object
-            that is a deep copy of the original one.
+            that can be assigned independently of the original one.
         """
-        return copy.deepcopy(self)
+        group = copy.copy(self)
+        group._tunables = {name: tunable.copy() for (name, tunable) in self._tunables.items()}
+        return group
 
     def __eq__(self, other: object) -> bool:
         """
@@ -226,8 +229,11 @@ class CovariantTunableGroup:
         return self.get_tunable(tunable).value
 
     def __setitem__(self, tunable: Union[str, Tunable], tunable_value: Union[TunableValue, Tunable]) -> TunableValue:
-        self._is_updated = True
         name: str = tunable.name if isinstance(tunable, Tunable) else tunable
         value: TunableValue = tunable_value.value if isinstance(tunable_value, Tunable) else tunable_value
+        prev_value = self._tunables[name].value
         self._tunables[name].value = value
+        # Same as in `.restore_defaults()`: assigning the same value is not an update.
+        if self._tunables[name].value != prev_value:
+            self._is_updated = True
         return value
@@ -166,14 +166,17 @@ class Tunable:  # pylint: disable=too-many-instance-attributes
 
     def copy(self) -> "Tunable":
         """
-        Deep copy of the Tunable object.
+        Copy of the Tunable object with its own current value.
+
+        The metadata (type, default, range, values, etc.) never changes after
+        the tunable is created, so the copies share it instead of cloning it.
 
         Returns
         -------
         tunable : Tunable
-            A new Tunable object that is a deep copy of the original one.
+            A new Tunable object that can be assigned independently of the original one.
         """
-        return copy.deepcopy(self)
+        return copy.copy(self)
 
     @property
     def default(self) -> TunableValue:
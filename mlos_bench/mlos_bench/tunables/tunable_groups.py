@@ -5,7 +5,7 @@
 """
 TunableGroups definition.
 """
-import copy
+import hashlib
 
 from typing import Dict, Generator, Iterable, Mapping, Optional, Tuple, Union
 
@@ -31,6 +31,10 @@ class TunableGroups:
             config = {}
         self._index: Dict[str, CovariantTunableGroup] = {}  # Index (Tunable id -> CovariantTunableGroup)
         self._tunable_groups: Dict[str, CovariantTunableGroup] = {}
+        # Tunable names in the canonical order of `__repr__()`. Shared by the copies.
+        self._sorted_names: Optional[Tuple[str, ...]] = None
+        # Tunable values (in canonical order) -> hash of the config, for `.get_values_hash()`.
+        self._hash_cache: Optional[Tuple[Tuple[TunableValue, ...], str]] = None
         for (name, group_config) in config.items():
             self._add_group(CovariantTunableGroup(name, group_config))
 
@@ -54,15 +58,23 @@ class TunableGroups:
 
     def copy(self) -> "TunableGroups":
         """
-        Deep copy of the TunableGroups object.
+        Copy of the TunableGroups object, its covariant groups, and tunables.
+        The immutable metadata of the tunables is shared with the original,
+        so the copy only costs as much as the list of the tunable values.
 
         Returns
         -------
         tunables : TunableGroups
             A new instance of the TunableGroups object
-            that is a deep copy of the original one.
+            that can be assigned independently of the original one.
         """
-        return copy.deepcopy(self)
+        # pylint: disable=protected-access
+        tunables = TunableGroups()
+        tunables._tunable_groups = {name: group.copy() for (name, group) in self._tunable_groups.items()}
+        tunables._index = {name: tunables._tunable_groups[group.name] for (name, group) in self._index.items()}
+        tunables._sorted_names = self._sorted_names
+        tunables._hash_cache = self._hash_cache
+        return tunables
 
     def _add_group(self, group: CovariantTunableGroup) -> None:
         """
@@ -75,6 +87,8 @@ class TunableGroups:
             group : CovariantTunableGroup
         """
         assert group.name not in self._tunable_groups, f"Duplicate covariant tunable group name {group.name} in {self}"
+        self._sorted_names = None
+        self._hash_cache = None
         self._tunable_groups[group.name] = group
         for tunable in group.get_tunables():
             if tunable.name in self._index:
@@ -126,9 +140,35 @@ class TunableGroups:
             A human-readable version of the TunableGroups.
         """
         return "{ " + ", ".join(
-            f"{group.name}::{tunable}"
-            for group in sorted(self._tunable_groups.values(), key=lambda g: (-g.cost, g.name))
-            for tunable in sorted(group._tunables.values())) + " }"
+            f"{self._index[name].name}::{self._index[name].get_tunable(name)}"
+            for name in self._get_sorted_names()) + " }"
+
+    def _get_sorted_names(self) -> Tuple[str, ...]:
+        """
+        Get the names of all tunables in canonical order: by the cost (descending)
+        and name of the covariant group, then by the name of the tunable.
+        The order only depends on the structure of the groups, so we compute it once.
+        """
+        if self._sorted_names is None:
+            self._sorted_names = tuple(sorted(
+                self._index, key=lambda name: (-self._index[name].cost, self._index[name].name, name)))
+        return self._sorted_names
+
+    def get_values_hash(self) -> str:
+        """
+        Get the stable hash of the current tunable values, e.g., to identify the config
+        in the storage. Same as the SHA-256 digest of the canonical string representation,
+        but cached until any of the values change.
+
+        Returns
+        -------
+        hash : str
+            Hex digest of the config.
+        """
+        values = tuple(self[name] for name in self._get_sorted_names())
+        if self._hash_cache is None or self._hash_cache[0] != values:
+            self._hash_cache = (values, hashlib.sha256(str(self).encode('utf-8')).hexdigest())
+        return self._hash_cache[1]
 
     def __contains__(self, tunable: Union[str, Tunable]) -> bool:
         """
@@ -266,6 +306,43 @@ class TunableGroups:
         return any(self._tunable_groups[name].is_updated()
                    for name in (group_names or self.get_covariant_group_names()))
 
+    def get_current_cost(self, group_names: Optional[Iterable[str]] = None) -> int:
+        """
+        Get the total cost of the updated covariant tunable groups.
+
+        Parameters
+        ----------
+        group_names : list of str or None
+            IDs of the covariant tunable groups.
+            Use all groups if omitted.
+
+        Returns
+        -------
+        cost : int
+            Sum of `CovariantTunableGroup.get_current_cost()` of the given groups.
+        """
+        return sum(self._tunable_groups[name].get_current_cost()
+                   for name in (group_names or self.get_covariant_group_names()))
+
+    def get_total_cost(self, group_names: Optional[Iterable[str]] = None) -> int:
+        """
+        Get the total cost of changing all values in the covariant tunable groups,
+        regardless of their update status.
+
+        Parameters
+        ----------
+        group_names : list of str or None
+            IDs of the covariant tunable groups.
+            Use all groups if omitted.
+
+        Returns
+        -------
+        cost : int
+            Sum of `CovariantTunableGroup.cost` of the given groups.
+        """
+        return sum(self._tunable_groups[name].cost
+                   for name in (group_names or self.get_covariant_group_names()))
+
     def reset(self, group_names: Optional[Iterable[str]] = None) -> "TunableGroups":
         """
         Clear the update flag of given covariant groups.
@@ -28,6 +28,8 @@ except LookupError as e:
 extra_requires: Dict[str, List[str]] = {    # pylint: disable=consider-using-namedtuple-or-dataclass
     # Additional tools for extra functionality.
     'azure': ['azure-storage-file-share'],
+    'arrow': ['pyarrow'],   # Parquet and Arrow results files in LocalEnv.
+    'otel': ['opentelemetry-api'],  # Export the trial phase timings as OpenTelemetry spans and metrics.
     'storage-sql-duckdb': ['sqlalchemy', 'duckdb_engine'],
     'storage-sql-mysql': ['sqlalchemy', 'mysql-connector-python'],
     'storage-sql-postgres': ['sqlalchemy', 'psycopg2'],
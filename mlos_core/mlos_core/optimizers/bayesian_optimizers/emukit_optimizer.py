@@ -6,7 +6,7 @@
 Contains the wrapper class for Emukit Bayesian optimizers.
 """
 
-from typing import Optional
+from typing import Any, Dict, List, Optional, Sequence, Union
 
 import ConfigSpace
 import numpy as np
@@ -29,24 +29,44 @@ class EmukitOptimizer(BaseBayesianOptimizer):
 
     space_adapter : BaseSpaceAdapter
         The space adapter class to employ for parameter space transformations.
+
+    context_space : Optional[ConfigSpace.ConfigurationSpace]
+        The space of the context features. If specified, the GP is fitted on the
+        (configuration, context) pairs, and the acquisition function is optimized
+        over the parameters only, with the context variables fixed to the given values.
+
+    objectives : Optional[List[str]]
+        Names of the objectives. Emukit GP-based optimization is single-objective only.
     """
 
+    _HYPERPARAMETER_REFIT_GROWTH = 1.25
+    """Re-optimize the GP hyperparameters once the number of observations grows by this factor."""
+
     def __init__(self, *,
                  parameter_space: ConfigSpace.ConfigurationSpace,
-                 space_adapter: Optional[BaseSpaceAdapter] = None):
+                 space_adapter: Optional[BaseSpaceAdapter] = None,
+                 context_space: Optional[ConfigSpace.ConfigurationSpace] = None,
+                 objectives: Optional[List[str]] = None):
 
         super().__init__(
             parameter_space=parameter_space,
             space_adapter=space_adapter,
+            context_space=context_space,
+            objectives=objectives,
         )
+        if self.is_multi_objective:
+            raise NotImplementedError(f"{self.__class__.__name__} does not support multiple objectives")
 
         # pylint: disable=import-outside-toplevel
         from emukit.examples.gp_bayesian_optimization.single_objective_bayesian_optimization import GPBayesianOptimization
-        self.emukit_parameter_space = configspace_to_emukit_space(self.optimizer_parameter_space)
+        self.emukit_parameter_space = configspace_to_emukit_space(self._model_parameter_space)
         self.gpbo: GPBayesianOptimization
+        # Number of observations the GP hyperparameters have been last optimized on.
+        self._n_optimized = 0
 
-    def _register(self, configurations: pd.DataFrame, scores: pd.Series,
-                  context: Optional[pd.DataFrame] = None) -> None:
+    def _register(self, configurations: pd.DataFrame, scores: Union[pd.Series, pd.DataFrame],
+                  context: Optional[pd.DataFrame] = None,
+                  budgets: Optional[Sequence[Optional[float]]] = None) -> None:
         """Registers the given configurations and scores.
 
         Parameters
@@ -58,22 +78,37 @@ class EmukitOptimizer(BaseBayesianOptimizer):
             Scores from running the configurations. The index is the same as the index of the configurations.
 
         context : pd.DataFrame
-            Not Yet Implemented.
+            Context features of each configuration, if the optimizer has a `context_space`.
+
+        budgets : Optional[Sequence[Optional[float]]]
+            Ignored: the optimizer is single-fidelity.
         """
+        # pylint: disable=unused-argument
+        assert isinstance(scores, pd.Series)    # Single-objective only.
         from emukit.core.loop.user_function_result import UserFunctionResult    # pylint: disable=import-outside-toplevel
-        if context is not None:
-            # not sure how that works here?
-            raise NotImplementedError()
         if getattr(self, 'gpbo', None) is None:
             # we're in the random initialization phase
             # just remembering the observation above is enough
             return
-        results = []
-        for (_, config), score in zip(configurations.iterrows(), scores):
-            one_hot = self._to_1hot(pd.DataFrame([config]))
-            results.append(UserFunctionResult(one_hot[0], np.array([score])))
-        self.gpbo.loop_state.update(results)
-        self.gpbo._update_models()  # pylint: disable=protected-access
+        # Encode the whole batch at once and update the model only once per batch.
+        one_hot = self._to_1hot(self._with_context(configurations, context))
+        results = [
+            UserFunctionResult(x, np.array([score]))
+            for (x, score) in zip(one_hot, scores.to_numpy(dtype=float))
+        ]
+        loop_state = self.gpbo.loop_state
+        loop_state.update(results)
+        # Instead of the full `._update_models()` (which re-optimizes the GP hyperparameters
+        # on every call), just condition the GP on the new data, and re-optimize the
+        # hyperparameters only after the number of observations grows by a fixed factor.
+        self.gpbo.model.set_data(loop_state.X, loop_state.Y)
+        if len(loop_state.X) >= self._n_optimized * self._HYPERPARAMETER_REFIT_GROWTH:
+            self._optimize_model()
+
+    def _optimize_model(self) -> None:
+        """Optimize the GP hyperparameters on all observations the model has."""
+        self.gpbo.model.optimize()
+        self._n_optimized = len(self.gpbo.model.X)
 
     def _suggest(self, context: Optional[pd.DataFrame] = None) -> pd.DataFrame:
         """Suggests a new configuration.
@@ -81,26 +116,72 @@ class EmukitOptimizer(BaseBayesianOptimizer):
         Parameters
         ----------
         context : pd.DataFrame
-            Not Yet Implemented.
+            Context features to suggest the configuration for, if the optimizer has a `context_space`.
 
         Returns
         -------
         configuration : pd.DataFrame
             Pandas dataframe with a single row. Column names are the parameter names.
         """
-        if context is not None:
-            raise NotImplementedError()
+        return self._suggest_batch(1, context)
+
+    def _suggest_batch(self, n_suggestions: int, context: Optional[pd.DataFrame] = None) -> pd.DataFrame:
+        """Suggests several new configurations at once.
+
+        After the initial random phase, uses the "constant liar" heuristic:
+        every point in the batch is temporarily added to the GP model with the
+        best score observed so far, so that the next point in the batch is
+        chosen away from it. The model is only refitted once per batch.
+
+        Parameters
+        ----------
+        n_suggestions : int
+            Number of configurations to suggest.
+        context : pd.DataFrame
+            Context features to suggest the configurations for, if the optimizer has a `context_space`.
+
+        Returns
+        -------
+        configurations : pd.DataFrame
+            Pandas dataframe with `n_suggestions` rows. Column names are the parameter names.
+        """
         if len(self._observations) <= 10:   # TODO: make this configurable
             from emukit.core.initial_designs import RandomDesign    # pylint: disable=import-outside-toplevel
-            config = RandomDesign(self.emukit_parameter_space).get_samples(1)
+            config = RandomDesign(self.emukit_parameter_space).get_samples(n_suggestions)
             # TODO: make sure that returned log int values are properly rounded
-        else:
-            if getattr(self, 'gpbo', None) is None:
-                # this should happen exactly once, when calling the 11th time
-                self._initialize_optimizer()
-            # this should happen any time after the initial model is created
-            config = self.gpbo.get_next_points(results=[])
-        return self._from_1hot(config)
+            return self._from_1hot(config)[self.optimizer_parameter_space.get_hyperparameter_names()]
+
+        if getattr(self, 'gpbo', None) is None:
+            # this should happen exactly once, when calling the 11th time
+            self._initialize_optimizer()
+        # this should happen any time after the initial model is created
+        emukit_context = self._to_emukit_context(context)
+        config = self.gpbo.get_next_points(results=[], context=emukit_context)
+        if n_suggestions > 1:
+            model = self.gpbo.model
+            (orig_x, orig_y) = (model.X, model.Y)
+            lie = np.min(orig_y)
+            points = [config]
+            try:
+                for _ in range(n_suggestions - 1):
+                    model.set_data(np.vstack([model.X, points[-1]]), np.vstack([model.Y, [[lie]]]))
+                    points.append(self.gpbo.candidate_point_calculator.compute_next_points(
+                        self.gpbo.loop_state, context=emukit_context))
+            finally:
+                model.set_data(orig_x, orig_y)
+            config = np.vstack(points)
+        return self._from_1hot(config)[self.optimizer_parameter_space.get_hyperparameter_names()]
+
+    @staticmethod
+    def _to_emukit_context(context: Optional[pd.DataFrame]) -> Optional[Dict[str, Any]]:
+        """
+        Convert the (single row) context DataFrame into the emukit context dict
+        of the variables to keep fixed when optimizing the acquisition function.
+        """
+        if context is None:
+            return None
+        return {str(name): value.item() if isinstance(value, np.generic) else value
+                for (name, value) in context.iloc[0].items()}
 
     def register_pending(self, configurations: pd.DataFrame,
                          context: Optional[pd.DataFrame] = None) -> None:
@@ -108,13 +189,12 @@ class EmukitOptimizer(BaseBayesianOptimizer):
 
     def surrogate_predict(self, configurations: pd.DataFrame,
                           context: Optional[pd.DataFrame] = None) -> npt.NDArray:
-        if context is not None:
-            raise NotImplementedError("EmuKit does not support context yet.")
         if self.space_adapter is not None:
             raise NotImplementedError("EmuKit does not support space adapters yet.")
         if self._space_adapter:
             configurations = self._space_adapter.inverse_transform(configurations)
-        one_hot = self._to_1hot(configurations)
+        context = self._check_context(context, len(configurations))
+        one_hot = self._to_1hot(self._with_context(configurations, context))
         # TODO return variance in some way
         mean_predictions, _variance_predictions = self.gpbo.model.predict(one_hot)
         # make 2ndim array into column vector
@@ -130,14 +210,17 @@ class EmukitOptimizer(BaseBayesianOptimizer):
         from emukit.examples.gp_bayesian_optimization.single_objective_bayesian_optimization import GPBayesianOptimization  # noqa pylint: disable=import-outside-toplevel
         observations = self.get_observations()
 
-        initial_input = observations.drop(columns='score')
+        initial_input = observations.drop(columns=['score'] + self._context_names)
         initial_output = observations[['score']]
 
         if self.space_adapter is not None:
             initial_input = self.space_adapter.inverse_transform(initial_input)
+        if self.context_space is not None:
+            initial_input = self._with_context(initial_input, observations[self._context_names])
 
         self.gpbo = GPBayesianOptimization(
             variables_list=self.emukit_parameter_space.parameters,
             X=self._to_1hot(initial_input),
             Y=np.array(initial_output)
         )
+        self._optimize_model()
@@ -7,17 +7,23 @@ Contains the wrapper class for SMAC Bayesian optimizers.
 See Also: <https://automl.github.io/SMAC3/main/index.html>
 """
 
+import base64
+import time
 from pathlib import Path
-from typing import Mapping, Optional
+from typing import Any, Dict, List, Optional, Sequence, Tuple, Type, Union, TYPE_CHECKING
 from tempfile import TemporaryDirectory
 
 import ConfigSpace
+import numpy as np
 import numpy.typing as npt
 import pandas as pd
 
 from mlos_core.optimizers.bayesian_optimizers.bayesian_optimizer import BaseBayesianOptimizer
 from mlos_core.spaces.adapters.adapter import BaseSpaceAdapter
 
+if TYPE_CHECKING:
+    from smac.runhistory import StatusType, TrialInfo
+
 
 class SmacOptimizer(BaseBayesianOptimizer):
     """Wrapper class for SMAC based Bayesian optimization.
@@ -51,8 +57,60 @@ class SmacOptimizer(BaseBayesianOptimizer):
     n_random_probability: Optional[float]
         Probability of choosing to evaluate a random configuration during optimization.
         Defaults to `0.1`. Setting this to a higher value favors exploration over exploitation.
+
+    min_budget : Optional[float]
+        Minimum budget (e.g., benchmark duration) to evaluate a configuration with.
+        If both `min_budget` and `max_budget` are set, use multi-fidelity optimization (Hyperband),
+        i.e., screen the configurations with cheap low-budget trials first.
+        The budget of each suggestion is available via `.get_budget()`.
+        Defaults to `None` (single-fidelity optimization).
+
+    max_budget : Optional[float]
+        Maximum budget to evaluate a configuration with. Defaults to `None`.
+
+    eta : int
+        Hyperband parameter: only 1/eta of the configurations are promoted to the next budget level.
+        Ignored in single-fidelity mode. Defaults to 3.
+
+    context_space : Optional[ConfigSpace.ConfigurationSpace]
+        The space of the context features. If specified, the surrogate model is trained on the
+        (configuration, context) pairs, and the suggestion for the given context is the candidate
+        configuration with the highest acquisition value in that context.
+        Defaults to `None` (no context).
+
+    n_context_candidates : int
+        Number of random configurations to consider in addition to the SMAC suggestion and
+        the best configurations of the most similar contexts. Ignored without `context_space`.
+        Defaults to 100.
+
+    objectives : Optional[List[str]]
+        Names of the objectives (all minimized). With more than one objective, SMAC
+        scalarizes the costs with ParEGO, i.e., a random augmented Chebyshev weighting
+        of the normalized objectives, redrawn on every iteration, so that the suggestions
+        spread along the Pareto front.
+        Defaults to `None` (a single objective, "score").
+
+    parego_rho : float
+        ParEGO parameter: the weight of the sum of the objectives in the augmented
+        Chebyshev scalarization. Ignored with a single objective. Defaults to 0.05.
+
+    save_interval : Optional[float]
+        Min. time (in seconds) between the saves of the SMAC state (run history, intensifier)
+        to the `output_directory` after the registrations. Use 0 to save after every registration.
+        Defaults to `None`: if `output_directory` is set explicitly, save at most every
+        `_DEFAULT_SAVE_INTERVAL` seconds; otherwise (temporary directory), save only on
+        `.checkpoint()`, which keeps the disk I/O off the registration path.
     """
 
+    _DEFAULT_SAVE_INTERVAL = 60.0
+    """Default `save_interval` (in seconds) when the `output_directory` is set explicitly."""
+
+    _N_CONTEXT_TRANSFER = 5
+    """Number of the best configurations of the most similar contexts to consider as candidates."""
+
+    _STATE_FILES = ("runhistory.json", "intensifier.json", "optimization.json")
+    """Files of the SMAC output directory that hold the optimizer state (see `SMBO.save()`)."""
+
     def __init__(self, *,  # pylint: disable=too-many-locals
                  parameter_space: ConfigSpace.ConfigurationSpace,
                  space_adapter: Optional[BaseSpaceAdapter] = None,
@@ -61,24 +119,43 @@ class SmacOptimizer(BaseBayesianOptimizer):
                  output_directory: Optional[str] = None,
                  max_trials: int = 100,
                  n_random_init: Optional[int] = 10,
-                 n_random_probability: Optional[float] = 0.1):
+                 n_random_probability: Optional[float] = 0.1,
+                 min_budget: Optional[float] = None,
+                 max_budget: Optional[float] = None,
+                 eta: int = 3,
+                 context_space: Optional[ConfigSpace.ConfigurationSpace] = None,
+                 n_context_candidates: int = 100,
+                 objectives: Optional[List[str]] = None,
+                 parego_rho: float = 0.05,
+                 save_interval: Optional[float] = None):
 
         super().__init__(
             parameter_space=parameter_space,
             space_adapter=space_adapter,
+            context_space=context_space,
+            objectives=objectives,
         )
+        self._n_context_candidates = n_context_candidates
+        if save_interval is None and output_directory is not None:
+            # Keep the state in the user's output directory up to date, as SMAC itself would.
+            save_interval = self._DEFAULT_SAVE_INTERVAL
+        self._save_interval = save_interval
+        self._last_save_time = time.monotonic()
 
         # pylint: disable=import-outside-toplevel
-        from smac import HyperparameterOptimizationFacade as Optimizer_Smac
+        from smac import HyperparameterOptimizationFacade, MultiFidelityFacade
         from smac import Scenario
+        from smac.facade.abstract_facade import AbstractFacade
         from smac.intensifier.abstract_intensifier import AbstractIntensifier
         from smac.initial_design import LatinHypercubeInitialDesign
         from smac.main.config_selector import ConfigSelector
+        from smac.multi_objective.parego import ParEGO
         from smac.random_design.probability_design import ProbabilityRandomDesign
         from smac.runhistory import TrialInfo
 
-        # Store for TrialInfo instances returned by .ask()
-        self.trial_info_map: Mapping[ConfigSpace.Configuration, TrialInfo] = {}
+        # Store for TrialInfo instances returned by .ask() and not told yet, by (config, budget):
+        # Hyperband can suggest the same configuration again with a larger budget.
+        self.trial_info_map: Dict[Tuple[ConfigSpace.Configuration, Optional[float]], TrialInfo] = {}
 
         # The default when not specified is to use a known seed (0) to keep results reproducible.
         # However, if a `None` seed is explicitly provided, we let a random seed be produced by SMAC.
@@ -95,16 +172,32 @@ class SmacOptimizer(BaseBayesianOptimizer):
                 self.temp_output_directory = TemporaryDirectory()
             output_directory = self.temp_output_directory.name
 
+        if (min_budget is None) != (max_budget is None):
+            raise ValueError("Both min_budget and max_budget must be set for multi-fidelity optimization")
+        # Budget to assume for the configurations that were not suggested by this optimizer (e.g., warm-up data).
+        self._max_budget = max_budget
+
         scenario: Scenario = Scenario(
-            self.optimizer_parameter_space,
+            self._model_parameter_space,
             name=run_name,
             output_directory=Path(output_directory),
             deterministic=True,
             n_trials=max_trials,
             seed=seed or -1,  # if -1, SMAC will generate a random seed internally
             n_workers=1,  # Use a single thread for evaluating trials
+            min_budget=min_budget,
+            max_budget=max_budget,
+            objectives=self._objectives if self.is_multi_objective else "cost",
         )
-        intensifier: AbstractIntensifier = Optimizer_Smac.get_intensifier(scenario, max_config_calls=1)
+        facade: Type[AbstractFacade]
+        intensifier: AbstractIntensifier
+        if max_budget is None:
+            facade = HyperparameterOptimizationFacade
+            intensifier = HyperparameterOptimizationFacade.get_intensifier(scenario, max_config_calls=1)
+        else:
+            # Multi-fidelity: Hyperband picks the budget for each suggestion.
+            facade = MultiFidelityFacade
+            intensifier = MultiFidelityFacade.get_intensifier(scenario, eta=eta)
         config_selector: ConfigSelector = ConfigSelector(scenario, retrain_after=1)
 
         initial_design: Optional[LatinHypercubeInitialDesign] = None
@@ -113,14 +206,18 @@ class SmacOptimizer(BaseBayesianOptimizer):
         random_design: Optional[ProbabilityRandomDesign] = None
         if n_random_probability is not None:
             random_design = ProbabilityRandomDesign(probability=n_random_probability)
+        multi_objective_algorithm: Optional[ParEGO] = None
+        if self.is_multi_objective:
+            multi_objective_algorithm = ParEGO(scenario, rho=parego_rho)
 
-        self.base_optimizer = Optimizer_Smac(
+        self.base_optimizer = facade(
             scenario,
             SmacOptimizer._dummy_target_func,
             initial_design=initial_design,
             intensifier=intensifier,
             random_design=random_design,
             config_selector=config_selector,
+            multi_objective_algorithm=multi_objective_algorithm,
             overwrite=True,
         )
 
@@ -129,7 +226,8 @@ class SmacOptimizer(BaseBayesianOptimizer):
         self.cleanup()
 
     @staticmethod
-    def _dummy_target_func(config: ConfigSpace.Configuration, seed: int = 0) -> None:
+    def _dummy_target_func(config: ConfigSpace.Configuration, seed: int = 0,
+                           budget: Optional[float] = None) -> None:
         """Dummy target function for SMAC optimizer.
 
         Since we only use the ask-and-tell interface, this is never called.
@@ -141,12 +239,17 @@ class SmacOptimizer(BaseBayesianOptimizer):
 
         seed : int
             Random seed to use for the target function. Not actually used.
+
+        budget : Optional[float]
+            Budget of the trial (required by SMAC in multi-fidelity mode). Not actually used.
         """
         # NOTE: Providing a target function when using the ask-and-tell interface is an imperfection of the API
         # -- this planned to be fixed in some future release: https://github.com/automl/SMAC3/issues/946
         raise RuntimeError('This function should never be called.')
 
-    def _register(self, configurations: pd.DataFrame, scores: pd.Series, context: Optional[pd.DataFrame] = None) -> None:
+    def _register(self, configurations: pd.DataFrame, scores: Union[pd.Series, pd.DataFrame],
+                  context: Optional[pd.DataFrame] = None,
+                  budgets: Optional[Sequence[Optional[float]]] = None) -> None:
         """Registers the given configurations and scores.
 
         Parameters
@@ -154,26 +257,96 @@ class SmacOptimizer(BaseBayesianOptimizer):
         configurations : pd.DataFrame
             Dataframe of configurations / parameters. The columns are parameter names and the rows are the configurations.
 
-        scores : pd.Series
+        scores : Union[pd.Series, pd.DataFrame]
             Scores from running the configurations. The index is the same as the index of the configurations.
+            A dataframe with one column per objective, if the optimizer has several `objectives`.
 
         context : pd.DataFrame
-            Not Yet Implemented.
-        """
-        from smac.runhistory import StatusType, TrialInfo, TrialValue  # pylint: disable=import-outside-toplevel
+            Context features of each configuration, if the optimizer has a `context_space`.
 
-        if context is not None:
-            raise NotImplementedError()
+        budgets : Optional[Sequence[Optional[float]]]
+            Budget each configuration has been evaluated with (multi-fidelity mode only).
+            If not specified, use the budget of the pending `.ask()` of the same configuration.
+        """
+        from smac.runhistory import StatusType, TrialValue  # pylint: disable=import-outside-toplevel
 
-        # Register each trial (one-by-one)
-        for config, score in zip(self._to_configspace_configs(configurations), scores.tolist()):
-            # Retrieve previously generated TrialInfo (returned by .ask()) or create new TrialInfo instance
-            info: TrialInfo = self.trial_info_map.get(config, TrialInfo(config=config))
+        configs = self._to_configspace_configs(self._with_context(configurations, context))
+        # Register each trial (one-by-one); SMAC takes a list of costs in the multi-objective mode.
+        for config, score, budget in zip(configs, scores.values.tolist(), budgets or [None] * len(configs)):
+            info = self._pop_trial_info(config, budget)
             value: TrialValue = TrialValue(cost=score, time=0.0, status=StatusType.SUCCESS)
             self.base_optimizer.tell(info, value, save=False)
 
-        # Save optimizer once we register all configs
+        # Save optimizer once we register all configs (if it's time to).
+        if self._save_interval is not None and time.monotonic() - self._last_save_time >= self._save_interval:
+            self._save()
+
+    def _register_failed(self, configurations: pd.DataFrame,
+                         context: Optional[pd.DataFrame] = None,
+                         budgets: Optional[Sequence[Optional[float]]] = None) -> None:
+        """Tell SMAC that the trials have crashed, with the crash cost, so that they
+        do not stay in the run history as running forever: e.g., Hyperband waits for all
+        trials of the bracket to complete before it promotes the best ones to the next stage.
+        """
+        from smac.runhistory import StatusType  # pylint: disable=import-outside-toplevel
+        configs = self._to_configspace_configs(self._with_context(configurations, context))
+        for config, budget in zip(configs, budgets or [None] * len(configs)):
+            self._tell_crash_cost(self._pop_trial_info(config, budget), StatusType.CRASHED)
+
+    def _pop_trial_info(self, config: ConfigSpace.Configuration, budget: Optional[float]) -> "TrialInfo":
+        """
+        Retrieve (and forget) the TrialInfo that `.ask()` has returned for the configuration
+        and budget, or make a new one for the configurations that SMAC has not suggested.
+        Without the budget, take the oldest pending TrialInfo of that configuration.
+        """
+        from smac.runhistory import TrialInfo  # pylint: disable=import-outside-toplevel
+        if budget is None:
+            budget = next((key_budget for (key_config, key_budget) in self.trial_info_map
+                           if key_config == config), self._max_budget)
+        info = self.trial_info_map.pop((config, budget), None)
+        return TrialInfo(config=config, budget=budget) if info is None else info
+
+    def _save(self) -> Path:
+        """Save the SMAC state to the output directory and return the path to it."""
         self.base_optimizer.optimizer.save()
+        self._last_save_time = time.monotonic()
+        return Path(self.base_optimizer.scenario.output_directory)
+
+    def _get_backend_state(self) -> Dict[str, str]:
+        """Get the SMAC state as saved to the output directory (file name -> base64-encoded contents).
+        The surrogate model is not saved, but SMAC retrains it on the next suggestion anyway.
+        """
+        output_directory = self._save()
+        return {
+            name: base64.b64encode((output_directory / name).read_bytes()).decode("ascii")
+            for name in self._STATE_FILES
+            if (output_directory / name).exists()
+        }
+
+    def _set_backend_state(self, state: Any) -> None:
+        """Put the saved SMAC state into the output directory and load it,
+        the same way SMAC continues the previous run with the same scenario.
+        """
+        if not state:
+            super()._set_backend_state(state)
+            return
+        unexpected = set(state).difference(self._STATE_FILES)
+        if unexpected:
+            raise ValueError(f"Unexpected SMAC state files in the checkpoint: {sorted(unexpected)}")
+        files = {name: base64.b64decode(data, validate=True) for (name, data) in state.items()}
+        output_directory = Path(self.base_optimizer.scenario.output_directory)
+        output_directory.mkdir(parents=True, exist_ok=True)
+        for (name, data) in files.items():
+            (output_directory / name).write_bytes(data)
+        try:
+            self.base_optimizer.optimizer.load()
+        except Exception:
+            # Do not keep the partially loaded state.
+            self.base_optimizer.runhistory.reset()
+            self.base_optimizer.intensifier.reset()
+            for name in files:
+                (output_directory / name).unlink(missing_ok=True)
+            raise
 
     def _suggest(self, context: Optional[pd.DataFrame] = None) -> pd.DataFrame:
         """Suggests a new configuration.
@@ -181,7 +354,7 @@ class SmacOptimizer(BaseBayesianOptimizer):
         Parameters
         ----------
         context : pd.DataFrame
-            Not Yet Implemented.
+            Context features to suggest the configuration for, if the optimizer has a `context_space`.
 
         Returns
         -------
@@ -190,26 +363,101 @@ class SmacOptimizer(BaseBayesianOptimizer):
         """
         from smac.runhistory import TrialInfo  # pylint: disable=import-outside-toplevel
 
-        if context is not None:
-            raise NotImplementedError()
-
         trial: TrialInfo = self.base_optimizer.ask()
+        if context is not None:
+            return self._suggest_for_context(trial, context)
         # Type ignore because this is WIP from ConfigSpace side
         # Check here: https://github.com/automl/ConfigSpace/issues/293
-        self.trial_info_map[trial.config] = trial  # type: ignore
+        self.trial_info_map[(trial.config, trial.budget)] = trial  # type: ignore
         return pd.DataFrame([trial.config], columns=self.optimizer_parameter_space.get_hyperparameter_names())
 
+    def _suggest_for_context(self, trial: "TrialInfo", context: pd.DataFrame) -> pd.DataFrame:
+        """
+        Pick the configuration for the given context.
+
+        SMAC cannot maximize the acquisition function with some of the dimensions fixed,
+        so we use its suggestion (over both the parameters and the context) only as one of the candidates,
+        along with the best configurations of the most similar contexts seen so far and some random ones.
+        Once the model is trained, return the candidate with the highest acquisition value
+        in the given context; during the initial design, return the SMAC suggestion.
+
+        The SMAC trial itself is never evaluated: even its parameters are benchmarked
+        in a different context. So we close it right away, and `.register()` tells SMAC
+        the results as a new trial in the actual context.
+        """
+        names = self.optimizer_parameter_space.get_hyperparameter_names()
+        # Note: `.ask()` also (re)trains the model and updates the acquisition function.
+        suggestion = pd.DataFrame([trial.config], columns=self._model_parameter_space.get_hyperparameter_names())[names]
+        self._discard_trial(trial)
+        # pylint: disable=protected-access
+        if len(self._observations) < self.base_optimizer._initial_design._n_configs or \
+                self.base_optimizer._config_selector._model is None or \
+                self.base_optimizer._config_selector._acquisition_function is None:
+            return suggestion
+        samples = self.optimizer_parameter_space.sample_configuration(size=self._n_context_candidates)
+        candidates = pd.concat([
+            suggestion,
+            self._best_configs_for_context(context, self._N_CONTEXT_TRANSFER),
+            pd.DataFrame([config.get_dictionary() for config in samples], columns=names),
+        ], ignore_index=True).drop_duplicates(ignore_index=True)
+        configs: list = self._to_configspace_configs(self._with_context(candidates, context))
+        acq_values = self.base_optimizer._config_selector._acquisition_function(configs).reshape(-1,)
+        return candidates.iloc[[int(np.argmax(acq_values))]].reset_index(drop=True)
+
+    def _discard_trial(self, trial: "TrialInfo") -> None:
+        """
+        Tell SMAC that the trial it has suggested will not be evaluated, so that it does not
+        stay in the run history as running forever. Report it as a timeout with the crash cost:
+        by default, SMAC does not train its surrogate model on the timed out trials.
+        """
+        from smac.runhistory import StatusType  # pylint: disable=import-outside-toplevel
+        self._tell_crash_cost(trial, StatusType.TIMEOUT)
+
+    def _tell_crash_cost(self, trial: "TrialInfo", status: "StatusType") -> None:
+        """
+        Complete the trial in SMAC with the given status and the crash cost.
+        """
+        from smac.runhistory import TrialValue  # pylint: disable=import-outside-toplevel
+        cost = self.base_optimizer.scenario.crash_cost
+        if self.is_multi_objective and not isinstance(cost, list):
+            cost = [cost] * len(self._objectives)
+        self.base_optimizer.tell(trial, TrialValue(cost=cost, time=0.0, status=status), save=False)
+
     def register_pending(self, configurations: pd.DataFrame, context: Optional[pd.DataFrame] = None) -> None:
         raise NotImplementedError()
 
+    def _get_budget(self, configuration: pd.DataFrame) -> Optional[float]:
+        """Get the budget that Hyperband has assigned to the suggested configuration.
+
+        Parameters
+        ----------
+        configuration : pd.DataFrame
+            Pandas dataframe with a single row. Column names are the parameter names.
+
+        Returns
+        -------
+        budget : Optional[float]
+            The budget of the trial, or None in single-fidelity mode.
+        """
+        if self.context_space is not None:
+            # The contextual suggestions do not come directly from SMAC, so have no budget assigned.
+            return self._max_budget
+        (config,) = self._to_configspace_configs(configuration)
+        # The latest suggestion of the configuration.
+        budgets = [budget for (key_config, budget) in self.trial_info_map if key_config == config]
+        return budgets[-1] if budgets else self._max_budget
+
+    @property
+    def is_multi_fidelity(self) -> bool:
+        return self._max_budget is not None
+
     def surrogate_predict(self, configurations: pd.DataFrame, context: Optional[pd.DataFrame] = None) -> npt.NDArray:
         from smac.utils.configspace import convert_configurations_to_array  # pylint: disable=import-outside-toplevel
 
-        if context is not None:
-            raise NotImplementedError()
         if self._space_adapter:
             raise NotImplementedError()
 
+        configurations = self._with_context(configurations, self._check_context(context, len(configurations)))
         # pylint: disable=protected-access
         if len(self._observations) < self.base_optimizer._initial_design._n_configs:
             raise RuntimeError('Surrogate model can make predictions *only* after all initial points have been evaluated')
@@ -221,11 +469,11 @@ class SmacOptimizer(BaseBayesianOptimizer):
         return mean_predictions.reshape(-1,)
 
     def acquisition_function(self, configurations: pd.DataFrame, context: Optional[pd.DataFrame] = None) -> npt.NDArray:
-        if context is not None:
-            raise NotImplementedError()
         if self._space_adapter:
-            raise NotImplementedError()
+            # SMAC scores the configurations in the target space of the adapter.
+            configurations = self._space_adapter.inverse_transform(configurations)
 
+        configurations = self._with_context(configurations, self._check_context(context, len(configurations)))
         # pylint: disable=protected-access
         if self.base_optimizer._config_selector._acquisition_function is None:
             raise RuntimeError('Acquisition function is not yet initialized')
@@ -244,7 +492,8 @@ class SmacOptimizer(BaseBayesianOptimizer):
         Parameters
         ----------
         configurations : pd.DataFrame
-            Dataframe of configurations / parameters. The columns are parameter names and the rows are the configurations.
+            Dataframe of configurations / parameters. The columns are parameter names
+            (and the context features, if the optimizer has a `context_space`) and the rows are the configurations.
 
         Returns
         -------
@@ -252,6 +501,6 @@ class SmacOptimizer(BaseBayesianOptimizer):
             List of ConfigSpace configurations.
         """
         return [
-            ConfigSpace.Configuration(self.optimizer_parameter_space, values=config.to_dict())
+            ConfigSpace.Configuration(self._model_parameter_space, values=config.to_dict())
             for (_, config) in configurations.iterrows()
         ]
@@ -6,10 +6,11 @@
 Contains the FlamlOptimizer class.
 """
 
-from typing import Dict, NamedTuple, Optional, Union
+from typing import Dict, List, NamedTuple, Optional, Sequence, Tuple, Union
 from warnings import warn
 
 import ConfigSpace
+import numpy as np
 import pandas as pd
 
 from mlos_core.optimizers.optimizer import BaseOptimizer
@@ -38,26 +39,46 @@ class FlamlOptimizer(BaseOptimizer):
     low_cost_partial_config : dict
         A dictionary from a subset of controlled dimensions to the initial low-cost values.
         More info: https://microsoft.github.io/FLAML/docs/FAQ#about-low_cost_partial_config-in-tune
+
+    context_space : Optional[ConfigSpace.ConfigurationSpace]
+        The space of the context features. FLAML has no notion of context, so, if specified,
+        each suggestion warm-starts FLAML from the samples of the most similar contexts first.
+
+    objectives : Optional[List[str]]
+        Names of the objectives. The FLAML ask-and-tell interface is single-objective only.
     """
 
     def __init__(self, *,
                  parameter_space: ConfigSpace.ConfigurationSpace,
                  space_adapter: Optional[BaseSpaceAdapter] = None,
-                 low_cost_partial_config: Optional[dict] = None):
+                 low_cost_partial_config: Optional[dict] = None,
+                 context_space: Optional[ConfigSpace.ConfigurationSpace] = None,
+                 objectives: Optional[List[str]] = None):
 
         super().__init__(
             parameter_space=parameter_space,
             space_adapter=space_adapter,
+            context_space=context_space,
+            objectives=objectives,
         )
+        if self.is_multi_objective:
+            raise NotImplementedError(f"{self.__class__.__name__} does not support multiple objectives")
 
         self.flaml_parameter_space: dict = configspace_to_flaml_space(self.optimizer_parameter_space)
         self.low_cost_partial_config = low_cost_partial_config
 
         self.evaluated_samples: Dict[ConfigSpace.Configuration, EvaluatedSample] = {}
+        # Samples suggested earlier in the current batch, with a (fake) "liar" score.
+        self._batch_samples: Dict[ConfigSpace.Configuration, EvaluatedSample] = {}
+        # (context, config, sample) of all registered samples, if the optimizer has a context space.
+        self._context_samples: List[Tuple[dict, ConfigSpace.Configuration, EvaluatedSample]] = []
+        # Samples to warm-start the current FLAML instance with.
+        self._active_samples: Dict[ConfigSpace.Configuration, EvaluatedSample] = self.evaluated_samples
         self._suggested_config: Optional[dict]
 
-    def _register(self, configurations: pd.DataFrame, scores: pd.Series,
-                  context: Optional[pd.DataFrame] = None) -> None:
+    def _register(self, configurations: pd.DataFrame, scores: Union[pd.Series, pd.DataFrame],
+                  context: Optional[pd.DataFrame] = None,
+                  budgets: Optional[Sequence[Optional[float]]] = None) -> None:
         """Registers the given configurations and scores.
 
         Parameters
@@ -68,18 +89,28 @@ class FlamlOptimizer(BaseOptimizer):
         scores : pd.Series
             Scores from running the configurations. The index is the same as the index of the configurations.
 
-        context : None
-            Not Yet Implemented.
+        context : pd.DataFrame
+            Context features of each configuration, if the optimizer has a `context_space`.
+
+        budgets : Optional[Sequence[Optional[float]]]
+            Ignored: the optimizer is single-fidelity.
         """
-        if context is not None:
-            raise NotImplementedError()
-        for (_, config), score in zip(configurations.iterrows(), scores):
+        # pylint: disable=unused-argument
+        assert isinstance(scores, pd.Series)    # Single-objective only.
+        contexts = [{}] * len(configurations) if context is None else \
+            self._with_context(configurations, context)[self._context_names].to_dict(orient="records")
+        for (_, config), score, ctx in zip(configurations.iterrows(), scores, contexts):
             cs_config: ConfigSpace.Configuration = ConfigSpace.Configuration(
                 self.optimizer_parameter_space, values=config.to_dict())
+            sample = EvaluatedSample(config=config.to_dict(), score=score)
+            if context is not None:
+                # The same configuration can be evaluated in different contexts.
+                self._context_samples.append((ctx, cs_config, sample))
+                continue
             if cs_config in self.evaluated_samples:
                 warn(f"Configuration {config} was already registered", UserWarning)
 
-            self.evaluated_samples[cs_config] = EvaluatedSample(config=config.to_dict(), score=score)
+            self.evaluated_samples[cs_config] = sample
 
     def _suggest(self, context: Optional[pd.DataFrame] = None) -> pd.DataFrame:
         """Suggests a new configuration.
@@ -88,23 +119,71 @@ class FlamlOptimizer(BaseOptimizer):
 
         Parameters
         ----------
-        context : None
-            Not Yet Implemented.
+        context : pd.DataFrame
+            Context features to suggest the configuration for, if the optimizer has a `context_space`.
 
         Returns
         -------
         configuration : pd.DataFrame
             Pandas dataframe with a single row. Column names are the parameter names.
         """
-        if context is not None:
-            raise NotImplementedError()
-        config: dict = self._get_next_config()
+        config: dict = self._get_next_config(self._samples_for_context(context))
         return pd.DataFrame(config, index=[0])
 
+    def _suggest_batch(self, n_suggestions: int, context: Optional[pd.DataFrame] = None) -> pd.DataFrame:
+        """Suggests several new configurations at once.
+
+        Uses the "constant liar" heuristic: every configuration suggested earlier in the batch
+        is passed to FLAML as already evaluated with the best score observed so far,
+        so that FLAML does not suggest it again.
+
+        Parameters
+        ----------
+        n_suggestions : int
+            Number of configurations to suggest.
+        context : pd.DataFrame
+            Context features to suggest the configurations for, if the optimizer has a `context_space`.
+
+        Returns
+        -------
+        configurations : pd.DataFrame
+            Pandas dataframe with `n_suggestions` rows. Column names are the parameter names.
+        """
+        samples = self._samples_for_context(context)
+        lie = min((s.score for s in samples.values()), default=0.0)
+        configs: List[dict] = []
+        try:
+            for _ in range(n_suggestions):
+                config = self._get_next_config(samples)
+                configs.append(config)
+                cs_config = ConfigSpace.Configuration(self.optimizer_parameter_space, values=config)
+                self._batch_samples[cs_config] = EvaluatedSample(config=config, score=lie)
+        finally:
+            self._batch_samples.clear()
+        return pd.DataFrame(configs)
+
     def register_pending(self, configurations: pd.DataFrame,
                          context: Optional[pd.DataFrame] = None) -> None:
         raise NotImplementedError()
 
+    def _samples_for_context(self, context: Optional[pd.DataFrame]) -> Dict[ConfigSpace.Configuration, EvaluatedSample]:
+        """
+        Get the samples to warm-start FLAML with for the given context (if any).
+
+        The samples are ordered from the most to the least similar context,
+        and for each configuration only the sample of the most similar context is kept.
+        """
+        if context is None:
+            return self.evaluated_samples
+        samples: Dict[ConfigSpace.Configuration, EvaluatedSample] = {}
+        if not self._context_samples:
+            return samples
+        dist = self._context_distances(pd.DataFrame([ctx for (ctx, _, _) in self._context_samples]), context)
+        for idx in np.argsort(dist, kind="stable"):
+            (_, cs_config, sample) = self._context_samples[idx]
+            samples.setdefault(cs_config, sample)
+        return samples
+
     def _target_function(self, config: dict) -> Union[dict, None]:
         """Configuration evaluation function called by FLAML optimizer.
 
@@ -123,13 +202,15 @@ class FlamlOptimizer(BaseOptimizer):
             Dictionary with a single key, `score`, if config already evaluated; `None` otherwise.
         """
         cs_config: ConfigSpace.Configuration = ConfigSpace.Configuration(self.optimizer_parameter_space, values=config)
-        if cs_config in self.evaluated_samples:
-            return {'score': self.evaluated_samples[cs_config].score}
+        if cs_config in self._active_samples:
+            return {'score': self._active_samples[cs_config].score}
+        if cs_config in self._batch_samples:
+            return {'score': self._batch_samples[cs_config].score}
 
         self._suggested_config = config
         return None  # Returning None stops the process
 
-    def _get_next_config(self) -> dict:
+    def _get_next_config(self, samples: Optional[Dict[ConfigSpace.Configuration, EvaluatedSample]] = None) -> dict:
         """Warm-starts a new instance of FLAML, and returns a recommended, unseen new configuration.
 
         Since FLAML does not provide an ask-and-tell interface, we need to create a new instance of FLAML
@@ -137,6 +218,11 @@ class FlamlOptimizer(BaseOptimizer):
         To do so, we use any previously evaluated configurations to bootstrap FLAML (i.e., warm-start).
         For more info: https://microsoft.github.io/FLAML/docs/Use-Cases/Tune-User-Defined-Function#warm-start
 
+        Parameters
+        ----------
+        samples : Optional[Dict[ConfigSpace.Configuration, EvaluatedSample]]
+            Evaluated samples to warm-start FLAML with. Defaults to all registered samples.
+
         Returns
         -------
         result: dict
@@ -149,10 +235,12 @@ class FlamlOptimizer(BaseOptimizer):
         from flaml import tune  # pylint: disable=import-outside-toplevel
 
         # Parse evaluated configs to format used by FLAML
+        self._active_samples = self.evaluated_samples if samples is None else samples
         points_to_evaluate: list = []
         evaluated_rewards: list = []
-        if len(self.evaluated_samples) > 0:
-            evaluated_samples_list: list = [(s.config, s.score) for s in self.evaluated_samples.values()]
+        if len(self._active_samples) > 0 or len(self._batch_samples) > 0:
+            evaluated_samples_list: list = [(s.config, s.score) for s in self._active_samples.values()]
+            evaluated_samples_list += [(s.config, s.score) for s in self._batch_samples.values()]
             points_to_evaluate, evaluated_rewards = list(zip(*evaluated_samples_list))
 
         # Warm start FLAML optimizer
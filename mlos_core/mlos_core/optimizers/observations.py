@@ -0,0 +1,233 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Contains the columnar store for the observations registered with the optimizers.
+"""
+
+from typing import Dict, List, Optional, Union
+
+import numpy as np
+import numpy.typing as npt
+import pandas as pd
+
+
+class ObservationStore:
+    """
+    Keeps the registered configurations and their scores in preallocated numpy
+    arrays (one per column) that grow geometrically, so appending a batch of
+    observations takes amortized time proportional to the size of the batch.
+    Also keeps track of the best (i.e., lowest) score observed so far,
+    so the incumbent lookup does not need to scan the history.
+    The context features (if any) are stored as extra columns after the parameters.
+
+    With several objectives (all minimized), the store keeps one score column per objective,
+    takes the first objective as the primary one for the incumbent, and maintains
+    the Pareto front (i.e., the non-dominated observations) incrementally.
+    """
+
+    DEFAULT_CAPACITY = 64
+    """Initial number of rows to preallocate."""
+
+    def __init__(self, capacity: int = DEFAULT_CAPACITY, objectives: Optional[List[str]] = None):
+        """
+        Create a new empty observation store.
+
+        Parameters
+        ----------
+        capacity : int
+            Initial number of rows to preallocate.
+        objectives : Optional[List[str]]
+            Names of the score columns. Default is a single objective, "score".
+        """
+        self._capacity = max(capacity, 1)
+        self._size = 0
+        self._columns: Dict[str, npt.NDArray] = {}
+        self._objectives: List[str] = list(objectives or ["score"])
+        self._scores: npt.NDArray = np.empty((self._capacity, len(self._objectives)), dtype=float)
+        self._best_idx: Optional[int] = None
+        # Indices of the non-dominated observations, in the order of registration.
+        self._front: List[int] = []
+        self._context_names: List[str] = []
+
+    def __len__(self) -> int:
+        return self._size
+
+    def __repr__(self) -> str:
+        return f"{self.__class__.__name__}(size={self._size}, capacity={self._capacity})"
+
+    @property
+    def objectives(self) -> List[str]:
+        """Names of the score columns."""
+        return list(self._objectives)
+
+    @property
+    def has_context(self) -> bool:
+        """True if the observations have been registered with a context."""
+        return len(self._context_names) > 0
+
+    def append(self, configurations: pd.DataFrame, scores: Union[pd.Series, pd.DataFrame],
+               context: Optional[pd.DataFrame] = None) -> None:
+        """
+        Add a batch of observations to the store.
+
+        Parameters
+        ----------
+        configurations : pd.DataFrame
+            Dataframe of configurations / parameters. The columns are parameter names and the rows are the configurations.
+        scores : Union[pd.Series, pd.DataFrame]
+            Scores from running the configurations. The index is the same as the index of the configurations.
+            A dataframe with one column per objective; a series is accepted if there is a single objective.
+        context : pd.DataFrame
+            Context features of the configurations (one row per configuration), if any.
+            Either all or none of the batches must have the context.
+        """
+        n_rows = len(configurations)
+        if len(scores) != n_rows:
+            raise ValueError(f"Got {n_rows} configurations but {len(scores)} scores")
+        batch_scores = self._score_values(scores)
+        if context is not None:
+            if len(context) != n_rows:
+                raise ValueError(f"Got {n_rows} configurations but {len(context)} context rows")
+            if self._columns and not self.has_context:
+                raise ValueError("Cannot add context to the observations registered without it")
+            self._context_names = list(context.columns)
+            configurations = pd.concat([configurations.reset_index(drop=True),
+                                        context.reset_index(drop=True)], axis=1)
+        elif self.has_context:
+            raise ValueError(f"Context is required: {self._context_names}")
+        if self._columns and set(configurations.columns) != set(self._columns):
+            raise ValueError(f"Configuration columns {list(configurations.columns)} "
+                             f"do not match the registered ones: {list(self._columns)}")
+        if n_rows == 0:
+            return
+
+        self._reserve(self._size + n_rows)
+        new_rows = slice(self._size, self._size + n_rows)
+        for name in configurations.columns:
+            values = configurations[name].to_numpy()
+            column = self._columns.get(name)
+            if column is None:
+                dtype = values.dtype if values.dtype.kind in "biuf" else np.dtype(object)
+                column = self._columns[name] = np.empty(self._capacity, dtype=dtype)
+            elif np.result_type(column.dtype, values.dtype) != column.dtype:
+                # E.g., int column receives floats or numeric column receives strings.
+                dtype = np.result_type(column.dtype, values.dtype) \
+                    if values.dtype.kind in "biuf" else np.dtype(object)
+                column = self._columns[name] = column.astype(dtype)
+            column[new_rows] = values
+
+        self._scores[new_rows] = batch_scores
+        primary = batch_scores[:, 0]
+        if not np.isnan(primary).all():
+            idx = int(np.nanargmin(primary))
+            if self._best_idx is None or primary[idx] < self._scores[self._best_idx, 0]:
+                self._best_idx = self._size + idx
+        if len(self._objectives) > 1:
+            for idx in range(self._size, self._size + n_rows):
+                self._update_front(idx)
+        self._size += n_rows
+
+    def _score_values(self, scores: Union[pd.Series, pd.DataFrame]) -> npt.NDArray:
+        """
+        Convert the scores of a batch to a 2D array with one column per objective.
+        """
+        if isinstance(scores, pd.Series):
+            if len(self._objectives) > 1:
+                raise ValueError(f"Expected scores for all objectives: {self._objectives}")
+            return scores.to_numpy(dtype=float).reshape(-1, 1)
+        missing = set(self._objectives).difference(scores.columns)
+        if missing:
+            raise ValueError(f"Scores missing for the objectives: {sorted(missing)}")
+        return scores[self._objectives].to_numpy(dtype=float)
+
+    def _update_front(self, idx: int) -> None:
+        """
+        Add the observation at `idx` to the Pareto front, unless it is dominated
+        by the front (or has NaN scores), and drop the observations it dominates.
+        """
+        point = self._scores[idx]
+        if np.isnan(point).any():
+            return
+        front = self._scores[self._front]
+        if ((front <= point).all(axis=1) & (front < point).any(axis=1)).any():
+            return
+        dominated = (point <= front).all(axis=1) & (point < front).any(axis=1)
+        self._front = [i for (i, is_dominated) in zip(self._front, dominated) if not is_dominated]
+        self._front.append(idx)
+
+    def to_dataframe(self) -> pd.DataFrame:
+        """
+        Get all observations as a dataframe.
+
+        Returns
+        -------
+        observations : pd.DataFrame
+            Dataframe of observations. The columns are parameter names and the objectives
+            ("score" by default) for the scores, each row is an observation.
+        """
+        return self._rows(slice(0, self._size))
+
+    def best(self) -> pd.DataFrame:
+        """
+        Get the observation with the lowest score (of the primary objective).
+
+        Returns
+        -------
+        best_observation : pd.DataFrame
+            Dataframe with a single row containing the best observation. The columns are parameter names and the objectives.
+        """
+        if self._best_idx is None:
+            raise ValueError("No observations with a valid score registered yet.")
+        return self._rows([self._best_idx])
+
+    def pareto_front(self) -> pd.DataFrame:
+        """
+        Get the non-dominated observations, i.e., the ones that no other observation
+        beats on all objectives. With a single objective, that is all the observations
+        tied with the best score.
+
+        Returns
+        -------
+        pareto_front : pd.DataFrame
+            Dataframe with one row per non-dominated observation, in the order of registration.
+            The columns are parameter names and the objectives.
+        """
+        if self._best_idx is None:
+            raise ValueError("No observations with a valid score registered yet.")
+        if len(self._objectives) > 1:
+            return self._rows(list(self._front))
+        scores = self._scores[:self._size, 0]
+        return self._rows(np.flatnonzero(scores == scores[self._best_idx]).tolist())
+
+    def _rows(self, rows: Union[slice, List[int]]) -> pd.DataFrame:
+        """
+        Get the selected observations as a dataframe, indexed by their positions in the store.
+        """
+        data = {name: column[:self._size][rows] for (name, column) in self._columns.items()}
+        scores = self._scores[:self._size][rows]
+        for (i, name) in enumerate(self._objectives):
+            data[name] = scores[:, i]
+        index = range(self._size)[rows] if isinstance(rows, slice) else rows
+        return pd.DataFrame(data, index=index, copy=True)
+
+    def _reserve(self, size: int) -> None:
+        """
+        Make sure the arrays can hold at least `size` rows, doubling the capacity if needed.
+        """
+        if size <= self._capacity:
+            return
+        capacity = max(size, 2 * self._capacity)
+        for (name, column) in self._columns.items():
+            self._columns[name] = self._grow(column, capacity)
+        self._scores = self._grow(self._scores, capacity)
+        self._capacity = capacity
+
+    def _grow(self, array: npt.NDArray, capacity: int) -> npt.NDArray:
+        """
+        Copy the occupied part of the array into a new, larger one.
+        """
+        new_array = np.empty((capacity,) + array.shape[1:], dtype=array.dtype)
+        new_array[:self._size] = array[:self._size]
+        return new_array
@@ -0,0 +1,96 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Contains the one-hot encoder for the configurations of the optimizers.
+"""
+
+from typing import List, NamedTuple, Optional
+
+import ConfigSpace
+import numpy as np
+import numpy.typing as npt
+import pandas as pd
+
+
+class _ColumnSpec(NamedTuple):
+    """
+    Position and type of a single hyperparameter in the one-hot encoded array.
+    """
+
+    name: str
+    offset: int
+    choices: Optional[npt.NDArray]  # None for numeric hyperparameters
+    is_int: bool
+
+
+class OneHotEncoder:
+    """
+    Converts the configurations between pandas DataFrame and one-hot encoded numpy array.
+    The column offsets and the category lookup tables are computed once
+    for the given parameter space, and the whole DataFrame is converted
+    with vectorized numpy operations, one hyperparameter at a time.
+    """
+
+    def __init__(self, parameter_space: ConfigSpace.ConfigurationSpace):
+        """
+        Create a new encoder for the given parameter space.
+
+        Parameters
+        ----------
+        parameter_space : ConfigSpace.ConfigurationSpace
+            The parameter space of the configurations.
+            The encoded columns follow the order of its hyperparameters.
+        """
+        self._columns: List[_ColumnSpec] = []
+        offset = 0
+        for param in parameter_space.get_hyperparameters():
+            if isinstance(param, ConfigSpace.CategoricalHyperparameter):
+                choices = np.empty(len(param.choices), dtype=object)
+                choices[:] = param.choices
+                self._columns.append(_ColumnSpec(param.name, offset, choices, False))
+                offset += len(param.choices)
+            else:
+                self._columns.append(_ColumnSpec(
+                    param.name, offset, None,
+                    isinstance(param, ConfigSpace.UniformIntegerHyperparameter)))
+                offset += 1
+        self.n_cols = offset
+
+    def encode(self, config: pd.DataFrame) -> npt.NDArray:
+        """
+        Convert pandas DataFrame (or a single configuration as pandas Series)
+        to one-hot-encoded numpy array.
+        """
+        if config.ndim == 1:
+            config = config.to_frame().T
+        n_rows = config.shape[0]
+        rows = np.arange(n_rows)
+        one_hot = np.zeros((n_rows, self.n_cols), dtype=np.float32)
+        for col in self._columns:
+            values = config[col.name].to_numpy()
+            if col.choices is None:
+                one_hot[:, col.offset] = values
+            else:
+                codes = pd.Categorical(values, categories=col.choices).codes
+                if (codes < 0).any():
+                    raise ValueError(f"Invalid value(s) of {col.name}: {values[codes < 0]}")
+                one_hot[rows, col.offset + codes] = 1
+        return one_hot
+
+    def decode(self, one_hot: npt.NDArray) -> pd.DataFrame:
+        """
+        Convert numpy array from one-hot encoding to a DataFrame
+        with categoricals and ints in proper columns.
+        """
+        one_hot = np.asarray(one_hot)
+        df_dict = {}
+        for col in self._columns:
+            if col.choices is None:
+                values = one_hot[:, col.offset]
+                df_dict[col.name] = values.astype(int) if col.is_int else values
+            else:
+                block = one_hot[:, col.offset:col.offset + len(col.choices)]
+                df_dict[col.name] = col.choices[np.argmax(block, axis=1)]
+        return pd.DataFrame(df_dict)
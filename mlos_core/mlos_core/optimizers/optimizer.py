@@ -6,9 +6,10 @@
 Contains the BaseOptimizer abstract class.
 """
 
-import collections
+import json
 from abc import ABCMeta, abstractmethod
-from typing import List, Optional, Tuple
+from copy import deepcopy
+from typing import Any, Dict, List, Optional, Sequence, Tuple, Union
 
 import ConfigSpace
 import numpy as np
@@ -16,9 +17,18 @@ import numpy.typing as npt
 import pandas as pd
 
 from mlos_core import config_to_dataframe
+from mlos_core.optimizers.observations import ObservationStore
+from mlos_core.optimizers.one_hot import OneHotEncoder
 from mlos_core.spaces.adapters.adapter import BaseSpaceAdapter
 
 
+def _json_default(value: Any) -> Any:
+    """Convert the numpy scalars of the observations for the JSON checkpoint."""
+    if isinstance(value, np.generic):
+        return value.item()
+    raise TypeError(f"Cannot serialize {type(value)} in the checkpoint")
+
+
 class BaseOptimizer(metaclass=ABCMeta):
     """
     Optimizer abstract base class defining the basic interface.
@@ -26,7 +36,9 @@ class BaseOptimizer(metaclass=ABCMeta):
 
     def __init__(self, *,
                  parameter_space: ConfigSpace.ConfigurationSpace,
-                 space_adapter: Optional[BaseSpaceAdapter] = None):
+                 space_adapter: Optional[BaseSpaceAdapter] = None,
+                 context_space: Optional[ConfigSpace.ConfigurationSpace] = None,
+                 objectives: Optional[List[str]] = None):
         """
         Create a new instance of the base optimizer.
 
@@ -36,6 +48,16 @@ class BaseOptimizer(metaclass=ABCMeta):
             The parameter space to optimize.
         space_adapter : BaseSpaceAdapter
             The space adapter class to employ for parameter space transformations.
+        context_space : Optional[ConfigSpace.ConfigurationSpace]
+            The space of the context features (e.g., workload characteristics).
+            If specified, every `.register()` and `.suggest()` call must provide the context;
+            the optimizer then learns a single model over the (configuration, context) pairs
+            and suggests the configurations for the given context.
+        objectives : Optional[List[str]]
+            Names of the objectives (all minimized) for multi-objective optimization.
+            If specified, `.register()` takes a dataframe of scores with one column per objective.
+            The first objective is the primary one, e.g., for `.get_best_observation()`.
+            Default is a single objective, "score".
         """
         self.parameter_space: ConfigSpace.ConfigurationSpace = parameter_space
         self.optimizer_parameter_space: ConfigSpace.ConfigurationSpace = \
@@ -45,8 +67,28 @@ class BaseOptimizer(metaclass=ABCMeta):
             raise ValueError("Given parameter space differs from the one given to space adapter")
 
         self._space_adapter: Optional[BaseSpaceAdapter] = space_adapter
-        self._observations: List[Tuple[pd.DataFrame, pd.Series, Optional[pd.DataFrame]]] = []
+
+        self.context_space: Optional[ConfigSpace.ConfigurationSpace] = context_space
+        self._context_names: List[str] = [] if context_space is None else \
+            context_space.get_hyperparameter_names()
+        overlap = set(self._context_names).intersection(
+            parameter_space.get_hyperparameter_names() +
+            self.optimizer_parameter_space.get_hyperparameter_names())
+        if overlap:
+            raise ValueError(f"Context features must not be named as the parameters: {sorted(overlap)}")
+        self._model_space: Optional[ConfigSpace.ConfigurationSpace] = None
+
+        self._objectives: List[str] = list(objectives or ["score"])
+        if len(set(self._objectives)) != len(self._objectives):
+            raise ValueError(f"Duplicate objectives: {self._objectives}")
+        overlap = set(self._objectives).intersection(
+            parameter_space.get_hyperparameter_names() + self._context_names)
+        if overlap:
+            raise ValueError(f"Objectives must not be named as the parameters or context: {sorted(overlap)}")
+
+        self._observations = ObservationStore(objectives=self._objectives)
         self._pending_observations: List[Tuple[pd.DataFrame, Optional[pd.DataFrame]]] = []
+        self._encoder: Optional[OneHotEncoder] = None
 
     def __repr__(self) -> str:
         return f"{self.__class__.__name__}(parameter_space={self.parameter_space})"
@@ -56,65 +98,111 @@ class BaseOptimizer(metaclass=ABCMeta):
         """Get the space adapter instance (if any)."""
         return self._space_adapter
 
-    def register(self, configurations: pd.DataFrame, scores: pd.Series,
-                 context: Optional[pd.DataFrame] = None) -> None:
+    @property
+    def objectives(self) -> List[str]:
+        """Names of the objectives to minimize (the primary one first)."""
+        return list(self._objectives)
+
+    @property
+    def is_multi_objective(self) -> bool:
+        """True if the optimizer has more than one objective."""
+        return len(self._objectives) > 1
+
+    @property
+    def is_multi_fidelity(self) -> bool:
+        """True if the optimizer assigns the budgets to its suggestions (see `.get_budget()`)."""
+        return False
+
+    def register(self, configurations: pd.DataFrame, scores: Union[pd.Series, pd.DataFrame],
+                 context: Optional[pd.DataFrame] = None,
+                 budgets: Optional[Sequence[Optional[float]]] = None) -> None:
         """Wrapper method, which employs the space adapter (if any), before registering the configurations and scores.
 
         Parameters
         ----------
         configurations : pd.DataFrame
             Dataframe of configurations / parameters. The columns are parameter names and the rows are the configurations.
-        scores : pd.Series
+        scores : Union[pd.Series, pd.DataFrame]
             Scores from running the configurations. The index is the same as the index of the configurations.
+            For multi-objective optimizers, a dataframe with one column per objective.
 
         context : pd.DataFrame
-            Not Yet Implemented.
+            Context features of each configuration (one row per configuration).
+            Required if (and only if) the optimizer has a `context_space`.
+        budgets : Optional[Sequence[Optional[float]]]
+            Budget each configuration has been evaluated with (see `.get_budget()`).
+            Only used by the multi-fidelity optimizers; if omitted, they assume
+            the budget of the last suggestion of the same configuration.
         """
-        # TODO: Validate that if context is ever added it must always be added.
-        self._observations.append((configurations, scores, context))
-
+        context = self._check_context(context, len(configurations))
+        if budgets is not None and len(budgets) != len(configurations):
+            raise ValueError(f"Expected {len(configurations)} budgets, got {len(budgets)}")
+        self._observations.append(configurations, scores, context)
+
+        if isinstance(scores, pd.DataFrame):
+            scores = scores[self._objectives]
+            if not self.is_multi_objective:
+                scores = scores[self._objectives[0]]
         if self._space_adapter:
             configurations = self._space_adapter.inverse_transform(configurations)
-        return self._register(configurations, scores, context)
+        return self._register(configurations, scores, context, budgets)
 
     @abstractmethod
-    def _register(self, configurations: pd.DataFrame, scores: pd.Series,
-                  context: Optional[pd.DataFrame] = None) -> None:
+    def _register(self, configurations: pd.DataFrame, scores: Union[pd.Series, pd.DataFrame],
+                  context: Optional[pd.DataFrame] = None,
+                  budgets: Optional[Sequence[Optional[float]]] = None) -> None:
         """Registers the given configurations and scores.
 
         Parameters
         ----------
         configurations : pd.DataFrame
             Dataframe of configurations / parameters. The columns are parameter names and the rows are the configurations.
-        scores : pd.Series
+        scores : Union[pd.Series, pd.DataFrame]
             Scores from running the configurations. The index is the same as the index of the configurations.
+            A series for single-objective optimizers, and a dataframe with the `objectives`
+            as the columns (in that order) for the multi-objective ones.
 
         context : pd.DataFrame
-            Not Yet Implemented.
+            Context features of each configuration (validated by `.register()`), or None.
+        budgets : Optional[Sequence[Optional[float]]]
+            Budget of each configuration (validated by `.register()`), or None.
         """
         pass    # pylint: disable=unnecessary-pass # pragma: no cover
 
-    def suggest(self, context: Optional[pd.DataFrame] = None, defaults: bool = False) -> pd.DataFrame:
+    def suggest(self, context: Optional[pd.DataFrame] = None, defaults: bool = False,
+                n_suggestions: int = 1) -> pd.DataFrame:
         """
         Wrapper method, which employs the space adapter (if any), after suggesting a new configuration.
 
         Parameters
         ----------
         context : pd.DataFrame
-            Not Yet Implemented.
+            Context features (a single row) to suggest the configuration(s) for.
+            Required if (and only if) the optimizer has a `context_space`.
         defaults : bool
             Whether or not to return the default config instead of an optimizer guided one.
             By default, use the one from the optimizer.
+            If `n_suggestions > 1`, only the first suggestion is the default config.
+        n_suggestions : int
+            Number of configurations to suggest at once. Default is 1.
 
         Returns
         -------
         configuration : pd.DataFrame
-            Pandas dataframe with a single row. Column names are the parameter names.
+            Pandas dataframe with `n_suggestions` rows. Column names are the parameter names.
         """
+        if n_suggestions < 1:
+            raise ValueError(f"Number of suggestions must be positive: {n_suggestions}")
+        context = self._check_context(context, 1)
         if defaults:
             configuration = config_to_dataframe(self.parameter_space.get_default_configuration())
             if self.space_adapter is not None:
                 configuration = self.space_adapter.inverse_transform(configuration)
+            if n_suggestions > 1:
+                configuration = pd.concat([configuration, self._suggest_batch(n_suggestions - 1, context)],
+                                          ignore_index=True)
+        elif n_suggestions > 1:
+            configuration = self._suggest_batch(n_suggestions, context)
         else:
             configuration = self._suggest(context)
         if self._space_adapter:
@@ -128,7 +216,7 @@ class BaseOptimizer(metaclass=ABCMeta):
         Parameters
         ----------
         context : pd.DataFrame
-            Not Yet Implemented.
+            Context features (a single row, validated by `.suggest()`), or None.
 
         Returns
         -------
@@ -137,6 +225,105 @@ class BaseOptimizer(metaclass=ABCMeta):
         """
         pass    # pylint: disable=unnecessary-pass # pragma: no cover
 
+    def _suggest_batch(self, n_suggestions: int, context: Optional[pd.DataFrame] = None) -> pd.DataFrame:
+        """Suggests several new configurations at once.
+
+        Base implementation just calls `._suggest()` repeatedly. Optimizers should override it
+        if they need to keep the suggestions in the batch diverse or can amortize the cost
+        of the model updates across the batch.
+
+        Parameters
+        ----------
+        n_suggestions : int
+            Number of configurations to suggest.
+        context : pd.DataFrame
+            Context features (a single row, validated by `.suggest()`), or None.
+
+        Returns
+        -------
+        configurations : pd.DataFrame
+            Pandas dataframe with `n_suggestions` rows. Column names are the parameter names.
+        """
+        return pd.concat([self._suggest(context) for _ in range(n_suggestions)], ignore_index=True)
+
+    def get_budget(self, configuration: pd.DataFrame) -> Optional[float]:
+        """Wrapper method, which employs the space adapter (if any), before looking up
+        the budget (i.e., fidelity) the optimizer has assigned to the suggested configuration.
+
+        Parameters
+        ----------
+        configuration : pd.DataFrame
+            Pandas dataframe with a single row, as returned by `.suggest()`.
+
+        Returns
+        -------
+        budget : Optional[float]
+            The budget to evaluate the configuration with (e.g., benchmark duration),
+            or None if the optimizer is not multi-fidelity.
+        """
+        if not self.is_multi_fidelity:
+            return None
+        if self._space_adapter:
+            configuration = self._space_adapter.inverse_transform(configuration)
+        return self._get_budget(configuration)
+
+    def _get_budget(self, configuration: pd.DataFrame) -> Optional[float]:
+        """Get the budget assigned to the suggested configuration.
+        Base implementation is single-fidelity, i.e., always returns None.
+
+        Parameters
+        ----------
+        configuration : pd.DataFrame
+            Pandas dataframe with a single row. Column names are the parameter names.
+
+        Returns
+        -------
+        budget : Optional[float]
+            The budget to evaluate the configuration with, or None.
+        """
+        # pylint: disable=unused-argument
+        return None
+
+    def register_failed(self, configurations: pd.DataFrame,
+                        context: Optional[pd.DataFrame] = None,
+                        budgets: Optional[Sequence[Optional[float]]] = None) -> None:
+        """Registers the given configurations as failed, i.e., evaluated without any scores
+        (e.g., the benchmark has crashed). The failed trials are not kept as observations.
+
+        Parameters
+        ----------
+        configurations : pd.DataFrame
+            Dataframe of configurations / parameters. The columns are parameter names and the rows are the configurations.
+        context : pd.DataFrame
+            Context features of each configuration (one row per configuration).
+            Required if (and only if) the optimizer has a `context_space`.
+        budgets : Optional[Sequence[Optional[float]]]
+            Budget each configuration has been evaluated with (see `.get_budget()`).
+        """
+        context = self._check_context(context, len(configurations))
+        if budgets is not None and len(budgets) != len(configurations):
+            raise ValueError(f"Expected {len(configurations)} budgets, got {len(budgets)}")
+        if self._space_adapter:
+            configurations = self._space_adapter.inverse_transform(configurations)
+        self._register_failed(configurations, context, budgets)
+
+    def _register_failed(self, configurations: pd.DataFrame,
+                         context: Optional[pd.DataFrame] = None,
+                         budgets: Optional[Sequence[Optional[float]]] = None) -> None:
+        """Registers the given configurations as failed.
+        Base implementation does nothing, i.e., the optimizer does not learn from the failures.
+
+        Parameters
+        ----------
+        configurations : pd.DataFrame
+            Dataframe of configurations / parameters, in the optimizer's parameter space.
+        context : pd.DataFrame
+            Context features of each configuration, if the optimizer has a `context_space`.
+        budgets : Optional[Sequence[Optional[float]]]
+            Budget each configuration has been evaluated with (multi-fidelity mode only).
+        """
+        # pylint: disable=unused-argument
+
     @abstractmethod
     def register_pending(self, configurations: pd.DataFrame,
                          context: Optional[pd.DataFrame] = None) -> None:
@@ -159,22 +346,13 @@ class BaseOptimizer(metaclass=ABCMeta):
         Returns
         -------
         observations : pd.DataFrame
-            Dataframe of observations. The columns are parameter names and "score" for the score, each row is an observation.
+            Dataframe of observations. The columns are parameter names, then the context features
+            (if the optimizer has a `context_space`), and the `objectives` ("score" by default)
+            for the scores, each row is an observation.
         """
         if len(self._observations) == 0:
             raise ValueError("No observations registered yet.")
-        configs = pd.concat([config for config, _, _ in self._observations])
-        scores = pd.concat([score for _, score, _ in self._observations])
-        try:
-            contexts = pd.concat([context for _, _, context in self._observations if context is not None])
-        except ValueError:
-            contexts = None
-        configs["score"] = scores
-        if contexts is not None:
-            # configs = pd.concat([configs, contexts], axis=1)
-            # Not reachable for now
-            raise NotImplementedError()  # pragma: no cover
-        return configs
+        return self._observations.to_dataframe()
 
     def get_best_observation(self) -> pd.DataFrame:
         """Returns the best observation so far as a dataframe.
@@ -183,65 +361,246 @@ class BaseOptimizer(metaclass=ABCMeta):
         -------
         best_observation : pd.DataFrame
             Dataframe with a single row containing the best observation. The columns are parameter names and "score" for the score.
+            For multi-objective optimizers, the best observation is the one with the best primary objective
+            (the first one), and the columns include all the `objectives`; see also `.get_pareto_front()`.
         """
         if len(self._observations) == 0:
             raise ValueError("No observations registered yet.")
-        observations = self.get_observations()
-        return observations.nsmallest(1, columns='score')
+        return self._observations.best()
+
+    def get_pareto_front(self) -> pd.DataFrame:
+        """Returns the Pareto front, i.e., the observations that are not dominated by any other
+        observation on all `objectives`. For a single objective, that is the best observation(s).
+
+        Returns
+        -------
+        pareto_front : pd.DataFrame
+            Dataframe with one row per non-dominated observation, in the order of registration.
+            The columns are parameter names and the `objectives`.
+        """
+        if len(self._observations) == 0:
+            raise ValueError("No observations registered yet.")
+        return self._observations.pareto_front()
+
+    def checkpoint(self) -> bytes:
+        """Take a snapshot of the optimizer state: the observations and the state
+        of the underlying optimizer, so that a new instance of the same optimizer can
+        resume from it via `.restore()` instead of re-registering all the history.
+        The pending configurations are not included.
+
+        Returns
+        -------
+        checkpoint : bytes
+            The state serialized as JSON (data only, so restoring it never runs any code).
+        """
+        context = self._context_names if self._observations.has_context else []
+        return json.dumps({
+            "class": self.__class__.__name__,
+            "parameters": self.optimizer_parameter_space.get_hyperparameter_names(),
+            "objectives": self._objectives,
+            "context": context,
+            "observations": self._observations.to_dataframe().to_dict(orient="list"),
+            "backend": self._get_backend_state(),
+        }, default=_json_default).encode("utf-8")
+
+    def restore(self, checkpoint: bytes) -> None:
+        """Resume the optimization from a snapshot taken by `.checkpoint()`
+        of an optimizer of the same class and parameter space (and objectives).
+        Must be called before registering any observations.
+
+        Parameters
+        ----------
+        checkpoint : bytes
+            The state returned by `.checkpoint()`.
+
+        Raises
+        ------
+        ValueError
+            If the checkpoint is invalid or incompatible with the optimizer.
+        """
+        if len(self._observations) > 0:
+            raise ValueError("Cannot restore the optimizer that already has observations.")
+        try:
+            state: Dict[str, Any] = json.loads(checkpoint)
+        except ValueError as ex:    # Includes JSONDecodeError and UnicodeDecodeError.
+            raise ValueError(f"Invalid checkpoint: {ex}") from ex
+        if not isinstance(state, dict):
+            raise ValueError(f"Invalid checkpoint: {type(state)}")
+        expected = {
+            "class": self.__class__.__name__,
+            "parameters": self.optimizer_parameter_space.get_hyperparameter_names(),
+            "objectives": self._objectives,
+        }
+        mismatch = {key: state.get(key) for (key, val) in expected.items() if state.get(key) != val}
+        if mismatch:
+            raise ValueError(f"Incompatible checkpoint: {mismatch} expected: {expected}")
+        missing = {"context", "observations", "backend"}.difference(state)
+        if missing:
+            raise ValueError(f"Invalid checkpoint: missing {sorted(missing)}")
+        try:
+            observations = pd.DataFrame(state["observations"])
+            if len(observations) > 0:
+                context: List[str] = state["context"]
+                self._observations.append(
+                    observations.drop(columns=self._objectives + context),
+                    observations[self._objectives],
+                    observations[context] if context else None,
+                )
+            self._set_backend_state(state["backend"])
+        except Exception:
+            # Leave the optimizer empty, so the caller can register the history instead.
+            self._observations = ObservationStore(objectives=self._objectives)
+            raise
+
+    def _get_backend_state(self) -> Any:
+        """Get the state of the underlying optimizer to include in the checkpoint.
+        Must be JSON-serializable.
+        Base implementation returns None, i.e., the observations are enough to rebuild it.
+        """
+        return None
+
+    def _set_backend_state(self, state: Any) -> None:
+        """Restore the state of the underlying optimizer from the checkpoint,
+        once the observations have been restored.
+
+        Base implementation re-registers all observations with the underlying optimizer
+        at once; that is still much cheaper than loading them from the storage and
+        registering them one by one. Optimizers should override it if they can restore
+        their internal state directly.
+
+        Parameters
+        ----------
+        state : Any
+            The value returned by `._get_backend_state()`.
+        """
+        # pylint: disable=unused-argument
+        if len(self._observations) == 0:
+            return
+        observations = self._observations.to_dataframe()
+        configurations = observations[self.parameter_space.get_hyperparameter_names()]
+        scores: Union[pd.Series, pd.DataFrame] = observations[self._objectives]
+        if not self.is_multi_objective:
+            scores = observations[self._objectives[0]]
+        context = observations[self._context_names] if self._context_names else None
+        if self._space_adapter:
+            configurations = self._space_adapter.inverse_transform(configurations)
+        self._register(configurations, scores, context)
 
     def cleanup(self) -> None:
         """Cleanup the optimizer."""
         pass    # pylint: disable=unnecessary-pass # pragma: no cover
 
+    def _check_context(self, context: Optional[pd.DataFrame], n_rows: int) -> Optional[pd.DataFrame]:
+        """
+        Make sure the context is provided if and only if the optimizer has a `context_space`,
+        and has one row per configuration (or a single row to apply to all of them).
+
+        Returns
+        -------
+        context : Optional[pd.DataFrame]
+            Context features in the order of the `context_space`, with the default index
+            and `n_rows` rows.
+        """
+        if self.context_space is None:
+            if context is not None:
+                raise ValueError("Context is not expected: the optimizer has no context_space")
+            return None
+        if context is None:
+            raise ValueError(f"Context is required: {self._context_names}")
+        missing = set(self._context_names).difference(context.columns)
+        if missing:
+            raise ValueError(f"Context features missing: {sorted(missing)}")
+        if len(context) not in {1, n_rows}:
+            raise ValueError(f"Got {len(context)} context rows for {n_rows} configurations")
+        context = context[self._context_names].reset_index(drop=True)
+        if len(context) != n_rows:
+            context = context.loc[[0] * n_rows].reset_index(drop=True)
+        return context
+
+    @property
+    def _model_parameter_space(self) -> ConfigSpace.ConfigurationSpace:
+        """
+        The space the underlying model is defined on: the `optimizer_parameter_space`,
+        extended with the context features if the optimizer has a `context_space`.
+        """
+        if self.context_space is None:
+            return self.optimizer_parameter_space
+        if self._model_space is None:
+            space = deepcopy(self.optimizer_parameter_space)
+            space.add_hyperparameters(deepcopy(self.context_space.get_hyperparameters()))
+            self._model_space = space
+        return self._model_space
+
+    def _with_context(self, configurations: pd.DataFrame,
+                      context: Optional[pd.DataFrame]) -> pd.DataFrame:
+        """
+        Append the context features (if any) as extra columns to the configurations.
+        A single row of context is applied to all configurations.
+        """
+        if context is None:
+            return configurations
+        if len(context) == 1 and len(configurations) != 1:
+            context = context.loc[[0] * len(configurations)]
+        return pd.concat([configurations.reset_index(drop=True),
+                          context.reset_index(drop=True)], axis=1)
+
+    def _context_distances(self, contexts: pd.DataFrame, context: pd.DataFrame) -> npt.NDArray:
+        """
+        Compute the distance of each row of `contexts` to the (single row) `context`.
+        Numeric features are scaled by their range in the `context_space`,
+        and any mismatch of a categorical feature counts as distance 1.
+        """
+        assert self.context_space is not None
+        dist = np.zeros(len(contexts))
+        for param in self.context_space.get_hyperparameters():
+            values = contexts[param.name].to_numpy()
+            target = context[param.name].iloc[0]
+            if isinstance(param, (ConfigSpace.UniformFloatHyperparameter, ConfigSpace.UniformIntegerHyperparameter)):
+                span = float(param.upper - param.lower) or 1.0
+                dist += ((values.astype(float) - float(target)) / span) ** 2
+            else:
+                dist += (values != target)
+        return np.sqrt(dist)
+
+    def _best_configs_for_context(self, context: pd.DataFrame, n_configs: int) -> pd.DataFrame:
+        """
+        Get the best observed configurations of the most similar contexts,
+        i.e., ordered by the distance of the context first, and then by score
+        (of the primary objective).
+        This is how the knowledge is transferred to a new context.
+
+        Returns
+        -------
+        configurations : pd.DataFrame
+            Up to `n_configs` configurations in the `optimizer_parameter_space`.
+        """
+        if len(self._observations) == 0:
+            return pd.DataFrame(columns=self.optimizer_parameter_space.get_hyperparameter_names())
+        observations = self._observations.to_dataframe()
+        dist = self._context_distances(observations[self._context_names], context)
+        scores = observations[self._objectives[0]].to_numpy(dtype=float)
+        order = [i for i in np.lexsort((scores, dist)) if not np.isnan(scores[i])][:n_configs]
+        configs = observations.iloc[order].drop(columns=self._context_names + self._objectives)
+        if self._space_adapter is not None:
+            configs = self._space_adapter.inverse_transform(configs)
+        return configs.reset_index(drop=True)
+
+    @property
+    def _one_hot_encoder(self) -> OneHotEncoder:
+        """One-hot encoder for the `_model_parameter_space` (created upon first access)."""
+        if self._encoder is None:
+            self._encoder = OneHotEncoder(self._model_parameter_space)
+        return self._encoder
+
     def _from_1hot(self, config: npt.NDArray) -> pd.DataFrame:
         """
         Convert numpy array from one-hot encoding to a DataFrame
         with categoricals and ints in proper columns.
         """
-        df_dict = collections.defaultdict(list)
-        for i in range(config.shape[0]):
-            j = 0
-            for param in self.optimizer_parameter_space.get_hyperparameters():
-                if isinstance(param, ConfigSpace.CategoricalHyperparameter):
-                    for (offset, val) in enumerate(param.choices):
-                        if config[i][j + offset] == 1:
-                            df_dict[param.name].append(val)
-                            break
-                    j += len(param.choices)
-                else:
-                    val = config[i][j]
-                    if isinstance(param, ConfigSpace.UniformIntegerHyperparameter):
-                        val = int(val)
-                    df_dict[param.name].append(val)
-                    j += 1
-        return pd.DataFrame(df_dict)
+        return self._one_hot_encoder.decode(config)
 
     def _to_1hot(self, config: pd.DataFrame) -> npt.NDArray:
         """
         Convert pandas DataFrame to one-hot-encoded numpy array.
         """
-        n_cols = 0
-        n_rows = config.shape[0] if config.ndim > 1 else 1
-        for param in self.optimizer_parameter_space.get_hyperparameters():
-            if isinstance(param, ConfigSpace.CategoricalHyperparameter):
-                n_cols += len(param.choices)
-            else:
-                n_cols += 1
-        one_hot = np.zeros((n_rows, n_cols), dtype=np.float32)
-        for i in range(n_rows):
-            j = 0
-            for param in self.optimizer_parameter_space.get_hyperparameters():
-                if config.ndim > 1:
-                    col = config.columns.get_loc(param.name)
-                    val = config.iloc[i, col]
-                else:
-                    col = config.index.get_loc(param.name)
-                    val = config.iloc[col]
-                if isinstance(param, ConfigSpace.CategoricalHyperparameter):
-                    offset = param.choices.index(val)
-                    one_hot[i][j + offset] = 1
-                    j += len(param.choices)
-                else:
-                    one_hot[i][j] = val
-                    j += 1
-        return one_hot
+        return self._one_hot_encoder.encode(config)
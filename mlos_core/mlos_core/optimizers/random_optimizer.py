@@ -6,7 +6,7 @@
 Contains the RandomOptimizer class.
 """
 
-from typing import Optional
+from typing import Optional, Sequence, Union
 
 import pandas as pd
 
@@ -21,10 +21,15 @@ class RandomOptimizer(BaseOptimizer):
     ----------
     parameter_space : ConfigSpace.ConfigurationSpace
         The parameter space to optimize.
+
+    objectives : Optional[List[str]]
+        Names of the objectives. Random sampling ignores the scores,
+        so any number of objectives is supported.
     """
 
-    def _register(self, configurations: pd.DataFrame, scores: pd.Series,
-                  context: Optional[pd.DataFrame] = None) -> None:
+    def _register(self, configurations: pd.DataFrame, scores: Union[pd.Series, pd.DataFrame],
+                  context: Optional[pd.DataFrame] = None,
+                  budgets: Optional[Sequence[Optional[float]]] = None) -> None:
         """Registers the given configurations and scores.
 
         Doesn't do anything on the RandomOptimizer except storing configurations for logging.
@@ -34,14 +39,17 @@ class RandomOptimizer(BaseOptimizer):
         configurations : pd.DataFrame
             Dataframe of configurations / parameters. The columns are parameter names and the rows are the configurations.
 
-        scores : pd.Series
+        scores : Union[pd.Series, pd.DataFrame]
             Scores from running the configurations. The index is the same as the index of the configurations.
+            A dataframe with one column per objective for multi-objective optimization.
+
+        context : pd.DataFrame
+            Ignored: the context is only kept with the observations.
 
-        context : None
-            Not Yet Implemented.
+        budgets : Optional[Sequence[Optional[float]]]
+            Ignored: the optimizer is single-fidelity.
         """
-        if context is not None:
-            raise NotImplementedError()
+        # pylint: disable=unused-argument
         # should we pop them from self.pending_observations?
 
     def _suggest(self, context: Optional[pd.DataFrame] = None) -> pd.DataFrame:
@@ -51,19 +59,41 @@ class RandomOptimizer(BaseOptimizer):
 
         Parameters
         ----------
-        context : None
-            Not Yet Implemented.
+        context : pd.DataFrame
+            Ignored: random sampling does not depend on the context.
 
         Returns
         -------
         configuration : pd.DataFrame
             Pandas dataframe with a single row. Column names are the parameter names.
         """
-        if context is not None:
-            # not sure how that works here?
-            raise NotImplementedError()
+        # pylint: disable=unused-argument
         return pd.DataFrame(self.optimizer_parameter_space.sample_configuration().get_dictionary(), index=[0])
 
+    def _suggest_batch(self, n_suggestions: int, context: Optional[pd.DataFrame] = None) -> pd.DataFrame:
+        """Suggests several new configurations at once.
+
+        Sampled at random using ConfigSpace.
+
+        Parameters
+        ----------
+        n_suggestions : int
+            Number of configurations to suggest.
+        context : pd.DataFrame
+            Ignored: random sampling does not depend on the context.
+
+        Returns
+        -------
+        configurations : pd.DataFrame
+            Pandas dataframe with `n_suggestions` rows. Column names are the parameter names.
+        """
+        # pylint: disable=unused-argument
+        configs = self.optimizer_parameter_space.sample_configuration(size=n_suggestions)
+        if n_suggestions == 1:
+            configs = [configs]
+        return pd.DataFrame([config.get_dictionary() for config in configs],
+                            columns=self.optimizer_parameter_space.get_hyperparameter_names())
+
     def register_pending(self, configurations: pd.DataFrame,
                          context: Optional[pd.DataFrame] = None) -> None:
         raise NotImplementedError()
@@ -50,18 +50,18 @@ class BaseSpaceAdapter(metaclass=ABCMeta):
 
     @abstractmethod
     def transform(self, configuration: pd.DataFrame) -> pd.DataFrame:
-        """Translates a configuration, which belongs to the target parameter space, to the original parameter space.
+        """Translates configurations, which belong to the target parameter space, to the original parameter space.
         This method is called by the `suggest` method of the `BaseOptimizer` class.
 
         Parameters
         ----------
         configuration : pd.DataFrame
-            Pandas dataframe with a single row. Column names are the parameter names of the target parameter space.
+            Pandas dataframe with one or more rows. Column names are the parameter names of the target parameter space.
 
         Returns
         -------
         configuration : pd.DataFrame
-            Pandas dataframe with a single row, containing the translated configuration.
+            Pandas dataframe with the same number of rows, containing the translated configurations.
             Column names are the parameter names of the original parameter space.
         """
         pass    # pylint: disable=unnecessary-pass # pragma: no cover
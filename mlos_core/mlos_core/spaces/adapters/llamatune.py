@@ -12,7 +12,6 @@ import ConfigSpace
 import numpy as np
 import numpy.typing as npt
 import pandas as pd
-from sklearn.preprocessing import MinMaxScaler
 from mlos_core.spaces.adapters.adapter import BaseSpaceAdapter
 
 
@@ -65,6 +64,8 @@ class LlamaTuneAdapter(BaseSpaceAdapter):   # pylint: disable=too-many-instance-
         self._construct_low_dim_space(num_low_dims, max_unique_values_per_param)
 
         # Initialize config values scaler: from (-1, 1) to (0, 1) range
+        # Import scikit-learn only when the adapter is used: it is slow to load.
+        from sklearn.preprocessing import MinMaxScaler  # pylint: disable=import-outside-toplevel
         config_scaler = MinMaxScaler(feature_range=(0, 1))
         ones_vector = np.ones(len(self.orig_parameter_space.get_hyperparameters()))
         config_scaler.fit([-ones_vector, ones_vector])
@@ -87,6 +88,8 @@ class LlamaTuneAdapter(BaseSpaceAdapter):   # pylint: disable=too-many-instance-
 
     def inverse_transform(self, configurations: pd.DataFrame) -> pd.DataFrame:
         target_configurations = []
+        unseen_idx = []
+        unseen_vectors = []
         for (_, config) in configurations.iterrows():
             configuration = ConfigSpace.Configuration(self.orig_parameter_space, values=config.to_dict())
 
@@ -103,36 +106,37 @@ class LlamaTuneAdapter(BaseSpaceAdapter):   # pylint: disable=too-many-instance-
                     raise ValueError(f"{repr(configuration)}\n" "The above configuration was not suggested by the optimizer. "
                                      "Approximate reverse mapping is currently disabled; thus *only* configurations suggested "
                                      "previously by the optimizer can be registered.")
-
-                # ...yet, we try to support that by implementing an approximate reverse mapping using pseudo-inverse matrix.
-                if getattr(self, '_pinv_matrix', None) is None:
-                    self._try_generate_approx_inverse_mapping()
-
-                # Perform approximate reverse mapping
-                # NOTE: applying special value biasing is not possible
-                vector = self._config_scaler.inverse_transform([configuration.get_array()])[0]
-                target_config_vector = self._pinv_matrix.dot(vector)
-                target_config = ConfigSpace.Configuration(self.target_parameter_space, vector=target_config_vector)
+                # ...yet, we try to support that by implementing an approximate reverse mapping (see below).
+                unseen_idx.append(len(target_configurations))
+                unseen_vectors.append(configuration.get_array())
 
             target_configurations.append(target_config)
 
+        if unseen_vectors:
+            # Perform approximate reverse mapping using pseudo-inverse matrix, for all unseen configs at once.
+            # NOTE: applying special value biasing is not possible
+            if getattr(self, '_pinv_matrix', None) is None:
+                self._try_generate_approx_inverse_mapping()
+            vectors = self._config_scaler.inverse_transform(np.array(unseen_vectors))
+            target_config_vectors = vectors.dot(self._pinv_matrix.T)
+            for (idx, target_config_vector) in zip(unseen_idx, target_config_vectors):
+                target_configurations[idx] = ConfigSpace.Configuration(
+                    self.target_parameter_space, vector=target_config_vector)
+
         return pd.DataFrame(target_configurations, columns=self.target_parameter_space.get_hyperparameter_names())
 
     def transform(self, configuration: pd.DataFrame) -> pd.DataFrame:
-        if len(configuration) != 1:
-            raise ValueError("Configuration dataframe must contain exactly 1 row. "
-                             f"Found {len(configuration)} rows.")
-
-        target_values_dict = configuration.iloc[0].to_dict()
-        target_configuration = ConfigSpace.Configuration(self.target_parameter_space, values=target_values_dict)
-
-        orig_values_dict = self._transform(target_values_dict)
-        orig_configuration = ConfigSpace.Configuration(self.orig_parameter_space, values=orig_values_dict)
+        target_names = self.target_parameter_space.get_hyperparameter_names()
+        orig_configurations = self._transform(configuration[target_names].to_numpy(dtype=float))
 
         # Add to inverse dictionary -- needed for registering the performance later
-        self._suggested_configs[orig_configuration] = target_configuration
+        for (target_values_dict, orig_values_dict) in zip(configuration[target_names].to_dict(orient='records'),
+                                                          orig_configurations.to_dict(orient='records')):
+            target_configuration = ConfigSpace.Configuration(self.target_parameter_space, values=target_values_dict)
+            orig_configuration = ConfigSpace.Configuration(self.orig_parameter_space, values=orig_values_dict)
+            self._suggested_configs[orig_configuration] = target_configuration
 
-        return pd.DataFrame([orig_values_dict.values()], columns=self.orig_parameter_space.get_hyperparameter_names())
+        return orig_configurations
 
     def _construct_low_dim_space(self, num_low_dims: int, max_unique_values_per_param: Optional[int]) -> None:
         """Constructs the low-dimensional parameter (potentially discretized) search space.
@@ -163,6 +167,7 @@ class LlamaTuneAdapter(BaseSpaceAdapter):   # pylint: disable=too-many-instance-
             ]
 
             # Initialize quantized values scaler: from [0, max_unique_values_per_param] to (-1, 1) range
+            from sklearn.preprocessing import MinMaxScaler  # pylint: disable=import-outside-toplevel
             q_scaler = MinMaxScaler(feature_range=(-1, 1))
             ones_vector = np.ones(num_low_dims)
             max_value_vector = ones_vector * max_unique_values_per_param
@@ -176,91 +181,97 @@ class LlamaTuneAdapter(BaseSpaceAdapter):   # pylint: disable=too-many-instance-
         config_space.add_hyperparameters(hyperparameters)
         self._target_config_space = config_space
 
-    def _transform(self, configuration: dict) -> dict:
-        """Projects a low-dimensional point (configuration) to the high-dimensional original parameter space,
+    def _transform(self, configurations: npt.NDArray) -> pd.DataFrame:
+        """Projects low-dimensional points (configurations) to the high-dimensional original parameter space,
         and then biases the resulting parameter values towards their special value(s) (if any).
+        All points are projected at once using vectorized numpy operations.
 
         Parameters
         ----------
-        configuration : dict
-            Configuration in the low-dimensional space.
+        configurations : npt.NDArray
+            Matrix of (n_configs x num_low_dims) configurations in the low-dimensional space.
 
         Returns
         -------
-        configuration : dict
-            Projected configuration in the high-dimensional original search space.
+        configurations : pd.DataFrame
+            Projected configurations in the high-dimensional original search space.
+            Column names are the parameter names of the original parameter space.
         """
-        original_parameters = self.orig_parameter_space.get_hyperparameters()
-        low_dim_config_values = list(configuration.values())
+        low_dim_config_values = configurations
 
         if self._q_scaler is not None:
             # Scale parameter values from [1, max_value] to [-1, 1]
-            low_dim_config_values = self._q_scaler.transform([low_dim_config_values])[0]
+            low_dim_config_values = self._q_scaler.transform(low_dim_config_values)
 
-        # Project low-dim point to original parameter space
-        original_config_values = [
-            self._sigma_vector[idx] * low_dim_config_values[self._h_matrix[idx]]
-            for idx in range(len(original_parameters))
-        ]
+        # Project low-dim points to original parameter space: gather the columns and flip the signs
+        original_config_values = low_dim_config_values[:, self._h_matrix] * self._sigma_vector
         # Scale parameter values to [0, 1]
-        original_config_values = self._config_scaler.transform([original_config_values])[0]
+        original_config_values = self._config_scaler.transform(original_config_values)
+        # Clip value to force it to fall in [0, 1]
+        # NOTE: HeSBO projection ensures that theoretically but due to
+        #       floating point ops nuances this is not always guaranteed
+        original_config_values = np.clip(original_config_values, 0., 1.)
 
         original_config = {}
-        for param, norm_value in zip(original_parameters, original_config_values):
-            # Clip value to force it to fall in [0, 1]
-            # NOTE: HeSBO projection ensures that theoretically but due to
-            #       floating point ops nuances this is not always guaranteed
-            value = max(0., min(1., norm_value))    # pylint: disable=redefined-loop-name
+        for (idx, param) in enumerate(self.orig_parameter_space.get_hyperparameters()):
+            values = original_config_values[:, idx]
 
             if isinstance(param, ConfigSpace.CategoricalHyperparameter):
-                index = int(value * len(param.choices))     # truncate integer part
-                index = max(0, min(len(param.choices) - 1, index))
+                index = (values * len(param.choices)).astype(int)   # truncate integer part
+                index = np.clip(index, 0, len(param.choices) - 1)
                 # NOTE: potential rounding here would be unfair to first & last values
-                orig_value = param.choices[index]
+                choices = np.empty(len(param.choices), dtype=object)
+                choices[:] = param.choices
+                orig_values = choices[index]
             elif isinstance(param, ConfigSpace.hyperparameters.NumericalHyperparameter):
                 if param.name in self._special_param_values_dict:
-                    value = self._special_param_value_scaler(param, value)
+                    values = self._special_param_value_scaler(param, values)
 
-                orig_value = param._transform(value)    # pylint: disable=protected-access
-                orig_value = max(param.lower, min(param.upper, orig_value))
+                orig_values = param._transform(values)    # pylint: disable=protected-access
+                orig_values = np.clip(orig_values, param.lower, param.upper)
+                if isinstance(param, ConfigSpace.UniformIntegerHyperparameter):
+                    orig_values = orig_values.astype(int)
             else:
                 raise NotImplementedError("Only Categorical, Integer, and Float hyperparameters are currently supported.")
 
-            original_config[param.name] = orig_value
+            original_config[param.name] = orig_values
 
-        return original_config
+        return pd.DataFrame(original_config, columns=self.orig_parameter_space.get_hyperparameter_names())
 
-    def _special_param_value_scaler(self, param: ConfigSpace.UniformIntegerHyperparameter, input_value: float) -> float:
-        """Biases the special value(s) of this parameter, by shifting the normalized `input_value` towards those.
+    def _special_param_value_scaler(self, param: ConfigSpace.UniformIntegerHyperparameter,
+                                    input_values: npt.NDArray) -> npt.NDArray:
+        """Biases the special value(s) of this parameter, by shifting the normalized `input_values` towards those.
 
         Parameters
         ----------
         param: ConfigSpace.UniformIntegerHyperparameter
             Parameter of the original parameter space.
 
-        input_value: float
-            Normalized value for this parameter, as suggested by the underlying optimizer.
+        input_values: npt.NDArray
+            Normalized values for this parameter, as suggested by the underlying optimizer.
 
         Returns
         -------
-        biased_value: float
-            Normalized value after special value(s) biasing is applied.
+        biased_values: npt.NDArray
+            Normalized values after special value(s) biasing is applied.
         """
         special_values_list = self._special_param_values_dict[param.name]
-
-        # Check if input value corresponds to some special value
-        perc_sum = 0.
-        ret: float
-        for special_value, biasing_perc in special_values_list:
-            perc_sum += biasing_perc
-            if input_value < perc_sum:
-                ret = param._inverse_transform(special_value)  # pylint: disable=protected-access
-                return ret
+        special_values = np.array([
+            param._inverse_transform(special_value)     # pylint: disable=protected-access
+            for (special_value, _) in special_values_list
+        ], dtype=float)
+        perc_sums = np.cumsum([biasing_perc for (_, biasing_perc) in special_values_list])
+        perc_sum = perc_sums[-1]
+
+        # Check if input value corresponds to some special value:
+        # i.e., find the first cumulative biasing percentage that is greater than the input value.
+        special_idx = np.searchsorted(perc_sums, input_values, side='right')
+        is_special = special_idx < len(special_values_list)
 
         # Scale input value uniformly to non-special values
-        ret = param._inverse_transform(                                         # pylint: disable=protected-access
-            param._transform_scalar((input_value - perc_sum) / (1 - perc_sum)))  # pylint: disable=protected-access
-        return ret
+        ret: npt.NDArray = param._inverse_transform(    # pylint: disable=protected-access
+            param._transform(np.clip((input_values - perc_sum) / (1 - perc_sum), 0., 1.)))  # pylint: disable=protected-access
+        return np.where(is_special, special_values[np.minimum(special_idx, len(special_values) - 1)], ret)
 
     # pylint: disable=too-complex,too-many-branches
     def _validate_special_param_values(self, special_param_values_dict: dict) -> None:
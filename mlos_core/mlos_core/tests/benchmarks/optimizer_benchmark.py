@@ -0,0 +1,353 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Benchmark of the overhead of the mlos_core optimizers.
+
+Measures the latency of the `.suggest()` and `.register()` calls and the peak RSS
+of each optimizer type and space adapter on synthetic objectives, for a varying
+number of observations, dimensions, and share of categorical parameters.
+Each case runs in a fresh process, so the peak RSS is not polluted by the other cases.
+
+The results can be compared to the stored baselines to catch the regressions, e.g.:
+
+    python -m mlos_core.tests.benchmarks.optimizer_benchmark --optimizers smac --check
+    python -m mlos_core.tests.benchmarks.optimizer_benchmark --optimizers smac --update-baseline
+"""
+
+import argparse
+import itertools
+import json
+import logging
+import os
+import sys
+import time
+
+from concurrent.futures import ProcessPoolExecutor
+from dataclasses import dataclass
+from multiprocessing import get_context
+from typing import Dict, Iterable, List, Optional, Sequence
+
+import ConfigSpace as CS
+import numpy as np
+import pandas as pd
+
+from mlos_core.optimizers import OptimizerFactory, OptimizerType
+from mlos_core.spaces.adapters import SpaceAdapterType
+from mlos_core.spaces.adapters.llamatune import LlamaTuneAdapter
+
+_LOG = logging.getLogger(__name__)
+
+DEFAULT_BASELINE_FILE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "optimizer_baselines.json")
+"""The baselines recorded with `--update-baseline` (the cases without one are skipped by `--check`)."""
+
+PERCENTILES = (50, 90, 99)
+
+# Baseline comparison: a metric regresses if it grows by more than the (relative) tolerance
+# *and* by more than the absolute slack (to ignore the noise of the sub-millisecond calls).
+DEFAULT_TOLERANCE = 1.5
+_LATENCY_SLACK_SEC = 0.005
+_RSS_SLACK_MB = 50.0
+
+
+@dataclass(frozen=True)
+class BenchmarkCase:
+    """
+    A single benchmark configuration.
+    """
+
+    optimizer_type: OptimizerType
+    space_adapter_type: SpaceAdapterType
+    n_dims: int
+    categorical_share: float
+    n_obs: int
+
+    @property
+    def name(self) -> str:
+        """A unique name of the case to use as the baseline key."""
+        return (f"{self.optimizer_type.name.lower()}-{self.space_adapter_type.name.lower()}"
+                f"-d{self.n_dims}-c{int(round(self.categorical_share * 100))}-n{self.n_obs}")
+
+
+def make_space(n_dims: int, categorical_share: float, seed: int = 42) -> CS.ConfigurationSpace:
+    """
+    Create a synthetic parameter space with a mix of float, int, and categorical parameters.
+
+    Parameters
+    ----------
+    n_dims : int
+        Total number of parameters.
+    categorical_share : float
+        Share of the categorical parameters (between 0 and 1).
+    seed : int
+        Random seed of the space.
+
+    Returns
+    -------
+    space : ConfigSpace.ConfigurationSpace
+        Parameters `cat_*` (4 choices each), followed by alternating `float_*` in [0, 1]
+        and `int_*` in [0, 100].
+    """
+    n_categorical = int(round(n_dims * categorical_share))
+    space = CS.ConfigurationSpace(seed=seed)
+    for i in range(n_categorical):
+        space.add_hyperparameter(CS.CategoricalHyperparameter(name=f"cat_{i}", choices=["a", "b", "c", "d"]))
+    for i in range(n_dims - n_categorical):
+        if i % 2 == 0:
+            space.add_hyperparameter(CS.UniformFloatHyperparameter(name=f"float_{i}", lower=0, upper=1))
+        else:
+            space.add_hyperparameter(CS.UniformIntegerHyperparameter(name=f"int_{i}", lower=0, upper=100))
+    return space
+
+
+def objective(configs: pd.DataFrame) -> pd.Series:
+    """
+    A synthetic objective for the spaces produced by `make_space`:
+    a shifted sphere over the (normalized) numeric parameters
+    plus a penalty for every categorical parameter not set to "a".
+    """
+    score = pd.Series(np.zeros(len(configs)), index=configs.index)
+    for name in configs.columns:
+        if name.startswith("cat_"):
+            score += (configs[name] != "a").astype(float)
+        else:
+            norm = configs[name].astype(float) / (100.0 if name.startswith("int_") else 1.0)
+            score += (norm - 0.3) ** 2
+    return score
+
+
+def _peak_rss_mb() -> float:
+    """
+    Peak resident set size of the current process in MB (NaN if not available).
+    """
+    try:
+        import resource  # pylint: disable=import-outside-toplevel
+    except ImportError:     # Windows
+        return float("nan")
+    max_rss = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    # Linux reports KB, macOS reports bytes.
+    return float(max_rss) / (2 ** 20 if sys.platform == "darwin" else 2 ** 10)
+
+
+def _latency_stats(prefix: str, latencies: Sequence[float]) -> Dict[str, float]:
+    """
+    Summary statistics of the per-call latencies (in seconds).
+    """
+    values = np.asarray(latencies, dtype=float)
+    stats = {f"{prefix}_p{pct}": float(np.percentile(values, pct)) for pct in PERCENTILES}
+    stats[f"{prefix}_max"] = float(values.max())
+    # The latency at the end of the run, i.e., with (almost) `n_obs` observations registered.
+    stats[f"{prefix}_tail_p50"] = float(np.percentile(values[-max(1, len(values) // 10):], 50))
+    return stats
+
+
+def run_case(case: BenchmarkCase, seed: int = 42) -> Dict[str, float]:
+    """
+    Run the benchmark case in the current process.
+
+    Parameters
+    ----------
+    case : BenchmarkCase
+        The benchmark configuration.
+    seed : int
+        Random seed of the parameter space and the global numpy state.
+
+    Returns
+    -------
+    results : Dict[str, float]
+        Latency percentiles of the `.suggest()` and `.register()` calls (in seconds),
+        the total time, and the peak RSS (in MB) of the process.
+    """
+    # Emukit doesn't allow specifying a random state, so we set the global seed.
+    np.random.seed(seed)
+    space = make_space(case.n_dims, case.categorical_share, seed)
+    space_adapter_kwargs: dict = {}
+    if case.space_adapter_type == SpaceAdapterType.LLAMATUNE:
+        space_adapter_kwargs["num_low_dims"] = min(LlamaTuneAdapter.DEFAULT_NUM_LOW_DIMS, case.n_dims - 1)
+    optimizer = OptimizerFactory.create(
+        parameter_space=space,
+        optimizer_type=case.optimizer_type,
+        space_adapter_type=case.space_adapter_type,
+        space_adapter_kwargs=space_adapter_kwargs,
+    )
+    rss_start = _peak_rss_mb()
+    suggest_latencies: List[float] = []
+    register_latencies: List[float] = []
+    total_start = time.perf_counter()
+    for _ in range(case.n_obs):
+        start = time.perf_counter()
+        suggestion = optimizer.suggest()
+        suggest_latencies.append(time.perf_counter() - start)
+        score = objective(suggestion)
+        start = time.perf_counter()
+        optimizer.register(suggestion, score)
+        register_latencies.append(time.perf_counter() - start)
+    results = {
+        "total_sec": time.perf_counter() - total_start,
+        "rss_start_mb": rss_start,
+        "peak_rss_mb": _peak_rss_mb(),
+    }
+    results.update(_latency_stats("suggest", suggest_latencies))
+    results.update(_latency_stats("register", register_latencies))
+    return results
+
+
+def run_benchmarks(cases: Iterable[BenchmarkCase], seed: int = 42,
+                   isolate: bool = True) -> Dict[str, Dict[str, float]]:
+    """
+    Run the benchmark cases one by one.
+
+    Parameters
+    ----------
+    cases : Iterable[BenchmarkCase]
+        Benchmark configurations to run.
+    seed : int
+        Random seed for all cases.
+    isolate : bool
+        If True (default), run each case in a fresh process to measure its peak RSS.
+
+    Returns
+    -------
+    results : Dict[str, Dict[str, float]]
+        Results of each case, keyed by the case name.
+    """
+    results: Dict[str, Dict[str, float]] = {}
+    for case in cases:
+        _LOG.info("Run benchmark: %s", case.name)
+        if isolate:
+            with ProcessPoolExecutor(max_workers=1, mp_context=get_context("spawn")) as executor:
+                results[case.name] = executor.submit(run_case, case, seed).result()
+        else:
+            results[case.name] = run_case(case, seed)
+        _LOG.info("Benchmark results: %s :: %s", case.name, results[case.name])
+    return results
+
+
+def compare_to_baseline(results: Dict[str, Dict[str, float]],
+                        baseline: Dict[str, Dict[str, float]],
+                        tolerance: float = DEFAULT_TOLERANCE) -> List[str]:
+    """
+    Compare the benchmark results to the baseline.
+
+    Parameters
+    ----------
+    results : Dict[str, Dict[str, float]]
+        Current results, as returned by `run_benchmarks`.
+    baseline : Dict[str, Dict[str, float]]
+        Baseline results of the same format.
+        The cases missing from it are skipped (see `missing_baselines`).
+    tolerance : float
+        Max. allowed ratio of the current to the baseline value.
+
+    Returns
+    -------
+    regressions : List[str]
+        Human-readable descriptions of the regressions; empty if there are none.
+    """
+    regressions: List[str] = []
+    for (name, metrics) in results.items():
+        for (metric, value) in metrics.items():
+            base = baseline.get(name, {}).get(metric)
+            if base is None or metric == "rss_start_mb" or np.isnan(value) or np.isnan(base):
+                continue
+            slack = _RSS_SLACK_MB if metric.endswith("_mb") else _LATENCY_SLACK_SEC
+            if value > base * tolerance and value > base + slack:
+                regressions.append(f"{name} :: {metric} = {value:.4g} (baseline: {base:.4g})")
+    return regressions
+
+
+def missing_baselines(results: Dict[str, Dict[str, float]],
+                      baseline: Dict[str, Dict[str, float]]) -> List[str]:
+    """
+    Get the names of the benchmark cases that have no baseline to compare to.
+    """
+    return [name for name in results if name not in baseline]
+
+
+def load_baseline(path: str) -> Dict[str, Dict[str, float]]:
+    """
+    Load the baseline results from a JSON file.
+    Raises FileNotFoundError if the file does not exist.
+    """
+    with open(path, mode="r", encoding="utf-8") as fh_baseline:
+        baseline: Dict[str, Dict[str, float]] = json.load(fh_baseline)
+    return baseline
+
+
+def save_baseline(path: str, results: Dict[str, Dict[str, float]]) -> None:
+    """
+    Merge the results into the baseline JSON file (create it if it does not exist).
+    """
+    baseline = load_baseline(path) if os.path.exists(path) else {}
+    baseline.update(results)
+    with open(path, mode="w", encoding="utf-8") as fh_baseline:
+        json.dump(baseline, fh_baseline, indent=2, sort_keys=True)
+        fh_baseline.write("\n")
+
+
+def _parse_args(argv: Optional[Sequence[str]] = None) -> argparse.Namespace:
+    parser = argparse.ArgumentParser(description="Benchmark the overhead of the mlos_core optimizers.")
+    parser.add_argument("--optimizers", nargs="+", default=[member.name.lower() for member in OptimizerType],
+                        choices=[member.name.lower() for member in OptimizerType],
+                        help="Optimizer types to benchmark (default: all).")
+    parser.add_argument("--adapters", nargs="+", default=[member.name.lower() for member in SpaceAdapterType],
+                        choices=[member.name.lower() for member in SpaceAdapterType],
+                        help="Space adapter types to benchmark (default: all).")
+    parser.add_argument("--dims", nargs="+", type=int, default=[8, 32, 200],
+                        help="Numbers of parameters in the space.")
+    parser.add_argument("--categorical-share", nargs="+", type=float, default=[0.0, 0.5],
+                        help="Shares of the categorical parameters in the space.")
+    parser.add_argument("--n-obs", nargs="+", type=int, default=[50, 200],
+                        help="Numbers of the suggest/register iterations.")
+    parser.add_argument("--seed", type=int, default=42, help="Random seed.")
+    parser.add_argument("--output", help="Path to the JSON file to store the results at.")
+    parser.add_argument("--baseline", default=DEFAULT_BASELINE_FILE, help="Path to the baselines JSON file.")
+    parser.add_argument("--check", action="store_true",
+                        help="Compare the results to the baselines and fail on regressions.")
+    parser.add_argument("--tolerance", type=float, default=DEFAULT_TOLERANCE,
+                        help="Max. allowed ratio of the current to the baseline value.")
+    parser.add_argument("--update-baseline", action="store_true",
+                        help="Store the results as the new baselines.")
+    return parser.parse_args(argv)
+
+
+def _main(argv: Optional[Sequence[str]] = None) -> int:
+    args = _parse_args(argv)
+    cases = [
+        BenchmarkCase(OptimizerType[opt.upper()], SpaceAdapterType[adapter.upper()], n_dims, share, n_obs)
+        for (opt, adapter, n_dims, share, n_obs) in itertools.product(
+            args.optimizers, args.adapters, args.dims, args.categorical_share, args.n_obs)
+        # LlamaTune needs a space to project from.
+        if adapter.upper() != SpaceAdapterType.LLAMATUNE.name or n_dims > 1
+    ]
+    results = run_benchmarks(cases, seed=args.seed)
+
+    for (name, metrics) in results.items():
+        print(f"{name}: suggest p50/p99 = {metrics['suggest_p50']:.4f}/{metrics['suggest_p99']:.4f} s, "
+              f"register p50/p99 = {metrics['register_p50']:.4f}/{metrics['register_p99']:.4f} s, "
+              f"peak RSS = {metrics['peak_rss_mb']:.1f} MB")
+    if args.output:
+        with open(args.output, mode="w", encoding="utf-8") as fh_output:
+            json.dump(results, fh_output, indent=2, sort_keys=True)
+
+    ret = 0
+    if args.check:
+        # The baselines are machine-specific: skip the cases not recorded on this one.
+        baseline = load_baseline(args.baseline) if os.path.exists(args.baseline) else {}
+        for name in missing_baselines(results, baseline):
+            print(f"SKIPPED: {name} :: no baseline in {args.baseline} (record it with --update-baseline)",
+                  file=sys.stderr)
+        regressions = compare_to_baseline(results, baseline, args.tolerance)
+        for regression in regressions:
+            print(f"REGRESSION: {regression}", file=sys.stderr)
+        ret = 1 if regressions else 0
+    if args.update_baseline:
+        save_baseline(args.baseline, results)
+    return ret
+
+
+if __name__ == "__main__":
+    logging.basicConfig(level=logging.INFO)
+    sys.exit(_main())
@@ -0,0 +1,89 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Tests for the optimizer overhead benchmark harness.
+"""
+
+import os
+
+from pathlib import Path
+
+import pytest
+
+import ConfigSpace as CS
+
+from mlos_core.optimizers import OptimizerType
+from mlos_core.spaces.adapters import SpaceAdapterType
+from mlos_core.tests.benchmarks.optimizer_benchmark import (
+    BenchmarkCase, _main, compare_to_baseline, load_baseline, make_space,
+    missing_baselines, run_benchmarks, save_baseline)
+
+
+def test_make_space() -> None:
+    """
+    Check the number and the types of the synthetic parameters.
+    """
+    space = make_space(n_dims=10, categorical_share=0.3)
+    params = space.get_hyperparameters()
+    assert len(params) == 10
+    assert sum(isinstance(param, CS.CategoricalHyperparameter) for param in params) == 3
+
+
+@pytest.mark.parametrize(('space_adapter_type'), list(SpaceAdapterType))
+def test_run_benchmarks(space_adapter_type: SpaceAdapterType) -> None:
+    """
+    Run a small benchmark case in-process and check the reported metrics.
+    """
+    case = BenchmarkCase(OptimizerType.RANDOM, space_adapter_type, n_dims=4, categorical_share=0.5, n_obs=5)
+    assert case.name == f"random-{space_adapter_type.name.lower()}-d4-c50-n5"
+    results = run_benchmarks([case], isolate=False)
+    metrics = results[case.name]
+    for metric in ("suggest_p50", "suggest_p99", "suggest_tail_p50", "register_p50", "register_max"):
+        assert metrics[metric] >= 0
+    assert metrics["suggest_p50"] <= metrics["suggest_p99"] <= metrics["suggest_max"]
+    assert metrics["total_sec"] >= metrics["suggest_max"]
+
+
+def test_compare_to_baseline(tmp_path: Path) -> None:
+    """
+    Check the regression detection and the baseline round trip.
+    """
+    baseline = {"case": {"suggest_p50": 0.1, "peak_rss_mb": 200.0}}
+    assert not compare_to_baseline({"case": {"suggest_p50": 0.12, "peak_rss_mb": 210.0}}, baseline)
+    # Sub-millisecond noise is not a regression.
+    assert not compare_to_baseline({"case": {"suggest_p50": 0.002}}, {"case": {"suggest_p50": 0.001}})
+    # Unknown metrics and the cases missing from the baseline are skipped.
+    assert not compare_to_baseline({"case": {"register_p50": 1.0}}, baseline)
+    assert not compare_to_baseline({"other": {"suggest_p50": 1.0}}, baseline)
+    assert missing_baselines({"case": {}, "other": {}}, baseline) == ["other"]
+    regressions = compare_to_baseline({"case": {"suggest_p50": 0.5, "peak_rss_mb": 400.0}}, baseline)
+    assert len(regressions) == 2
+
+    path = os.path.join(tmp_path, "baselines.json")
+    with pytest.raises(FileNotFoundError):
+        load_baseline(path)
+    save_baseline(path, baseline)
+    save_baseline(path, {"other": {"suggest_p50": 1.0}})
+    assert load_baseline(path) == {"case": baseline["case"], "other": {"suggest_p50": 1.0}}
+
+
+def test_check_without_baseline(tmp_path: Path, capsys: pytest.CaptureFixture) -> None:
+    """
+    Check that `--check` explicitly skips the cases without a baseline to compare to,
+    and still fails on the regressions of the others.
+    """
+    path = os.path.join(tmp_path, "baselines.json")
+    argv = ["--optimizers", "random", "--adapters", "identity", "--dims", "2",
+            "--categorical-share", "0", "--n-obs", "2", "--baseline", path, "--check"]
+    assert _main(argv) == 0
+    assert "SKIPPED: random-identity-d2-c0-n2" in capsys.readouterr().err
+    # The baseline file exists, but has no such case.
+    save_baseline(path, {"other": {"suggest_p50": 1.0}})
+    assert _main(argv) == 0
+    assert "SKIPPED: random-identity-d2-c0-n2" in capsys.readouterr().err
+    # An impossible baseline for the case.
+    save_baseline(path, {"random-identity-d2-c0-n2": {"total_sec": -1.0}})
+    assert _main(argv) == 1
+    assert "REGRESSION: random-identity-d2-c0-n2 :: total_sec" in capsys.readouterr().err
@@ -6,7 +6,7 @@
 Tests for Bayesian Optimizers.
 """
 
-from typing import Optional, Type
+from typing import List, Optional, Type
 
 import pytest
 
@@ -14,31 +14,32 @@ import pandas as pd
 import ConfigSpace as CS
 
 from mlos_core.optimizers import BaseOptimizer, OptimizerType
-from mlos_core.optimizers.bayesian_optimizers import BaseBayesianOptimizer
+from mlos_core.optimizers.bayesian_optimizers import BaseBayesianOptimizer, EmukitOptimizer
 
 
 @pytest.mark.parametrize(('optimizer_class', 'kwargs'), [
     *[(member.value, {}) for member in OptimizerType],
 ])
-def test_context_not_implemented_error(configuration_space: CS.ConfigurationSpace,
-                                       optimizer_class: Type[BaseOptimizer], kwargs: Optional[dict]) -> None:
+def test_context_without_context_space_error(configuration_space: CS.ConfigurationSpace,
+                                             optimizer_class: Type[BaseOptimizer], kwargs: Optional[dict]) -> None:
     """
-    Make sure we raise exceptions for the functionality that has not been implemented yet.
+    Make sure we raise exceptions for the context passed to an optimizer without a context space,
+    and for the functionality that has not been implemented yet.
     """
     if kwargs is None:
         kwargs = {}
     optimizer = optimizer_class(parameter_space=configuration_space, **kwargs)
     suggestion = optimizer.suggest()
     scores = pd.DataFrame({'score': [1]})
-    # test context not implemented errors
-    with pytest.raises(NotImplementedError):
+    # test unexpected context errors
+    with pytest.raises(ValueError):
         optimizer.register(suggestion, scores['score'], context=pd.DataFrame([["something"]]))
 
-    with pytest.raises(NotImplementedError):
+    with pytest.raises(ValueError):
         optimizer.suggest(context=pd.DataFrame([["something"]]))
 
     if isinstance(optimizer, BaseBayesianOptimizer):
-        with pytest.raises(NotImplementedError):
+        with pytest.raises(ValueError):
             optimizer.surrogate_predict(suggestion, context=pd.DataFrame([["something"]]))
 
         if optimizer_class in [OptimizerType.EMUKIT.value]:
@@ -46,3 +47,102 @@ def test_context_not_implemented_error(configuration_space: CS.ConfigurationSpac
             # NOTE: currently, only SMAC implements this
             with pytest.raises(NotImplementedError):
                 optimizer.acquisition_function(suggestion)
+
+
+def test_emukit_incremental_update(configuration_space: CS.ConfigurationSpace,
+                                   monkeypatch: pytest.MonkeyPatch) -> None:
+    """
+    Make sure Emukit conditions the GP on every new observation,
+    but re-optimizes its hyperparameters only as the number of observations grows.
+    """
+    optimizer = EmukitOptimizer(parameter_space=configuration_space)
+    for _ in range(11):
+        suggestion = optimizer.suggest()
+        optimizer.register(suggestion, pd.Series([1.0]))
+    optimizer.suggest()     # Bootstrap the GP model on the initial observations.
+    model = optimizer.gpbo.model
+    n_optimize: List[int] = []
+    optimize = model.optimize
+    monkeypatch.setattr(model, "optimize", lambda: n_optimize.append(1) or optimize())
+    for i in range(20):
+        suggestion = optimizer.suggest()
+        optimizer.register(suggestion, pd.Series([float(i)]))
+        assert len(model.X) == 12 + i
+    # 11 -> 14, 18, 23, 29 observations.
+    assert len(n_optimize) == 4
+
+
+def test_smac_multi_fidelity(configuration_space: CS.ConfigurationSpace) -> None:
+    """
+    Make sure multi-fidelity SMAC assigns a budget to each suggestion
+    and accepts the scores for the configurations evaluated with that budget.
+    """
+    optimizer = OptimizerType.SMAC.value(parameter_space=configuration_space,
+                                         min_budget=1, max_budget=9, eta=3)
+    budgets = set()
+    for _ in range(10):
+        suggestion = optimizer.suggest()
+        budget = optimizer.get_budget(suggestion)
+        assert budget is not None and 1 <= budget <= 9
+        budgets.add(budget)
+        optimizer.register(suggestion, pd.Series([budget * suggestion['x'].iloc[0]]))
+    # Hyperband starts with the cheap low-fidelity trials.
+    assert min(budgets) < 9
+
+    # Single-fidelity SMAC and the other optimizers have no budgets.
+    optimizer = OptimizerType.SMAC.value(parameter_space=configuration_space)
+    assert optimizer.get_budget(optimizer.suggest()) is None
+
+    with pytest.raises(ValueError):
+        OptimizerType.SMAC.value(parameter_space=configuration_space, max_budget=9)
+
+
+def test_smac_multi_fidelity_budgets(configuration_space: CS.ConfigurationSpace) -> None:
+    """
+    Make sure multi-fidelity SMAC registers the scores for the given budgets
+    and forgets the suggestions once their scores are registered.
+    """
+    optimizer = OptimizerType.SMAC.value(parameter_space=configuration_space,
+                                         min_budget=1, max_budget=9, eta=3)
+    assert optimizer.is_multi_fidelity
+    suggestion = optimizer.suggest()
+    budget = optimizer.get_budget(suggestion)
+    assert len(optimizer.trial_info_map) == 1
+    with pytest.raises(ValueError):
+        optimizer.register(suggestion, pd.Series([1.0]), budgets=[budget, budget])
+    optimizer.register(suggestion, pd.Series([1.0]), budgets=[budget])
+    assert not optimizer.trial_info_map
+
+    # A configuration SMAC has not suggested gets the max. budget unless specified.
+    assert optimizer.get_budget(suggestion) == 9
+    optimizer.register(suggestion, pd.Series([2.0]), budgets=[3])
+    assert not optimizer.trial_info_map
+
+    assert not OptimizerType.SMAC.value(parameter_space=configuration_space).is_multi_fidelity
+
+
+def test_smac_multi_fidelity_failed(configuration_space: CS.ConfigurationSpace) -> None:
+    """
+    Make sure the failed trials complete in SMAC with the crash cost, so that
+    Hyperband still promotes the best configurations to the higher budgets.
+    """
+    from smac.runhistory import StatusType  # pylint: disable=import-outside-toplevel
+    optimizer = OptimizerType.SMAC.value(parameter_space=configuration_space,
+                                         min_budget=1, max_budget=9, eta=3)
+    budgets = []
+    for i in range(15):
+        suggestion = optimizer.suggest()
+        budget = optimizer.get_budget(suggestion)
+        budgets.append(budget)
+        if i % 4 == 1:
+            optimizer.register_failed(suggestion, budgets=[budget])
+        else:
+            optimizer.register(suggestion, pd.Series([suggestion['x'].iloc[0]]), budgets=[budget])
+        assert not optimizer.trial_info_map
+    # The low-fidelity stage completes despite the failures.
+    assert min(budgets) == 1 and max(budgets) > 1
+    statuses = [value.status for value in optimizer.base_optimizer.runhistory.values()]
+    assert statuses.count(StatusType.CRASHED) == 4
+    assert StatusType.RUNNING not in statuses
+    # The failures are not observations.
+    assert len(optimizer.get_observations()) == 11
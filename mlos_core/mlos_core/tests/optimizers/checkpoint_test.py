@@ -0,0 +1,145 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Tests for the optimizer checkpoints.
+"""
+
+import base64
+import json
+from pathlib import Path
+from typing import List, Optional, Type
+
+import pytest
+
+import pandas as pd
+import ConfigSpace as CS
+
+from mlos_core.optimizers import OptimizerType, BaseOptimizer, SmacOptimizer
+
+
+def _objective(configs: pd.DataFrame) -> pd.Series:
+    return configs['x'] + configs['z'] / 10
+
+
+@pytest.mark.parametrize(('optimizer_class', 'kwargs'), [
+    *[(member.value, {}) for member in OptimizerType],
+])
+def test_checkpoint_restore(configuration_space: CS.ConfigurationSpace,
+                            optimizer_class: Type[BaseOptimizer], kwargs: Optional[dict]) -> None:
+    """
+    Resume the optimization from a checkpoint in a new instance of the optimizer.
+    """
+    optimizer = optimizer_class(parameter_space=configuration_space, **(kwargs or {}))
+    for _ in range(12):
+        suggestion = optimizer.suggest()
+        optimizer.register(suggestion, _objective(suggestion))
+    checkpoint = optimizer.checkpoint()
+    assert isinstance(checkpoint, bytes)
+
+    restored = optimizer_class(parameter_space=configuration_space, **(kwargs or {}))
+    restored.restore(checkpoint)
+    pd.testing.assert_frame_equal(restored.get_observations(), optimizer.get_observations())
+    pd.testing.assert_frame_equal(restored.get_best_observation(), optimizer.get_best_observation())
+
+    # The restored optimizer keeps going.
+    suggestion = restored.suggest()
+    assert (suggestion.columns == ['x', 'y', 'z']).all()
+    restored.register(suggestion, _objective(suggestion))
+    assert len(restored.get_observations()) == 13
+
+    # Only the fresh optimizers can be restored.
+    with pytest.raises(ValueError):
+        restored.restore(checkpoint)
+    optimizer.cleanup()
+    restored.cleanup()
+
+
+def test_checkpoint_incompatible(configuration_space: CS.ConfigurationSpace) -> None:
+    """
+    The checkpoints of a different optimizer or parameter space are rejected.
+    """
+    optimizer = OptimizerType.RANDOM.value(parameter_space=configuration_space)
+    suggestion = optimizer.suggest()
+    optimizer.register(suggestion, _objective(suggestion))
+    checkpoint = optimizer.checkpoint()
+
+    with pytest.raises(ValueError):
+        OptimizerType.FLAML.value(parameter_space=configuration_space).restore(checkpoint)
+    with pytest.raises(ValueError):
+        OptimizerType.RANDOM.value(parameter_space=configuration_space,
+                                   objectives=['latency', 'cost']).restore(checkpoint)
+    space = CS.ConfigurationSpace(seed=1234)
+    space.add_hyperparameter(CS.UniformFloatHyperparameter(name='x', lower=0, upper=1))
+    with pytest.raises(ValueError):
+        OptimizerType.RANDOM.value(parameter_space=space).restore(checkpoint)
+
+
+@pytest.mark.parametrize(('blob'), [
+    b"",
+    b"garbage",
+    b"[]",
+    b'{"class": "RandomOptimizer"}',
+    # A pickle is never loaded.
+    b"\x80\x04\x95\x1d\x00\x00\x00\x00\x00\x00\x00\x8c\x02os\x94\x8c\x06system\x94\x93\x94.",
+])
+def test_checkpoint_invalid(configuration_space: CS.ConfigurationSpace, blob: bytes) -> None:
+    """
+    Malformed or non-JSON checkpoints are rejected with a ValueError.
+    """
+    optimizer = OptimizerType.RANDOM.value(parameter_space=configuration_space)
+    with pytest.raises(ValueError):
+        optimizer.restore(blob)
+    with pytest.raises(ValueError):
+        optimizer.get_observations()
+
+
+def test_smac_restore_corrupt_state(configuration_space: CS.ConfigurationSpace) -> None:
+    """
+    If SMAC fails to load its state from the checkpoint, the optimizer is left empty,
+    so the observations can be registered from scratch instead.
+    """
+    optimizer = SmacOptimizer(parameter_space=configuration_space)
+    for _ in range(3):
+        suggestion = optimizer.suggest()
+        optimizer.register(suggestion, _objective(suggestion))
+    state = json.loads(optimizer.checkpoint())
+    state["backend"]["runhistory.json"] = base64.b64encode(b"{not json").decode("ascii")
+
+    restored = SmacOptimizer(parameter_space=configuration_space)
+    with pytest.raises(Exception):
+        restored.restore(json.dumps(state).encode("utf-8"))
+    with pytest.raises(ValueError):
+        restored.get_observations()
+    observations = optimizer.get_observations()
+    restored.register(observations[['x', 'y', 'z']], observations['score'])
+    assert len(restored.base_optimizer.runhistory) == 3
+    assert len(restored.get_observations()) == 3
+    optimizer.cleanup()
+    restored.cleanup()
+
+
+def test_smac_save_interval(configuration_space: CS.ConfigurationSpace,
+                            monkeypatch: pytest.MonkeyPatch, tmp_path: Path) -> None:
+    """
+    By default, SMAC saves its state only with the checkpoints, not on every registration,
+    unless the output directory is set explicitly.
+    """
+    monkeypatch.setattr(SmacOptimizer, "_DEFAULT_SAVE_INTERVAL", 0)
+    for (save_interval, output_directory, n_saves) in [
+            (None, None, 0), (0, None, 3), (3600, None, 0),
+            (None, str(tmp_path / "smac"), 3), (3600, str(tmp_path / "smac_3600"), 0)]:
+        optimizer = SmacOptimizer(parameter_space=configuration_space, save_interval=save_interval,
+                                  output_directory=output_directory)
+        saves: List[int] = []
+        smbo = optimizer.base_optimizer.optimizer
+        save = smbo.save
+        monkeypatch.setattr(smbo, "save", lambda: saves.append(1) or save())
+        for _ in range(3):
+            suggestion = optimizer.suggest()
+            optimizer.register(suggestion, _objective(suggestion))
+        assert len(saves) == n_saves
+        optimizer.checkpoint()
+        assert len(saves) == n_saves + 1
+        optimizer.cleanup()
@@ -0,0 +1,85 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Tests for the contextual optimization.
+"""
+
+from typing import Type
+
+import pytest
+
+import pandas as pd
+import numpy as np
+import ConfigSpace as CS
+
+from mlos_core.optimizers import OptimizerType, BaseOptimizer
+from mlos_core.optimizers.bayesian_optimizers import BaseBayesianOptimizer, SmacOptimizer
+
+
+@pytest.fixture
+def context_space() -> CS.ConfigurationSpace:
+    """
+    Test fixture to produce a context space with a numeric and a categorical feature.
+    """
+    space = CS.ConfigurationSpace(seed=1234)
+    space.add_hyperparameter(CS.UniformFloatHyperparameter(name='read_ratio', lower=0, upper=1))
+    space.add_hyperparameter(CS.CategoricalHyperparameter(name='workload', choices=["oltp", "olap"]))
+    return space
+
+
+@pytest.mark.parametrize(('optimizer_class'), [member.value for member in OptimizerType])
+def test_contextual_optimization(configuration_space: CS.ConfigurationSpace,
+                                 context_space: CS.ConfigurationSpace,
+                                 optimizer_class: Type[BaseOptimizer]) -> None:
+    """
+    Register the scores with their contexts and get the suggestions for a given context.
+    """
+    # Emukit doesn't allow specifying a random state, so we set the global seed.
+    np.random.seed(42)
+    optimizer = optimizer_class(parameter_space=configuration_space, context_space=context_space)
+    for i in range(15):
+        context = pd.DataFrame([{'read_ratio': (i % 5) / 4, 'workload': ["oltp", "olap"][i % 2]}])
+        suggestion = optimizer.suggest(context=context)
+        assert isinstance(suggestion, pd.DataFrame)
+        assert (suggestion.columns == ['x', 'y', 'z']).all()
+        assert len(suggestion) == 1
+        score = suggestion['x'] * context['read_ratio'] + suggestion['z']
+        optimizer.register(suggestion, score, context=context)
+
+    observations = optimizer.get_observations()
+    assert list(observations.columns) == ['x', 'y', 'z', 'read_ratio', 'workload', 'score']
+    assert len(observations) == 15
+
+    context = pd.DataFrame([{'read_ratio': 0.5, 'workload': "olap"}])
+    suggestions = optimizer.suggest(context=context, n_suggestions=3)
+    assert len(suggestions) == 3
+    assert (suggestions.columns == ['x', 'y', 'z']).all()
+
+    if isinstance(optimizer, BaseBayesianOptimizer):
+        assert len(optimizer.surrogate_predict(suggestions, context=context)) == 3
+
+    if isinstance(optimizer, SmacOptimizer):
+        # SMAC does not wait for the results of its own suggestions.
+        assert not optimizer.trial_info_map
+        assert not optimizer.base_optimizer.runhistory.get_running_trials()
+
+    # The context is required for every call.
+    with pytest.raises(ValueError):
+        optimizer.suggest()
+    with pytest.raises(ValueError):
+        optimizer.register(suggestion, pd.Series([1.0]))
+    # ... with all the context features.
+    with pytest.raises(ValueError):
+        optimizer.suggest(context=pd.DataFrame([{'read_ratio': 0.5}]))
+
+
+def test_context_space_overlap(configuration_space: CS.ConfigurationSpace) -> None:
+    """
+    Context features cannot shadow the parameters.
+    """
+    context_space = CS.ConfigurationSpace(seed=1234)
+    context_space.add_hyperparameter(CS.UniformFloatHyperparameter(name='x', lower=0, upper=1))
+    with pytest.raises(ValueError):
+        OptimizerType.RANDOM.value(parameter_space=configuration_space, context_space=context_space)
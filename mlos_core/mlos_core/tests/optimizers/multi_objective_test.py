@@ -0,0 +1,87 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Tests for the multi-objective optimization.
+"""
+
+from typing import Type
+
+import pytest
+
+import pandas as pd
+import ConfigSpace as CS
+
+from mlos_core.optimizers import OptimizerType, BaseOptimizer
+
+
+@pytest.mark.parametrize(('optimizer_class'), [OptimizerType.RANDOM.value, OptimizerType.SMAC.value])
+def test_multi_objective_optimization(configuration_space: CS.ConfigurationSpace,
+                                      optimizer_class: Type[BaseOptimizer]) -> None:
+    """
+    Register the scores of two conflicting objectives and check the Pareto front.
+    """
+    optimizer = optimizer_class(parameter_space=configuration_space, objectives=['latency', 'cost'])
+    assert optimizer.is_multi_objective
+    for _ in range(12):
+        suggestion = optimizer.suggest()
+        assert (suggestion.columns == ['x', 'y', 'z']).all()
+        scores = pd.DataFrame({
+            'latency': suggestion['x'] + suggestion['z'] / 10,
+            'cost': (1 - suggestion['x']) + suggestion['z'] / 10,
+        })
+        optimizer.register(suggestion, scores)
+
+    observations = optimizer.get_observations()
+    assert list(observations.columns) == ['x', 'y', 'z', 'latency', 'cost']
+    assert len(observations) == 12
+
+    best = optimizer.get_best_observation()
+    assert best['latency'].iloc[0] == observations['latency'].min()
+
+    front = optimizer.get_pareto_front()
+    assert len(front) > 0
+    assert list(front.columns) == ['x', 'y', 'z', 'latency', 'cost']
+    # No observation is better than a Pareto-optimal one on both objectives.
+    for (_, point) in front.iterrows():
+        assert not ((observations['latency'] <= point['latency']) &
+                    (observations['cost'] <= point['cost']) &
+                    ((observations['latency'] < point['latency']) |
+                     (observations['cost'] < point['cost']))).any()
+
+    # The scores of all objectives are required.
+    with pytest.raises(ValueError):
+        optimizer.register(suggestion, pd.Series([1.0]))
+    with pytest.raises(ValueError):
+        optimizer.register(suggestion, pd.DataFrame({'latency': [1.0]}))
+
+
+@pytest.mark.parametrize(('optimizer_class'), [OptimizerType.FLAML.value, OptimizerType.EMUKIT.value])
+def test_multi_objective_unsupported(configuration_space: CS.ConfigurationSpace,
+                                     optimizer_class: Type[BaseOptimizer]) -> None:
+    """
+    The single-objective backends reject several objectives upfront.
+    """
+    with pytest.raises(NotImplementedError):
+        optimizer_class(parameter_space=configuration_space, objectives=['latency', 'cost'])
+
+
+def test_objectives_overlap(configuration_space: CS.ConfigurationSpace) -> None:
+    """
+    Objectives cannot shadow the parameters.
+    """
+    with pytest.raises(ValueError):
+        OptimizerType.RANDOM.value(parameter_space=configuration_space, objectives=['x', 'cost'])
+
+
+def test_single_objective_pareto_front(configuration_space: CS.ConfigurationSpace) -> None:
+    """
+    With a single objective, the Pareto front is the best observation(s).
+    """
+    optimizer = OptimizerType.RANDOM.value(parameter_space=configuration_space)
+    suggestions = optimizer.suggest(n_suggestions=3)
+    optimizer.register(suggestions, pd.Series([2.0, 1.0, 3.0]))
+    front = optimizer.get_pareto_front()
+    assert front['score'].tolist() == [1.0]
+    assert front.index.tolist() == optimizer.get_best_observation().index.tolist()
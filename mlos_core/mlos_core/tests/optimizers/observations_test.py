@@ -0,0 +1,112 @@
+#
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+"""
+Tests for the columnar observation store of the optimizers.
+"""
+
+import pytest
+
+import numpy as np
+import pandas as pd
+
+from mlos_core.optimizers.observations import ObservationStore
+
+
+def test_observation_store_append() -> None:
+    """
+    Append several batches (beyond the initial capacity) and check the history and the incumbent.
+    """
+    store = ObservationStore(capacity=2)
+    assert len(store) == 0
+    with pytest.raises(ValueError):
+        store.best()
+
+    store.append(pd.DataFrame({'x': [1, 2], 'y': ['a', 'b']}), pd.Series([5.0, 3.0]))
+    assert store.best().to_dict(orient='records') == [{'x': 2, 'y': 'b', 'score': 3.0}]
+
+    # Columns in different order; int column receives floats.
+    store.append(pd.DataFrame({'y': ['c', 'd', 'e'], 'x': [3.5, 4.0, 5.0]}), pd.Series([4.0, 1.0, 1.0]))
+    assert len(store) == 5
+    best = store.best()
+    assert best.index.tolist() == [3]     # first of the two tied rows
+    assert best.to_dict(orient='records') == [{'x': 4.0, 'y': 'd', 'score': 1.0}]
+
+    observations = store.to_dataframe()
+    assert observations.columns.tolist() == ['x', 'y', 'score']
+    assert observations['x'].tolist() == [1.0, 2.0, 3.5, 4.0, 5.0]
+    assert observations['y'].tolist() == ['a', 'b', 'c', 'd', 'e']
+    assert observations['score'].tolist() == [5.0, 3.0, 4.0, 1.0, 1.0]
+
+
+def test_observation_store_invalid() -> None:
+    """
+    Check that invalid batches are rejected and NaN scores never become the incumbent.
+    """
+    store = ObservationStore()
+    store.append(pd.DataFrame({'x': [1.0]}), pd.Series([np.nan]))
+    with pytest.raises(ValueError):
+        store.best()
+    store.append(pd.DataFrame({'x': [2.0]}), pd.Series([7.0]))
+    assert store.best()['score'].iloc[0] == 7.0
+
+    with pytest.raises(ValueError):
+        store.append(pd.DataFrame({'x': [1.0, 2.0]}), pd.Series([1.0]))
+    with pytest.raises(ValueError):
+        store.append(pd.DataFrame({'z': [1.0]}), pd.Series([1.0]))
+    assert len(store) == 2
+
+
+def test_observation_store_context() -> None:
+    """
+    Check that the context features are stored after the parameters and are required once used.
+    """
+    store = ObservationStore()
+    store.append(pd.DataFrame({'x': [1.0, 2.0]}), pd.Series([5.0, 3.0]),
+                 context=pd.DataFrame({'c': ['a', 'b']}))
+    assert store.has_context
+    assert store.to_dataframe().columns.tolist() == ['x', 'c', 'score']
+    assert store.best().to_dict(orient='records') == [{'x': 2.0, 'c': 'b', 'score': 3.0}]
+
+    with pytest.raises(ValueError):
+        store.append(pd.DataFrame({'x': [3.0]}), pd.Series([1.0]))
+    with pytest.raises(ValueError):
+        store.append(pd.DataFrame({'x': [3.0]}), pd.Series([1.0]), context=pd.DataFrame({'c': ['a', 'b']}))
+    assert len(store) == 2
+
+    store = ObservationStore()
+    store.append(pd.DataFrame({'x': [1.0]}), pd.Series([5.0]))
+    with pytest.raises(ValueError):
+        store.append(pd.DataFrame({'x': [3.0]}), pd.Series([1.0]), context=pd.DataFrame({'c': ['a']}))
+
+
+def test_observation_store_pareto_front() -> None:
+    """
+    Check that the Pareto front is maintained incrementally over several objectives.
+    """
+    store = ObservationStore(objectives=['latency', 'cost'])
+    with pytest.raises(ValueError):
+        store.pareto_front()
+    # A single series is ambiguous with several objectives.
+    with pytest.raises(ValueError):
+        store.append(pd.DataFrame({'x': [1.0]}), pd.Series([1.0]))
+
+    store.append(pd.DataFrame({'x': [1.0, 2.0, 3.0]}),
+                 pd.DataFrame({'cost': [1.0, 3.0, 2.0], 'latency': [5.0, 2.0, 6.0]}))
+    # (6, 2) is dominated by (5, 1).
+    assert store.pareto_front()['x'].tolist() == [1.0, 2.0]
+    assert store.to_dataframe().columns.tolist() == ['x', 'latency', 'cost']
+    # The primary objective is the first one.
+    assert store.best().to_dict(orient='records') == [{'x': 2.0, 'latency': 2.0, 'cost': 3.0}]
+
+    # (1, 1) dominates the whole front; NaN scores never make it to the front.
+    store.append(pd.DataFrame({'x': [4.0, 5.0]}),
+                 pd.DataFrame({'latency': [1.0, np.nan], 'cost': [1.0, 0.0]}))
+    front = store.pareto_front()
+    assert front.index.tolist() == [3]
+    assert front.to_dict(orient='records') == [{'x': 4.0, 'latency': 1.0, 'cost': 1.0}]
+
+    # Ties do not dominate each other.
+    store.append(pd.DataFrame({'x': [6.0]}), pd.DataFrame({'latency': [1.0], 'cost': [1.0]}))
+    assert store.pareto_front().index.tolist() == [3, 5]
@@ -80,3 +80,36 @@ def test_round_trip_reverse(configuration_space: CS.ConfigurationSpace, one_hot:
     optimizer = EmukitOptimizer(parameter_space=configuration_space)
     round_trip = optimizer._to_1hot(optimizer._from_1hot(one_hot))
     assert round_trip == pytest.approx(one_hot)
+
+
+def test_to_1hot_series(configuration_space: CS.ConfigurationSpace,
+                        data_frame: pd.DataFrame, one_hot: npt.NDArray) -> None:
+    """
+    One-hot encoding of a single configuration given as pandas Series.
+    """
+    optimizer = EmukitOptimizer(parameter_space=configuration_space)
+    assert optimizer._to_1hot(data_frame.iloc[1]) == pytest.approx(one_hot[[1]])
+
+
+def test_to_1hot_invalid(configuration_space: CS.ConfigurationSpace, data_frame: pd.DataFrame) -> None:
+    """
+    Make sure one-hot encoding fails on the values that are not in the parameter space.
+    """
+    optimizer = EmukitOptimizer(parameter_space=configuration_space)
+    data_frame.loc[1, 'y'] = 'foo'
+    with pytest.raises(ValueError):
+        optimizer._to_1hot(data_frame)
+
+
+def test_round_trip_large(configuration_space: CS.ConfigurationSpace, data_frame: pd.DataFrame) -> None:
+    """
+    Round-trip test for one-hot-encoding and decoding of a large batch of configurations.
+    """
+    optimizer = EmukitOptimizer(parameter_space=configuration_space)
+    df_large = pd.concat([data_frame] * 1000, ignore_index=True)
+    one_hot = optimizer._to_1hot(df_large)
+    assert one_hot.shape == (3000, 5)
+    df_round_trip = optimizer._from_1hot(one_hot)
+    assert df_round_trip.x.to_numpy() == pytest.approx(df_large.x)
+    assert (df_round_trip.y == df_large.y).all()
+    assert (df_round_trip.z == df_large.z).all()
@@ -6,6 +6,9 @@
 Tests for Bayesian Optimizers.
 """
 
+import subprocess
+import sys
+
 from typing import List, Optional, Type
 
 import pytest
@@ -105,6 +108,41 @@ def test_basic_interface_toy_problem(configuration_space: CS.ConfigurationSpace,
         assert pred_all.shape == (20,)
 
 
+@pytest.mark.parametrize(('optimizer_class', 'kwargs'), [
+    *[(member.value, {}) for member in OptimizerType],
+])
+def test_suggest_batch(configuration_space: CS.ConfigurationSpace,
+                       optimizer_class: Type[BaseOptimizer], kwargs: Optional[dict]) -> None:
+    """
+    Test that we can get several suggestions at once and register them all.
+    """
+    if kwargs is None:
+        kwargs = {}
+    np.random.seed(42)
+    optimizer = optimizer_class(parameter_space=configuration_space, **kwargs)
+
+    with pytest.raises(ValueError):
+        optimizer.suggest(n_suggestions=0)
+
+    n_suggestions = 4
+    for i in range(5):
+        suggestions = optimizer.suggest(defaults=(i == 0), n_suggestions=n_suggestions)
+        assert isinstance(suggestions, pd.DataFrame)
+        assert suggestions.shape == (n_suggestions, 3)
+        assert set(suggestions.columns) == {'x', 'y', 'z'}
+        for (_, suggestion) in suggestions.iterrows():
+            # Raises an error if outside of configuration space
+            CS.Configuration(optimizer.parameter_space, suggestion.to_dict()).is_valid_configuration()
+        if i == 0:
+            default_config = configuration_space.get_default_configuration().get_dictionary()
+            assert suggestions.iloc[0].to_dict() == default_config
+        suggestions = suggestions[['x', 'y', 'z']].reset_index(drop=True)
+        optimizer.register(suggestions, suggestions['x'] * suggestions['z'])
+
+    all_observations = optimizer.get_observations()
+    assert all_observations.shape == (5 * n_suggestions, 4)
+
+
 @pytest.mark.parametrize(('optimizer_type'), [
     # Enumerate all supported Optimizers
     # *[member for member in OptimizerType],
@@ -253,3 +291,15 @@ def test_optimizer_type_defs(optimizer_class: Type[BaseOptimizer]) -> None:
     """
     optimizer_type_classes = {member.value for member in OptimizerType}
     assert optimizer_class in optimizer_type_classes
+
+
+def test_optimizer_backends_lazy_import() -> None:
+    """
+    Test that importing the optimizer and space adapter factories does not load
+    the ML stacks of the backends until an optimizer is created.
+    """
+    backends = ["smac", "emukit", "GPy", "flaml", "sklearn"]
+    code = "import sys; import mlos_core.optimizers; import mlos_core.spaces.adapters; " + \
+        f"print([name for name in {backends!r} if name in sys.modules])"
+    output = subprocess.run([sys.executable, "-c", code], check=True, capture_output=True, text=True).stdout
+    assert output.strip() == "[]"
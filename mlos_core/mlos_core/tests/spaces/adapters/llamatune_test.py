@@ -496,3 +496,38 @@ def test_deterministic_behavior_for_same_seed(num_target_space_dims: int, param_
 
     assert generate_target_param_space_configs(42) == generate_target_param_space_configs(42)
     assert generate_target_param_space_configs(1234) != generate_target_param_space_configs(42)
+
+
+@pytest.mark.parametrize(('special_param_values', 'max_unique_values_per_param'), ([
+    (special_param_values, max_unique_values_per_param)
+    for special_param_values in (None, {'int_1': (-1, 0.1), 'int_4': [(-1, 0.1), (0, 0.2)]})
+    for max_unique_values_per_param in (None, 50)
+]))
+def test_batch_transform(special_param_values: dict, max_unique_values_per_param: int) -> None:
+    """
+    Tests that transforming a batch of configurations gives the same results as transforming them one by one.
+    """
+    input_space = construct_parameter_space(n_continuous_params=10, n_integer_params=10, n_categorical_params=5)
+    adapter = LlamaTuneAdapter(
+        orig_parameter_space=input_space,
+        num_low_dims=4,
+        special_param_values=special_param_values,
+        max_unique_values_per_param=max_unique_values_per_param,
+    )
+
+    num_configs = 100
+    configs = adapter.target_parameter_space.sample_configuration(size=num_configs)
+    sampled_configs_df = pd.DataFrame([config.get_dictionary() for config in configs],
+                                      columns=adapter.target_parameter_space.get_hyperparameter_names())
+
+    orig_configs_df = adapter.transform(sampled_configs_df)
+    assert len(orig_configs_df) == num_configs
+    for idx in range(num_configs):
+        orig_config_df = adapter.transform(sampled_configs_df.iloc[[idx]])
+        assert orig_config_df.iloc[0].to_dict() == orig_configs_df.iloc[idx].to_dict()
+        input_space.check_configuration(CS.Configuration(input_space, values=orig_configs_df.iloc[idx].to_dict()))
+
+    # The whole batch maps back to the original low-dim points.
+    target_configs_df = adapter.inverse_transform(orig_configs_df)
+    for (idx, config) in enumerate(configs):
+        assert CS.Configuration(adapter.target_parameter_space, values=target_configs_df.iloc[idx].to_dict()) == config